@@ -43,3 +43,11 @@ for f in files:
 	command_line = f"{compiler_path} -c {debug_key} {f} -o {output_path}{file_name}{extension_new}"
 	#print(command_line)
 	subprocess.call(command_line)
+	# "// variant: NAME" compiles shader once more with NAME defined, f.e. DRAW_PARAMETERS goes to
+	# <file>DrawParameters_vertex.spv
+	with open(f) as source:
+		variants = [line.split(":", 1)[1].strip() for line in source if line.startswith("// variant:")]
+	for variant in variants:
+		suffix = "".join(word.capitalize() for word in variant.split("_"))
+		command_line = f"{compiler_path} -c {debug_key} -D{variant} {f} -o {output_path}{file_name}{suffix}{extension_new}"
+		subprocess.call(command_line)
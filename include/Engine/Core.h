@@ -7,7 +7,11 @@
 #include "Utility/Timer.h"
 #include "Utility/ResourceManager.h"
 #include "Utility/Animation.h"
-#include "Utility/GameState.h"
+#include "Utility/AnimationSystem.h"
+#include "Utility/Benchmark.h"
+#include "Utility/Profiler.h"
+#include "Utility/UploadManager.h"
+#include "Vulkan/FrameGraph.h"
 #include "Vulkan/Render.h"
 #include "Vulkan/Swapchain.h"
 #include "Graphic/Postprocessing.h"
@@ -15,6 +19,9 @@
 #include "Graphic/LightManager.h"
 #include "Graphic/IBL.h"
 #include "Graphic/Blur.h"
+#include "Graphic/BVH.h"
+#include "Graphic/CullingCompute.h"
+#include "Graphic/SkinningCompute.h"
 #include "Primitive/ParticleSystem.h"
 #include "Primitive/Terrain.h"
 #include "Primitive/Skybox.h"
@@ -39,17 +46,34 @@ class Core {
   std::shared_ptr<RenderPass> _renderPassShadowMap, _renderPassGraphic, _renderPassDebug, _renderPassBlur;
   std::vector<std::shared_ptr<Framebuffer>> _frameBufferGraphic, _frameBufferDebug;
   std::shared_ptr<CommandPool> _commandPoolRender, _commandPoolApplication, _commandPoolInitialize,
-      _commandPoolParticleSystem, _commandPoolEquirectangular, _commandPoolPostprocessing, _commandPoolGUI;
+      _commandPoolParticleSystem, _commandPoolEquirectangular, _commandPoolPostprocessing, _commandPoolGUI,
+      _commandPoolSkinning, _commandPoolShadows;
   std::shared_ptr<CommandBuffer> _commandBufferRender, _commandBufferApplication, _commandBufferInitialize,
-      _commandBufferEquirectangular, _commandBufferParticleSystem, _commandBufferPostprocessing, _commandBufferGUI;
+      _commandBufferEquirectangular, _commandBufferParticleSystem, _commandBufferPostprocessing, _commandBufferGUI,
+      _commandBufferSkinning;
+  // shadow maps are recorded in parallel, so barriers of shadow pass are recorded to own command buffer before them
+  std::shared_ptr<CommandBuffer> _commandBufferShadows;
+  // main pass is recorded to secondary command buffers, drawables are split to chunks recorded in parallel
+  std::vector<std::shared_ptr<CommandPool>> _commandPoolSecondary;
+  std::map<AlphaType, std::vector<std::shared_ptr<CommandBuffer>>> _commandBufferSecondary;
+  std::shared_ptr<CommandBuffer> _commandBufferSkybox;
+  // GPU part of asynchronously loaded models, is allocated from application's pool
+  std::shared_ptr<CommandBuffer> _commandBufferModelGLTF;
   std::shared_ptr<Logger> _logger, _loggerPostprocessing, _loggerParticles, _loggerGUI, _loggerDebug;
   std::vector<std::shared_ptr<Logger>> _loggerDirectional;
   std::vector<std::vector<std::shared_ptr<Logger>>> _loggerPoint;
 
   std::vector<std::shared_ptr<Semaphore>> _semaphoreImageAvailable, _semaphoreRenderFinished;
-  std::vector<std::shared_ptr<Semaphore>> _semaphoreParticleSystem, _semaphorePostprocessing, _semaphoreGUI;
-  std::vector<std::shared_ptr<Semaphore>> _semaphoreResourcesReady, _semaphoreApplicationReady;
-  std::map<int, bool> _waitSemaphoreResourcesReady, _waitSemaphoreApplicationReady;
+  std::shared_ptr<FrameGraph> _frameGraph;
+  std::shared_ptr<UploadManager> _uploadManager;
+  // passes of current frame in frame graph, skinning and shadows passes are -1 if there is nothing to record
+  int _passParticles, _passSkinning, _passShadows, _passRender, _passPostprocessing, _passGUI;
+  // queue of particles, blur and postprocessing passes
+  vkb::QueueType _queueCompute;
+  // models parsed by thread pool, GPU resources are created at the frame boundary
+  std::vector<std::tuple<std::shared_ptr<SceneGLTF>, std::shared_ptr<std::promise<std::shared_ptr<ModelGLTF>>>>>
+      _scenesGLTF;
+  std::mutex _mutexScenesGLTF;
 
   std::vector<std::shared_ptr<Fence>> _fenceInFlight;
 
@@ -60,42 +84,72 @@ class Core {
   std::shared_ptr<Timer> _timer;
   std::shared_ptr<TimerFPS> _timerFPSReal;
   std::shared_ptr<TimerFPS> _timerFPSLimited;
+  std::shared_ptr<Benchmark> _benchmark = nullptr;
 
   std::map<AlphaType, std::vector<std::shared_ptr<Drawable>>> _drawables;
   std::map<int, std::vector<std::shared_ptr<Drawable>>> _unusedDrawable;
   std::map<int, std::vector<std::shared_ptr<Shadowable>>> _unusedShadowable;
   std::vector<std::shared_ptr<Shadowable>> _shadowables;
-  std::vector<std::shared_ptr<Animation>> _animations;
-  std::map<std::shared_ptr<Animation>, std::future<void>> _futureAnimationUpdate;
+  std::shared_ptr<AnimationSystem> _animationSystem;
+  // objects with known bounds are culled via BVH, others (f.e. terrain, sprites) are always drawn
+  std::map<AlphaType, std::shared_ptr<BVH>> _bvhDrawable;
+  std::shared_ptr<BVH> _bvhShadowable;
+  std::map<AlphaType, std::vector<std::shared_ptr<Drawable>>> _drawablesUnbounded;
+  std::vector<std::shared_ptr<Shadowable>> _shadowablesUnbounded;
+  CullingStatistic _cullingCamera;
+  std::vector<CullingStatistic> _cullingDirectional;
+  std::vector<std::array<CullingStatistic, 6>> _cullingPoint;
 
   std::vector<std::shared_ptr<ParticleSystem>> _particleSystem;
   std::shared_ptr<Postprocessing> _postprocessing;
   std::shared_ptr<Skybox> _skybox = nullptr;
   std::shared_ptr<BlurCompute> _blurCompute;
+  std::shared_ptr<CullingCompute> _cullingCompute;
+  std::shared_ptr<SkinningCompute> _skinningCompute;
   std::map<std::shared_ptr<DirectionalShadow>, std::shared_ptr<DirectionalShadowBlur>> _blurGraphicDirectional;
   std::map<std::shared_ptr<PointShadow>, std::shared_ptr<PointShadowBlur>> _blurGraphicPoint;
   std::shared_ptr<BS::thread_pool> _pool;
   std::function<void()> _callbackUpdate;
   std::function<void(int width, int height)> _callbackReset;
 
-  std::vector<std::vector<VkSubmitInfo>> _frameSubmitInfoPreCompute, _frameSubmitInfoPostCompute,
-      _frameSubmitInfoGraphic, _frameSubmitInfoDebug;
-  std::mutex _frameSubmitMutexGraphic;
+  // frame capture requested by saveFrame is applied to the next drawn frame
+  std::string _captureRequest;
+  std::vector<std::string> _capturePath;
+  std::vector<std::shared_ptr<Buffer>> _captureBuffer;
 
+  void _markBoundsChanged(Drawable* drawable);
+  void _unregisterTransformChange(std::shared_ptr<Drawable> drawable);
+  void _updateBVH();
+  std::vector<std::shared_ptr<Drawable>> _cullDrawables(AlphaType type,
+                                                        glm::mat4 viewProjection,
+                                                        CullingStatistic& culling);
+  std::vector<std::shared_ptr<Shadowable>> _cullShadowables(glm::mat4 viewProjection, CullingStatistic& culling);
+  void _drawDrawables(const std::vector<std::shared_ptr<Drawable>>& drawables,
+                      int begin,
+                      int end,
+                      std::shared_ptr<CommandBuffer> commandBuffer);
   void _drawShadowMapDirectional(int index);
   void _drawShadowMapPoint(int index, int face);
   void _computeParticles();
+  void _computeSkinning();
   void _drawShadowMapDirectionalBlur(std::shared_ptr<DirectionalShadow> directionalShadow);
   void _drawShadowMapPointBlur(std::shared_ptr<PointShadow> pointShadow, int face);
   void _computePostprocessing(int swapchainImageIndex);
   void _debugVisualizations(int swapchainImageIndex);
+  void _recordCapture(int swapchainImageIndex);
+  void _writeCapture(int swapchainImageIndex);
   void _initializeTextures();
   void _initializeFramebuffer();
   void _renderGraphic();
 
   VkResult _getImageIndex(uint32_t* imageIndex);
   void _displayFrame(uint32_t* imageIndex);
+  void _declareFrameGraph(int swapchainImageIndex);
   void _drawFrame(int imageIndex);
+  void _addMaterials(std::shared_ptr<ModelGLTF> model);
+  void _loadModelsGLTF();
+  // stage is passed to benchmark and CPU profiler capture if they are active
+  void _addCPU(const char* stage, std::chrono::high_resolution_clock::time_point start);
   void _clearUnusedData();
   void _reset();
 
@@ -106,7 +160,16 @@ class Core {
   void setNativeWindow(ANativeWindow* window);
 #endif
   void initialize();
+  // in headless mode renders exactly one frame per call
   void draw();
+  // save the next drawn frame to PNG file, blocks until the frame is rendered
+  void saveFrame(std::string path);
+  // wait until all submitted frames are finished, in headless mode draw doesn't do it
+  void waitIdle();
+  // CPU time of stages and GPU time of passes are collected to benchmark every frame, nullptr disables collection
+  void setBenchmark(std::shared_ptr<Benchmark> benchmark);
+  // draws warm up frames and then given number of frames with benchmark, results are saved to path (.json and .csv)
+  void runBenchmark(int frames, std::string path);
   void registerUpdate(std::function<void()> update);
   void registerReset(std::function<void(int width, int height)> reset);
 
@@ -124,18 +187,32 @@ class Core {
   std::shared_ptr<ImageCPU<uint8_t>> loadImageCPU(std::string path);
   std::shared_ptr<BufferImage> loadImageGPU(std::shared_ptr<ImageCPU<uint8_t>> imageCPU);
   std::shared_ptr<Texture> createTexture(std::string path, VkFormat format, int mipMapLevels);
+  // image is decoded by thread pool and uploaded by UploadManager, callback is called by main thread between frames
+  void createTextureAsync(std::string path,
+                          VkFormat format,
+                          int mipMapLevels,
+                          std::function<void(std::shared_ptr<Texture>)> callback);
   std::shared_ptr<Cubemap> createCubemap(std::vector<std::string> paths, VkFormat format, int mipMapLevels);
   std::shared_ptr<ModelGLTF> createModelGLTF(std::string path);
+  // CPU part is spread over thread pool, GPU resources are created by main thread at the frame boundary and future is
+  // resolved there, so main thread must not wait for it
+  std::future<std::shared_ptr<ModelGLTF>> createModelGLTFAsync(std::string path);
   std::shared_ptr<Animation> createAnimation(std::shared_ptr<ModelGLTF> modelGLTF);
   std::shared_ptr<Equirectangular> createEquirectangular(std::string path);
   std::shared_ptr<MaterialColor> createMaterialColor(MaterialTarget target);
   std::shared_ptr<MaterialPhong> createMaterialPhong(MaterialTarget target);
   std::shared_ptr<MaterialPBR> createMaterialPBR(MaterialTarget target);
   std::shared_ptr<Shape3D> createShape3D(ShapeType shapeType, VkCullModeFlagBits cullMode = VK_CULL_MODE_BACK_BIT);
+  // instance matrices are in shape's model space, all instances are drawn with one draw call
+  std::shared_ptr<Shape3D> createShape3DInstanced(ShapeType shapeType,
+                                                  std::vector<glm::mat4> instances,
+                                                  VkCullModeFlagBits cullMode = VK_CULL_MODE_BACK_BIT);
   std::shared_ptr<Shape3D> createCapsule(float height,
                                          float radius,
                                          VkCullModeFlagBits cullMode = VK_CULL_MODE_BACK_BIT);
   std::shared_ptr<Model3D> createModel3D(std::shared_ptr<ModelGLTF> modelGLTF);
+  std::shared_ptr<Model3D> createModel3DInstanced(std::shared_ptr<ModelGLTF> modelGLTF,
+                                                  std::vector<glm::mat4> instances);
   std::shared_ptr<Sprite> createSprite();
   std::shared_ptr<TerrainGPU> createTerrainInterpolation(std::shared_ptr<ImageCPU<uint8_t>> heightmap);
   std::shared_ptr<TerrainGPU> createTerrainComposition(std::shared_ptr<ImageCPU<uint8_t>> heightmap);
@@ -155,6 +232,7 @@ class Core {
 
   std::shared_ptr<CommandBuffer> getCommandBufferApplication();
   std::shared_ptr<ResourceManager> getResourceManager();
+  std::shared_ptr<UploadManager> getUploadManager();
   const std::vector<std::shared_ptr<Drawable>>& getDrawables(AlphaType type);
   std::vector<std::shared_ptr<PointLight>> getPointLights();
   std::vector<std::shared_ptr<DirectionalLight>> getDirectionalLights();
@@ -168,4 +246,10 @@ class Core {
   std::shared_ptr<Camera> getCamera();
   std::shared_ptr<GUI> getGUI();
   std::tuple<int, int> getFPS();
+  // closest drawable with known bounds under cursor and hit position on its world space AABB
+  std::optional<std::tuple<std::shared_ptr<Drawable>, glm::vec3>> getHit(glm::vec2 cursorPosition);
+  // visible/culled objects during the latest frame for camera, every directional light and every point light face
+  CullingStatistic getCullingCamera();
+  const std::vector<CullingStatistic>& getCullingDirectional();
+  const std::vector<std::array<CullingStatistic, 6>>& getCullingPoint();
 };
\ No newline at end of file
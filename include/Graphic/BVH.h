@@ -0,0 +1,59 @@
+#pragma once
+#include "Primitive/Drawable.h"
+#include "Graphic/Frustum.h"
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+
+// Dynamic AABB tree over world space bounds of drawables.
+// Leaves store bounds enlarged by margin, so small movements don't require tree modification.
+class BVH {
+ private:
+  struct Node {
+    // enlarged bounds for leaves, union of children for internal nodes
+    glm::vec3 min;
+    glm::vec3 max;
+    // exact bounds, used only in leaves
+    glm::vec3 minLeaf;
+    glm::vec3 maxLeaf;
+    int parent = -1;
+    int left = -1;
+    int right = -1;
+    std::shared_ptr<Drawable> drawable = nullptr;
+  };
+
+  float _margin;
+  int _root = -1;
+  std::vector<Node> _nodes;
+  std::vector<int> _freeNodes;
+  std::unordered_map<Drawable*, int> _leaves;
+  std::unordered_set<Drawable*> _changed;
+  std::mutex _changedMutex;
+
+  float _getSurfaceArea(glm::vec3 min, glm::vec3 max);
+  // slab test, returns distance to the closest point of box along the ray
+  std::optional<float> _intersectRay(glm::vec3 origin, glm::vec3 directionInverse, glm::vec3 min, glm::vec3 max);
+  int _allocateNode();
+  void _freeNode(int index);
+  void _insertLeaf(int leaf);
+  void _removeLeaf(int leaf);
+  void _refit(int index);
+  bool _setLeafBounds(int leaf);
+
+ public:
+  BVH(float margin = 0.1f);
+  // drawables without bounds (getAABB returns nullptr) can't be added, false is returned
+  bool add(std::shared_ptr<Drawable> drawable);
+  void remove(std::shared_ptr<Drawable> drawable);
+  bool contains(std::shared_ptr<Drawable> drawable);
+  int getSize();
+  // can be called from any thread, bounds are recalculated during next update
+  void markChanged(Drawable* drawable);
+  // refit leaves marked as changed, if new bounds don't fit to enlarged ones leaf is reinserted
+  void update();
+  // read only, can be called from multiple threads at once if there is no update in parallel
+  void query(Frustum& frustum, std::vector<std::shared_ptr<Drawable>>& result);
+  // closest drawable which bounds are hit by ray and distance along direction to the hit
+  std::optional<std::tuple<std::shared_ptr<Drawable>, float>> intersect(glm::vec3 origin, glm::vec3 direction);
+};
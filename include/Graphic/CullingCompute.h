@@ -0,0 +1,72 @@
+#pragma once
+#include "Utility/EngineState.h"
+#include "Vulkan/Buffer.h"
+#include "Vulkan/Command.h"
+#include "Vulkan/Descriptor.h"
+#include "Vulkan/Pipeline.h"
+#include "Graphic/Frustum.h"
+#include <set>
+
+class CullingCompute;
+
+// Such objects are culled per instance on GPU, visible instances are drawn with indirect draw commands
+// generated by compute shader.
+class Cullable {
+ public:
+  // bounds of one instance in model space
+  virtual std::shared_ptr<AABB> getInstanceAABB() = 0;
+  // world matrix of every instance
+  virtual std::vector<glm::mat4> getInstanceMatrices() = 0;
+  // index ranges of all draws, instance count is filled by culling
+  virtual std::vector<VkDrawIndexedIndirectCommand> getDrawCommands() = 0;
+  virtual void setCulling(std::shared_ptr<CullingCompute> culling) = 0;
+};
+
+// Scene-wide storage of instances of all cullable objects with their bounds. Compute shader culls every instance
+// against camera frustum, compacts matrices of visible ones and writes instance count to draw commands.
+class CullingCompute {
+ private:
+  // ranges of object in buffers of frame in flight
+  struct Slot {
+    int object;
+    int firstCommand;
+    int commandCount;
+    int firstInstance;
+    int instanceCount;
+  };
+  std::shared_ptr<EngineState> _engineState;
+  std::vector<std::shared_ptr<Cullable>> _objects;
+  // buffers are rebuilt for all objects if objects are added or removed
+  std::vector<bool> _changed;
+  // changed objects are rewritten in place if number of their draws and instances is the same
+  std::vector<std::set<Cullable*>> _changedObjects;
+  // draw commands with zero instance count, they are uploaded every frame to reset counters
+  std::vector<std::vector<VkDrawIndexedIndirectCommand>> _commands;
+  std::vector<std::map<Cullable*, Slot>> _slots;
+  std::vector<int> _instanceCount;
+  std::vector<std::shared_ptr<Buffer>> _objectBuffer, _instanceBuffer, _commandBuffer, _visibleBuffer;
+  std::shared_ptr<DescriptorSetLayout> _descriptorSetLayoutCompute, _descriptorSetLayoutVisible;
+  std::shared_ptr<DescriptorSet> _descriptorSetCompute, _descriptorSetVisible;
+  std::shared_ptr<PipelineCompute> _pipeline;
+
+  std::mutex _mutex;
+
+  void _update(int currentFrame);
+  // returns false if object doesn't fit its slot anymore, so all buffers have to be rebuilt
+  bool _updateObject(Cullable* object, int currentFrame);
+
+ public:
+  CullingCompute(std::shared_ptr<EngineState> engineState);
+  void add(std::shared_ptr<Cullable> object);
+  void remove(std::shared_ptr<Cullable> object);
+  // instances or transformation of object have been changed
+  void markChanged(Cullable* object);
+  // has to be recorded outside of render pass before any indirect draw
+  void draw(glm::mat4 viewProjection, std::shared_ptr<CommandBuffer> commandBuffer);
+  // visible instance matrices, compatible with InstanceBuffer descriptor set layout
+  std::shared_ptr<DescriptorSet> getDescriptorSetInstances();
+  // object has been processed by culling in current frame, so it can be drawn indirectly
+  bool contains(Cullable* object);
+  // draws count consecutive commands of object with one multi draw indirect
+  void drawIndirect(Cullable* object, int command, int count, std::shared_ptr<CommandBuffer> commandBuffer);
+};
@@ -0,0 +1,26 @@
+#pragma once
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+#include <array>
+#include <memory>
+#include "Primitive/Mesh.h"
+
+// Six planes extracted from view * projection matrix, normals point inside the frustum.
+// Plane is stored as (normal, distance), so point p is inside if dot(normal, p) + distance >= 0.
+class Frustum {
+ private:
+  std::array<glm::vec4, 6> _planes;
+
+ public:
+  Frustum(glm::mat4 viewProjection);
+  // aabb is expected in world space
+  bool intersect(std::shared_ptr<AABB> aabb);
+  bool intersect(glm::vec3 min, glm::vec3 max);
+  const std::array<glm::vec4, 6>& getPlanes();
+};
+
+struct CullingStatistic {
+  int visible = 0;
+  int culled = 0;
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include "Utility/EngineState.h"
+#include "Vulkan/Buffer.h"
+#include "Vulkan/Command.h"
+#include "Vulkan/Descriptor.h"
+#include "Vulkan/Pipeline.h"
+
+class SkinningCompute;
+
+// Such objects are skinned once per frame by compute shader to own vertex buffers, all passes draw them as static
+// geometry.
+class Skinnable {
+ public:
+  virtual void setSkinning(std::shared_ptr<SkinningCompute> skinning) = 0;
+  // records dispatch for every skinned mesh, vertex buffers of current frame are written
+  virtual void skin(std::shared_ptr<CommandBuffer> commandBuffer) = 0;
+  // vertex buffers written by skin in current frame
+  virtual std::vector<std::shared_ptr<Buffer>> getSkinnedBuffers() = 0;
+};
+
+// Scene-wide skinning of animated models, so skinned model isn't skinned again by vertex shaders of main pass and of
+// every shadow pass. Is recorded to graphic queue before shadow passes and ends with barrier to vertex input, so passes
+// recorded in parallel don't need own barriers.
+class SkinningCompute {
+ private:
+  std::shared_ptr<EngineState> _engineState;
+  std::vector<std::shared_ptr<Skinnable>> _objects;
+  std::shared_ptr<DescriptorSetLayout> _descriptorSetLayout;
+  std::shared_ptr<PipelineCompute> _pipeline;
+
+ public:
+  SkinningCompute(std::shared_ptr<EngineState> engineState);
+  void add(std::shared_ptr<Skinnable> object);
+  void remove(std::shared_ptr<Skinnable> object);
+  // source vertices, joint matrices and skinned vertices, descriptor sets are created by skinnable objects
+  std::shared_ptr<DescriptorSetLayout> getDescriptorSetLayout();
+  // vertexOffset is offset of mesh in source buffer, skinned buffer contains only vertices of the mesh
+  void dispatch(std::shared_ptr<DescriptorSet> descriptorSet,
+                int vertexOffset,
+                int vertexCount,
+                std::shared_ptr<CommandBuffer> commandBuffer);
+  // vertex buffers written in current frame
+  std::vector<std::shared_ptr<Buffer>> getBuffers();
+  // has to be recorded before any pass draws skinned objects
+  void draw(std::shared_ptr<CommandBuffer> commandBuffer);
+};
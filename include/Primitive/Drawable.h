@@ -2,6 +2,7 @@
 #include "Utility/Settings.h"
 #include "Vulkan/Command.h"
 #include "Graphic/LightManager.h"
+#include "Primitive/Mesh.h"
 #undef OPAQUE
 #undef TRANSPARENT
 
@@ -10,10 +11,13 @@ enum class AlphaType { TRANSPARENT, OPAQUE };
 class Named {
  private:
   std::string _name;
+  const char* _marker = "";
 
  public:
   void setName(std::string name);
   std::string getName();
+  // interned name for profiling markers
+  const char* getMarker();
 };
 
 struct BufferMVP {
@@ -28,6 +32,7 @@ class Drawable : virtual public Named {
   glm::vec3 _translate = glm::vec3{0.f, 0.f, 0.f};
   glm::quat _rotate = glm::identity<glm::quat>();
   glm::vec3 _scale = glm::vec3{1.f, 1.f, 1.f};
+  std::function<void()> _callbackTransformChange;
 
  public:
   virtual void draw(std::shared_ptr<CommandBuffer> commandBuffer) = 0;
@@ -40,6 +45,10 @@ class Drawable : virtual public Named {
   glm::quat getRotate();
   glm::vec3 getScale();
   glm::mat4 getModel();
+  // called every time when model matrix is changed
+  void registerTransformChange(std::function<void()> callback);
+  // bounds in model space, nullptr means bounds are unknown and object is never culled
+  virtual std::shared_ptr<AABB> getAABB();
 };
 
 // Such objects are being rendered on the shadow map, it doesn't mean that such objects will be shadowed.
@@ -12,7 +12,6 @@ class Equirectangular {
   std::shared_ptr<ImageView> _imageView;
   std::shared_ptr<Texture> _texture;
   std::shared_ptr<Cubemap> _cubemap;
-  std::shared_ptr<Buffer> _stagingBuffer;
   std::shared_ptr<CommandBuffer> _commandBufferTransfer;
   std::shared_ptr<DescriptorSetLayout> _descriptorSetLayout;
   std::vector<std::vector<std::shared_ptr<Buffer>>> _bufferCubemap;
@@ -0,0 +1,38 @@
+#pragma once
+#include "Utility/EngineState.h"
+#include "Vulkan/Buffer.h"
+#include "Vulkan/Descriptor.h"
+#include "Primitive/Mesh.h"
+#include <mutex>
+
+// Model matrices of all instances of drawable, stored in storage buffer and indexed by gl_InstanceIndex in shaders.
+// Not instanced drawable has exactly one identity instance.
+class InstanceBuffer {
+ private:
+  std::shared_ptr<EngineState> _engineState;
+  std::vector<glm::mat4> _instances = {glm::mat4(1.f)};
+  std::vector<std::shared_ptr<Buffer>> _buffer;
+  // model matrix of drawable that was used during the latest upload to frame's buffer
+  std::vector<glm::mat4> _model;
+  std::vector<bool> _changed;
+  std::shared_ptr<DescriptorSetLayout> _descriptorSetLayout;
+  std::shared_ptr<DescriptorSet> _descriptorSet;
+  std::mutex _mutex;
+
+  void _allocateBuffer(int frame);
+
+ public:
+  InstanceBuffer(std::shared_ptr<EngineState> engineState);
+  // instance matrices are in drawable's model space, so drawable transformation is applied on top of them
+  void setInstances(std::vector<glm::mat4> instances);
+  const std::vector<glm::mat4>& getInstances();
+  int getInstanceCount();
+  // bounds of all instances in drawable's model space
+  std::shared_ptr<AABB> getAABB(std::shared_ptr<AABB> aabb);
+  // model * instance for every instance
+  std::vector<glm::mat4> getMatrices(glm::mat4 model);
+  // upload model * instance for current frame if something has changed, is called from draw and drawShadow threads
+  void update(glm::mat4 model);
+  std::shared_ptr<DescriptorSetLayout> getDescriptorSetLayout();
+  std::shared_ptr<DescriptorSet> getDescriptorSet();
+};
@@ -11,7 +11,6 @@ class Line : public Drawable {
  private:
   std::shared_ptr<EngineState> _engineState;
   std::shared_ptr<GameState> _gameState;
-  std::shared_ptr<Buffer> _stagingBuffer;
   std::shared_ptr<MeshDynamic3D> _mesh;
   std::vector<std::shared_ptr<Buffer>> _cameraBuffer;
   std::shared_ptr<DescriptorSet> _descriptorSetCamera;
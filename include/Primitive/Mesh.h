@@ -1,5 +1,6 @@
 #pragma once
 #include "Vulkan/Buffer.h"
+#include "Vulkan/Arena.h"
 #include "Utility/EngineState.h"
 
 struct MeshPrimitive {
@@ -35,6 +36,8 @@ class AABB {
   AABB();
   void extend(glm::vec3 point);
   void extend(std::shared_ptr<AABB> aabb);
+  // AABB that encloses this AABB after transformation (f.e. local -> world space)
+  std::shared_ptr<AABB> transform(glm::mat4 matrix);
   glm::vec3 getMin();
   glm::vec3 getMax();
 };
@@ -82,16 +85,23 @@ class MeshDynamic3D : public Mesh {
   std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions();
 };
 
+// Vertices and indices are suballocated from geometry arena shared by all static meshes, so draws have to use
+// getVertexOffset/getIndexOffset as vertexOffset/firstIndex.
 class MeshStatic3D : public Mesh {
  private:
   std::mutex _accessVertexMutex, _accessIndexMutex;
   std::vector<uint32_t> _indexData;
   std::vector<Vertex3D> _vertexData;
-  std::shared_ptr<VertexBufferStatic<Vertex3D>> _vertexBuffer;
-  std::shared_ptr<VertexBufferStatic<uint32_t>> _indexBuffer;
+  std::optional<ArenaRange> _vertexRange, _indexRange;
   std::vector<MeshPrimitive> _primitives;
   std::shared_ptr<AABB> _aabb;
 
+  void _upload(std::shared_ptr<BufferArena> arena,
+               std::optional<ArenaRange>& range,
+               void* data,
+               VkDeviceSize size,
+               std::shared_ptr<CommandBuffer> commandBufferTransfer);
+
  public:
   MeshStatic3D(std::shared_ptr<EngineState> engineState);
 
@@ -107,10 +117,14 @@ class MeshStatic3D : public Mesh {
   const std::vector<Vertex3D>& getVertexData();
   const std::vector<MeshPrimitive>& getPrimitives();
   std::shared_ptr<AABB> getAABB();
-  std::shared_ptr<VertexBuffer<Vertex3D>> getVertexBuffer();
-  std::shared_ptr<VertexBuffer<uint32_t>> getIndexBuffer();
+  // arena blocks, can be shared with other meshes
+  std::shared_ptr<Buffer> getVertexBuffer();
+  std::shared_ptr<Buffer> getIndexBuffer();
+  int getVertexOffset();
+  int getIndexOffset();
   VkVertexInputBindingDescription getBindingDescription();
   std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions();
+  ~MeshStatic3D();
 };
 
 class MeshCube : public MeshStatic3D {
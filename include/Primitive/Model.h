@@ -13,7 +13,10 @@
 #include "Graphic/Camera.h"
 #include "Graphic/LightManager.h"
 #include "Graphic/Material.h"
+#include "Graphic/CullingCompute.h"
+#include "Graphic/SkinningCompute.h"
 #include "Primitive/Drawable.h"
+#include "Primitive/Instance.h"
 #include "Utility/PhysicsManager.h"
 #include <Jolt/Physics/Body/BodyCreationSettings.h>
 #include <Jolt/Physics/Character/Character.h>
@@ -55,15 +58,46 @@ class Model3DPhysics {
   ~Model3DPhysics();
 };
 
-class Model3D : public Drawable, public Shadowable {
+class Model3D : public Drawable, public Shadowable, public Cullable, public Skinnable {
  private:
   std::shared_ptr<EngineState> _engineState;
   std::shared_ptr<GameState> _gameState;
   std::vector<bool> _changedMaterial;
   std::vector<std::shared_ptr<NodeGLTF>> _nodes;
-  std::vector<std::vector<std::vector<std::shared_ptr<Buffer>>>> _cameraUBODepth;
-  std::vector<std::shared_ptr<Buffer>> _cameraUBOFull;
-  std::vector<std::vector<std::shared_ptr<DescriptorSet>>> _descriptorSetCameraDepth;
+  std::shared_ptr<InstanceBuffer> _instanceBuffer;
+  std::shared_ptr<CullingCompute> _culling;
+  std::shared_ptr<SkinningCompute> _skinning;
+  // pre-skinned vertices of nodes with skin for every frame in flight, buffers are kept if skinning is disabled,
+  // because they can be still used by frames in flight
+  std::map<int, std::vector<std::shared_ptr<Buffer>>> _skinnedBuffers;
+  // nodes whose skinned buffer of frame in flight doesn't have static attributes yet, they are copied from mesh
+  // right before the first dispatch
+  std::vector<std::set<int>> _skinnedUnfilled;
+  // only nodes in this map are skinned by compute shader and drawn as static geometry
+  std::map<int, std::shared_ptr<DescriptorSet>> _descriptorSetSkinning;
+  // joint matrices stub with zero joints, so pre-skinned vertices aren't skinned again by vertex shaders
+  std::shared_ptr<Buffer> _jointsStub;
+  std::shared_ptr<DescriptorSet> _descriptorSetJointsStatic;
+  // nodes in topological order (parent is always before its children) and index of parent (-1 for root)
+  std::vector<std::shared_ptr<NodeGLTF>> _nodesOrdered;
+  std::vector<int> _nodesParent;
+  // world matrices of nodes in the same order in rest pose, nodes driven by animation take them from its pose of frame
+  std::vector<glm::mat4> _nodesMatrix;
+  // bounds in mesh space of vertices influenced by every joint of skin, key is mesh of skinned node
+  std::map<int, std::vector<std::shared_ptr<AABB>>> _jointsAABB;
+  std::vector<std::shared_ptr<Buffer>> _nodesBuffer;
+  // primitive of node, draws are sorted by state, so consecutive draws with the same state are merged to one indirect
+  // draw, vertex shaders take node of draw from draw nodes buffer by pushed first draw + gl_DrawIDARB
+  struct Draw {
+    int node;
+    int primitive;
+    int material;
+  };
+  std::vector<Draw> _draws;
+  std::vector<std::shared_ptr<Buffer>> _drawsBuffer;
+  std::optional<uint64_t> _nodesFrame;
+  std::mutex _nodesMutex;
+  std::shared_ptr<DescriptorSet> _descriptorSetCameraDepth;
   std::vector<std::shared_ptr<DescriptorSet>> _descriptorSetColor, _descriptorSetPhong, _descriptorSetPBR,
       _descriptorSetJoints;
   std::shared_ptr<DescriptorSetLayout> _descriptorSetLayoutJoints;
@@ -90,18 +124,22 @@ class Model3D : public Drawable, public Shadowable {
   DrawType _drawType = DrawType::FILL;
 
   void _updateJointsDescriptor();
+  void _updateSkinning();
   void _updateColorDescriptor();
   void _updatePhongDescriptor();
   void _updatePBRDescriptor();
 
-  void _drawNode(std::shared_ptr<CommandBuffer> commandBuffer,
-                 std::shared_ptr<Pipeline> pipeline,
-                 std::shared_ptr<Pipeline> pipelineCullOff,
-                 std::shared_ptr<DescriptorSet> cameraDS,
-                 std::vector<std::shared_ptr<Buffer>> cameraUBO,
-                 glm::mat4 view,
-                 glm::mat4 projection,
-                 std::shared_ptr<NodeGLTF> node);
+  // has to be called if materials or skinning are changed
+  void _updateDraws();
+  void _flattenNode(std::shared_ptr<NodeGLTF> node, int parent);
+  // world matrices of nodes in pose of current frame
+  const std::vector<glm::mat4>& _getNodesMatrix();
+  void _updateNodes();
+  void _drawNodes(std::shared_ptr<CommandBuffer> commandBuffer,
+                  std::shared_ptr<Pipeline> pipeline,
+                  std::shared_ptr<Pipeline> pipelineCullOff,
+                  uint32_t cameraOffset,
+                  std::shared_ptr<CullingCompute> culling);
 
  public:
   Model3D(const std::vector<std::shared_ptr<NodeGLTF>>& nodes,
@@ -109,6 +147,7 @@ class Model3D : public Drawable, public Shadowable {
           std::shared_ptr<CommandBuffer> commandBufferTransfer,
           std::shared_ptr<GameState> gameState,
           std::shared_ptr<EngineState> engineState);
+  ~Model3D();
   void enableShadow(bool enable);
   void enableLighting(bool enable);
 
@@ -117,13 +156,24 @@ class Model3D : public Drawable, public Shadowable {
   void setMaterial(std::vector<std::shared_ptr<MaterialColor>> materials);
   void setAnimation(std::shared_ptr<Animation> animation);
   void setDrawType(DrawType drawType);
+  // all instances share meshes, materials and animation and are drawn with one draw call per primitive
+  void setInstances(std::vector<glm::mat4> instances);
+  const std::vector<glm::mat4>& getInstances();
 
   void enableDepth(bool enable);
   bool isDepthEnabled();
 
   MaterialType getMaterialType();
   DrawType getDrawType();
-  std::shared_ptr<AABB> getAABB();
+  std::shared_ptr<AABB> getAABB() override;
+  std::shared_ptr<AABB> getInstanceAABB() override;
+  std::vector<glm::mat4> getInstanceMatrices() override;
+  // one command per primitive in the same order as primitives are drawn
+  std::vector<VkDrawIndexedIndirectCommand> getDrawCommands() override;
+  void setCulling(std::shared_ptr<CullingCompute> culling) override;
+  void setSkinning(std::shared_ptr<SkinningCompute> skinning) override;
+  void skin(std::shared_ptr<CommandBuffer> commandBuffer) override;
+  std::vector<std::shared_ptr<Buffer>> getSkinnedBuffers() override;
 
   void draw(std::shared_ptr<CommandBuffer> commandBuffer) override;
   void drawShadow(LightType lightType, int lightIndex, int face, std::shared_ptr<CommandBuffer> commandBuffer) override;
@@ -6,8 +6,10 @@
 #include "Vulkan/Pipeline.h"
 #include "Primitive/Drawable.h"
 #include "Primitive/Mesh.h"
+#include "Primitive/Instance.h"
 #include "Graphic/Camera.h"
 #include "Graphic/Material.h"
+#include "Graphic/CullingCompute.h"
 #include "Utility/PhysicsManager.h"
 #include <Jolt/Physics/Body/BodyCreationSettings.h>
 
@@ -28,7 +30,7 @@ class Shape3DPhysics {
   ~Shape3DPhysics();
 };
 
-class Shape3D : public Drawable, public Shadowable {
+class Shape3D : public Drawable, public Shadowable, public Cullable {
  private:
   std::shared_ptr<EngineState> _engineState;
   std::shared_ptr<GameState> _gameState;
@@ -42,10 +44,10 @@ class Shape3D : public Drawable, public Shadowable {
       _descriptorSetLayout;
   std::shared_ptr<DescriptorSetLayout> _descriptorSetLayoutNormalsMesh;
   std::shared_ptr<DescriptorSet> _descriptorSetNormalsMesh, _descriptorSetColor, _descriptorSetPhong, _descriptorSetPBR;
-  std::vector<std::shared_ptr<Buffer>> _uniformBufferCamera;
+  std::shared_ptr<InstanceBuffer> _instanceBuffer;
+  std::shared_ptr<CullingCompute> _culling;
 
-  std::vector<std::vector<std::vector<std::shared_ptr<Buffer>>>> _cameraUBODepth;
-  std::vector<std::vector<std::shared_ptr<DescriptorSet>>> _descriptorSetCameraDepth;
+  std::shared_ptr<DescriptorSet> _descriptorSetCameraDepth;
   std::map<ShapeType, std::map<MaterialType, std::shared_ptr<PipelineGraphic>>> _pipeline, _pipelineWireframe;
   std::shared_ptr<RenderPass> _renderPass, _renderPassDepth;
   std::shared_ptr<PipelineGraphic> _pipelineDirectional, _pipelinePoint, _pipelineNormalMesh, _pipelineTangentMesh;
@@ -77,8 +79,16 @@ class Shape3D : public Drawable, public Shadowable {
   void setMaterial(std::shared_ptr<MaterialPhong> material);
   void setMaterial(std::shared_ptr<MaterialPBR> material);
   void setDrawType(DrawType drawType);
+  // all instances share mesh and material and are drawn with one draw call
+  void setInstances(std::vector<glm::mat4> instances);
+  const std::vector<glm::mat4>& getInstances();
 
   std::shared_ptr<MeshStatic3D> getMesh();
+  std::shared_ptr<AABB> getAABB() override;
+  std::shared_ptr<AABB> getInstanceAABB() override;
+  std::vector<glm::mat4> getInstanceMatrices() override;
+  std::vector<VkDrawIndexedIndirectCommand> getDrawCommands() override;
+  void setCulling(std::shared_ptr<CullingCompute> culling) override;
 
   void draw(std::shared_ptr<CommandBuffer> commandBuffer) override;
   void drawShadow(LightType lightType, int lightIndex, int face, std::shared_ptr<CommandBuffer> commandBuffer) override;
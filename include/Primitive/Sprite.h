@@ -20,7 +20,7 @@ class Sprite : public Drawable, public Shadowable {
   std::shared_ptr<DescriptorSet> _descriptorSetCameraFull;
   std::shared_ptr<DescriptorSetLayout> _descriptorSetLayoutNormalsMesh, _descriptorSetLayoutDepth;
   std::shared_ptr<DescriptorSet> _descriptorSetNormalsMesh;
-  std::vector<std::vector<std::shared_ptr<DescriptorSet>>> _descriptorSetCameraDepth;
+  std::shared_ptr<DescriptorSet> _descriptorSetCameraDepth;
   std::map<MaterialType, std::vector<std::pair<std::string, std::shared_ptr<DescriptorSetLayout>>>>
       _descriptorSetLayout;
   std::vector<std::pair<std::string, std::shared_ptr<DescriptorSetLayout>>> _descriptorSetLayoutNormal;
@@ -35,8 +35,6 @@ class Sprite : public Drawable, public Shadowable {
   bool _enableLighting = true;
   bool _enableDepth = true;
   bool _enableHUD = false;
-  std::vector<std::vector<std::vector<std::shared_ptr<Buffer>>>> _cameraUBODepth;
-  std::vector<std::shared_ptr<Buffer>> _cameraUBOFull;
   std::shared_ptr<Material> _material;
   std::shared_ptr<MaterialPhong> _defaultMaterialPhong;
   std::shared_ptr<MaterialPBR> _defaultMaterialPBR;
@@ -53,38 +51,17 @@ class Sprite : public Drawable, public Shadowable {
   template <class T>
   void _updateShadowDescriptor(std::shared_ptr<T> material) {
     int currentFrame = _engineState->getFrameInFlight();
-    for (int d = 0; d < _engineState->getSettings()->getMaxDirectionalLights(); d++) {
-      std::map<int, std::vector<VkDescriptorBufferInfo>> bufferInfoColor = {
-          {0,
-           {{.buffer = _cameraUBODepth[d][0][currentFrame]->getData(),
-             .offset = 0,
-             .range = _cameraUBODepth[d][0][currentFrame]->getSize()}}}};
-      std::map<int, std::vector<VkDescriptorImageInfo>> textureInfoColor = {
-          {1,
-           {{.sampler = material->getBaseColor()[0]->getSampler()->getSampler(),
-             .imageView = material->getBaseColor()[0]->getImageView()->getImageView(),
-             .imageLayout = material->getBaseColor()[0]->getImageView()->getImage()->getImageLayout()}}}};
-      _descriptorSetCameraDepth[d][0]->createCustom(currentFrame, bufferInfoColor, textureInfoColor);
-    }
-
-    for (int p = 0; p < _engineState->getSettings()->getMaxPointLights(); p++) {
-      for (int f = 0; f < 6; f++) {
-        std::map<int, std::vector<VkDescriptorBufferInfo>> bufferInfoColor = {
-            {0,
-             {{.buffer = _cameraUBODepth[_engineState->getSettings()->getMaxDirectionalLights() + p][f][currentFrame]
-                             ->getData(),
-               .offset = 0,
-               .range = _cameraUBODepth[_engineState->getSettings()->getMaxDirectionalLights() + p][f][currentFrame]
-                            ->getSize()}}}};
-        std::map<int, std::vector<VkDescriptorImageInfo>> textureInfoColor = {
-            {1,
-             {{.sampler = material->getBaseColor()[0]->getSampler()->getSampler(),
-               .imageView = material->getBaseColor()[0]->getImageView()->getImageView(),
-               .imageLayout = material->getBaseColor()[0]->getImageView()->getImage()->getImageLayout()}}}};
-        _descriptorSetCameraDepth[_engineState->getSettings()->getMaxDirectionalLights() + p][f]->createCustom(
-            currentFrame, bufferInfoColor, textureInfoColor);
-      }
-    }
+    std::map<int, std::vector<VkDescriptorBufferInfo>> bufferInfoColor = {
+        {0,
+         {{.buffer = _engineState->getUniformRing()->getBuffer(currentFrame)->getData(),
+           .offset = 0,
+           .range = sizeof(BufferMVP)}}}};
+    std::map<int, std::vector<VkDescriptorImageInfo>> textureInfoColor = {
+        {1,
+         {{.sampler = material->getBaseColor()[0]->getSampler()->getSampler(),
+           .imageView = material->getBaseColor()[0]->getImageView()->getImageView(),
+           .imageLayout = material->getBaseColor()[0]->getImageView()->getImage()->getImageLayout()}}}};
+    _descriptorSetCameraDepth->createCustom(currentFrame, bufferInfoColor, textureInfoColor);
   }
 
  public:
@@ -2,6 +2,7 @@
 #include "Utility/Loader.h"
 #include "Utility/Logger.h"
 #include "Utility/EngineState.h"
+#include "Utility/PoseKernel.h"
 
 class Animation {
  private:
@@ -13,12 +14,50 @@ class Animation {
   // separate descriptor for each skin
   std::vector<std::vector<std::shared_ptr<Buffer>>> _ssboJoints;
   int _animationIndex = 0;
-  std::map<int, glm::mat4> _matricesJoint;
+  // current time of every animation, glTF animations are shared between instances of the same model
+  std::vector<float> _times;
+  // skeleton compiled at creation: nodes in topological order (parent is always before child) with local transforms
+  // stored per component, so local -> world is a single linear pass without allocations
+  std::vector<int> _parents;
+  std::vector<glm::vec3> _translations, _scales;
+  std::vector<glm::quat> _rotations;
+  std::vector<glm::mat4> _matrices, _world;
+  // ordered indexes of nodes with matrix, it's identity for the rest of nodes
+  std::vector<int> _matrixNodes;
+  // ordered index of node animated by every channel of every animation, -1 if node isn't found
+  std::vector<std::vector<int>> _targets;
+  // ordered indexes of joints of every skin
+  std::vector<std::vector<int>> _joints;
+  // ordered index and skin of nodes with skin, one node per skin, so joint ranges can be evaluated in parallel
+  std::vector<std::tuple<int, int>> _skinned;
+  // index of the first joint of every entry of _skinned in flat joint range of calculatePalettes
+  std::vector<int> _skinnedOffsets;
+  int _jointNumber = 0;
+  // world matrices of nodes and joint matrices of every skin are evaluated to back buffers and published together,
+  // updateBuffers takes the latest published pose as pose of frame, so upload never waits for evaluation and node
+  // matrices read by recording threads are from the same pose as joint matrices
+  std::vector<std::vector<glm::mat4>> _palettes, _palettesPublished, _palettesFrame;
+  std::vector<glm::mat4> _worldPublished, _worldFrame;
+  bool _published = false;
+  std::mutex _mutexPalettes;
+  std::map<const void*, std::function<void()>> _callbacksPose;
+  // index of the first keyframe after current time for every channel of every animation, animations are shared
+  // between instances of the same model, so cursors are stored here
+  std::vector<std::vector<int>> _cursors;
+  // rotation channels of current frame, interpolated in one batch
+  std::vector<int> _slerpChannels;
+  std::vector<glm::quat> _slerpFrom, _slerpTo, _slerpResult;
+  std::vector<float> _slerpFactors;
   bool _play = true;
+  // PoseKernel SIMD path, GLM otherwise
+  bool _simd = true;
   std::mutex _mutex;
 
-  void _updateJoints(int currentImage, std::shared_ptr<NodeGLTF> node);
-  void _fillMatricesJoint(std::shared_ptr<NodeGLTF> node, glm::mat4 matrixParent);
+  void _flattenNode(std::shared_ptr<NodeGLTF> node, int parent, std::map<uint32_t, int>& ordered);
+  // world matrices from current local transforms
+  void _calculateWorld();
+  // cursor is checked first, time mostly moves forward by less than a keyframe, binary search otherwise
+  int _findKeyframe(const std::vector<float>& inputs, float time, int& cursor);
 
  public:
   Animation(const std::vector<std::shared_ptr<NodeGLTF>>& nodes,
@@ -28,14 +67,36 @@ class Animation {
   std::vector<std::string> getAnimations();
   void setAnimation(std::string name);
   void setPlay(bool play);
+  void setSIMD(bool simd);
   void setTime(float time);
   std::tuple<float, float> getTimeRange();
 
   std::tuple<float, float> getTimeline();
   float getCurrentTime();
 
+  // sample + calculatePalettes for all joints + publish
   void calculateJoints(float deltaTime);
+  // advances time and evaluates world matrices of nodes, returns false if there is nothing to update
+  bool sample(float deltaTime);
+  int getNodeNumber();
+  // number of joints of all skins, joint palettes are evaluated as one flat range
+  int getJointNumber();
+  // joints [begin, end) of sampled pose to back palettes, different ranges can be evaluated in parallel
+  void calculatePalettes(int begin, int end);
+  // back palettes become visible for updateBuffers
+  void publish();
+  // takes the latest published pose as pose of frame and copies its joint matrices to SSBO, doesn't wait for
+  // evaluation in progress, has to be called before recording of frame
   void updateBuffers(int currentImage);
+  // world matrices of nodes in pose of frame, nodes are in topological order (the same as Model3D flattens them)
+  const std::vector<glm::mat4>& getNodeMatrices();
+  // joint matrices of every skin in pose of frame
+  const std::vector<std::vector<glm::mat4>>& getPalettes();
+  // called by updateBuffers if pose of frame is changed, f.e. bounds of animated model have to be updated
+  void registerPoseChange(const void* owner, std::function<void()> callback);
+  void unregisterPoseChange(const void* owner);
 
+  // joint matrices buffer contains stub with identity matrix if there are no skins
+  int getSkinNumber();
   std::vector<std::vector<std::shared_ptr<Buffer>>> getJointMatricesBuffer();
 };
\ No newline at end of file
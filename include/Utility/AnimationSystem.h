@@ -0,0 +1,40 @@
+#pragma once
+#include "Utility/Animation.h"
+#include "BS_thread_pool.hpp"
+#include <atomic>
+#include <future>
+
+// Updates all animations of scene in parallel. Frame update is split to two stages: sampling of animations batched to
+// jobs by number of nodes and channels, and joint palettes split to jobs of the same number of joints regardless of
+// skeleton, so huge skeleton is spread across threads and small ones are packed together. Workers take the next job
+// from shared counter until jobs are over, so fast workers take over jobs of slow ones. Evaluation is asynchronous,
+// updateBuffers takes the latest finished pose as pose of frame and never waits for it, glTF nodes aren't changed, so
+// recording threads read only pose of frame.
+class AnimationSystem {
+ private:
+  std::shared_ptr<BS::thread_pool> _pool;
+  std::shared_ptr<EngineState> _engineState;
+  std::vector<std::shared_ptr<Animation>> _animations;
+  // approximate cost of one job, in joints for palettes and in nodes + channels for sampling
+  int _jobSize = 256;
+  std::future<void> _future;
+  std::mutex _mutex;
+
+  // runs jobs on calling thread and on up to threads - 1 workers of pool, returns when all jobs are finished
+  void _fanOut(int jobs, std::function<void(int)> job);
+  void _update(std::vector<std::shared_ptr<Animation>> animations, float deltaTime);
+
+ public:
+  AnimationSystem(std::shared_ptr<BS::thread_pool> pool, std::shared_ptr<EngineState> engineState);
+  void add(std::shared_ptr<Animation> animation);
+  void remove(std::shared_ptr<Animation> animation);
+  void setJobSize(int jobSize);
+  // starts evaluation of the next pose, waits only if evaluation of the previous one isn't finished yet
+  void update(float deltaTime);
+  // the latest evaluated pose of every animation becomes pose of frame and is uploaded to SSBO of frame in flight, has
+  // to be called before any pass of frame is recorded
+  void updateBuffers(int currentFrame);
+  // blocks until evaluation in progress is finished
+  void wait();
+  ~AnimationSystem();
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include "Utility/Settings.h"
+#include <array>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// command line of benchmarked sample: --benchmark <frames> <path without extension>
+struct BenchmarkArguments {
+  // 0 if sample isn't benchmarked
+  int frames = 0;
+  std::string path;
+};
+
+// Per frame CPU time of Core stages and GPU time of passes, saved as p50/p95/p99 to JSON and CSV.
+// Stage or pass recorded several times per frame (f.e. shadow map per light) is summed.
+class Benchmark {
+ private:
+  std::map<std::string, float> _frameCPU, _frameGPU;
+  std::map<std::string, std::vector<float>> _samplesCPU, _samplesGPU;
+  int _frames = 0;
+  std::mutex _mutex;
+
+  float _percentile(std::vector<float> samples, float percentile);
+  std::map<std::string, std::array<float, 4>> _statistic(std::map<std::string, std::vector<float>>& samples);
+
+ public:
+  static BenchmarkArguments parseArguments(int argc, char* argv[]);
+  // benchmark is rendered headlessly with fixed timestep, so every frame has the same amount of work
+  static void configure(std::shared_ptr<Settings> settings);
+
+  void addCPU(std::string stage, std::chrono::high_resolution_clock::time_point start);
+  // GPU time is reported by profiler maxFramesInFlight frames later
+  void addGPU(std::string pass, float milliseconds);
+  // move times accumulated during current frame to samples
+  void nextFrame();
+  int getFrames();
+  // {mean, p50, p95, p99} in milliseconds for every stage/pass
+  std::map<std::string, std::array<float, 4>> getCPU();
+  std::map<std::string, std::array<float, 4>> getGPU();
+  // path without extension, .json and .csv files are written
+  void save(std::string path);
+};
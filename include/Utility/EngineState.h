@@ -10,6 +10,11 @@
 #include "Utility/Settings.h"
 #include "Utility/Input.h"
 
+class BufferArena;
+class StagingRing;
+class UniformRing;
+class ProfilerGPU;
+
 class EngineState {
  private:
   std::shared_ptr<Settings> _settings;
@@ -22,7 +27,12 @@ class EngineState {
   std::shared_ptr<Filesystem> _filesystem;
   std::shared_ptr<MemoryAllocator> _memoryAllocator;
   std::shared_ptr<RenderPassManager> _renderPassManager;
+  std::shared_ptr<BufferArena> _vertexArena, _indexArena;
+  std::shared_ptr<StagingRing> _stagingRing;
+  std::shared_ptr<UniformRing> _uniformRing;
+  std::shared_ptr<ProfilerGPU> _profilerGPU;
   int _frameInFlight = 0;
+  uint64_t _frame = 0;
 #ifdef __ANDROID__
   AAssetManager* _assetManager;
   ANativeWindow* _nativeWindow;
@@ -45,6 +55,20 @@ class EngineState {
   std::shared_ptr<DescriptorPool> getDescriptorPool();
   std::shared_ptr<Filesystem> getFilesystem();
   std::shared_ptr<RenderPassManager> getRenderPassManager();
+  // arenas depend on EngineState, so they are created by Core right after initialize
+  void setGeometryArena(std::shared_ptr<BufferArena> vertexArena, std::shared_ptr<BufferArena> indexArena);
+  std::shared_ptr<BufferArena> getVertexArena();
+  std::shared_ptr<BufferArena> getIndexArena();
+  // all uploads go through it, is created by Core right after initialize
+  void setStagingRing(std::shared_ptr<StagingRing> stagingRing);
+  std::shared_ptr<StagingRing> getStagingRing();
+  void setUniformRing(std::shared_ptr<UniformRing> uniformRing);
+  std::shared_ptr<UniformRing> getUniformRing();
+  void setProfilerGPU(std::shared_ptr<ProfilerGPU> profilerGPU);
+  std::shared_ptr<ProfilerGPU> getProfilerGPU();
   void setFrameInFlight(int frameInFlight);
   int getFrameInFlight();
+  // global frame number, increases every frame
+  void setFrame(uint64_t frame);
+  uint64_t getFrame();
 };
\ No newline at end of file
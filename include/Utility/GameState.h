@@ -12,7 +12,9 @@ class GameState {
   std::shared_ptr<LightManager> _lightManager;
 
  public:
-  GameState(std::shared_ptr<CommandBuffer> commandBuffer, std::shared_ptr<EngineState> engineState);
+  GameState(std::shared_ptr<CommandBuffer> commandBuffer,
+            std::shared_ptr<BS::thread_pool> pool,
+            std::shared_ptr<EngineState> engineState);
   std::shared_ptr<ResourceManager> getResourceManager();
   std::shared_ptr<CameraManager> getCameraManager();
   std::shared_ptr<LightManager> getLightManager();
@@ -6,6 +6,7 @@
 #define TINYGLTF_ANDROID_LOAD_FROM_ASSETS
 #endif
 #include "tiny_gltf.h"
+#include "BS_thread_pool.hpp"
 #include <filesystem>
 
 template <class T>
@@ -27,21 +28,44 @@ class ImageCPU {
 
 class LoaderImage {
  private:
+  std::shared_ptr<BS::thread_pool> _pool;
   std::shared_ptr<EngineState> _engineState;
+  // decoded images by hash and size of encoded content, identical files are decoded once while image is alive
+  std::map<std::tuple<size_t, size_t>, std::weak_ptr<ImageCPU<uint8_t>>> _cacheUint8;
+  std::map<std::tuple<size_t, size_t>, std::weak_ptr<ImageCPU<float>>> _cacheFloat;
+  std::mutex _mutex;
+
+  std::tuple<size_t, size_t> _getKey(const uint8_t* content, size_t size);
+  template <class T>
+  std::map<std::tuple<size_t, size_t>, std::weak_ptr<ImageCPU<T>>>& _getCache();
+  template <class T>
+  std::shared_ptr<ImageCPU<T>> _decode(const uint8_t* content, size_t size, std::string name);
+  template <class T>
+  std::shared_ptr<ImageCPU<T>> _load(std::tuple<size_t, size_t> key,
+                                     const uint8_t* content,
+                                     size_t size,
+                                     std::string name);
+  // SIMD if target supports it, stb_image expands RGB to RGBA per channel
+  static void _expandRGBA(const uint8_t* rgb, uint8_t* rgba, size_t pixels);
 
  public:
-  LoaderImage(std::shared_ptr<EngineState> engineState);
+  LoaderImage(std::shared_ptr<BS::thread_pool> pool, std::shared_ptr<EngineState> engineState);
   template <class T>
   std::shared_ptr<ImageCPU<T>> loadCPU(std::string path);
+  // files are decoded in parallel by pool, so it must not be called from pool's tasks
+  template <class T>
+  std::vector<std::shared_ptr<ImageCPU<T>>> loadCPU(std::vector<std::string> paths);
+  // encoded image in memory, name is used in errors
+  template <class T>
+  std::shared_ptr<ImageCPU<T>> loadCPU(const uint8_t* content, size_t size, std::string name);
 
   // have to support vector of inputs for cubemap
   template <class T>
   std::shared_ptr<BufferImage> loadGPU(std::vector<std::shared_ptr<ImageCPU<T>>> imagesCPU) {
     auto [width, height] = imagesCPU[0]->getResolution();
     int channels = imagesCPU[0]->getChannels();
-    std::shared_ptr<BufferImage> bufferImage = std::make_shared<BufferImage>(
-        std::tuple{width, height}, channels, imagesCPU.size(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, _engineState);
+    std::shared_ptr<BufferImage> bufferImage = std::make_shared<BufferImage>(std::tuple{width, height}, channels,
+                                                                             imagesCPU.size());
     for (int i = 0; i < imagesCPU.size(); i++) {
       auto pixels = imagesCPU[i]->getData();
       VkDeviceSize imageSize = width * height * channels;
@@ -90,14 +114,19 @@ struct SkinGLTF {
   std::vector<std::shared_ptr<NodeGLTF>> joints;
 };
 
+// resolved from strings at load, so they aren't compared every frame
+enum class InterpolationGLTF { LINEAR, STEP, CUBICSPLINE };
+enum class AnimationPathGLTF { TRANSLATION, ROTATION, SCALE, WEIGHTS };
+
 struct AnimationSamplerGLTF {
-  std::string interpolation;
+  InterpolationGLTF interpolation;
+  // sorted keyframe times
   std::vector<float> inputs;
   std::vector<glm::vec4> outputsVec4;
 };
 
 struct AnimationChannelGLTF {
-  std::string path;
+  AnimationPathGLTF path;
   std::shared_ptr<NodeGLTF> node;
   uint32_t samplerIndex;
 };
@@ -108,7 +137,6 @@ struct AnimationGLTF {
   std::vector<AnimationChannelGLTF> channels;
   float start = std::numeric_limits<float>::max();
   float end = std::numeric_limits<float>::min();
-  float currentTime = 0.0f;
 };
 
 class ModelGLTF {
@@ -142,21 +170,56 @@ class ModelGLTF {
   const std::vector<std::shared_ptr<MeshStatic3D>>& getMeshes();
 };
 
+// vertices of glTF primitive, indexes are relative to its first vertex
+struct PrimitiveGLTF {
+  std::vector<uint32_t> indexes;
+  std::vector<Vertex3D> vertices;
+  int material = -1;
+};
+
+// vertices of all primitives of glTF mesh
+struct MeshDataGLTF {
+  std::vector<uint32_t> indexes;
+  std::vector<Vertex3D> vertices;
+  std::vector<MeshPrimitive> primitives;
+};
+
+// everything what can be loaded without GPU, is filled by LoaderGLTF::loadCPU from any thread
+struct SceneGLTF {
+  std::string path;
+  tinygltf::Model model;
+  std::vector<std::shared_ptr<MaterialGLTF>> materials;
+  std::vector<std::shared_ptr<NodeGLTF>> nodes;
+  std::vector<std::shared_ptr<SkinGLTF>> skins;
+  std::vector<std::shared_ptr<AnimationGLTF>> animations;
+  // decoded RGBA images, index is glTF image index
+  std::vector<std::shared_ptr<BufferImage>> images;
+  // index is glTF mesh index, primitives are merged to meshes when all of them are loaded
+  std::vector<std::vector<PrimitiveGLTF>> primitives;
+  std::vector<MeshDataGLTF> meshes;
+  // nullptr if mesh isn't referenced by any node
+  std::vector<std::shared_ptr<AABB>> aabbs;
+  // the first error of load tasks, is rethrown by LoaderGLTF::loadGPU
+  std::exception_ptr error;
+  std::mutex mutex;
+};
+
 class LoaderGLTF {
  private:
-  std::filesystem::path _path;
   std::shared_ptr<EngineState> _engineState;
   std::shared_ptr<LoaderImage> _loaderImage;
-  tinygltf::TinyGLTF _loader;
   std::map<std::string, std::shared_ptr<ModelGLTF>> _models;
 
+  void _parse(SceneGLTF& scene);
+  void _decodeImage(SceneGLTF& scene, int imageIndex);
+  void _mergePrimitives(SceneGLTF& scene);
   std::shared_ptr<Texture> _loadTexture(int imageIndex,
                                         VkFormat format,
-                                        const tinygltf::Model& modelInternal,
+                                        const std::vector<std::shared_ptr<BufferImage>>& images,
                                         std::vector<std::shared_ptr<Texture>>& textures,
                                         std::shared_ptr<CommandBuffer> commandBufferTransfer);
   void _loadMaterials(const tinygltf::Model& modelInternal,
-                      std::vector<std::shared_ptr<MaterialGLTF>>& materialGLTF,
+                      const std::vector<std::shared_ptr<BufferImage>>& images,
                       std::shared_ptr<ModelGLTF> modelExternal,
                       std::shared_ptr<CommandBuffer> commandBufferTransfer);
   void _loadAnimations(const tinygltf::Model& modelInternal,
@@ -173,10 +236,12 @@ class LoaderGLTF {
                  const tinygltf::Node& input,
                  std::shared_ptr<NodeGLTF> parent,
                  uint32_t nodeIndex,
-                 const std::vector<std::shared_ptr<MaterialGLTF>>& materials,
-                 const std::vector<std::shared_ptr<MeshStatic3D>>& meshes,
-                 std::vector<std::shared_ptr<NodeGLTF>>& nodes,
-                 std::shared_ptr<CommandBuffer> commandBufferTransfer);
+                 std::vector<std::shared_ptr<AABB>>& aabbs,
+                 std::vector<std::shared_ptr<NodeGLTF>>& nodes);
+  void _loadPrimitive(const tinygltf::Model& modelInternal,
+                      const tinygltf::Primitive& glTFPrimitive,
+                      const std::vector<std::shared_ptr<MaterialGLTF>>& materials,
+                      PrimitiveGLTF& primitive);
 
  public:
   LoaderGLTF(std::shared_ptr<LoaderImage> loaderImage, std::shared_ptr<EngineState> engineState);
@@ -184,4 +249,12 @@ class LoaderGLTF {
   void setAssetManager(AAssetManager* assetManager);
 #endif
   std::shared_ptr<ModelGLTF> load(std::string path, std::shared_ptr<CommandBuffer> commandBufferTransfer);
+  // parsing, decoding of every image and vertices with tangents of every primitive are spread over pool tasks,
+  // callback is called by the last finished task
+  void loadCPU(std::string path,
+               std::shared_ptr<BS::thread_pool> pool,
+               std::function<void(std::shared_ptr<SceneGLTF>)> callback);
+  // creates materials, textures and meshes, has to be called from thread which records commandBufferTransfer
+  std::shared_ptr<ModelGLTF> loadGPU(std::shared_ptr<SceneGLTF> scene,
+                                     std::shared_ptr<CommandBuffer> commandBufferTransfer);
 };
\ No newline at end of file
@@ -5,7 +5,7 @@
 
 class LoggerAndroid {
  public:
-  void begin(std::string name);
+  void begin(const char* name, int64_t payload);
   void end();
 };
 
@@ -32,16 +32,21 @@ class LoggerUtils {
     }
   }
 
-  void begin(std::string marker, std::shared_ptr<CommandBuffer> buffer, std::array<float, 4> color);
+  void begin(const char* marker, int64_t payload, std::shared_ptr<CommandBuffer> buffer, std::array<float, 4> color);
   void end(std::shared_ptr<CommandBuffer> buffer);
 };
 
 class LoggerNVTX {
  public:
-  void begin(std::string name);
+  void begin(const char* name, int64_t payload);
   void end();
 };
 
+// Markers don't allocate: name has to be a string literal or a name interned with Logger::intern, dynamic part
+// (f.e. frame number) is passed as payload. Debug utils, NVTX and ATrace markers are compiled out without
+// ENGINE_MARKERS and are skipped at runtime if there is no consumer: debug utils disabled, trace isn't captured on
+// Android. All scopes are recorded by CPU profiler during capture, scopes recorded to command buffer are also measured
+// by GPU profiler if it's enabled, profilers don't depend on ENGINE_MARKERS
 class Logger {
  private:
   std::shared_ptr<LoggerAndroid> _loggerAndroid;
@@ -51,8 +56,12 @@ class Logger {
 
  public:
   Logger(std::shared_ptr<EngineState> engineState = nullptr);
-  void begin(std::string marker,
+  // returned pointer is valid until application exit, the same pointer is returned for equal names
+  static const char* intern(const std::string& name);
+  // negative payload isn't shown
+  void begin(const char* marker,
              std::shared_ptr<CommandBuffer> buffer = nullptr,
+             int64_t payload = -1,
              std::array<float, 4> color = {0.0f, 0.0f, 0.0f, 0.0f});
   void end(std::shared_ptr<CommandBuffer> buffer = nullptr);
 };
\ No newline at end of file
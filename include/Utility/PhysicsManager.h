@@ -96,11 +96,21 @@ class ObjectVsBroadPhaseLayerFilterImpl : public JPH::ObjectVsBroadPhaseLayerFil
   }
 };
 
+// Jolt thread pool with jobs recorded by CPU profiler
+class JobSystemProfiled : public JPH::JobSystemThreadPool {
+ public:
+  using JPH::JobSystemThreadPool::JobSystemThreadPool;
+  JobHandle CreateJob(const char* inName,
+                      JPH::ColorArg inColor,
+                      const JobFunction& inJobFunction,
+                      JPH::uint32 inNumDependencies = 0) override;
+};
+
 class PhysicsManager {
  private:
   JPH::PhysicsSystem _physicsSystem;
   std::shared_ptr<JPH::TempAllocatorImpl> _tempAllocator;
-  std::shared_ptr<JPH::JobSystemThreadPool> _jobSystem;
+  std::shared_ptr<JobSystemProfiled> _jobSystem;
   const float _deltaTime = 1.0f / 60.0f;
   const int _collisionSteps = 1;
 
@@ -0,0 +1,39 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// Batch kernels of skeleton pose evaluation, process 4 joints (or matrix columns) per instruction.
+// SSE2 on x86 (FMA and 256-bit multiply if compiled with ENGINE_AVX2), NEON on ARM. GLM path is used if simd is
+// false or there is no supported instruction set, results of both paths match up to float rounding.
+class PoseKernel {
+ public:
+  // true if SIMD path is compiled in
+  static bool isSupported();
+  // result = translate * rotate * scale
+  static void composeTRS(const glm::vec3* translations,
+                         const glm::quat* rotations,
+                         const glm::vec3* scales,
+                         glm::mat4* result,
+                         int count,
+                         bool simd);
+  // result = a * b, result can be the same as a or b
+  static void multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& result, bool simd);
+  // result[i] = left * matrices[indexes[i]] * right[i], f.e. joint palette of skin
+  static void multiplyIndexed(const glm::mat4& left,
+                              const glm::mat4* matrices,
+                              const int* indexes,
+                              const glm::mat4* right,
+                              glm::mat4* result,
+                              int count,
+                              bool simd);
+  // normalized shortest path interpolation, SIMD path uses nlerp for close rotations and falls back to slerp for the
+  // rest, so error is negligible for keyframed animations
+  static void slerp(const glm::quat* from,
+                    const glm::quat* to,
+                    const float* factors,
+                    glm::quat* result,
+                    int count,
+                    bool simd);
+  // prints time of GLM and SIMD paths and max difference between them for count random joints
+  static void benchmark(int count, int iterations);
+};
@@ -0,0 +1,127 @@
+#pragma once
+#include "Utility/EngineState.h"
+#include "Utility/GUI.h"
+#include "Vulkan/Command.h"
+#include "Vulkan/Pool.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+struct ScopeGPU {
+  // string literal or interned name, see Logger
+  const char* name;
+  // nesting level inside command buffer
+  int depth;
+  float milliseconds;
+};
+
+struct StackGPU {
+  // frame stack belongs to, stack of previous frame is dropped
+  int64_t frame = -1;
+  // opened scopes, -1 if there is no free query
+  std::vector<int> scopes;
+};
+
+// GPU time of Logger scopes recorded to command buffers, measured with timestamp queries.
+// Every frame in flight has own query pool, results are read after frame's fence, so they are maxFramesInFlight frames
+// old. Queries are reset from CPU, so scopes can be recorded inside render passes and secondary command buffers.
+// Command buffer is recorded by one thread, so opened scopes are kept per thread and queries are reserved by atomic
+// counter, scopes recorded in parallel don't take any lock.
+class ProfilerGPU {
+ private:
+  std::shared_ptr<EngineState> _engineState;
+  // 2 timestamps per scope
+  int _scopesMax = 2048;
+  std::vector<std::shared_ptr<QueryPool>> _queryPool;
+  // name and depth of every scope started in frame, scope index * 2 is query index
+  std::vector<std::vector<std::tuple<const char*, int>>> _scopes;
+  // number of reserved scopes of every frame in flight, can be above _scopesMax
+  std::vector<std::atomic<int>> _scopesNext;
+  // opened scopes of every command buffer recorded by thread
+  static thread_local std::map<std::pair<ProfilerGPU*, VkCommandBuffer>, StackGPU> _stacks;
+  std::atomic<int64_t> _frame = 0;
+  std::vector<ScopeGPU> _results;
+  float _timestampPeriod;
+  bool _supported;
+  // enabling is applied at the next frame so begin/end pairs aren't split
+  std::atomic<bool> _enabled = false;
+  bool _enabledNext = false;
+  // only command buffers recorded between beginFrame and endFrame are submitted in the same frame
+  std::atomic<bool> _active = false;
+  bool _overlay = false;
+  std::mutex _mutex;
+
+  std::vector<int>& _getStack(VkCommandBuffer commandBuffer);
+
+ public:
+  ProfilerGPU(std::shared_ptr<EngineState> engineState);
+  bool isSupported();
+  void setEnabled(bool enabled);
+  bool isEnabled();
+  void setOverlay(bool overlay);
+  void begin(const char* name, std::shared_ptr<CommandBuffer> commandBuffer);
+  void end(std::shared_ptr<CommandBuffer> commandBuffer);
+  // is called by Core after fence of current frame in flight, resolves results of previous usage of its queries
+  void beginFrame();
+  void endFrame();
+  // scopes of the latest resolved frame in order of recording
+  std::vector<ScopeGPU> getResults();
+  void drawOverlay(std::shared_ptr<GUI> gui);
+};
+
+struct EventCPU {
+  // string literal or interned name, see Logger
+  const char* name;
+  int64_t payload;
+  std::chrono::high_resolution_clock::time_point timestamp;
+  // only for complete events
+  std::chrono::high_resolution_clock::duration duration;
+  // B - begin, E - end, X - complete, as in trace_event format
+  char phase;
+};
+
+struct ThreadCPU {
+  int id;
+  std::atomic<const char*> name = nullptr;
+  std::vector<EventCPU> events;
+  // events below size are fully written
+  std::atomic<int> size = 0;
+  // capture events belong to, -1 if thread hasn't recorded anything yet
+  std::atomic<int> generation = -1;
+};
+
+// CPU scopes of all threads (main, thread pool, physics jobs) recorded during N frames and saved to Chrome trace_event
+// JSON (chrome://tracing, ui.perfetto.dev). Every thread writes only to own buffer, so recording is lock-free, mutex is
+// taken once per thread to register the buffer. Scopes are ignored if there is no capture in progress.
+// Process wide, because threads of Jolt aren't owned by engine.
+class ProfilerCPU {
+ private:
+  // per thread, events above are dropped
+  static const int _eventsMax = 1 << 18;
+  static std::mutex _mutex;
+  static std::vector<std::shared_ptr<ThreadCPU>> _threads;
+  static thread_local std::shared_ptr<ThreadCPU> _thread;
+  static std::atomic<bool> _recording;
+  static std::atomic<int> _generation;
+  static int _frames;
+  static std::string _path;
+  static std::chrono::high_resolution_clock::time_point _origin;
+
+  static std::shared_ptr<ThreadCPU> _getThread();
+  static void _record(EventCPU event);
+  static void _save();
+
+ public:
+  // records next frames and saves them to path when the last one is finished
+  static void capture(int frames, std::string path);
+  static bool isRecording();
+  // is called by Core at the end of every frame
+  static void nextFrame();
+  // the first name is kept, unnamed threads are shown with their index
+  static void setThreadName(const char* name);
+  // negative payload isn't saved
+  static void begin(const char* name, int64_t payload = -1);
+  static void end();
+  // scope which is already finished
+  static void complete(const char* name, std::chrono::high_resolution_clock::time_point start);
+};
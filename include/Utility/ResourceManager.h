@@ -8,6 +8,7 @@ class ResourceManager {
  private:
   std::shared_ptr<LoaderGLTF> _loaderGLTF;
   std::shared_ptr<LoaderImage> _loaderImage;
+  std::shared_ptr<BS::thread_pool> _pool;
   std::shared_ptr<Texture> _stubTextureZero, _stubTextureOne;
   std::shared_ptr<Cubemap> _stubCubemapZero, _stubCubemapOne;
   std::shared_ptr<EngineState> _engineState;
@@ -18,7 +19,7 @@ class ResourceManager {
   std::string _assetEnginePath = "assets/";
 #endif
  public:
-  ResourceManager(std::shared_ptr<EngineState> engineState);
+  ResourceManager(std::shared_ptr<BS::thread_pool> pool, std::shared_ptr<EngineState> engineState);
   void initialize(std::shared_ptr<CommandBuffer> commandBufferTransfer);
 #ifdef __ANDROID__
   void setAssetManager(AAssetManager* assetManager);
@@ -34,7 +35,17 @@ class ResourceManager {
   std::shared_ptr<ImageCPU<T>> loadImageCPU(std::string path) {
     return _loaderImage->loadCPU<T>(path);
   }
+  // decoded in parallel, has to be called outside of thread pool's tasks
+  template <class T>
+  std::vector<std::shared_ptr<ImageCPU<T>>> loadImageCPU(std::vector<std::string> paths) {
+    return _loaderImage->loadCPU<T>(paths);
+  }
   std::shared_ptr<ModelGLTF> loadModel(std::string path, std::shared_ptr<CommandBuffer> commandBufferTransfer);
+  void loadModelCPU(std::string path,
+                    std::shared_ptr<BS::thread_pool> pool,
+                    std::function<void(std::shared_ptr<SceneGLTF>)> callback);
+  std::shared_ptr<ModelGLTF> loadModelGPU(std::shared_ptr<SceneGLTF> scene,
+                                          std::shared_ptr<CommandBuffer> commandBufferTransfer);
   std::shared_ptr<Texture> getTextureZero();
   std::shared_ptr<Texture> getTextureOne();
   std::shared_ptr<Cubemap> getCubemapZero();
@@ -43,6 +43,27 @@ struct Settings {
   // TODO: protect by mutex?
   int _bloomPasses = 0;
   int _desiredFPS = 250;
+  // time in seconds passed to particles and animations every frame instead of measured one, 0 means measured
+  float _fixedTimestep = 0.f;
+  // render to offscreen images without window and surface, every Core::draw call renders one frame
+  bool _headless = false;
+  // skip drawables and shadowables which bounds are outside of camera/light frustum
+  bool _frustumCulling = true;
+  // cull instances of shapes and models on GPU and draw them with indirect commands
+  bool _indirectCulling = false;
+  // skinned models are skinned once per frame by compute shader, so main and shadow passes don't skin them again
+  bool _computeSkinning = false;
+  // particles, blur and postprocessing are submitted to dedicated compute queue if device has one, so they overlap
+  // with graphic work, otherwise everything is submitted to graphic queue
+  bool _asyncCompute = false;
+  // number of vertices and indices in one block of geometry arena shared by static meshes
+  std::tuple<int, int> _geometryArenaSize = {1 << 18, 1 << 20};
+  // size of staging ring in bytes, uploads that don't fit get dedicated staging buffers
+  int _stagingSize = 1 << 25;
+  // size of per frame uniform ring in bytes, camera matrices of all draws are pushed there
+  int _uniformSize = 1 << 22;
+  // driver specific compiled pipelines are stored there between runs, empty path disables persistence
+  std::string _pipelineCachePath = "pipeline.cache";
   std::vector<std::tuple<int, float>> _attenuations = {{7, 1.8},      {13, 0.44},    {20, 0.20},    {32, 0.07},
                                                        {50, 0.032},   {65, 0.017},   {100, 0.0075}, {160, 0.0028},
                                                        {200, 0.0019}, {325, 0.0007}, {600, 0.0002}, {3250, 0.000007}};
@@ -53,6 +74,7 @@ struct Settings {
   float _depthBiasSlope = 1.75f;
   // number of DESCRIPTORS in descriptor pool
   int _poolSizeUBO = 3000;
+  int _poolSizeUBODynamic = 1000;
   int _poolSizeSampler = 2500;
   int _poolSizeSSBO = 100;
   int _poolSizeComputeImage = 100;
@@ -75,8 +97,19 @@ struct Settings {
   void setBloomPasses(int number);
   void setAnisotropicSamples(int number);
   void setDesiredFPS(int fps);
+  void setFixedTimestep(float timestep);
+  void setFrustumCulling(bool enable);
+  void setIndirectCulling(bool enable);
+  void setComputeSkinning(bool enable);
+  void setHeadless(bool headless);
+  void setAsyncCompute(bool enable);
+  void setGeometryArenaSize(std::tuple<int, int> size);
+  void setStagingSize(int size);
+  void setUniformSize(int size);
+  void setPipelineCachePath(std::string path);
   void setPoolSize(int poolSizeDescriptorSets,
                    int poolSizeUBO,
+                   int poolSizeUBODynamic,
                    int poolSizeSampler,
                    int poolSizeSSBO,
                    int poolSizeComputeImage);
@@ -99,12 +132,23 @@ struct Settings {
   VkClearColorValue getClearColor();
   int getAnisotropicSamples();
   int getDesiredFPS();
+  float getFixedTimestep();
+  bool getFrustumCulling();
+  bool getIndirectCulling();
+  bool getComputeSkinning();
+  bool getHeadless();
+  bool getAsyncCompute();
+  std::tuple<int, int> getGeometryArenaSize();
+  int getStagingSize();
+  int getUniformSize();
+  std::string getPipelineCachePath();
   std::tuple<int, int> getDiffuseIBLResolution();
   std::tuple<int, int> getSpecularIBLResolution();
   int getSpecularMipMap();
   float getDepthBiasConstant();
   float getDepthBiasSlope();
   int getPoolSizeUBO();
+  int getPoolSizeUBODynamic();
   int getPoolSizeSampler();
   int getPoolSizeSSBO();
   int getPoolSizeComputeImage();
@@ -27,6 +27,7 @@ class Timer {
   std::chrono::high_resolution_clock::time_point _startTimeCurrent;
   float _elapsedCurrent;
   int _FPSMaxPrevious;
+  float _fixedTimestep;
   std::shared_ptr<Logger> _logger;
 
  public:
@@ -35,6 +36,8 @@ class Timer {
   void tock();
   void reset();
   void sleep(int FPSMax);
+  // if set (> 0) is returned by getElapsedCurrent instead of measured frame time
+  void setFixedTimestep(float timestep);
   float getElapsedCurrent();
   uint64_t getFrameCounter();
 };
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+#include "Utility/EngineState.h"
+#include "Utility/Logger.h"
+#include "Graphic/Texture.h"
+#include "Vulkan/Buffer.h"
+#include "Vulkan/FrameGraph.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <thread>
+
+// Streams buffers and textures to device local memory without stalling frame loop. Requests from any thread are
+// recorded by worker thread: copies go to transfer queue, then images are released to graphic queue family which
+// acquires them and generates mip maps. Queues are accessed only by main thread, so recorded batches are submitted by
+// Core at the frame boundary. Callback is called by main thread once graphic part is submitted, frames compiled after
+// it wait for the upload, so resource can be used right away (f.e. drawable is added to Core from callback).
+class UploadManager {
+ private:
+  struct Batch {
+    VkCommandBuffer transfer, graphic;
+    // held allocations of StagingRing, released once transfer is finished
+    std::vector<StagingAllocation> staging;
+    // callbacks of requests
+    std::vector<std::function<void()>> ready;
+    // signaled by transfer part
+    uint64_t value;
+    // graphic part is submitted in this frame
+    uint64_t frame;
+  };
+
+  std::shared_ptr<EngineState> _engineState;
+  std::shared_ptr<Logger> _logger;
+  // command pools are used only by worker thread
+  std::shared_ptr<CommandPool> _commandPoolTransfer, _commandPoolGraphic;
+  uint32_t _familyTransfer, _familyGraphic;
+  std::shared_ptr<SemaphoreTimeline> _timeline;
+  uint64_t _value = 0;
+  std::vector<std::function<void(Batch&)>> _requests;
+  // recorded by worker -> submitted to transfer queue -> submitted to graphic queue -> command buffers can be freed
+  std::deque<std::shared_ptr<Batch>> _recorded, _transferred, _submitted, _finished;
+  std::mutex _mutex;
+  std::condition_variable _condition;
+  bool _stop = false;
+  std::thread _worker;
+
+  void _request(std::function<void(Batch&)> request);
+  void _work();
+  void _record(std::vector<std::function<void(Batch&)>> requests);
+
+ public:
+  UploadManager(std::shared_ptr<EngineState> engineState);
+  // data is copied to staging memory before return
+  void uploadBuffer(void* data,
+                    VkDeviceSize size,
+                    VkBufferUsageFlags usage,
+                    std::function<void(std::shared_ptr<Buffer>)> callback);
+  std::future<std::shared_ptr<Buffer>> uploadBuffer(void* data, VkDeviceSize size, VkBufferUsageFlags usage);
+  void uploadTexture(std::shared_ptr<BufferImage> data,
+                     VkFormat format,
+                     VkSamplerAddressMode mode,
+                     int mipMapLevels,
+                     VkFilter filter,
+                     std::function<void(std::shared_ptr<Texture>)> callback);
+  std::future<std::shared_ptr<Texture>> uploadTexture(std::shared_ptr<BufferImage> data,
+                                                      VkFormat format,
+                                                      VkSamplerAddressMode mode,
+                                                      int mipMapLevels,
+                                                      VkFilter filter);
+  // is called by Core every frame before passes are compiled, futures aren't resolved outside of frame loop, so main
+  // thread must not wait for them
+  void update(std::shared_ptr<FrameGraph> frameGraph);
+  ~UploadManager();
+};
@@ -0,0 +1,54 @@
+#pragma once
+#include "Vulkan/Buffer.h"
+#include <deque>
+#include <map>
+#include <mutex>
+#include <optional>
+
+// range of elements inside one block of arena
+struct ArenaRange {
+  int block;
+  VkDeviceSize offset;
+  VkDeviceSize size;
+};
+
+// A few big device local buffers (blocks) shared by many meshes, every mesh gets a range of elements in one block.
+// Offsets and sizes are in elements, so vertex offset / first index of draws can be taken directly from range.
+// Freed ranges can still be read by frames in flight, so they are merged with free neighbours and reused by next
+// allocations (first fit) only after release of the frame they were freed in.
+class BufferArena {
+ private:
+  VkDeviceSize _elementSize;
+  VkDeviceSize _blockSize;
+  VkBufferUsageFlags _usage;
+  std::vector<std::shared_ptr<Buffer>> _blocks;
+  // offset -> size of free ranges for every block
+  std::vector<std::map<VkDeviceSize, VkDeviceSize>> _free;
+  // ranges freed during frame, in frame order
+  std::deque<std::tuple<uint64_t, ArenaRange>> _released;
+  VkDeviceSize _used = 0;
+  std::mutex _mutex;
+  std::shared_ptr<EngineState> _engineState;
+
+  void _addBlock(VkDeviceSize size);
+  void _release(ArenaRange range);
+
+ public:
+  BufferArena(VkDeviceSize elementSize,
+              VkDeviceSize blockSize,
+              VkBufferUsageFlags usage,
+              std::shared_ptr<EngineState> engineState);
+  // range bigger than block gets own block of exactly requested size
+  ArenaRange allocate(VkDeviceSize size);
+  // range can still be used by frames in flight, it becomes free after release of current frame
+  void free(ArenaRange range);
+  // free everything freed during frames <= frame, GPU has to be done with these frames
+  void release(uint64_t frame);
+  // data is uploaded through StagingRing, range can be overwritten in place, draws recorded before wait for copy
+  void setData(ArenaRange range, void* data, std::shared_ptr<CommandBuffer> commandBufferTransfer);
+  std::shared_ptr<Buffer> getBuffer(int block);
+  int getBlockNumber();
+  // in elements
+  VkDeviceSize getUsed();
+  VkDeviceSize getCapacity();
+};
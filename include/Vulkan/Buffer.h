@@ -2,6 +2,9 @@
 #include "Vulkan/Device.h"
 #include "Vulkan/Command.h"
 #include <array>
+#include <deque>
+#include <mutex>
+#include <optional>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/hash.hpp>
 #undef far
@@ -13,16 +16,17 @@ class Buffer {
   VmaAllocationInfo _memoryInfo;
   VkDeviceSize _size;
   std::shared_ptr<EngineState> _engineState;
-  std::shared_ptr<Buffer> _stagingBuffer;
 
  public:
   Buffer(VkDeviceSize size,
          VkBufferUsageFlags usage,
          VkMemoryPropertyFlags properties,
          std::shared_ptr<EngineState> engineState);
+  // source buffer has to be alive until command buffer is executed (f.e. allocated from StagingRing)
   void copyFrom(std::shared_ptr<Buffer> buffer,
                 VkDeviceSize srcOffset,
                 VkDeviceSize dstOffset,
+                VkDeviceSize size,
                 std::shared_ptr<CommandBuffer> commandBufferTransfer);
   template <class T>
   void setData(T* data, VkDeviceSize size, int offset = 0) {
@@ -35,24 +39,102 @@ class Buffer {
   }
   // if buffer was created without VK_MEMORY_PROPERTY_HOST_COHERENT_BIT need to call
   VkResult flush();
+  // need to call before reading data written by GPU if memory isn't coherent
+  VkResult invalidate();
+  // host visible buffers are persistently mapped, device local ones return nullptr
+  void* getMappedMemory();
   VkBuffer& getData();
   VkDeviceSize& getSize();
   ~Buffer();
 };
 
-class BufferImage : public Buffer {
+// Part of staging ring, is valid only during the frame it was allocated in
+struct StagingAllocation {
+  std::shared_ptr<Buffer> buffer;
+  VkDeviceSize offset;
+};
+
+// All uploads to device local memory go through one persistently mapped staging buffer. Allocations are placed one
+// after another and are reused once fence of the frame they were allocated in is signaled. If ring is full, dedicated
+// buffer is allocated and released the same way. Held allocations aren't bound to frame (f.e. staging of streamed
+// uploads waits for its batch on transfer timeline), they are released explicitly.
+class StagingRing {
+ private:
+  struct Region {
+    uint64_t frame;
+    VkDeviceSize offset;
+    VkDeviceSize size;
+  };
+  std::shared_ptr<Buffer> _buffer;
+  VkDeviceSize _head = 0;
+  VkDeviceSize _tail = 0;
+  std::deque<Region> _regions;
+  std::deque<std::tuple<uint64_t, std::shared_ptr<Buffer>>> _dedicated;
+  VkDeviceSize _used = 0;
+  VkDeviceSize _peak = 0;
+  std::mutex _mutex;
+  std::shared_ptr<EngineState> _engineState;
+
+  std::optional<VkDeviceSize> _find(VkDeviceSize size);
+
+ public:
+  StagingRing(VkDeviceSize size, std::shared_ptr<EngineState> engineState);
+  StagingAllocation allocate(VkDeviceSize size, bool held = false);
+  // allocate and copy data to staging memory
+  StagingAllocation upload(void* data, VkDeviceSize size, bool held = false);
+  // free everything allocated during frames <= frame, GPU has to be done with these frames
+  void release(uint64_t frame);
+  // held allocation is freed by the next release(frame), GPU has to be done with it
+  void release(StagingAllocation allocation);
+  // in bytes
+  VkDeviceSize getUsed();
+  VkDeviceSize getPeak();
+  VkDeviceSize getCapacity();
+};
+
+// Per frame linear allocator for uniform data that is rewritten every draw (f.e. camera matrices). Every frame in
+// flight has own buffer that is bound as VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, allocation offset is passed as
+// dynamic offset during descriptor set bind. Allocations are reset once fence of the frame is signaled.
+class UniformRing {
  private:
+  std::vector<std::shared_ptr<Buffer>> _buffer;
+  std::vector<VkDeviceSize> _head;
+  VkDeviceSize _alignment;
+  VkDeviceSize _peak = 0;
+  std::mutex _mutex;
+  std::shared_ptr<EngineState> _engineState;
+
+ public:
+  UniformRing(VkDeviceSize size, std::shared_ptr<EngineState> engineState);
+  // copy data to buffer of current frame in flight, returns dynamic offset
+  uint32_t push(void* data, VkDeviceSize size);
+  void reset(int frame);
+  std::shared_ptr<Buffer> getBuffer(int frame);
+  // in bytes
+  VkDeviceSize getPeak();
+};
+
+// Pixels of one or more images (f.e. cubemap faces) in host memory, are uploaded through StagingRing by Image
+class BufferImage {
+ private:
+  std::vector<uint8_t> _data;
   std::tuple<int, int> _resolution;
   int _channels;
   int _number;
 
  public:
-  BufferImage(std::tuple<int, int> resolution,
-              int channels,
-              int number,
-              VkBufferUsageFlags usage,
-              VkMemoryPropertyFlags properties,
-              std::shared_ptr<EngineState> engineState);
+  BufferImage(std::tuple<int, int> resolution, int channels, int number);
+  template <class T>
+  void setData(T* data, VkDeviceSize size, int offset = 0) {
+    memcpy(_data.data() + offset, data, size);
+  }
+
+  template <class T>
+  void setData(T* data) {
+    setData(data, _data.size());
+  }
+  uint8_t* getData();
+  VkDeviceSize getSize();
   std::tuple<int, int> getResolution();
   int getChannels();
   int getNumber();
@@ -96,9 +178,6 @@ class VertexBufferDynamic : public VertexBuffer<T> {
 
 template <class T>
 class VertexBufferStatic : public VertexBuffer<T> {
- private:
-  std::shared_ptr<Buffer> _stagingBuffer;
-
  public:
   VertexBufferStatic(VkBufferUsageFlagBits type, std::shared_ptr<EngineState> engineState)
       : VertexBuffer<T>(type, engineState) {}
@@ -106,18 +185,13 @@ class VertexBufferStatic : public VertexBuffer<T> {
     this->_vertices = vertices;
 
     VkDeviceSize bufferSize = sizeof(vertices[0]) * vertices.size();
-    if (_stagingBuffer == nullptr || bufferSize != _stagingBuffer->getSize()) {
-      _stagingBuffer = std::make_shared<Buffer>(
-          bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, this->_engineState);
-    }
-    _stagingBuffer->setData(vertices.data());
+    auto staging = this->_engineState->getStagingRing()->upload(vertices.data(), bufferSize);
     if (this->_buffer == nullptr || bufferSize != this->_buffer->getSize()) {
       this->_buffer = std::make_shared<Buffer>(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | this->_type,
                                                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, this->_engineState);
     }
 
-    this->_buffer->copyFrom(_stagingBuffer, 0, 0, commandBufferTransfer);
+    this->_buffer->copyFrom(staging.buffer, staging.offset, 0, bufferSize, commandBufferTransfer);
     // need to insert memory barrier so read in vertex shader waits for copy
     VkMemoryBarrier memoryBarrier = {};
     memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
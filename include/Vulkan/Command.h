@@ -9,13 +9,21 @@ class CommandBuffer {
   std::vector<VkCommandBuffer> _buffer;
   std::shared_ptr<EngineState> _engineState;
   std::shared_ptr<CommandPool> _pool;
+  VkCommandBufferLevel _level;
   bool _active = false;
 
  public:
   CommandBuffer(int size, std::shared_ptr<CommandPool> pool, std::shared_ptr<EngineState> engineState);
+  CommandBuffer(int size,
+                VkCommandBufferLevel level,
+                std::shared_ptr<CommandPool> pool,
+                std::shared_ptr<EngineState> engineState);
   void beginCommands();
+  // secondary command buffer continues render pass of primary command buffer
+  void beginCommands(VkRenderPass renderPass, VkFramebuffer framebuffer);
   void endCommands();
   bool getActive();
+  VkCommandBufferLevel getLevel();
   std::vector<VkCommandBuffer>& getCommandBuffer();
   ~CommandBuffer();
 };
\ No newline at end of file
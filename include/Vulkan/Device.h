@@ -9,6 +9,7 @@
 #include <map>
 #include <mutex>
 #include <memory>
+#include <atomic>
 
 #include "Vulkan/Instance.h"
 #include "Vulkan/Surface.h"
@@ -17,6 +18,14 @@ class Device {
  private:
   vkb::Device _device;
   VkPhysicalDeviceLimits _deviceLimits;
+  // shared by all pipelines, is loaded from and saved to file so driver doesn't recompile pipelines on every start
+  VkPipelineCache _pipelineCache = VK_NULL_HANDLE;
+  std::string _pipelineCachePath;
+  bool _pipelineFeedback = false;
+  bool _hostQueryReset = false;
+  bool _synchronization2 = false;
+  bool _multiDrawIndirect = false;
+  std::atomic<int> _pipelineCacheHit = 0, _pipelineCacheMiss = 0;
 
  public:
   Device(std::shared_ptr<Surface> surface, std::shared_ptr<Instance> instance);
@@ -28,6 +37,21 @@ class Device {
   int getQueueIndex(vkb::QueueType type);
 
   VkPhysicalDeviceLimits& getDeviceLimits();
+  // empty path means cache isn't persisted
+  void createPipelineCache(std::string path);
+  void savePipelineCache();
+  VkPipelineCache getPipelineCache();
+  // hit/miss are tracked only if VK_EXT_pipeline_creation_feedback is supported
+  bool isPipelineFeedbackSupported();
+  void addPipelineFeedback(VkPipelineCreationFeedbackEXT feedback);
+  int getPipelineCacheHit();
+  int getPipelineCacheMiss();
+  // queries can be reset by vkResetQueryPoolEXT from CPU
+  bool isHostQueryResetSupported();
+  // vkQueueSubmit2KHR can be used
+  bool isSynchronization2Supported();
+  // multiDrawIndirect, drawIndirectFirstInstance and shaderDrawParameters are enabled, so GPU culling can be used
+  bool isMultiDrawIndirectSupported();
 
   ~Device();
 };
\ No newline at end of file
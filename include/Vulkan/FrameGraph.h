@@ -0,0 +1,91 @@
+#pragma once
+#include "Utility/EngineState.h"
+#include "Vulkan/Command.h"
+#include "Vulkan/Sync.h"
+
+// Passes of frame are declared in order of submission with resources they access. Dependencies between passes are
+// derived from these accesses: pipeline barriers if passes share queue, timeline semaphore waits otherwise.
+// Command buffers can be recorded in parallel after compile, then the whole frame is submitted with one submit per
+// queue. Image layouts aren't tracked, image has to stay in the declared layout between passes.
+// Images used by passes of different queue families are released and acquired, buffers are expected to be created
+// with concurrent sharing. Ownership isn't carried between frames, so the first pass of image in frame discards it.
+class FrameGraph {
+ private:
+  struct Access {
+    // VK_NULL_HANDLE means any memory
+    uint64_t handle;
+    bool image;
+    VkImageSubresourceRange range;
+    VkImageLayout layout;
+    VkPipelineStageFlags stage;
+    VkAccessFlags access;
+  };
+
+  struct Pass {
+    std::string name;
+    VkQueue queue;
+    uint32_t family;
+    std::vector<std::shared_ptr<CommandBuffer>> commandBuffers;
+    std::vector<Access> accesses;
+    // binary semaphores, f.e. swapchain image acquire and present
+    std::vector<std::tuple<VkSemaphore, VkPipelineStageFlags>> waitBinary;
+    std::vector<VkSemaphore> signalBinary;
+    // derived by compile
+    uint64_t value;
+    std::map<VkQueue, std::tuple<uint64_t, VkPipelineStageFlags>> waitTimeline;
+    VkPipelineStageFlags barrierSrcStage, barrierDstStage;
+    std::vector<VkMemoryBarrier> memoryBarriers;
+    std::vector<VkBufferMemoryBarrier> bufferBarriers;
+    std::vector<VkImageMemoryBarrier> imageBarriers;
+    // ownership of images is released to passes of other queue families
+    VkPipelineStageFlags releaseSrcStage;
+    std::vector<VkImageMemoryBarrier> releaseBarriers;
+  };
+
+  std::shared_ptr<EngineState> _engineState;
+  std::vector<Pass> _passes;
+  // one timeline semaphore per queue, value is increased by every submitted pass
+  std::map<VkQueue, std::shared_ptr<SemaphoreTimeline>> _timeline;
+  std::map<VkQueue, uint64_t> _value;
+  // work submitted outside of graph, passes of the next frame wait for it
+  std::map<VkQueue, uint64_t> _external;
+
+  bool _isWrite(VkAccessFlags access);
+  std::shared_ptr<SemaphoreTimeline> _getTimeline(VkQueue queue);
+  void _addDependency(Pass& pass, int passSource, const Access& source, const Access& destination);
+  void _addOwnershipTransfer(Pass& pass, int passSource, const Access& source, const Access& destination);
+  void _submit(VkQueue queue, std::vector<int> passes, VkFence fence);
+
+ public:
+  FrameGraph(std::shared_ptr<EngineState> engineState);
+  // removes passes of previous frame
+  void reset();
+  // returns index of pass, command buffers are submitted in the given order
+  int addPass(std::string name, vkb::QueueType queue, std::vector<std::shared_ptr<CommandBuffer>> commandBuffers);
+  void addImage(int pass,
+                VkImage image,
+                VkImageSubresourceRange range,
+                VkImageLayout layout,
+                VkPipelineStageFlags stage,
+                VkAccessFlags access);
+  void addBuffer(int pass, VkBuffer buffer, VkPipelineStageFlags stage, VkAccessFlags access);
+  // for resources which aren't tracked individually, f.e. all buffers of particle systems
+  void addMemory(int pass, VkPipelineStageFlags stage, VkAccessFlags access);
+  void addWait(int pass, VkSemaphore semaphore, VkPipelineStageFlags stage);
+  void addSignal(int pass, VkSemaphore semaphore);
+  // derives barriers and waits, has to be called after all passes are added and before recordBarriers
+  void compile();
+  // records barriers derived for pass, has to be called at the beginning of pass's first command buffer
+  void recordBarriers(int pass);
+  // records ownership releases of pass, has to be called at the end of pass's last command buffer
+  void recordReleases(int pass);
+  // fence is signaled when all passes are finished
+  void submit(VkFence fence);
+  // is submitted immediately, f.e. resources upload, all passes of the next frame wait for it
+  void submitExternal(vkb::QueueType queue, std::shared_ptr<CommandBuffer> commandBuffer);
+  // command buffer isn't bound to frame in flight, execution waits for value of timeline semaphore if it's passed
+  void submitExternal(vkb::QueueType queue,
+                      VkCommandBuffer commandBuffer,
+                      VkSemaphore waitTimeline = VK_NULL_HANDLE,
+                      uint64_t waitValue = 0);
+};
@@ -13,7 +13,6 @@ class Image {
   int _layers;
   bool _external = false;
   VkImageLayout _imageLayout;
-  std::shared_ptr<Buffer> _stagingBuffer;
 
  public:
   Image(VkImage& image, std::tuple<int, int> resolution, VkFormat format, std::shared_ptr<EngineState> engineState);
@@ -28,9 +27,14 @@ class Image {
 
   void setData(std::shared_ptr<Buffer> buffer);
   // bufferOffsets contains offsets for part of buffer that should be copied to corresponding layers of image
+  // buffer has to be alive until command buffer is executed (f.e. allocated from StagingRing)
   void copyFrom(std::shared_ptr<Buffer> buffer,
                 std::vector<int> bufferOffsets,
                 std::shared_ptr<CommandBuffer> commandBufferTransfer);
+  // data is uploaded through StagingRing
+  void copyFrom(std::shared_ptr<BufferImage> data,
+                std::vector<int> bufferOffsets,
+                std::shared_ptr<CommandBuffer> commandBufferTransfer);
   void changeLayout(VkImageLayout oldLayout,
                     VkImageLayout newLayout,
                     VkImageAspectFlags aspectMask,
@@ -38,6 +42,8 @@ class Image {
                     int mipMapLevels,
                     std::shared_ptr<CommandBuffer> commandBufferTransfer);
   void generateMipmaps(int mipMapLevels, int layers, std::shared_ptr<CommandBuffer> commandBuffer);
+  // for command buffers which aren't bound to frame in flight, f.e. recorded by UploadManager
+  void generateMipmaps(int mipMapLevels, int layers, VkCommandBuffer commandBuffer);
 
   void overrideLayout(VkImageLayout layout);
   std::tuple<int, int> getResolution();
@@ -10,7 +10,7 @@ class Instance {
   bool _debugUtils = false;
 
  public:
-  Instance(std::string name, bool validation);
+  Instance(std::string name, bool validation, bool headless);
   bool isDebug();
   const vkb::Instance& getInstance();
   ~Instance();
@@ -15,6 +15,19 @@ class CommandPool {
   ~CommandPool();
 };
 
+class QueryPool {
+ private:
+  std::shared_ptr<Device> _device;
+  VkQueryPool _queryPool;
+  int _size;
+
+ public:
+  QueryPool(VkQueryType type, int size, std::shared_ptr<Device> device);
+  VkQueryPool& getQueryPool();
+  int getSize();
+  ~QueryPool();
+};
+
 class DescriptorPool {
  private:
   std::shared_ptr<Device> _device;
@@ -8,12 +8,16 @@ class Swapchain {
   vkb::Swapchain _swapchain;
   std::vector<std::shared_ptr<ImageView>> _swapchainImageViews;
   void _createImageViews();
+  // in headless mode offscreen images are used instead of swapchain ones, one per frame in flight
+  void _createImageViewsHeadless();
   void _destroy();
 
  public:
   Swapchain(std::shared_ptr<EngineState> engineState);
   void reset();
   const vkb::Swapchain& getSwapchain();
+  // layout of images between frames, swapchain one isn't available in headless mode
+  VkImageLayout getPresentLayout();
 
   std::vector<std::shared_ptr<ImageView>> getImageViews();
   ~Swapchain();
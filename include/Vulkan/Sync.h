@@ -12,6 +12,18 @@ class Semaphore {
   ~Semaphore();
 };
 
+// signaled with increasing values, wait for value can be submitted before its signal
+class SemaphoreTimeline {
+ private:
+  std::shared_ptr<Device> _device;
+  VkSemaphore _semaphore;
+
+ public:
+  SemaphoreTimeline(std::shared_ptr<Device> device);
+  VkSemaphore& getSemaphore();
+  ~SemaphoreTimeline();
+};
+
 class Fence {
  private:
   std::shared_ptr<Device> _device;
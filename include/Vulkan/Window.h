@@ -11,7 +11,7 @@
 
 class Window {
  private:
-  void* _window;
+  void* _window = nullptr;
   std::tuple<int, int> _resolution;
   bool _resized = false;
 
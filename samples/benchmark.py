@@ -0,0 +1,61 @@
+import argparse
+import csv
+import json
+import os
+import subprocess
+import sys
+
+# samples are expected to be built to samples/<sample>/build, see samples README
+scenes = {"scene": "Scene", "shape": "Shape", "shadow": "Shadow", "terrain": "Terrain", "model": "Model"}
+
+parser = argparse.ArgumentParser(description="Run samples headlessly and collect per stage CPU/GPU timings")
+parser.add_argument("--frames", type=int, default=1000, help="number of measured frames per scene")
+parser.add_argument("--output", default="benchmark", help="path without extension for merged .json and .csv")
+parser.add_argument("--baseline", help="merged .json of previous run to compare with")
+parser.add_argument("--threshold", type=float, default=10, help="p95 regression in percents reported as failure")
+parser.add_argument("--scenes", nargs="+", default=list(scenes.keys()), choices=list(scenes.keys()))
+arguments = parser.parse_args()
+
+root = os.path.dirname(os.path.abspath(__file__))
+results = {}
+for scene in arguments.scenes:
+    build = os.path.join(root, scene, "build")
+    executable = os.path.join(build, scenes[scene] + (".exe" if sys.platform == "win32" else ""))
+    path = os.path.join(build, "benchmark")
+    print(f"Run {scene} for {arguments.frames} frames")
+    # assets are loaded relatively to build folder
+    process = subprocess.run([executable, "--benchmark", str(arguments.frames), path], cwd=build)
+    if process.returncode:
+        print(f"Application crashed: {process.returncode}")
+        sys.exit(process.returncode)
+    with open(path + ".json") as file:
+        results[scene] = json.load(file)
+
+output = os.path.abspath(arguments.output)
+with open(output + ".json", "w") as file:
+    json.dump(results, file, indent=4)
+with open(output + ".csv", "w", newline="") as file:
+    writer = csv.writer(file)
+    writer.writerow(["scene", "type", "name", "mean", "p50", "p95", "p99"])
+    for scene, result in results.items():
+        for type in ["cpu", "gpu"]:
+            for name, value in result[type].items():
+                writer.writerow([scene, type, name, value["mean"], value["p50"], value["p95"], value["p99"]])
+print(f"Results are saved to {output}.json and {output}.csv")
+
+if arguments.baseline:
+    with open(arguments.baseline) as file:
+        baseline = json.load(file)
+    regression = False
+    for scene, result in results.items():
+        for type in ["cpu", "gpu"]:
+            for name, value in result[type].items():
+                previous = baseline.get(scene, {}).get(type, {}).get(name)
+                if previous is None or previous["p95"] == 0:
+                    continue
+                change = (value["p95"] - previous["p95"]) / previous["p95"] * 100
+                if change > arguments.threshold:
+                    regression = True
+                    print(f"{scene} {type} '{name}' p95: {previous['p95']:.3f} -> {value['p95']:.3f} ms (+{change:.1f}%)")
+    if regression:
+        sys.exit(1)
@@ -33,8 +33,12 @@ class Main {
   std::vector<std::shared_ptr<MaterialPhong>> _materialModelBottlePhong;
   std::vector<std::shared_ptr<MaterialPBR>> _materialModelBottlePBR;
 
+  // render given number of frames headlessly and save timings of engine stages to _benchmarkPath
+  int _benchmarkFrames;
+  std::string _benchmarkPath;
+
  public:
-  Main();
+  Main(int benchmarkFrames = 0, std::string benchmarkPath = "");
   void update();
   void reset(int width, int height);
   void start();
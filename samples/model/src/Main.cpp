@@ -3,6 +3,9 @@
 #include <future>
 #include "Main.h"
 #include "Primitive/Model.h"
+#include "Utility/PoseKernel.h"
+#include <glm/gtc/epsilon.hpp>
+#include <glm/gtx/string_cast.hpp>
 
 InputHandler::InputHandler(std::shared_ptr<Core> core) { _core = core; }
 
@@ -26,7 +29,9 @@ void InputHandler::charNotify(unsigned int code) {}
 
 void InputHandler::scrollNotify(double xOffset, double yOffset) {}
 
-Main::Main() {
+Main::Main(int benchmarkFrames, std::string benchmarkPath) {
+  _benchmarkFrames = benchmarkFrames;
+  _benchmarkPath = benchmarkPath;
   int mipMapLevels = 4;
   auto settings = std::make_shared<Settings>();
   settings->setName("Model");
@@ -46,6 +51,7 @@ Main::Main() {
   settings->setMaxFramesInFlight(2);
   settings->setThreadsInPool(6);
   settings->setDesiredFPS(1000);
+  if (_benchmarkFrames > 0) Benchmark::configure(settings);
 
   _core = std::make_shared<Core>(settings);
   _core->initialize();
@@ -324,11 +330,92 @@ void Main::update() {
 
 void Main::reset(int width, int height) { _camera->setAspect((float)width / (float)height); }
 
-void Main::start() { _core->draw(); }
+void Main::start() {
+  if (_benchmarkFrames > 0)
+    _core->runBenchmark(_benchmarkFrames, _benchmarkPath);
+  else
+    _core->draw();
+}
+
+// builds model with non-identity node transforms and compares its bounds with expected ones
+static bool testBounds() {
+  auto settings = std::make_shared<Settings>();
+  settings->setName("Model bounds");
+  settings->setResolution(std::tuple{640, 480});
+  settings->setGraphicColorFormat(VK_FORMAT_R32G32B32A32_SFLOAT);
+  settings->setSwapchainColorFormat(VK_FORMAT_B8G8R8A8_UNORM);
+  settings->setLoadTextureColorFormat(VK_FORMAT_R8G8B8A8_SRGB);
+  settings->setLoadTextureAuxilaryFormat(VK_FORMAT_R8G8B8A8_UNORM);
+  settings->setDepthFormat(VK_FORMAT_D32_SFLOAT);
+  settings->setMaxFramesInFlight(2);
+  settings->setThreadsInPool(2);
+  settings->setHeadless(true);
+  auto core = std::make_shared<Core>(settings);
+  core->initialize();
+  core->startRecording();
+
+  // cube [-1, 1] shared by two nodes
+  std::vector<Vertex3D> vertices(8);
+  for (int i = 0; i < vertices.size(); i++)
+    vertices[i].pos = glm::vec3(i & 1 ? 1.f : -1.f, i & 2 ? 1.f : -1.f, i & 4 ? 1.f : -1.f);
+  std::vector<uint32_t> indexes{0, 1, 2, 1, 3, 2};
+  auto mesh = std::make_shared<MeshStatic3D>(core->getEngineState());
+  mesh->setVertices(vertices, core->getCommandBufferApplication());
+  mesh->setIndexes(indexes, core->getCommandBufferApplication());
+  mesh->addPrimitive({.firstIndex = 0, .indexCount = static_cast<int>(indexes.size()), .materialIndex = -1});
+
+  // glm doesn't initialize quaternions and matrices
+  auto createNode = []() {
+    auto node = std::make_shared<NodeGLTF>();
+    node->rotation = glm::quat(1.f, 0.f, 0.f, 0.f);
+    node->matrix = glm::mat4(1.f);
+    return node;
+  };
+  // parent is translated, child is scaled, rotated around Z and translated relatively to parent
+  auto parent = createNode();
+  parent->translation = glm::vec3(10.f, 0.f, 0.f);
+  auto child = createNode();
+  child->mesh = 0;
+  child->parent = parent;
+  child->translation = glm::vec3(0.f, 5.f, 0.f);
+  child->rotation = glm::angleAxis(glm::radians(45.f), glm::vec3(0.f, 0.f, 1.f));
+  child->scale = glm::vec3(2.f);
+  parent->children.push_back(child);
+  auto other = createNode();
+  other->mesh = 0;
+  other->translation = glm::vec3(-10.f, 0.f, 0.f);
+
+  std::vector<std::shared_ptr<NodeGLTF>> nodes{parent, other};
+  std::vector<std::shared_ptr<MeshStatic3D>> meshes{mesh};
+  auto modelGLTF = std::make_shared<ModelGLTF>();
+  modelGLTF->setNodes(nodes);
+  modelGLTF->setMeshes(meshes);
+  auto model = core->createModel3D(modelGLTF);
+  core->endRecording();
+
+  // rotated by 45 degrees cube with half size 2 has half size 2 * sqrt(2) along X and Y
+  float extent = 2.f * std::sqrt(2.f);
+  glm::vec3 expectedMin(-11.f, std::min(-1.f, 5.f - extent), -2.f);
+  glm::vec3 expectedMax(10.f + extent, 5.f + extent, 2.f);
+  auto aabb = model->getAABB();
+  bool passed = glm::all(glm::epsilonEqual(aabb->getMin(), expectedMin, 0.001f)) &&
+                glm::all(glm::epsilonEqual(aabb->getMax(), expectedMax, 0.001f));
+  std::cout << "Bounds min: " << glm::to_string(aabb->getMin()) << " max: " << glm::to_string(aabb->getMax())
+            << (passed ? " passed" : " failed") << std::endl;
+  return passed;
+}
 
-int main() {
+int main(int argc, char* argv[]) {
   try {
-    auto main = std::make_shared<Main>();
+    // --benchmark-pose <joints> <iterations>, compares SIMD and GLM paths of animation without window
+    if (argc == 4 && std::string(argv[1]) == "--benchmark-pose") {
+      PoseKernel::benchmark(std::stoi(argv[2]), std::stoi(argv[3]));
+      return EXIT_SUCCESS;
+    }
+    // --test-bounds, checks bounds of model with node transforms without window
+    if (argc == 2 && std::string(argv[1]) == "--test-bounds") return testBounds() ? EXIT_SUCCESS : EXIT_FAILURE;
+    auto arguments = Benchmark::parseArguments(argc, argv);
+    auto main = std::make_shared<Main>(arguments.frames, arguments.path);
     main->start();
   } catch (const std::exception& e) {
     std::cerr << e.what() << std::endl;
@@ -28,8 +28,12 @@ class Main {
   std::shared_ptr<Shape3D> _cubeColoredLightVertical, _cubeColoredLightHorizontal;
   float _directionalValue = 0.5f, _pointVerticalValue = 1.f, _pointHorizontalValue = 10.f;
 
+  // render given number of frames headlessly and save timings of engine stages to _benchmarkPath
+  int _benchmarkFrames;
+  std::string _benchmarkPath;
+
  public:
-  Main();
+  Main(int benchmarkFrames = 0, std::string benchmarkPath = "");
   void update();
   void reset(int width, int height);
   void start();
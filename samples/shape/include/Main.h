@@ -27,8 +27,12 @@ class Main {
   std::shared_ptr<DirectionalLight> _directionalLight;
   std::shared_ptr<Shape3D> _cubeColoredLightVertical, _cubeColoredLightHorizontal;
 
+  // render given number of frames headlessly and save timings of engine stages to _benchmarkPath
+  int _benchmarkFrames;
+  std::string _benchmarkPath;
+
  public:
-  Main();
+  Main(int benchmarkFrames = 0, std::string benchmarkPath = "");
   void update();
   void reset(int width, int height);
   void start();
@@ -26,7 +26,9 @@ void InputHandler::charNotify(unsigned int code) {}
 
 void InputHandler::scrollNotify(double xOffset, double yOffset) {}
 
-Main::Main() {
+Main::Main(int benchmarkFrames, std::string benchmarkPath) {
+  _benchmarkFrames = benchmarkFrames;
+  _benchmarkPath = benchmarkPath;
   int mipMapLevels = 4;
   auto settings = std::make_shared<Settings>();
   settings->setName("Shape");
@@ -46,6 +48,7 @@ Main::Main() {
   settings->setMaxFramesInFlight(2);
   settings->setThreadsInPool(6);
   settings->setDesiredFPS(1000);
+  if (_benchmarkFrames > 0) Benchmark::configure(settings);
 
   _core = std::make_shared<Core>(settings);
   _core->initialize();
@@ -413,11 +416,17 @@ void Main::update() {
 
 void Main::reset(int width, int height) { _camera->setAspect((float)width / (float)height); }
 
-void Main::start() { _core->draw(); }
+void Main::start() {
+  if (_benchmarkFrames > 0)
+    _core->runBenchmark(_benchmarkFrames, _benchmarkPath);
+  else
+    _core->draw();
+}
 
-int main() {
+int main(int argc, char* argv[]) {
   try {
-    auto main = std::make_shared<Main>();
+    auto arguments = Benchmark::parseArguments(argc, argv);
+    auto main = std::make_shared<Main>(arguments.frames, arguments.path);
     main->start();
   } catch (const std::exception& e) {
     std::cerr << e.what() << std::endl;
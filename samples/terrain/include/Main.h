@@ -59,8 +59,12 @@ class Main {
   void _createTerrainPBR(std::string path);
   void _createTerrainDebug(std::string path);
 
+  // render given number of frames headlessly and save timings of engine stages to _benchmarkPath
+  int _benchmarkFrames;
+  std::string _benchmarkPath;
+
  public:
-  Main();
+  Main(int benchmarkFrames = 0, std::string benchmarkPath = "");
   void update();
   void reset(int width, int height);
   void start();
@@ -1,4 +1,12 @@
 #version 450
+// variant: DRAW_PARAMETERS
+#ifdef DRAW_PARAMETERS
+#extension GL_ARB_shader_draw_parameters : enable
+#define DRAW_ID gl_DrawIDARB
+#else
+// without shader draw parameters draws aren't merged, so draw is fully defined by push constant
+#define DRAW_ID 0
+#endif
 
 layout(set = 0, binding = 0) uniform UniformCamera {
     mat4 model;
@@ -6,6 +14,11 @@ layout(set = 0, binding = 0) uniform UniformCamera {
     mat4 proj;
 } mvp;
 
+// model matrix of every instance (already multiplied by drawable model matrix)
+layout(std430, set = 2, binding = 0) readonly buffer Instances {
+    mat4 instanceMatrices[];
+};
+
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec4 inJointIndices;
 layout(location = 2) in vec4 inJointWeights;
@@ -17,6 +30,21 @@ layout(std430, set = 1, binding = 0) readonly buffer JointMatrices {
     mat4 jointMatrices[];
 };
 
+// world matrices of all nodes of model, calculated once per frame
+layout(std430, set = 1, binding = 1) readonly buffer NodeMatrices {
+    mat4 nodeMatrices[];
+};
+
+// node of every draw of model, consecutive draws with the same state are merged to one indirect draw
+layout(std430, set = 1, binding = 2) readonly buffer DrawNodes {
+    int drawNodes[];
+};
+
+layout( push_constant ) uniform constantsVertex {
+    // index of the first draw, DRAW_ID is index of draw inside indirect draw
+    int draw;
+} pushVertex;
+
 void main() {
     mat4 skinMat = mat4(1.0);
     if (jointNumber > 0) {
@@ -26,7 +54,7 @@ void main() {
                   inJointWeights.w * jointMatrices[int(inJointIndices.w)];
     }
 
-    mat4 model = mvp.model * skinMat;
+    mat4 model = instanceMatrices[gl_InstanceIndex] * nodeMatrices[drawNodes[pushVertex.draw + DRAW_ID]] * skinMat;
     gl_Position = mvp.proj * mvp.view * model * vec4(inPosition, 1.0);
     modelCoords = model * vec4(inPosition, 1.0);
 }
\ No newline at end of file
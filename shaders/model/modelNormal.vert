@@ -0,0 +1,53 @@
+#version 450
+// variant: DRAW_PARAMETERS
+#ifdef DRAW_PARAMETERS
+#extension GL_ARB_shader_draw_parameters : enable
+#define DRAW_ID gl_DrawIDARB
+#else
+// without shader draw parameters draws aren't merged, so draw is fully defined by push constant
+#define DRAW_ID 0
+#endif
+
+layout(set = 0, binding = 0) uniform UniformCamera {
+    mat4 model;
+    mat4 view;
+    mat4 proj;
+} mvp;
+
+// model matrix of every instance (already multiplied by drawable model matrix)
+layout(std430, set = 2, binding = 0) readonly buffer Instances {
+    mat4 instanceMatrices[];
+};
+
+// world matrices of all nodes of model, calculated once per frame
+layout(std430, set = 1, binding = 1) readonly buffer NodeMatrices {
+    mat4 nodeMatrices[];
+};
+
+// node of every draw of model, consecutive draws with the same state are merged to one indirect draw
+layout(std430, set = 1, binding = 2) readonly buffer DrawNodes {
+    int drawNodes[];
+};
+
+layout( push_constant ) uniform constantsVertex {
+    // index of the first draw, DRAW_ID is index of draw inside indirect draw
+    int draw;
+} pushVertex;
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+layout(location = 2) in vec3 inColor;
+
+layout(location = 0) out vec3 fragNormal;
+layout(location = 1) out vec3 fragColor;
+
+void main() {
+    mat4 model = instanceMatrices[gl_InstanceIndex] * nodeMatrices[drawNodes[pushVertex.draw + DRAW_ID]];
+    vec4 afterModel = model * vec4(inPosition, 1.0);
+    // normals should be in the same space as gl_Position, because we will sum position and normals
+    mat3 normalMatrix = mat3(transpose(inverse(mvp.view * model)));
+    fragNormal = normalize(normalMatrix * inNormal);
+
+    fragColor = inColor;
+    gl_Position = mvp.view * model * vec4(inPosition, 1.0);
+}  
\ No newline at end of file
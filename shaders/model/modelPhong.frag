@@ -75,7 +75,7 @@ layout(set = 0, binding = 5) uniform Material {
 } material;
 
 layout( push_constant ) uniform constants {
-    int enableShadow;
+    layout(offset = 16) int enableShadow;
     int enableLighting;
     vec3 cameraPosition;
 } push;
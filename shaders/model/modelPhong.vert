@@ -1,4 +1,12 @@
 #version 450
+// variant: DRAW_PARAMETERS
+#ifdef DRAW_PARAMETERS
+#extension GL_ARB_shader_draw_parameters : enable
+#define DRAW_ID gl_DrawIDARB
+#else
+// without shader draw parameters draws aren't merged, so draw is fully defined by push constant
+#define DRAW_ID 0
+#endif
 #define epsilon 0.0001 
 
 layout(set = 0, binding = 0) uniform UniformCamera {
@@ -7,11 +15,31 @@ layout(set = 0, binding = 0) uniform UniformCamera {
     mat4 proj;
 } mvp;
 
+// model matrix of every instance (already multiplied by drawable model matrix)
+layout(std430, set = 3, binding = 0) readonly buffer Instances {
+    mat4 instanceMatrices[];
+};
+
 layout(std140, set = 1, binding = 0) readonly buffer JointMatrices {
     int jointNumber;
     mat4 jointMatrices[];
 };
 
+// world matrices of all nodes of model, calculated once per frame
+layout(std430, set = 1, binding = 1) readonly buffer NodeMatrices {
+    mat4 nodeMatrices[];
+};
+
+// node of every draw of model, consecutive draws with the same state are merged to one indirect draw
+layout(std430, set = 1, binding = 2) readonly buffer DrawNodes {
+    int drawNodes[];
+};
+
+layout( push_constant ) uniform constantsVertex {
+    // index of the first draw, DRAW_ID is index of draw inside indirect draw
+    int draw;
+} pushVertex;
+
 layout(std140, set = 2, binding = 0) readonly buffer LightMatrixDirectional {
     int lightDirectionalNumber;
     mat4 lightDirectionalVP[];
@@ -43,7 +71,7 @@ void main() {
                   inJointWeights.w * jointMatrices[int(inJointIndices.w)];
     }
 
-    mat4 model = mvp.model * skinMat;
+    mat4 model = instanceMatrices[gl_InstanceIndex] * nodeMatrices[drawNodes[pushVertex.draw + DRAW_ID]] * skinMat;
     mat3 normalMatrix = mat3(transpose(inverse(model)));
 
     vec4 afterModel = model * vec4(inPosition, 1.0);
@@ -6,6 +6,11 @@ layout(set = 0, binding = 0) uniform UniformCamera {
     mat4 proj;
 } mvp;
 
+// model matrix of every instance (already multiplied by drawable model matrix)
+layout(std430, set = 1, binding = 0) readonly buffer Instances {
+    mat4 instanceMatrices[];
+};
+
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inNormal;
 layout(location = 2) in vec3 inColor;
@@ -15,11 +20,12 @@ layout(location = 1) out vec3 fragColor;
 layout(location = 2) out vec3 texCoords;
 
 void main() {
-    vec4 afterModel = mvp.model * vec4(inPosition, 1.0);
-    mat3 normalMatrix = mat3(transpose(inverse(mvp.model)));
+    mat4 model = instanceMatrices[gl_InstanceIndex] * mvp.model;
+    vec4 afterModel = model * vec4(inPosition, 1.0);
+    mat3 normalMatrix = mat3(transpose(inverse(model)));
     fragNormal = normalize(normalMatrix * inNormal);
 
     fragColor = inColor;
     texCoords = inPosition;
-    gl_Position = mvp.proj * mvp.view * mvp.model * vec4(inPosition, 1.0);
+    gl_Position = mvp.proj * mvp.view * model * vec4(inPosition, 1.0);
 }  
\ No newline at end of file
@@ -6,10 +6,16 @@ layout(set = 0, binding = 0) uniform UniformCamera {
     mat4 proj;
 } mvp;
 
+// model matrix of every instance (already multiplied by drawable model matrix)
+layout(std430, set = 1, binding = 0) readonly buffer Instances {
+    mat4 instanceMatrices[];
+};
+
 layout(location = 0) in vec3 inPosition;
 
 layout(location = 0) out vec4 modelCoords;
 void main() {
-    gl_Position = mvp.proj * mvp.view * mvp.model * vec4(inPosition, 1.0);
-    modelCoords = mvp.model * vec4(inPosition, 1.0);
+    mat4 model = instanceMatrices[gl_InstanceIndex] * mvp.model;
+    gl_Position = mvp.proj * mvp.view * model * vec4(inPosition, 1.0);
+    modelCoords = model * vec4(inPosition, 1.0);
 }
\ No newline at end of file
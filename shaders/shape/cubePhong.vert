@@ -7,6 +7,11 @@ layout(set = 0, binding = 0) uniform UniformCamera {
     mat4 proj;
 } mvp;
 
+// model matrix of every instance (already multiplied by drawable model matrix)
+layout(std430, set = 2, binding = 0) readonly buffer Instances {
+    mat4 instanceMatrices[];
+};
+
 layout(std140, set = 1, binding = 0) readonly buffer LightMatrixDirectional {
     int lightDirectionalNumber;
     mat4 lightDirectionalVP[];
@@ -26,8 +31,9 @@ layout(location = 4) out mat3 fragTBN;
 layout(location = 7) out vec4 fragLightDirectionalCoord[2];
 
 void main() {
-    vec4 afterModel = mvp.model * vec4(inPosition, 1.0);
-    mat3 normalMatrix = mat3(transpose(inverse(mvp.model)));
+    mat4 model = instanceMatrices[gl_InstanceIndex] * mvp.model;
+    vec4 afterModel = model * vec4(inPosition, 1.0);
+    mat3 normalMatrix = mat3(transpose(inverse(model)));
 
     gl_Position = mvp.proj * mvp.view * afterModel;
     
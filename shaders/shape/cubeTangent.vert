@@ -6,6 +6,11 @@ layout(set = 0, binding = 0) uniform UniformCamera {
     mat4 proj;
 } mvp;
 
+// model matrix of every instance (already multiplied by drawable model matrix)
+layout(std430, set = 1, binding = 0) readonly buffer Instances {
+    mat4 instanceMatrices[];
+};
+
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inColor;
 layout(location = 2) in vec4 inTangent;
@@ -14,11 +19,12 @@ layout(location = 0) out vec3 fragNormal;
 layout(location = 1) out vec3 fragColor;
 
 void main() {
-    vec4 afterModel = mvp.model * vec4(inPosition, 1.0);
+    mat4 model = instanceMatrices[gl_InstanceIndex] * mvp.model;
+    vec4 afterModel = model * vec4(inPosition, 1.0);
     // normals should be in the same space as gl_Position, because we will sum position and normals
-    mat3 normalMatrix = mat3(transpose(inverse(mvp.view * mvp.model)));
+    mat3 normalMatrix = mat3(transpose(inverse(mvp.view * model)));
     fragNormal = normalize(normalMatrix * inTangent.xyz);
 
     fragColor = inColor;
-    gl_Position = mvp.view * mvp.model * vec4(inPosition, 1.0);
+    gl_Position = mvp.view * model * vec4(inPosition, 1.0);
 }  
\ No newline at end of file
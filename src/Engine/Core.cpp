@@ -1,9 +1,15 @@
 #include "Engine/Core.h"
 #include "Primitive/TerrainInterpolation.h"
 #include "Primitive/TerrainComposition.h"
+#include "stb_image_write.h"
 #include <typeinfo>
 
-Core::Core(std::shared_ptr<Settings> settings) { _engineState = std::make_shared<EngineState>(settings); }
+Core::Core(std::shared_ptr<Settings> settings) {
+  _engineState = std::make_shared<EngineState>(settings);
+  _bvhDrawable[AlphaType::OPAQUE] = std::make_shared<BVH>();
+  _bvhDrawable[AlphaType::TRANSPARENT] = std::make_shared<BVH>();
+  _bvhShadowable = std::make_shared<BVH>();
+}
 
 void Core::_initializeTextures() {
   auto settings = _engineState->getSettings();
@@ -81,11 +87,26 @@ void Core::initialize() {
   _engineState->setAssetManager(_assetManager);
 #endif
   _engineState->initialize();
+  ProfilerCPU::setThreadName("Main");
   auto settings = _engineState->getSettings();
+  _engineState->setStagingRing(std::make_shared<StagingRing>(settings->getStagingSize(), _engineState));
+  _engineState->setUniformRing(std::make_shared<UniformRing>(settings->getUniformSize(), _engineState));
+  _engineState->setProfilerGPU(std::make_shared<ProfilerGPU>(_engineState));
+  // vertices and indices of all static meshes are suballocated from a few big buffers
+  auto [arenaVertices, arenaIndices] = settings->getGeometryArenaSize();
+  // vertices are also read by compute skinning
+  _engineState->setGeometryArena(
+      std::make_shared<BufferArena>(sizeof(Vertex3D), arenaVertices,
+                                    VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                    _engineState),
+      std::make_shared<BufferArena>(sizeof(uint32_t), arenaIndices, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, _engineState));
   _swapchain = std::make_shared<Swapchain>(_engineState);
   _timer = std::make_shared<Timer>();
+  _timer->setFixedTimestep(settings->getFixedTimestep());
   _timerFPSReal = std::make_shared<TimerFPS>();
   _timerFPSLimited = std::make_shared<TimerFPS>();
+  // compute passes share graphic queue unless async compute is enabled
+  _queueCompute = settings->getAsyncCompute() ? vkb::QueueType::compute : vkb::QueueType::graphics;
   auto loggerUtils = std::make_shared<LoggerUtils>(_engineState);
   loggerUtils->setName("Queue graphic", VkObjectType::VK_OBJECT_TYPE_QUEUE,
                        _engineState->getDevice()->getQueue(vkb::QueueType::graphics));
@@ -99,6 +120,24 @@ void Core::initialize() {
                                                            _engineState);
     loggerUtils->setName("Command buffer for render graphic", VkObjectType::VK_OBJECT_TYPE_COMMAND_BUFFER,
                          _commandBufferRender->getCommandBuffer());
+    // skybox is recorded from the main thread only, so it can share command pool with render command buffer
+    _commandBufferSkybox = std::make_shared<CommandBuffer>(
+        settings->getMaxFramesInFlight(), VK_COMMAND_BUFFER_LEVEL_SECONDARY, _commandPoolRender, _engineState);
+    loggerUtils->setName("Command buffer for skybox", VkObjectType::VK_OBJECT_TYPE_COMMAND_BUFFER,
+                         _commandBufferSkybox->getCommandBuffer());
+    // command pool can't be used from different threads simultaneously, so every chunk of drawables has own one
+    for (int i = 0; i < std::max(settings->getThreadsInPool(), 1); i++) {
+      auto commandPool = std::make_shared<CommandPool>(vkb::QueueType::graphics, _engineState->getDevice());
+      _commandPoolSecondary.push_back(commandPool);
+      for (auto type : {AlphaType::OPAQUE, AlphaType::TRANSPARENT}) {
+        auto commandBuffer = std::make_shared<CommandBuffer>(
+            settings->getMaxFramesInFlight(), VK_COMMAND_BUFFER_LEVEL_SECONDARY, commandPool, _engineState);
+        std::string typeName = type == AlphaType::OPAQUE ? "opaque" : "transparent";
+        loggerUtils->setName("Command buffer for " + typeName + " drawables " + std::to_string(i),
+                             VkObjectType::VK_OBJECT_TYPE_COMMAND_BUFFER, commandBuffer->getCommandBuffer());
+        _commandBufferSecondary[type].push_back(commandBuffer);
+      }
+    }
   }
   {
     _commandPoolApplication = std::make_shared<CommandPool>(vkb::QueueType::graphics, _engineState->getDevice());
@@ -107,6 +146,10 @@ void Core::initialize() {
                                                                 _commandPoolApplication, _engineState);
     loggerUtils->setName("Command buffer for appplication", VkObjectType::VK_OBJECT_TYPE_COMMAND_BUFFER,
                          _commandBufferApplication->getCommandBuffer());
+    _commandBufferModelGLTF = std::make_shared<CommandBuffer>(settings->getMaxFramesInFlight(), _commandPoolApplication,
+                                                              _engineState);
+    loggerUtils->setName("Command buffer for glTF models", VkObjectType::VK_OBJECT_TYPE_COMMAND_BUFFER,
+                         _commandBufferModelGLTF->getCommandBuffer());
   }
   {
     _commandPoolInitialize = std::make_shared<CommandPool>(vkb::QueueType::graphics, _engineState->getDevice());
@@ -123,14 +166,28 @@ void Core::initialize() {
                          _commandBufferEquirectangular->getCommandBuffer());
   }
   {
-    _commandPoolParticleSystem = std::make_shared<CommandPool>(vkb::QueueType::compute, _engineState->getDevice());
+    _commandPoolParticleSystem = std::make_shared<CommandPool>(_queueCompute, _engineState->getDevice());
     _commandBufferParticleSystem = std::make_shared<CommandBuffer>(settings->getMaxFramesInFlight(),
                                                                    _commandPoolParticleSystem, _engineState);
     loggerUtils->setName("Command buffer for particle system", VkObjectType::VK_OBJECT_TYPE_COMMAND_BUFFER,
                          _commandBufferParticleSystem->getCommandBuffer());
   }
   {
-    _commandPoolPostprocessing = std::make_shared<CommandPool>(vkb::QueueType::compute, _engineState->getDevice());
+    _commandPoolSkinning = std::make_shared<CommandPool>(vkb::QueueType::graphics, _engineState->getDevice());
+    _commandBufferSkinning = std::make_shared<CommandBuffer>(settings->getMaxFramesInFlight(), _commandPoolSkinning,
+                                                             _engineState);
+    loggerUtils->setName("Command buffer for skinning", VkObjectType::VK_OBJECT_TYPE_COMMAND_BUFFER,
+                         _commandBufferSkinning->getCommandBuffer());
+  }
+  {
+    _commandPoolShadows = std::make_shared<CommandPool>(vkb::QueueType::graphics, _engineState->getDevice());
+    _commandBufferShadows = std::make_shared<CommandBuffer>(settings->getMaxFramesInFlight(), _commandPoolShadows,
+                                                            _engineState);
+    loggerUtils->setName("Command buffer for shadows barriers", VkObjectType::VK_OBJECT_TYPE_COMMAND_BUFFER,
+                         _commandBufferShadows->getCommandBuffer());
+  }
+  {
+    _commandPoolPostprocessing = std::make_shared<CommandPool>(_queueCompute, _engineState->getDevice());
     _commandBufferPostprocessing = std::make_shared<CommandBuffer>(settings->getMaxFramesInFlight(),
                                                                    _commandPoolPostprocessing, _engineState);
     loggerUtils->setName("Command buffer for postprocessing", VkObjectType::VK_OBJECT_TYPE_COMMAND_BUFFER,
@@ -144,10 +201,8 @@ void Core::initialize() {
                          _commandBufferGUI->getCommandBuffer());
   }
 
-  _frameSubmitInfoPreCompute.resize(settings->getMaxFramesInFlight());
-  _frameSubmitInfoGraphic.resize(settings->getMaxFramesInFlight());
-  _frameSubmitInfoPostCompute.resize(settings->getMaxFramesInFlight());
-  _frameSubmitInfoDebug.resize(settings->getMaxFramesInFlight());
+  _capturePath.resize(settings->getMaxFramesInFlight());
+  _captureBuffer.resize(settings->getMaxFramesInFlight());
 
   _renderPassGraphic = _engineState->getRenderPassManager()->getRenderPass(RenderPassScenario::GRAPHIC);
   _renderPassShadowMap = _engineState->getRenderPassManager()->getRenderPass(RenderPassScenario::SHADOW);
@@ -167,22 +222,10 @@ void Core::initialize() {
     // graphic-presentation
     _semaphoreImageAvailable.push_back(std::make_shared<Semaphore>(_engineState->getDevice()));
     _semaphoreRenderFinished.push_back(std::make_shared<Semaphore>(_engineState->getDevice()));
-
-    // compute-graphic
-    _semaphoreParticleSystem.push_back(std::make_shared<Semaphore>(_engineState->getDevice()));
-    _semaphoreGUI.push_back(std::make_shared<Semaphore>(_engineState->getDevice()));
-
-    // postprocessing semaphore
-    _semaphorePostprocessing.push_back(std::make_shared<Semaphore>(_engineState->getDevice()));
-
-    // resources submit semaphore
-    _semaphoreResourcesReady.push_back(std::make_shared<Semaphore>(_engineState->getDevice()));
-    _waitSemaphoreResourcesReady[i] = false;
-
-    // application submit semaphore
-    _semaphoreApplicationReady.push_back(std::make_shared<Semaphore>(_engineState->getDevice()));
-    _waitSemaphoreApplicationReady[i] = false;
   }
+  // passes of frame and resources uploads are synchronized by timeline semaphores of frame graph
+  _frameGraph = std::make_shared<FrameGraph>(_engineState);
+  _uploadManager = std::make_shared<UploadManager>(_engineState);
 
   for (int i = 0; i < settings->getMaxFramesInFlight(); i++) {
     _fenceInFlight.push_back(std::make_shared<Fence>(_engineState->getDevice()));
@@ -194,46 +237,37 @@ void Core::initialize() {
   _gui->initialize(_commandBufferInitialize);
 
   _blurCompute = std::make_shared<BlurCompute>(_textureBlurIn, _textureBlurOut, _engineState);
+  _cullingCompute = std::make_shared<CullingCompute>(_engineState);
+  _skinningCompute = std::make_shared<SkinningCompute>(_engineState);
   // for postprocessing layout GENERAL is needed
   for (auto& imageView : _swapchain->getImageViews()) imageView->getImage()->overrideLayout(VK_IMAGE_LAYOUT_GENERAL);
 
   _postprocessing = std::make_shared<Postprocessing>(_textureRender, _textureBlurIn, _swapchain->getImageViews(),
                                                      _engineState);
-  // but we expect it to be in VK_IMAGE_LAYOUT_PRESENT_SRC_KHR as start value
+  // but we expect it to be in present layout as start value
   for (auto& imageView : _swapchain->getImageViews())
-    imageView->getImage()->changeLayout(VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+    imageView->getImage()->changeLayout(VK_IMAGE_LAYOUT_UNDEFINED, _swapchain->getPresentLayout(),
                                         VK_IMAGE_ASPECT_COLOR_BIT, 1, 1, _commandBufferInitialize);
   _engineState->getInput()->subscribe(std::dynamic_pointer_cast<InputSubscriberExclusive>(_gui));
 
   _pool = std::make_shared<BS::thread_pool>(settings->getThreadsInPool());
+  _animationSystem = std::make_shared<AnimationSystem>(_pool, _engineState);
 
-  _gameState = std::make_shared<GameState>(_commandBufferInitialize, _engineState);
+  _gameState = std::make_shared<GameState>(_commandBufferInitialize, _pool, _engineState);
 
   _commandBufferInitialize->endCommands();
 
   _initializeFramebuffer();
 
-  {
-    std::vector<VkSemaphore> signalSemaphoresInitialize = {
-        _semaphoreResourcesReady[_engineState->getFrameInFlight()]->getSemaphore()};
-    VkSubmitInfo submitInfo{
-        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-        .commandBufferCount = 1,
-        .pCommandBuffers = &_commandBufferInitialize->getCommandBuffer()[_engineState->getFrameInFlight()],
-        .signalSemaphoreCount = static_cast<uint32_t>(signalSemaphoresInitialize.size()),
-        .pSignalSemaphores = signalSemaphoresInitialize.data()};
-
-    auto queue = _engineState->getDevice()->getQueue(vkb::QueueType::graphics);
-    vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
-
-    _waitSemaphoreResourcesReady[_engineState->getFrameInFlight()] = true;
-  }
+  _frameGraph->submitExternal(vkb::QueueType::graphics, _commandBufferInitialize);
 }
 
 void Core::_computeParticles() {
   auto frameInFlight = _engineState->getFrameInFlight();
 
   _commandBufferParticleSystem->beginCommands();
+  _engineState->getProfilerGPU()->begin("Particles", _commandBufferParticleSystem);
+  _frameGraph->recordBarriers(_passParticles);
 
   // any read from SSBO should wait for write to SSBO
   // First dispatch writes to a storage buffer, second dispatch reads from that storage buffer.
@@ -245,17 +279,88 @@ void Core::_computeParticles() {
                        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,  // dstStageMask
                        0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
 
-  _loggerParticles->begin("Particle system compute " + std::to_string(_timer->getFrameCounter()),
-                          _commandBufferParticleSystem);
+  _loggerParticles->begin("Particle system compute", _commandBufferParticleSystem, _timer->getFrameCounter());
   for (auto& particleSystem : _particleSystem) {
     particleSystem->drawCompute(_commandBufferParticleSystem);
     particleSystem->updateTimer(_timer->getElapsedCurrent());
   }
   _loggerParticles->end(_commandBufferParticleSystem);
+  _engineState->getProfilerGPU()->end(_commandBufferParticleSystem);
+  _frameGraph->recordReleases(_passParticles);
   _commandBufferParticleSystem->endCommands();
 }
 
+void Core::_computeSkinning() {
+  _commandBufferSkinning->beginCommands();
+  _engineState->getProfilerGPU()->begin("Skinning", _commandBufferSkinning);
+  _frameGraph->recordBarriers(_passSkinning);
+  _skinningCompute->draw(_commandBufferSkinning);
+  _engineState->getProfilerGPU()->end(_commandBufferSkinning);
+  _frameGraph->recordReleases(_passSkinning);
+  _commandBufferSkinning->endCommands();
+}
+
+void Core::_markBoundsChanged(Drawable* drawable) {
+  for (auto& [_, bvh] : _bvhDrawable) bvh->markChanged(drawable);
+  _bvhShadowable->markChanged(drawable);
+  if (auto cullable = dynamic_cast<Cullable*>(drawable)) _cullingCompute->markChanged(cullable);
+}
+
+void Core::_updateBVH() {
+  for (auto& [_, bvh] : _bvhDrawable) bvh->update();
+  _bvhShadowable->update();
+}
+
+std::vector<std::shared_ptr<Drawable>> Core::_cullDrawables(AlphaType type,
+                                                            glm::mat4 viewProjection,
+                                                            CullingStatistic& culling) {
+  if (_engineState->getSettings()->getFrustumCulling() == false) {
+    culling.visible += _drawables[type].size();
+    return _drawables[type];
+  }
+
+  Frustum frustum(viewProjection);
+  std::vector<std::shared_ptr<Drawable>> visible = _drawablesUnbounded[type];
+  _bvhDrawable[type]->query(frustum, visible);
+  int visibleBounded = visible.size() - _drawablesUnbounded[type].size();
+  culling.visible += visible.size();
+  culling.culled += _bvhDrawable[type]->getSize() - visibleBounded;
+  return visible;
+}
+
+std::vector<std::shared_ptr<Shadowable>> Core::_cullShadowables(glm::mat4 viewProjection, CullingStatistic& culling) {
+  if (_engineState->getSettings()->getFrustumCulling() == false) {
+    culling.visible += _shadowables.size();
+    return _shadowables;
+  }
+
+  Frustum frustum(viewProjection);
+  std::vector<std::shared_ptr<Drawable>> visibleBounded;
+  _bvhShadowable->query(frustum, visibleBounded);
+  std::vector<std::shared_ptr<Shadowable>> visible = _shadowablesUnbounded;
+  for (auto& drawable : visibleBounded) visible.push_back(std::dynamic_pointer_cast<Shadowable>(drawable));
+  culling.visible += visible.size();
+  culling.culled += _bvhShadowable->getSize() - visibleBounded.size();
+  return visible;
+}
+
+void Core::_drawDrawables(const std::vector<std::shared_ptr<Drawable>>& drawables,
+                          int begin,
+                          int end,
+                          std::shared_ptr<CommandBuffer> commandBuffer) {
+  auto frameInFlight = _engineState->getFrameInFlight();
+  auto globalFrame = _timer->getFrameCounter();
+  commandBuffer->beginCommands(_renderPassGraphic->getRenderPass(), _frameBufferGraphic[frameInFlight]->getBuffer());
+  for (int i = begin; i < end; i++) {
+    _logger->begin(drawables[i]->getMarker(), commandBuffer, globalFrame);
+    drawables[i]->draw(commandBuffer);
+    _logger->end(commandBuffer);
+  }
+  commandBuffer->endCommands();
+}
+
 void Core::_drawShadowMapDirectional(int index) {
+  auto start = std::chrono::high_resolution_clock::now();
   auto frameInFlight = _engineState->getFrameInFlight();
   auto shadow = _gameState->getLightManager()->getDirectionalShadows()[index];
 
@@ -264,7 +369,8 @@ void Core::_drawShadowMapDirectional(int index) {
 
   // record command buffer
   commandBuffer->beginCommands();
-  loggerGPU->begin("Directional to depth buffer " + std::to_string(_timer->getFrameCounter()), commandBuffer);
+  _engineState->getProfilerGPU()->begin("Directional shadow", commandBuffer);
+  loggerGPU->begin("Directional to depth buffer", commandBuffer, _timer->getFrameCounter());
   //
   auto [widthFramebuffer, heightFramebuffer] = shadow->getShadowMapFramebuffer()[frameInFlight]->getResolution();
   VkClearValue clearDepth{.color = {1.f, 1.f, 1.f, 1.f}};
@@ -287,20 +393,25 @@ void Core::_drawShadowMapDirectional(int index) {
 
   // draw scene here
   auto globalFrame = _timer->getFrameCounter();
-  for (auto shadowable : _shadowables) {
-    loggerGPU->begin(shadowable->getName() + " to directional depth buffer " + std::to_string(globalFrame),
-                     commandBuffer);
+  auto camera = _gameState->getLightManager()->getDirectionalLights()[index]->getCamera();
+  CullingStatistic culling;
+  for (auto& shadowable : _cullShadowables(camera->getProjection() * camera->getView(), culling)) {
+    loggerGPU->begin(shadowable->getMarker(), commandBuffer, globalFrame);
     shadowable->drawShadow(LightType::DIRECTIONAL, index, 0, commandBuffer);
     loggerGPU->end(commandBuffer);
   }
+  _cullingDirectional[index] = culling;
   vkCmdEndRenderPass(commandBuffer->getCommandBuffer()[frameInFlight]);
   loggerGPU->end(commandBuffer);
+  _engineState->getProfilerGPU()->end(commandBuffer);
 
   // record command buffer
   commandBuffer->endCommands();
+  _addCPU("Shadow recording", start);
 }
 
 void Core::_drawShadowMapPoint(int index, int face) {
+  auto start = std::chrono::high_resolution_clock::now();
   auto frameInFlight = _engineState->getFrameInFlight();
   auto shadow = _gameState->getLightManager()->getPointShadows()[index];
 
@@ -308,7 +419,8 @@ void Core::_drawShadowMapPoint(int index, int face) {
   auto loggerGPU = shadow->getShadowMapLogger()[face];
   // record command buffer
   commandBuffer->beginCommands();
-  loggerGPU->begin("Point to depth buffer " + std::to_string(_timer->getFrameCounter()), commandBuffer);
+  _engineState->getProfilerGPU()->begin("Point shadow", commandBuffer);
+  loggerGPU->begin("Point to depth buffer", commandBuffer, _timer->getFrameCounter());
   auto [widthFramebuffer, heightFramebuffer] = shadow->getShadowMapFramebuffer()[frameInFlight][face]->getResolution();
   VkClearValue clearDepth{.color = {1.f, 1.f, 1.f, 1.f}};
   VkRenderPassBeginInfo renderPassInfo{
@@ -335,25 +447,32 @@ void Core::_drawShadowMapPoint(int index, int face) {
                  std::get<1>(_engineState->getSettings()->getResolution());
 
   // draw scene here
-  for (auto shadowable : _shadowables) {
-    loggerGPU->begin(shadowable->getName() + " to point depth buffer " + std::to_string(globalFrame), commandBuffer);
+  auto camera = _gameState->getLightManager()->getPointLights()[index]->getCamera();
+  CullingStatistic culling;
+  for (auto& shadowable : _cullShadowables(camera->getProjection() * camera->getView(face), culling)) {
+    loggerGPU->begin(shadowable->getMarker(), commandBuffer, globalFrame);
     shadowable->drawShadow(LightType::POINT, index, face, commandBuffer);
     loggerGPU->end(commandBuffer);
   }
+  _cullingPoint[index][face] = culling;
   vkCmdEndRenderPass(commandBuffer->getCommandBuffer()[frameInFlight]);
   loggerGPU->end(commandBuffer);
+  _engineState->getProfilerGPU()->end(commandBuffer);
 
   // record command buffer
   commandBuffer->endCommands();
+  _addCPU("Shadow recording", start);
 }
 
 void Core::_drawShadowMapPointBlur(std::shared_ptr<PointShadow> pointShadow, int face) {
+  auto start = std::chrono::high_resolution_clock::now();
   auto frameInFlight = _engineState->getFrameInFlight();
   auto commandBufferBlur = _blurGraphicPoint[pointShadow]->getShadowMapBlurCommandBuffer()[face];
   auto loggerGPU = _blurGraphicPoint[pointShadow]->getShadowMapBlurLogger()[face];
 
   commandBufferBlur->beginCommands();
-  loggerGPU->begin("Blur point " + std::to_string(_timer->getFrameCounter()), commandBufferBlur);
+  _engineState->getProfilerGPU()->begin("Shadow blur", commandBufferBlur);
+  loggerGPU->begin("Blur point", commandBufferBlur, _timer->getFrameCounter());
   auto [widthFramebuffer, heightFramebuffer] =
       _blurGraphicPoint[pointShadow]->getShadowMapBlurFramebuffer()[0][frameInFlight][face]->getResolution();
   VkClearValue clearDepth{.color = {0.f, 0.f, 0.f, 1.f}};
@@ -368,7 +487,7 @@ void Core::_drawShadowMapPointBlur(std::shared_ptr<PointShadow> pointShadow, int
       .pClearValues = &clearDepth};
   vkCmdBeginRenderPass(commandBufferBlur->getCommandBuffer()[frameInFlight], &renderPassInfo,
                        VK_SUBPASS_CONTENTS_INLINE);
-  loggerGPU->begin("Horizontal " + std::to_string(_timer->getFrameCounter()), commandBufferBlur);
+  loggerGPU->begin("Horizontal", commandBufferBlur, _timer->getFrameCounter());
   _blurGraphicPoint[pointShadow]->getBlur()[face]->draw(true, commandBufferBlur);
   loggerGPU->end(commandBufferBlur);
   vkCmdEndRenderPass(commandBufferBlur->getCommandBuffer()[frameInFlight]);
@@ -402,7 +521,7 @@ void Core::_drawShadowMapPointBlur(std::shared_ptr<PointShadow> pointShadow, int
       .pClearValues = &clearDepth};
   vkCmdBeginRenderPass(commandBufferBlur->getCommandBuffer()[frameInFlight], &renderPassInfo,
                        VK_SUBPASS_CONTENTS_INLINE);
-  loggerGPU->begin("Vertical " + std::to_string(_timer->getFrameCounter()), commandBufferBlur);
+  loggerGPU->begin("Vertical", commandBufferBlur, _timer->getFrameCounter());
   // Vertical blur
   _blurGraphicPoint[pointShadow]->getBlur()[face]->draw(false, commandBufferBlur);
   loggerGPU->end(commandBufferBlur);
@@ -431,16 +550,20 @@ void Core::_drawShadowMapPointBlur(std::shared_ptr<PointShadow> pointShadow, int
                          nullptr, 0, nullptr, 1, &imageMemoryBarrier);
   }
   loggerGPU->end(commandBufferBlur);
+  _engineState->getProfilerGPU()->end(commandBufferBlur);
   commandBufferBlur->endCommands();
+  _addCPU("Shadow recording", start);
 }
 
 void Core::_drawShadowMapDirectionalBlur(std::shared_ptr<DirectionalShadow> directionalShadow) {
+  auto start = std::chrono::high_resolution_clock::now();
   auto frameInFlight = _engineState->getFrameInFlight();
   auto commandBufferBlur = _blurGraphicDirectional[directionalShadow]->getShadowMapBlurCommandBuffer();
   auto loggerGPU = _blurGraphicDirectional[directionalShadow]->getShadowMapBlurLogger();
 
   commandBufferBlur->beginCommands();
-  loggerGPU->begin("Blur directional " + std::to_string(_timer->getFrameCounter()), commandBufferBlur);
+  _engineState->getProfilerGPU()->begin("Shadow blur", commandBufferBlur);
+  loggerGPU->begin("Blur directional", commandBufferBlur, _timer->getFrameCounter());
   auto [widthFramebuffer, heightFramebuffer] =
       _blurGraphicDirectional[directionalShadow]->getShadowMapBlurFramebuffer()[0][frameInFlight]->getResolution();
   VkClearValue clearDepth{.color = {0.f, 0.f, 0.f, 1.f}};
@@ -456,7 +579,7 @@ void Core::_drawShadowMapDirectionalBlur(std::shared_ptr<DirectionalShadow> dire
       .pClearValues = &clearDepth};
   vkCmdBeginRenderPass(commandBufferBlur->getCommandBuffer()[frameInFlight], &renderPassInfo,
                        VK_SUBPASS_CONTENTS_INLINE);
-  loggerGPU->begin("Horizontal " + std::to_string(_timer->getFrameCounter()), commandBufferBlur);
+  loggerGPU->begin("Horizontal", commandBufferBlur, _timer->getFrameCounter());
   _blurGraphicDirectional[directionalShadow]->getBlur()->draw(true, commandBufferBlur);
   loggerGPU->end(commandBufferBlur);
   vkCmdEndRenderPass(commandBufferBlur->getCommandBuffer()[frameInFlight]);
@@ -490,7 +613,7 @@ void Core::_drawShadowMapDirectionalBlur(std::shared_ptr<DirectionalShadow> dire
       .pClearValues = &clearDepth};
   vkCmdBeginRenderPass(commandBufferBlur->getCommandBuffer()[frameInFlight], &renderPassInfo,
                        VK_SUBPASS_CONTENTS_INLINE);
-  loggerGPU->begin("Vertical " + std::to_string(_timer->getFrameCounter()), commandBufferBlur);
+  loggerGPU->begin("Vertical", commandBufferBlur, _timer->getFrameCounter());
   // Vertical blur
   _blurGraphicDirectional[directionalShadow]->getBlur()->draw(false, commandBufferBlur);
   loggerGPU->end(commandBufferBlur);
@@ -519,20 +642,23 @@ void Core::_drawShadowMapDirectionalBlur(std::shared_ptr<DirectionalShadow> dire
                          nullptr, 0, nullptr, 1, &imageMemoryBarrier);
   }
   loggerGPU->end(commandBufferBlur);
+  _engineState->getProfilerGPU()->end(commandBufferBlur);
   commandBufferBlur->endCommands();
+  _addCPU("Shadow recording", start);
 }
 
 void Core::_computePostprocessing(int swapchainImageIndex) {
   auto frameInFlight = _engineState->getFrameInFlight();
 
   _commandBufferPostprocessing->beginCommands();
+  _engineState->getProfilerGPU()->begin("Postprocessing", _commandBufferPostprocessing);
+  _frameGraph->recordBarriers(_passPostprocessing);
   int bloomPasses = _engineState->getSettings()->getBloomPasses();
   // blur cycle:
   // in - out - horizontal
   // out - in - vertical
   for (int i = 0; i < bloomPasses; i++) {
-    _loggerPostprocessing->begin("Blur horizontal compute " + std::to_string(_timer->getFrameCounter()),
-                                 _commandBufferPostprocessing);
+    _loggerPostprocessing->begin("Blur horizontal compute", _commandBufferPostprocessing, _timer->getFrameCounter());
     _blurCompute->draw(true, _commandBufferPostprocessing);
     _loggerPostprocessing->end(_commandBufferPostprocessing);
 
@@ -559,8 +685,7 @@ void Core::_computePostprocessing(int swapchainImageIndex) {
       );
     }
 
-    _loggerPostprocessing->begin("Blur vertical compute " + std::to_string(_timer->getFrameCounter()),
-                                 _commandBufferPostprocessing);
+    _loggerPostprocessing->begin("Blur vertical compute", _commandBufferPostprocessing, _timer->getFrameCounter());
     _blurCompute->draw(false, _commandBufferPostprocessing);
     _loggerPostprocessing->end(_commandBufferPostprocessing);
 
@@ -590,7 +715,7 @@ void Core::_computePostprocessing(int swapchainImageIndex) {
   // wait dst image to be ready
   {
     VkImageMemoryBarrier colorBarrier{.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-                                      .oldLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                                      .oldLayout = _swapchain->getPresentLayout(),
                                       .newLayout = VK_IMAGE_LAYOUT_GENERAL,
                                       .image = _swapchain->getImageViews()[swapchainImageIndex]->getImage()->getImage(),
                                       .subresourceRange = {.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
@@ -607,10 +732,11 @@ void Core::_computePostprocessing(int swapchainImageIndex) {
     );
   }
 
-  _loggerPostprocessing->begin("Postprocessing compute " + std::to_string(_timer->getFrameCounter()),
-                               _commandBufferPostprocessing);
+  _loggerPostprocessing->begin("Postprocessing compute", _commandBufferPostprocessing, _timer->getFrameCounter());
   _postprocessing->drawCompute(frameInFlight, swapchainImageIndex, _commandBufferPostprocessing);
   _loggerPostprocessing->end(_commandBufferPostprocessing);
+  _engineState->getProfilerGPU()->end(_commandBufferPostprocessing);
+  _frameGraph->recordReleases(_passPostprocessing);
   _commandBufferPostprocessing->endCommands();
 }
 
@@ -618,6 +744,8 @@ void Core::_debugVisualizations(int swapchainImageIndex) {
   auto frameInFlight = _engineState->getFrameInFlight();
 
   _commandBufferGUI->beginCommands();
+  _engineState->getProfilerGPU()->begin("GUI", _commandBufferGUI);
+  _frameGraph->recordBarriers(_passGUI);
 
   auto [widthFramebuffer, heightFramebuffer] = _frameBufferDebug[swapchainImageIndex]->getResolution();
   VkClearValue clearColor{.color = _engineState->getSettings()->getClearColor()};
@@ -632,73 +760,104 @@ void Core::_debugVisualizations(int swapchainImageIndex) {
   // TODO: only one depth texture?
   vkCmdBeginRenderPass(_commandBufferGUI->getCommandBuffer()[frameInFlight], &renderPassInfo,
                        VK_SUBPASS_CONTENTS_INLINE);
-  _loggerDebug->begin("Render GUI " + std::to_string(_timer->getFrameCounter()), _commandBufferGUI);
+  _loggerDebug->begin("Render GUI", _commandBufferGUI, _timer->getFrameCounter());
   _gui->updateBuffers(frameInFlight);
   _gui->drawFrame(frameInFlight, _commandBufferGUI);
   _loggerDebug->end(_commandBufferGUI);
   vkCmdEndRenderPass(_commandBufferGUI->getCommandBuffer()[frameInFlight]);
+  if (_capturePath[frameInFlight].empty() == false) _recordCapture(swapchainImageIndex);
+  _engineState->getProfilerGPU()->end(_commandBufferGUI);
+  _frameGraph->recordReleases(_passGUI);
 
   _commandBufferGUI->endCommands();
 }
 
+void Core::_recordCapture(int swapchainImageIndex) {
+  auto frameInFlight = _engineState->getFrameInFlight();
+  auto image = _swapchain->getImageViews()[swapchainImageIndex]->getImage();
+  auto [width, height] = image->getResolution();
+  VkDeviceSize size = width * height * 4;
+  // buffer of current frame isn't used by GPU anymore, so it can be safely recreated
+  if (_captureBuffer[frameInFlight] == nullptr || _captureBuffer[frameInFlight]->getSize() < size) {
+    _captureBuffer[frameInFlight] = std::make_shared<Buffer>(
+        size, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT, _engineState);
+  }
+
+  auto commandBuffer = _commandBufferGUI->getCommandBuffer()[frameInFlight];
+  VkImageMemoryBarrier colorBarrier{.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                                    .srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                                    .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
+                                    .oldLayout = _swapchain->getPresentLayout(),
+                                    .newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                    .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                                    .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                                    .image = image->getImage(),
+                                    .subresourceRange = {.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                                                         .baseMipLevel = 0,
+                                                         .levelCount = 1,
+                                                         .baseArrayLayer = 0,
+                                                         .layerCount = 1}};
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                       0, nullptr, 0, nullptr, 1, &colorBarrier);
+
+  VkBufferImageCopy region{.bufferOffset = 0,
+                           .bufferRowLength = 0,
+                           .bufferImageHeight = 0,
+                           .imageSubresource = {.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                                                .mipLevel = 0,
+                                                .baseArrayLayer = 0,
+                                                .layerCount = 1},
+                           .imageOffset = {0, 0, 0},
+                           .imageExtent = {static_cast<uint32_t>(width), static_cast<uint32_t>(height), 1}};
+  vkCmdCopyImageToBuffer(commandBuffer, image->getImage(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                         _captureBuffer[frameInFlight]->getData(), 1, &region);
+
+  // image is returned to layout expected by present and the next frame, copied data is made visible to host
+  colorBarrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+  colorBarrier.dstAccessMask = 0;
+  colorBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+  colorBarrier.newLayout = _swapchain->getPresentLayout();
+  VkMemoryBarrier hostBarrier{.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                              .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                              .dstAccessMask = VK_ACCESS_HOST_READ_BIT};
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT | VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &hostBarrier, 0,
+                       nullptr, 1, &colorBarrier);
+}
+
+void Core::_writeCapture(int swapchainImageIndex) {
+  auto frameInFlight = _engineState->getFrameInFlight();
+  std::vector<VkFence> waitFences = {_fenceInFlight[frameInFlight]->getFence()};
+  auto result = vkWaitForFences(_engineState->getDevice()->getLogicalDevice(), waitFences.size(), waitFences.data(),
+                                VK_TRUE, UINT64_MAX);
+  if (result != VK_SUCCESS) throw std::runtime_error("Can't wait for fence");
+
+  auto image = _swapchain->getImageViews()[swapchainImageIndex]->getImage();
+  auto [width, height] = image->getResolution();
+  _captureBuffer[frameInFlight]->invalidate();
+  auto data = static_cast<uint8_t*>(_captureBuffer[frameInFlight]->getMappedMemory());
+  std::vector<uint8_t> pixels(data, data + width * height * 4);
+  bool swizzle = image->getFormat() == VK_FORMAT_B8G8R8A8_UNORM || image->getFormat() == VK_FORMAT_B8G8R8A8_SRGB;
+  for (int i = 0; i < width * height; i++) {
+    if (swizzle) std::swap(pixels[i * 4], pixels[i * 4 + 2]);
+    // swapchain alpha isn't meaningful, captured frame should be opaque
+    pixels[i * 4 + 3] = 255;
+  }
+  if (stbi_write_png(_capturePath[frameInFlight].c_str(), width, height, 4, pixels.data(), width * 4) == 0)
+    throw std::runtime_error("Can't write frame to " + _capturePath[frameInFlight]);
+  _capturePath[frameInFlight].clear();
+}
+
 void Core::_renderGraphic() {
+  auto start = std::chrono::high_resolution_clock::now();
   auto frameInFlight = _engineState->getFrameInFlight();
 
   // record command buffer
   _commandBufferRender->beginCommands();
-  /////////////////////////////////////////////////////////////////////////////////////////
-  // depth to screne barrier
-  /////////////////////////////////////////////////////////////////////////////////////////
-  // Image memory barrier to make sure that writes are finished before sampling from the texture
-  int directionalNum = _gameState->getLightManager()->getDirectionalLights().size();
-  int pointNum = _gameState->getLightManager()->getPointLights().size();
-  std::vector<VkImageMemoryBarrier> imageMemoryBarrier;
-  for (int i = 0; i < directionalNum; i++) {
-    if (_gameState->getLightManager()->getDirectionalShadows()[i]) {
-      VkImageMemoryBarrier barrier{.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-                                   .srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
-                                   .dstAccessMask = VK_ACCESS_SHADER_READ_BIT,
-                                   // We won't be changing the layout of the image
-                                   .oldLayout = VK_IMAGE_LAYOUT_GENERAL,
-                                   .newLayout = VK_IMAGE_LAYOUT_GENERAL,
-                                   .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                                   .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                                   .image = _gameState->getLightManager()
-                                                ->getDirectionalShadows()[i]
-                                                ->getShadowMapTexture()[frameInFlight]
-                                                ->getImageView()
-                                                ->getImage()
-                                                ->getImage(),
-                                   .subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1}};
-
-      imageMemoryBarrier.push_back(barrier);
-    }
-  }
-
-  for (int i = 0; i < pointNum; i++) {
-    if (_gameState->getLightManager()->getPointShadows()[i]) {
-      VkImageMemoryBarrier barrier{.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-                                   .srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
-                                   .dstAccessMask = VK_ACCESS_SHADER_READ_BIT,
-                                   .oldLayout = VK_IMAGE_LAYOUT_GENERAL,
-                                   .newLayout = VK_IMAGE_LAYOUT_GENERAL,
-                                   .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                                   .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                                   .image = _gameState->getLightManager()
-                                                ->getPointShadows()[i]
-                                                ->getShadowMapCubemap()[frameInFlight]
-                                                ->getTexture()
-                                                ->getImageView()
-                                                ->getImage()
-                                                ->getImage(),
-                                   .subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1}};
-
-      imageMemoryBarrier.push_back(barrier);
-    }
-  }
-  vkCmdPipelineBarrier(_commandBufferRender->getCommandBuffer()[frameInFlight],
-                       VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0,
-                       nullptr, 0, nullptr, imageMemoryBarrier.size(), imageMemoryBarrier.data());
+  _engineState->getProfilerGPU()->begin("Render", _commandBufferRender);
+  // shadow maps are sampled after they are written
+  _frameGraph->recordBarriers(_passRender);
 
   /////////////////////////////////////////////////////////////////////////////////////////
   // render graphic
@@ -717,63 +876,91 @@ void Core::_renderGraphic() {
                                        .pClearValues = clearColor.data()};
 
   auto globalFrame = _timer->getFrameCounter();
-  // TODO: only one depth texture?
-  vkCmdBeginRenderPass(_commandBufferRender->getCommandBuffer()[frameInFlight], &renderPassInfo,
-                       VK_SUBPASS_CONTENTS_INLINE);
-
-  _logger->begin("Render light " + std::to_string(globalFrame), _commandBufferRender);
+  _logger->begin("Render light", nullptr, globalFrame);
   _gameState->getLightManager()->draw(frameInFlight);
-  _logger->end(_commandBufferRender);
+  _logger->end();
 
   // draw scene here
-  for (auto& animation : _animations) {
-    _logger->begin("Update animation buffers " + std::to_string(globalFrame));
-    if (_futureAnimationUpdate[animation].valid()) {
-      _futureAnimationUpdate[animation].get();
-    }
-    animation->updateBuffers(_engineState->getFrameInFlight());
-    _logger->end();
-  }
+  // indirect draw commands have to be generated outside of render pass
+  auto camera = _gameState->getCameraManager()->getCurrentCamera();
+  auto viewProjection = camera->getProjection() * camera->getView();
+  _logger->begin("Cull instances", _commandBufferRender, globalFrame);
+  _cullingCompute->draw(viewProjection, _commandBufferRender);
+  _logger->end(_commandBufferRender);
+
+  // TODO: only one depth texture?
+  // all draw commands are recorded to secondary command buffers
+  vkCmdBeginRenderPass(_commandBufferRender->getCommandBuffer()[frameInFlight], &renderPassInfo,
+                       VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+  std::vector<VkCommandBuffer> secondaryBuffers;
 
   // should be draw first
   if (_skybox) {
-    _logger->begin("Render skybox " + std::to_string(globalFrame), _commandBufferRender);
-    _skybox->draw(_commandBufferRender);
-    _logger->end(_commandBufferRender);
-  }
-
-  for (auto& drawable : _drawables[AlphaType::OPAQUE]) {
-    // TODO: add getName() to drawable?
-    std::string drawableName = typeid(drawable.get()).name();
-    _logger->begin("Render " + drawable->getName() + " " + std::to_string(globalFrame), _commandBufferRender);
-    drawable->draw(_commandBufferRender);
-    _logger->end(_commandBufferRender);
+    _commandBufferSkybox->beginCommands(_renderPassGraphic->getRenderPass(),
+                                        _frameBufferGraphic[frameInFlight]->getBuffer());
+    _logger->begin("Render skybox", _commandBufferSkybox, globalFrame);
+    _skybox->draw(_commandBufferSkybox);
+    _logger->end(_commandBufferSkybox);
+    _commandBufferSkybox->endCommands();
+    secondaryBuffers.push_back(_commandBufferSkybox->getCommandBuffer()[frameInFlight]);
   }
 
-  std::sort(_drawables[AlphaType::TRANSPARENT].begin(), _drawables[AlphaType::TRANSPARENT].end(),
-            [camera = _gameState->getCameraManager()->getCurrentCamera()](std::shared_ptr<Drawable> left,
-                                                                          std::shared_ptr<Drawable> right) {
+  CullingStatistic culling;
+  std::map<AlphaType, std::vector<std::shared_ptr<Drawable>>> drawables;
+  drawables[AlphaType::OPAQUE] = _cullDrawables(AlphaType::OPAQUE, viewProjection, culling);
+  drawables[AlphaType::TRANSPARENT] = _cullDrawables(AlphaType::TRANSPARENT, viewProjection, culling);
+  std::sort(drawables[AlphaType::TRANSPARENT].begin(), drawables[AlphaType::TRANSPARENT].end(),
+            [camera](std::shared_ptr<Drawable> left, std::shared_ptr<Drawable> right) {
               return glm::distance(glm::vec3(left->getModel()[3]), camera->getEye()) >
                      glm::distance(glm::vec3(right->getModel()[3]), camera->getEye());
             });
-  for (auto& drawable : _drawables[AlphaType::TRANSPARENT]) {
-    _logger->begin("Render " + drawable->getName() + " " + std::to_string(globalFrame), _commandBufferRender);
-    drawable->draw(_commandBufferRender);
-    _logger->end(_commandBufferRender);
+  _cullingCamera = culling;
+
+  // every chunk is contiguous range of drawables and chunks are executed in order, so transparent drawables are still
+  // drawn back to front
+  int chunks = _commandPoolSecondary.size();
+  std::map<AlphaType, std::vector<std::pair<int, int>>> ranges;
+  for (auto type : {AlphaType::OPAQUE, AlphaType::TRANSPARENT}) {
+    int size = drawables[type].size();
+    int chunkSize = (size + chunks - 1) / chunks;
+    for (int i = 0; i < chunks; i++) {
+      int begin = std::min(i * chunkSize, size);
+      ranges[type].push_back({begin, std::min(begin + chunkSize, size)});
+    }
   }
 
-  // submit model3D update
-  for (auto& animation : _animations) {
-    _futureAnimationUpdate[animation] = _pool->submit([&, frame = globalFrame]() {
-      _logger->begin("Calculate animation joints " + std::to_string(frame));
-      // we want update model for next frame, current frame we can't touch and update because it will be used on GPU
-      animation->calculateJoints(_timer->getElapsedCurrent());
-      _logger->end();
-    });
+  auto drawChunk = [&](int chunk) {
+    for (auto type : {AlphaType::OPAQUE, AlphaType::TRANSPARENT}) {
+      auto [begin, end] = ranges[type][chunk];
+      if (begin < end) _drawDrawables(drawables[type], begin, end, _commandBufferSecondary[type][chunk]);
+    }
+  };
+  std::vector<std::future<void>> chunkFutures;
+  for (int i = 1; i < chunks; i++) chunkFutures.push_back(_pool->submit([&drawChunk, i]() { drawChunk(i); }));
+  // main thread records the first chunk itself instead of idle waiting
+  drawChunk(0);
+  for (auto& chunkFuture : chunkFutures) chunkFuture.get();
+
+  for (auto type : {AlphaType::OPAQUE, AlphaType::TRANSPARENT}) {
+    for (int i = 0; i < chunks; i++) {
+      auto [begin, end] = ranges[type][i];
+      if (begin < end) secondaryBuffers.push_back(_commandBufferSecondary[type][i]->getCommandBuffer()[frameInFlight]);
+    }
   }
+  if (secondaryBuffers.size() > 0)
+    vkCmdExecuteCommands(_commandBufferRender->getCommandBuffer()[frameInFlight], secondaryBuffers.size(),
+                         secondaryBuffers.data());
+
+  // submit model3D update, pose is evaluated for next frame, current frame's buffers are already written
+  _logger->begin("Calculate animation joints", nullptr, globalFrame);
+  _animationSystem->update(_timer->getElapsedCurrent());
+  _logger->end();
 
   vkCmdEndRenderPass(_commandBufferRender->getCommandBuffer()[frameInFlight]);
+  _engineState->getProfilerGPU()->end(_commandBufferRender);
+  _frameGraph->recordReleases(_passRender);
   _commandBufferRender->endCommands();
+  _addCPU("Render recording", start);
 }
 
 VkResult Core::_getImageIndex(uint32_t* imageIndex) {
@@ -782,21 +969,33 @@ VkResult Core::_getImageIndex(uint32_t* imageIndex) {
   auto result = vkWaitForFences(_engineState->getDevice()->getLogicalDevice(), waitFences.size(), waitFences.data(),
                                 VK_TRUE, UINT64_MAX);
   if (result != VK_SUCCESS) throw std::runtime_error("Can't wait for fence");
-
-  _frameSubmitInfoPreCompute[frameInFlight].clear();
-  _frameSubmitInfoGraphic[frameInFlight].clear();
-  _frameSubmitInfoPostCompute[frameInFlight].clear();
-  _frameSubmitInfoDebug[frameInFlight].clear();
-  // RETURNS ONLY INDEX, NOT IMAGE
-  // semaphore to signal, once image is available
-  result = vkAcquireNextImageKHR(_engineState->getDevice()->getLogicalDevice(), _swapchain->getSwapchain(), UINT64_MAX,
-                                 _semaphoreImageAvailable[frameInFlight]->getSemaphore(), VK_NULL_HANDLE, imageIndex);
-
-  if (result == VK_ERROR_OUT_OF_DATE_KHR) {
-    _reset();
-    return result;
-  } else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
-    throw std::runtime_error("failed to acquire swap chain image!");
+  // the latest submit signaling this fence was done maxFramesInFlight frames ago, all uploads recorded before it are
+  // executed
+  int maxFramesInFlight = _engineState->getSettings()->getMaxFramesInFlight();
+  if (_engineState->getFrame() >= maxFramesInFlight) {
+    _engineState->getStagingRing()->release(_engineState->getFrame() - maxFramesInFlight);
+    // meshes freed during that frame aren't read anymore, so their ranges can be reused
+    _engineState->getVertexArena()->release(_engineState->getFrame() - maxFramesInFlight);
+    _engineState->getIndexArena()->release(_engineState->getFrame() - maxFramesInFlight);
+  }
+  _engineState->getUniformRing()->reset(frameInFlight);
+
+  if (_engineState->getSettings()->getHeadless()) {
+    // offscreen image belongs to frame in flight, fence above guarantees it isn't used by GPU anymore
+    *imageIndex = frameInFlight;
+  } else {
+    // RETURNS ONLY INDEX, NOT IMAGE
+    // semaphore to signal, once image is available
+    result = vkAcquireNextImageKHR(_engineState->getDevice()->getLogicalDevice(), _swapchain->getSwapchain(),
+                                   UINT64_MAX, _semaphoreImageAvailable[frameInFlight]->getSemaphore(),
+                                   VK_NULL_HANDLE, imageIndex);
+
+    if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+      _reset();
+      return result;
+    } else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
+      throw std::runtime_error("failed to acquire swap chain image!");
+    }
   }
 
   // Only reset the fence if we are submitting work
@@ -820,7 +1019,7 @@ void Core::_reset() {
   for (auto& imageView : _swapchain->getImageViews()) imageView->getImage()->overrideLayout(VK_IMAGE_LAYOUT_GENERAL);
   _postprocessing->reset(_textureRender, _textureBlurIn, _swapchain->getImageViews());
   for (auto& imageView : _swapchain->getImageViews())
-    imageView->getImage()->changeLayout(VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+    imageView->getImage()->changeLayout(VK_IMAGE_LAYOUT_UNDEFINED, _swapchain->getPresentLayout(),
                                         VK_IMAGE_ASPECT_COLOR_BIT, 1, 1, _commandBufferInitialize);
   _gui->reset();
   _blurCompute->reset(_textureBlurIn, _textureBlurOut);
@@ -828,20 +1027,7 @@ void Core::_reset() {
   _commandBufferInitialize->endCommands();
 
   _initializeFramebuffer();
-  {
-    std::vector<VkSemaphore> signalSemaphoresInitialize = {
-        _semaphoreResourcesReady[_engineState->getFrameInFlight()]->getSemaphore()};
-    VkSubmitInfo submitInfo{
-        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-        .commandBufferCount = 1,
-        .pCommandBuffers = &_commandBufferInitialize->getCommandBuffer()[_engineState->getFrameInFlight()],
-        .signalSemaphoreCount = static_cast<uint32_t>(signalSemaphoresInitialize.size()),
-        .pSignalSemaphores = signalSemaphoresInitialize.data()};
-
-    auto queue = _engineState->getDevice()->getQueue(vkb::QueueType::graphics);
-    vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
-    _waitSemaphoreResourcesReady[_engineState->getFrameInFlight()] = true;
-  }
+  _frameGraph->submitExternal(vkb::QueueType::graphics, _commandBufferInitialize);
 
   _callbackReset(_swapchain->getSwapchain().extent.width, _swapchain->getSwapchain().extent.height);
 }
@@ -852,10 +1038,118 @@ void Core::_clearUnusedData() {
   _unusedDrawable[currentFrame].clear();
 }
 
+void Core::_declareFrameGraph(int swapchainImageIndex) {
+  auto frameInFlight = _engineState->getFrameInFlight();
+  bool headless = _engineState->getSettings()->getHeadless();
+  VkImageSubresourceRange range{.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                                .baseMipLevel = 0,
+                                .levelCount = 1,
+                                .baseArrayLayer = 0,
+                                .layerCount = VK_REMAINING_ARRAY_LAYERS};
+  _frameGraph->reset();
+
+  // particles are tracked as any memory, they are read by vertex input
+  _passParticles = _frameGraph->addPass("Particles", _queueCompute, {_commandBufferParticleSystem});
+  _frameGraph->addMemory(_passParticles, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT);
+
+  // skinned vertices are read by shadow and render passes, they are recorded in parallel without barriers, so skinning
+  // is on graphic queue before them and ends with own barrier to vertex input
+  _passSkinning = -1;
+  auto skinnedBuffers = _skinningCompute->getBuffers();
+  if (skinnedBuffers.size() > 0) {
+    _passSkinning = _frameGraph->addPass("Skinning", vkb::QueueType::graphics, {_commandBufferSkinning});
+    for (auto& buffer : skinnedBuffers)
+      _frameGraph->addBuffer(_passSkinning, buffer->getData(), VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             VK_ACCESS_SHADER_WRITE_BIT);
+  }
+
+  // shadow maps and their blur, barriers of the pass are recorded to the first command buffer
+  _passShadows = -1;
+  std::vector<std::shared_ptr<CommandBuffer>> commandBuffersShadow = {_commandBufferShadows};
+  std::vector<VkImage> shadowMaps;
+  for (auto& shadow : _gameState->getLightManager()->getDirectionalShadows()) {
+    if (shadow == nullptr) continue;
+    commandBuffersShadow.push_back(shadow->getShadowMapCommandBuffer());
+    if (_blurGraphicDirectional.find(shadow) != _blurGraphicDirectional.end())
+      commandBuffersShadow.push_back(_blurGraphicDirectional[shadow]->getShadowMapBlurCommandBuffer());
+    shadowMaps.push_back(shadow->getShadowMapTexture()[frameInFlight]->getImageView()->getImage()->getImage());
+  }
+  for (auto& shadow : _gameState->getLightManager()->getPointShadows()) {
+    if (shadow == nullptr) continue;
+    for (int i = 0; i < shadow->getShadowMapCommandBuffer().size(); i++) {
+      commandBuffersShadow.push_back(shadow->getShadowMapCommandBuffer()[i]);
+      if (_blurGraphicPoint.find(shadow) != _blurGraphicPoint.end())
+        commandBuffersShadow.push_back(_blurGraphicPoint[shadow]->getShadowMapBlurCommandBuffer()[i]);
+    }
+    shadowMaps.push_back(
+        shadow->getShadowMapCubemap()[frameInFlight]->getTexture()->getImageView()->getImage()->getImage());
+  }
+  if (commandBuffersShadow.size() > 1) {
+    _passShadows = _frameGraph->addPass("Shadows", vkb::QueueType::graphics, commandBuffersShadow);
+    for (auto shadowMap : shadowMaps)
+      _frameGraph->addImage(_passShadows, shadowMap, range, VK_IMAGE_LAYOUT_GENERAL,
+                            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+  }
+
+  auto textureRender = _textureRender[frameInFlight]->getImageView()->getImage()->getImage();
+  auto textureBloom = _textureBlurIn[frameInFlight]->getImageView()->getImage()->getImage();
+  auto swapchainImage = _swapchain->getImageViews()[swapchainImageIndex]->getImage()->getImage();
+
+  _passRender = _frameGraph->addPass("Render", vkb::QueueType::graphics, {_commandBufferRender});
+  _frameGraph->addMemory(_passRender, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT);
+  for (auto shadowMap : shadowMaps)
+    _frameGraph->addImage(_passRender, shadowMap, range, VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                          VK_ACCESS_SHADER_READ_BIT);
+  for (auto texture : {textureRender, textureBloom})
+    _frameGraph->addImage(_passRender, texture, range, VK_IMAGE_LAYOUT_GENERAL,
+                          VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+
+  _passPostprocessing = _frameGraph->addPass("Postprocessing", _queueCompute, {_commandBufferPostprocessing});
+  // offscreen images aren't acquired in headless mode
+  if (headless == false)
+    _frameGraph->addWait(_passPostprocessing, _semaphoreImageAvailable[frameInFlight]->getSemaphore(),
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+  _frameGraph->addImage(_passPostprocessing, textureRender, range, VK_IMAGE_LAYOUT_GENERAL,
+                        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+  _frameGraph->addImage(_passPostprocessing, textureBloom, range, VK_IMAGE_LAYOUT_GENERAL,
+                        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+  _frameGraph->addImage(_passPostprocessing, swapchainImage, range, VK_IMAGE_LAYOUT_GENERAL,
+                        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT);
+
+  _passGUI = _frameGraph->addPass("GUI", vkb::QueueType::graphics, {_commandBufferGUI});
+  // render pass of GUI transitions image to present layout itself
+  _frameGraph->addImage(_passGUI, swapchainImage, range, VK_IMAGE_LAYOUT_GENERAL,
+                        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                        VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+  // nothing is presented in headless mode
+  if (headless == false) _frameGraph->addSignal(_passGUI, _semaphoreRenderFinished[frameInFlight]->getSemaphore());
+
+  _frameGraph->compile();
+}
+
 void Core::_drawFrame(int imageIndex) {
   auto frameInFlight = _engineState->getFrameInFlight();
+  // fence of frame in flight has been already waited, so its previous queries can be read
+  _engineState->getProfilerGPU()->beginFrame();
+  if (_benchmark) {
+    for (auto& scope : _engineState->getProfilerGPU()->getResults())
+      if (scope.depth == 0) _benchmark->addGPU(scope.name, scope.milliseconds);
+  }
+  // finished uploads are submitted as external work, so passes of this frame wait for them
+  _uploadManager->update(_frameGraph);
+  // the same for models loaded by thread pool
+  _loadModelsGLTF();
+  // the latest evaluated pose becomes pose of frame before any pass is recorded, evaluation started by the previous
+  // frame isn't waited, bounds of animated models are changed by it
+  _logger->begin("Update animation buffers", nullptr, _timer->getFrameCounter());
+  _animationSystem->updateBuffers(frameInFlight);
+  _logger->end();
+  // passes are declared before recording, so recording threads know derived barriers
+  _declareFrameGraph(imageIndex);
   // submit compute particles
   auto particlesFuture = _pool->submit(std::bind(&Core::_computeParticles, this));
+  std::future<void> skinningFuture;
+  if (_passSkinning >= 0) skinningFuture = _pool->submit(std::bind(&Core::_computeSkinning, this));
 
   _gameState->getCameraManager()->update();
 
@@ -869,6 +1163,16 @@ void Core::_drawFrame(int imageIndex) {
   /////////////////////////////////////////////////////////////////////////////////////////
   std::vector<std::future<void>> shadowFutures;
   std::vector<std::future<void>> shadowBlurFutures;
+  // shadow passes are recorded in parallel, so prepare everything they share beforehand
+  _updateBVH();
+  if (_passShadows >= 0) {
+    // shadow maps are read only by render pass on the same queue, so there is nothing to release
+    _commandBufferShadows->beginCommands();
+    _frameGraph->recordBarriers(_passShadows);
+    _commandBufferShadows->endCommands();
+  }
+  _cullingDirectional.resize(_gameState->getLightManager()->getDirectionalShadows().size());
+  _cullingPoint.resize(_gameState->getLightManager()->getPointShadows().size());
   {
     auto shadows = _gameState->getLightManager()->getDirectionalShadows();
     for (int i = 0; i < shadows.size(); i++) {
@@ -900,7 +1204,7 @@ void Core::_drawFrame(int imageIndex) {
   /////////////////////////////////////////////////////////////////////////////////////////////////
   _renderGraphic();
 
-  // wait for shadow to complete before render
+  // wait for all passes to be recorded
   for (auto& shadowFuture : shadowFutures) {
     if (shadowFuture.valid()) {
       shadowFuture.get();
@@ -913,141 +1217,20 @@ void Core::_drawFrame(int imageIndex) {
     }
   }
 
-  // wait for particles to complete before render
   if (particlesFuture.valid()) particlesFuture.get();
-  // submit particles
-  VkSubmitInfo submitInfoCompute{.commandBufferCount = 1,
-                                 .pCommandBuffers = &_commandBufferParticleSystem->getCommandBuffer()[frameInFlight],
-                                 .signalSemaphoreCount = 1,
-                                 .pSignalSemaphores = &_semaphoreParticleSystem[frameInFlight]->getSemaphore()};
-  submitInfoCompute.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-  std::vector<VkPipelineStageFlags> waitStages;
-  std::vector<VkSemaphore> semaphoresWaitParticles;
-  if (_waitSemaphoreResourcesReady[frameInFlight]) {
-    waitStages.push_back(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
-    semaphoresWaitParticles.push_back(_semaphoreResourcesReady[frameInFlight]->getSemaphore());
-    _waitSemaphoreResourcesReady[_engineState->getFrameInFlight()] = false;
-  }
-  if (_waitSemaphoreApplicationReady[frameInFlight]) {
-    waitStages.push_back(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
-    semaphoresWaitParticles.push_back(_semaphoreApplicationReady[frameInFlight]->getSemaphore());
-    _waitSemaphoreApplicationReady[_engineState->getFrameInFlight()] = false;
-  }
-  if (semaphoresWaitParticles.size() > 0) {
-    submitInfoCompute.waitSemaphoreCount = semaphoresWaitParticles.size();
-    submitInfoCompute.pWaitSemaphores = semaphoresWaitParticles.data();
-    submitInfoCompute.pWaitDstStageMask = waitStages.data();
-  }
-
-  // end command buffer
-  _frameSubmitInfoPreCompute[frameInFlight].push_back(submitInfoCompute);
-
-  std::vector<VkCommandBuffer> shadowAndGraphicBuffers;
-  {
-    // binary wait structure
-    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_VERTEX_INPUT_BIT};
-
-    VkSubmitInfo submitInfo{.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-                            .waitSemaphoreCount = 1,
-                            .pWaitSemaphores = &_semaphoreParticleSystem[frameInFlight]->getSemaphore(),
-                            .pWaitDstStageMask = waitStages};
-    {
-      auto shadows = _gameState->getLightManager()->getDirectionalShadows();
-      for (int i = 0; i < shadows.size(); i++) {
-        if (shadows[i]) {
-          shadowAndGraphicBuffers.push_back(_gameState->getLightManager()
-                                                ->getDirectionalShadows()[i]
-                                                ->getShadowMapCommandBuffer()
-                                                ->getCommandBuffer()[frameInFlight]);
-          if (_blurGraphicDirectional.find(shadows[i]) != _blurGraphicDirectional.end())
-            shadowAndGraphicBuffers.push_back(_blurGraphicDirectional[shadows[i]]
-                                                  ->getShadowMapBlurCommandBuffer()
-                                                  ->getCommandBuffer()[frameInFlight]);
-        }
-      }
-    }
-    {
-      auto shadows = _gameState->getLightManager()->getPointShadows();
-      for (int i = 0; i < shadows.size(); i++) {
-        if (shadows[i]) {
-          auto shadowMap = shadows[i]->getShadowMapCommandBuffer();
-          for (int j = 0; j < shadowMap.size(); j++) {
-            shadowAndGraphicBuffers.push_back(shadowMap[j]->getCommandBuffer()[frameInFlight]);
-            if (_blurGraphicPoint.find(shadows[i]) != _blurGraphicPoint.end())
-              shadowAndGraphicBuffers.push_back(
-                  _blurGraphicPoint[shadows[i]]->getShadowMapBlurCommandBuffer()[j]->getCommandBuffer()[frameInFlight]);
-          }
-        }
-      }
-    }
-    shadowAndGraphicBuffers.push_back(_commandBufferRender->getCommandBuffer()[frameInFlight]);
-    submitInfo.commandBufferCount = shadowAndGraphicBuffers.size();
-    submitInfo.pCommandBuffers = shadowAndGraphicBuffers.data();
-    submitInfo.signalSemaphoreCount = 1;
-    submitInfo.pSignalSemaphores = &_semaphorePostprocessing[frameInFlight]->getSemaphore();
-
-    std::unique_lock<std::mutex> lock(_frameSubmitMutexGraphic);
-    _frameSubmitInfoGraphic[frameInFlight].push_back(submitInfo);
-  }
-  //////////////////////////////////////////////////////////////////////////////////////////////////
-  // Render compute postprocessing
-  //////////////////////////////////////////////////////////////////////////////////////////////////
-  std::vector<VkSemaphore> waitSemaphoresPostprocessing = {_semaphoreImageAvailable[frameInFlight]->getSemaphore(),
-                                                           _semaphorePostprocessing[frameInFlight]->getSemaphore()};
-  {
-    if (postprocessingFuture.valid()) postprocessingFuture.get();
-
-    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT};
-    VkSubmitInfo submitInfo{.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-                            .waitSemaphoreCount = static_cast<uint32_t>(waitSemaphoresPostprocessing.size()),
-                            .pWaitSemaphores = waitSemaphoresPostprocessing.data(),
-                            .pWaitDstStageMask = waitStages,
-                            .commandBufferCount = 1,
-                            .pCommandBuffers = &_commandBufferPostprocessing->getCommandBuffer()[frameInFlight],
-                            .signalSemaphoreCount = 1,
-                            .pSignalSemaphores = &_semaphoreGUI[frameInFlight]->getSemaphore()};
-
-    _frameSubmitInfoPostCompute[frameInFlight].push_back(submitInfo);
-  }
-
-  //////////////////////////////////////////////////////////////////////////////////////////////////
-  // Render debug visualization
-  //////////////////////////////////////////////////////////////////////////////////////////////////
-  {
-    if (debugVisualizationFuture.valid()) debugVisualizationFuture.get();
-
-    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT};
-    VkSubmitInfo submitInfo{.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-                            .waitSemaphoreCount = 1,
-                            .pWaitSemaphores = &_semaphoreGUI[frameInFlight]->getSemaphore(),
-                            .pWaitDstStageMask = waitStages,
-                            .commandBufferCount = 1,
-                            .pCommandBuffers = &_commandBufferGUI->getCommandBuffer()[frameInFlight],
-                            .signalSemaphoreCount = 1,
-                            .pSignalSemaphores = &_semaphoreRenderFinished[frameInFlight]->getSemaphore()};
-
-    _frameSubmitInfoDebug[frameInFlight].push_back(submitInfo);
-  }
-
-  // because of binary semaphores, we can't submit task with semaphore wait BEFORE task with semaphore signal.
-  // that's why we have to split submit pipeline.
-  vkQueueSubmit(_engineState->getDevice()->getQueue(vkb::QueueType::compute),
-                _frameSubmitInfoPreCompute[frameInFlight].size(), _frameSubmitInfoPreCompute[frameInFlight].data(),
-                VK_NULL_HANDLE);
-  vkQueueSubmit(_engineState->getDevice()->getQueue(vkb::QueueType::graphics),
-                _frameSubmitInfoGraphic[frameInFlight].size(), _frameSubmitInfoGraphic[frameInFlight].data(),
-                VK_NULL_HANDLE);
-  vkQueueSubmit(_engineState->getDevice()->getQueue(vkb::QueueType::compute),
-                _frameSubmitInfoPostCompute[frameInFlight].size(), _frameSubmitInfoPostCompute[frameInFlight].data(),
-                VK_NULL_HANDLE);
-  // latest graphic job should signal fence about completion, otherwise render signal that it's done, but debug still in
-  // progress (for 0 frame) and we submit new frame with 0 index
-  vkQueueSubmit(_engineState->getDevice()->getQueue(vkb::QueueType::graphics),
-                _frameSubmitInfoDebug[frameInFlight].size(), _frameSubmitInfoDebug[frameInFlight].data(),
-                _fenceInFlight[frameInFlight]->getFence());
+  if (skinningFuture.valid()) skinningFuture.get();
+  if (postprocessingFuture.valid()) postprocessingFuture.get();
+  if (debugVisualizationFuture.valid()) debugVisualizationFuture.get();
+
+  // the whole frame is submitted at once, the latest pass signals fence about completion
+  auto start = std::chrono::high_resolution_clock::now();
+  _frameGraph->submit(_fenceInFlight[frameInFlight]->getFence());
+  _addCPU("Submit", start);
+  _engineState->getProfilerGPU()->endFrame();
 }
 
 void Core::_displayFrame(uint32_t* imageIndex) {
+  if (_engineState->getSettings()->getHeadless()) return;
   auto frameInFlight = _engineState->getFrameInFlight();
 
   std::vector<VkSemaphore> waitSemaphoresPresent = {_semaphoreRenderFinished[frameInFlight]->getSemaphore()};
@@ -1076,28 +1259,52 @@ void Core::draw() {
 #ifdef __ANDROID__
   {
 #else
-  while (!glfwWindowShouldClose((GLFWwindow*)(_engineState->getWindow()->getWindow()))) {
-    glfwPollEvents();
+  bool headless = _engineState->getSettings()->getHeadless();
+  while (headless || !glfwWindowShouldClose((GLFWwindow*)(_engineState->getWindow()->getWindow()))) {
+    if (headless == false) glfwPollEvents();
 #endif
+    auto startFrame = std::chrono::high_resolution_clock::now();
     _timer->tick();
     _timerFPSReal->tick();
     _timerFPSLimited->tick();
     _engineState->setFrameInFlight(_timer->getFrameCounter() % _engineState->getSettings()->getMaxFramesInFlight());
+    _engineState->setFrame(_timer->getFrameCounter());
 
     // business/application update loop callback
     uint32_t imageIndex;
+    auto start = std::chrono::high_resolution_clock::now();
     while (_getImageIndex(&imageIndex) != VK_SUCCESS)
       ;
+    _addCPU("Acquire", start);
     // clear removed entities: drawables and shadowables
     _clearUnusedData();
     // application update, can be anything
+    start = std::chrono::high_resolution_clock::now();
     _callbackUpdate();
+    _addCPU("Update", start);
+    _engineState->getProfilerGPU()->drawOverlay(_gui);
+    _capturePath[_engineState->getFrameInFlight()] = _captureRequest;
+    _captureRequest.clear();
     // render scene
     _drawFrame(imageIndex);
+    if (_capturePath[_engineState->getFrameInFlight()].empty() == false) _writeCapture(imageIndex);
     _timerFPSReal->tock();
     // if GPU frames are limited by driver it will happen during display
+    start = std::chrono::high_resolution_clock::now();
     _displayFrame(&imageIndex);
+    _addCPU("Present", start);
+    _addCPU("Frame", startFrame);
+    if (_benchmark) _benchmark->nextFrame();
+    ProfilerCPU::nextFrame();
 
+#ifndef __ANDROID__
+    // in headless mode application drives frames by itself, so no FPS limit is applied
+    if (headless) {
+      _timer->tock();
+      _timerFPSLimited->tock();
+      return;
+    }
+#endif
     _timer->sleep(_engineState->getSettings()->getDesiredFPS());
     _timer->tock();
     _timerFPSLimited->tock();
@@ -1107,6 +1314,39 @@ void Core::draw() {
 #endif
 }
 
+void Core::saveFrame(std::string path) {
+  auto format = _swapchain->getImageViews()[0]->getImage()->getFormat();
+  std::set<VkFormat> supported = {VK_FORMAT_R8G8B8A8_UNORM, VK_FORMAT_R8G8B8A8_SRGB, VK_FORMAT_B8G8R8A8_UNORM,
+                                  VK_FORMAT_B8G8R8A8_SRGB};
+  if (supported.contains(format) == false)
+    throw std::runtime_error("Frame capture of swapchain format isn't supported");
+  _captureRequest = path;
+}
+
+void Core::waitIdle() { vkDeviceWaitIdle(_engineState->getDevice()->getLogicalDevice()); }
+
+void Core::setBenchmark(std::shared_ptr<Benchmark> benchmark) {
+  _benchmark = benchmark;
+  // GPU time of passes is taken from profiler
+  if (benchmark) _engineState->getProfilerGPU()->setEnabled(true);
+}
+
+void Core::runBenchmark(int frames, std::string path) {
+  // first frames are affected by pipeline and resources warm up
+  for (int i = 0; i < _engineState->getSettings()->getMaxFramesInFlight() * 4; i++) draw();
+  auto benchmark = std::make_shared<Benchmark>();
+  setBenchmark(benchmark);
+  for (int i = 0; i < frames; i++) draw();
+  waitIdle();
+  setBenchmark(nullptr);
+  benchmark->save(path);
+}
+
+void Core::_addCPU(const char* stage, std::chrono::high_resolution_clock::time_point start) {
+  ProfilerCPU::complete(stage, start);
+  if (_benchmark) _benchmark->addCPU(stage, start);
+}
+
 void Core::registerUpdate(std::function<void()> update) { _callbackUpdate = update; }
 
 void Core::registerReset(std::function<void(int width, int height)> reset) { _callbackReset = reset; }
@@ -1115,20 +1355,7 @@ void Core::startRecording() { _commandBufferApplication->beginCommands(); }
 
 void Core::endRecording() {
   _commandBufferApplication->endCommands();
-  {
-    std::vector<VkSemaphore> signalSemaphores = {
-        _semaphoreApplicationReady[_engineState->getFrameInFlight()]->getSemaphore()};
-    VkSubmitInfo submitInfo{
-        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-        .commandBufferCount = 1,
-        .pCommandBuffers = &_commandBufferApplication->getCommandBuffer()[_engineState->getFrameInFlight()],
-        .signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size()),
-        .pSignalSemaphores = signalSemaphores.data()};
-
-    auto queue = _engineState->getDevice()->getQueue(vkb::QueueType::graphics);
-    vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
-    _waitSemaphoreApplicationReady[_engineState->getFrameInFlight()] = true;
-  }
+  _frameGraph->submitExternal(vkb::QueueType::graphics, _commandBufferApplication);
 }
 
 void Core::setCamera(std::shared_ptr<Camera> camera) { _gameState->getCameraManager()->setCurrentCamera(camera); }
@@ -1138,10 +1365,40 @@ void Core::addDrawable(std::shared_ptr<Drawable> drawable, AlphaType type) {
 
   auto position = std::find(_drawables[type].begin(), _drawables[type].end(), drawable);
   // add only if doesn't exist already
-  if (position == _drawables[type].end()) _drawables[type].push_back(drawable);
+  if (position == _drawables[type].end()) {
+    _drawables[type].push_back(drawable);
+    if (_bvhDrawable[type]->add(drawable) == false) _drawablesUnbounded[type].push_back(drawable);
+    drawable->registerTransformChange([this, pointer = drawable.get()]() { _markBoundsChanged(pointer); });
+    // instances are culled on GPU and drawn with indirect commands
+    auto cullable = std::dynamic_pointer_cast<Cullable>(drawable);
+    if (cullable && _engineState->getSettings()->getIndirectCulling()) {
+      _cullingCompute->add(cullable);
+      cullable->setCulling(_cullingCompute);
+    }
+    // the same skinned vertices are used by drawable and shadowable parts of object
+    auto skinnable = std::dynamic_pointer_cast<Skinnable>(drawable);
+    if (skinnable && _engineState->getSettings()->getComputeSkinning()) {
+      _skinningCompute->add(skinnable);
+      skinnable->setSkinning(_skinningCompute);
+    }
+  }
 }
 
-void Core::addShadowable(std::shared_ptr<Shadowable> shadowable) { _shadowables.push_back(shadowable); }
+void Core::addShadowable(std::shared_ptr<Shadowable> shadowable) {
+  _shadowables.push_back(shadowable);
+  auto drawable = std::dynamic_pointer_cast<Drawable>(shadowable);
+  // shadowable without bounds is never culled
+  if (drawable == nullptr || _bvhShadowable->add(drawable) == false) {
+    _shadowablesUnbounded.push_back(shadowable);
+  } else {
+    drawable->registerTransformChange([this, pointer = drawable.get()]() { _markBoundsChanged(pointer); });
+  }
+  auto skinnable = std::dynamic_pointer_cast<Skinnable>(shadowable);
+  if (skinnable && _engineState->getSettings()->getComputeSkinning()) {
+    _skinningCompute->add(skinnable);
+    skinnable->setSkinning(_skinningCompute);
+  }
+}
 
 void Core::addSkybox(std::shared_ptr<Skybox> skybox) { _skybox = skybox; }
 
@@ -1153,13 +1410,25 @@ void Core::addParticleSystem(std::shared_ptr<ParticleSystem> particleSystem) {
 void Core::removeDrawable(std::shared_ptr<Drawable> drawable) {
   if (drawable == nullptr) return;
 
-  for (auto& [_, drawableVector] : _drawables) {
+  for (auto& [type, drawableVector] : _drawables) {
     auto position = std::find(drawableVector.begin(), drawableVector.end(), drawable);
     // we can remove this object only after current frame on GPU ends processing
     if (position != drawableVector.end()) {
       _unusedDrawable[(_engineState->getFrameInFlight() + 1) % _engineState->getSettings()->getMaxFramesInFlight()]
           .push_back(*position);
       drawableVector.erase(position);
+      _bvhDrawable[type]->remove(drawable);
+      std::erase(_drawablesUnbounded[type], drawable);
+      if (auto cullable = std::dynamic_pointer_cast<Cullable>(drawable)) {
+        _cullingCompute->remove(cullable);
+        cullable->setCulling(nullptr);
+      }
+      // object falls back to skinning in vertex shaders
+      if (auto skinnable = std::dynamic_pointer_cast<Skinnable>(drawable)) {
+        _skinningCompute->remove(skinnable);
+        skinnable->setSkinning(nullptr);
+      }
+      _unregisterTransformChange(drawable);
       break;
     }
   }
@@ -1174,9 +1443,26 @@ void Core::removeShadowable(std::shared_ptr<Shadowable> shadowable) {
     _unusedShadowable[(_engineState->getFrameInFlight() + 1) % _engineState->getSettings()->getMaxFramesInFlight()]
         .push_back(*position);
     _shadowables.erase(position);
+    _bvhShadowable->remove(std::dynamic_pointer_cast<Drawable>(shadowable));
+    std::erase(_shadowablesUnbounded, shadowable);
+    if (auto skinnable = std::dynamic_pointer_cast<Skinnable>(shadowable)) {
+      _skinningCompute->remove(skinnable);
+      skinnable->setSkinning(nullptr);
+    }
+    if (auto drawable = std::dynamic_pointer_cast<Drawable>(shadowable)) _unregisterTransformChange(drawable);
   }
 }
 
+void Core::_unregisterTransformChange(std::shared_ptr<Drawable> drawable) {
+  // callback captures Core, so it's reset once object isn't drawn by Core at all, object can outlive Core
+  for (auto& [_, drawableVector] : _drawables) {
+    if (std::find(drawableVector.begin(), drawableVector.end(), drawable) != drawableVector.end()) return;
+  }
+  auto shadowable = std::dynamic_pointer_cast<Shadowable>(drawable);
+  if (shadowable && std::find(_shadowables.begin(), _shadowables.end(), shadowable) != _shadowables.end()) return;
+  drawable->registerTransformChange(nullptr);
+}
+
 std::shared_ptr<ImageCPU<uint8_t>> Core::loadImageCPU(std::string path) {
   return _gameState->getResourceManager()->loadImageCPU<uint8_t>(path);
 }
@@ -1192,29 +1478,76 @@ std::shared_ptr<Texture> Core::createTexture(std::string path, VkFormat format,
   return texture;
 }
 
+void Core::createTextureAsync(std::string path,
+                              VkFormat format,
+                              int mipMapLevels,
+                              std::function<void(std::shared_ptr<Texture>)> callback) {
+  _pool->push_task([this, path, format, mipMapLevels, callback]() {
+    _uploadManager->uploadTexture(loadImageGPU(loadImageCPU(path)), format, VK_SAMPLER_ADDRESS_MODE_REPEAT,
+                                  mipMapLevels, VK_FILTER_LINEAR, callback);
+  });
+}
+
 std::shared_ptr<Cubemap> Core::createCubemap(std::vector<std::string> paths, VkFormat format, int mipMapLevels) {
-  std::vector<std::shared_ptr<ImageCPU<uint8_t>>> images;
-  for (auto path : paths) {
-    images.push_back(loadImageCPU(path));
-  }
+  // faces are decoded in parallel
+  auto images = _gameState->getResourceManager()->loadImageCPU<uint8_t>(paths);
   return std::make_shared<Cubemap>(
       _gameState->getResourceManager()->loadImageGPU<uint8_t>(images), format, mipMapLevels, VK_IMAGE_ASPECT_COLOR_BIT,
       VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_FILTER_LINEAR,
       _commandBufferApplication, _engineState);
 }
 
-std::shared_ptr<ModelGLTF> Core::createModelGLTF(std::string path) {
-  auto model = _gameState->getResourceManager()->loadModel(path, _commandBufferApplication);
+void Core::_addMaterials(std::shared_ptr<ModelGLTF> model) {
   _materials.insert(model->getMaterialsColor().begin(), model->getMaterialsColor().end());
   _materials.insert(model->getMaterialsPhong().begin(), model->getMaterialsPhong().end());
   _materials.insert(model->getMaterialsPBR().begin(), model->getMaterialsPBR().end());
+}
+
+void Core::_loadModelsGLTF() {
+  decltype(_scenesGLTF) scenes;
+  {
+    std::unique_lock<std::mutex> lock(_mutexScenesGLTF);
+    std::swap(scenes, _scenesGLTF);
+  }
+  if (scenes.size() == 0) return;
+
+  std::vector<std::tuple<std::shared_ptr<ModelGLTF>, std::shared_ptr<std::promise<std::shared_ptr<ModelGLTF>>>>>
+      models;
+  _commandBufferModelGLTF->beginCommands();
+  for (auto& [scene, promise] : scenes) {
+    try {
+      auto model = _gameState->getResourceManager()->loadModelGPU(scene, _commandBufferModelGLTF);
+      _addMaterials(model);
+      models.push_back({model, promise});
+    } catch (...) {
+      promise->set_exception(std::current_exception());
+    }
+  }
+  _commandBufferModelGLTF->endCommands();
+  _frameGraph->submitExternal(vkb::QueueType::graphics, _commandBufferModelGLTF);
+  // passes of this frame wait for submitted upload, so model can be drawn right away
+  for (auto& [model, promise] : models) promise->set_value(model);
+}
+
+std::shared_ptr<ModelGLTF> Core::createModelGLTF(std::string path) {
+  auto model = _gameState->getResourceManager()->loadModel(path, _commandBufferApplication);
+  _addMaterials(model);
   return model;
 }
 
+std::future<std::shared_ptr<ModelGLTF>> Core::createModelGLTFAsync(std::string path) {
+  auto promise = std::make_shared<std::promise<std::shared_ptr<ModelGLTF>>>();
+  _gameState->getResourceManager()->loadModelCPU(path, _pool, [this, promise](std::shared_ptr<SceneGLTF> scene) {
+    std::unique_lock<std::mutex> lock(_mutexScenesGLTF);
+    _scenesGLTF.push_back({scene, promise});
+  });
+  return promise->get_future();
+}
+
 std::shared_ptr<Animation> Core::createAnimation(std::shared_ptr<ModelGLTF> modelGLTF) {
   auto animation = std::make_shared<Animation>(modelGLTF->getNodes(), modelGLTF->getSkins(), modelGLTF->getAnimations(),
                                                _engineState);
-  _animations.push_back(animation);
+  _animationSystem->add(animation);
   return animation;
 }
 
@@ -1256,6 +1589,14 @@ std::shared_ptr<Shape3D> Core::createShape3D(ShapeType shapeType, VkCullModeFlag
   return std::make_shared<Shape3D>(shapeType, mesh, cullMode, _commandBufferApplication, _gameState, _engineState);
 }
 
+std::shared_ptr<Shape3D> Core::createShape3DInstanced(ShapeType shapeType,
+                                                     std::vector<glm::mat4> instances,
+                                                     VkCullModeFlagBits cullMode) {
+  auto shape = createShape3D(shapeType, cullMode);
+  shape->setInstances(instances);
+  return shape;
+}
+
 std::shared_ptr<Shape3D> Core::createCapsule(float height, float radius, VkCullModeFlagBits cullMode) {
   auto mesh = std::make_shared<MeshCapsule>(height, radius, _commandBufferApplication, _engineState);
   return std::make_shared<Shape3D>(ShapeType::CAPSULE, mesh, cullMode, _commandBufferApplication, _gameState,
@@ -1267,6 +1608,13 @@ std::shared_ptr<Model3D> Core::createModel3D(std::shared_ptr<ModelGLTF> modelGLT
                                    _engineState);
 }
 
+std::shared_ptr<Model3D> Core::createModel3DInstanced(std::shared_ptr<ModelGLTF> modelGLTF,
+                                                     std::vector<glm::mat4> instances) {
+  auto model = createModel3D(modelGLTF);
+  model->setInstances(instances);
+  return model;
+}
+
 std::shared_ptr<Sprite> Core::createSprite() {
   return std::make_shared<Sprite>(_commandBufferApplication, _gameState, _engineState);
 }
@@ -1346,6 +1694,8 @@ std::shared_ptr<CommandBuffer> Core::getCommandBufferApplication() { return _com
 
 std::shared_ptr<ResourceManager> Core::getResourceManager() { return _gameState->getResourceManager(); }
 
+std::shared_ptr<UploadManager> Core::getUploadManager() { return _uploadManager; }
+
 const std::vector<std::shared_ptr<Drawable>>& Core::getDrawables(AlphaType type) { return _drawables[type]; }
 
 std::vector<std::shared_ptr<PointLight>> Core::getPointLights() {
@@ -1376,4 +1726,36 @@ std::shared_ptr<Camera> Core::getCamera() { return _gameState->getCameraManager(
 
 std::shared_ptr<GUI> Core::getGUI() { return _gui; }
 
-std::tuple<int, int> Core::getFPS() { return {_timerFPSLimited->getFPS(), _timerFPSReal->getFPS()}; }
\ No newline at end of file
+std::tuple<int, int> Core::getFPS() { return {_timerFPSLimited->getFPS(), _timerFPSReal->getFPS()}; }
+
+std::optional<std::tuple<std::shared_ptr<Drawable>, glm::vec3>> Core::getHit(glm::vec2 cursorPosition) {
+  auto camera = _gameState->getCameraManager()->getCurrentCamera();
+  // cursor -> NDC -> view space -> world space, same as in TerrainPhysics::getHit
+  glm::vec2 normalizedScreen = glm::vec2(
+      (2.0f * cursorPosition.x) / std::get<0>(_engineState->getSettings()->getResolution()) - 1.0f,
+      1.0f - (2.0f * cursorPosition.y) / std::get<1>(_engineState->getSettings()->getResolution()));
+  glm::vec4 clipSpacePos = glm::vec4(normalizedScreen, -1.0f, 1.0f);
+  glm::vec4 viewSpacePos = glm::inverse(camera->getProjection()) * clipSpacePos;
+  viewSpacePos = glm::vec4(viewSpacePos.x, viewSpacePos.y, -1.0f, 0.0f);
+  glm::vec3 direction = glm::normalize(glm::vec3(glm::inverse(camera->getView()) * viewSpacePos));
+  glm::vec3 origin = glm::vec3(glm::inverse(camera->getView())[3]);
+
+  // transforms could be changed in update callback after the latest frame
+  _updateBVH();
+  std::optional<std::tuple<std::shared_ptr<Drawable>, float>> closest = std::nullopt;
+  for (auto& [_, bvh] : _bvhDrawable) {
+    auto hit = bvh->intersect(origin, direction);
+    if (hit.has_value() && (closest.has_value() == false || std::get<1>(hit.value()) < std::get<1>(closest.value())))
+      closest = hit;
+  }
+  if (closest.has_value() == false || std::get<1>(closest.value()) > camera->getFar()) return std::nullopt;
+
+  auto [drawable, distance] = closest.value();
+  return std::tuple{drawable, origin + distance * direction};
+}
+
+CullingStatistic Core::getCullingCamera() { return _cullingCamera; }
+
+const std::vector<CullingStatistic>& Core::getCullingDirectional() { return _cullingDirectional; }
+
+const std::vector<std::array<CullingStatistic, 6>>& Core::getCullingPoint() { return _cullingPoint; }
\ No newline at end of file
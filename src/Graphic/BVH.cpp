@@ -0,0 +1,231 @@
+#include "Graphic/BVH.h"
+
+float BVH::_getSurfaceArea(glm::vec3 min, glm::vec3 max) {
+  glm::vec3 size = max - min;
+  return 2.f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+std::optional<float> BVH::_intersectRay(glm::vec3 origin, glm::vec3 directionInverse, glm::vec3 min, glm::vec3 max) {
+  glm::vec3 t0 = (min - origin) * directionInverse;
+  glm::vec3 t1 = (max - origin) * directionInverse;
+  glm::vec3 tMin = glm::min(t0, t1);
+  glm::vec3 tMax = glm::max(t0, t1);
+  float enter = std::max(std::max(tMin.x, tMin.y), std::max(tMin.z, 0.f));
+  float exit = std::min(std::min(tMax.x, tMax.y), tMax.z);
+  if (enter > exit) return std::nullopt;
+  return enter;
+}
+
+BVH::BVH(float margin) { _margin = margin; }
+
+int BVH::_allocateNode() {
+  if (_freeNodes.size() > 0) {
+    int index = _freeNodes.back();
+    _freeNodes.pop_back();
+    return index;
+  }
+  _nodes.push_back(Node());
+  return _nodes.size() - 1;
+}
+
+void BVH::_freeNode(int index) {
+  _nodes[index] = Node();
+  _freeNodes.push_back(index);
+}
+
+void BVH::_refit(int index) {
+  while (index != -1) {
+    int left = _nodes[index].left;
+    int right = _nodes[index].right;
+    _nodes[index].min = glm::min(_nodes[left].min, _nodes[right].min);
+    _nodes[index].max = glm::max(_nodes[left].max, _nodes[right].max);
+    index = _nodes[index].parent;
+  }
+}
+
+void BVH::_insertLeaf(int leaf) {
+  if (_root == -1) {
+    _root = leaf;
+    _nodes[leaf].parent = -1;
+    return;
+  }
+
+  // go down choosing child with the lowest surface area increase (surface area heuristic)
+  glm::vec3 leafMin = _nodes[leaf].min;
+  glm::vec3 leafMax = _nodes[leaf].max;
+  int sibling = _root;
+  while (_nodes[sibling].left != -1) {
+    float area = _getSurfaceArea(_nodes[sibling].min, _nodes[sibling].max);
+    float combinedArea = _getSurfaceArea(glm::min(_nodes[sibling].min, leafMin),
+                                         glm::max(_nodes[sibling].max, leafMax));
+    // cost of creating new parent for this node and the new leaf
+    float cost = 2.f * combinedArea;
+    // minimum cost of pushing the leaf further down the tree
+    float inheritanceCost = 2.f * (combinedArea - area);
+    auto getChildCost = [&](int child) {
+      float childArea = _getSurfaceArea(glm::min(_nodes[child].min, leafMin), glm::max(_nodes[child].max, leafMax));
+      if (_nodes[child].left != -1) childArea -= _getSurfaceArea(_nodes[child].min, _nodes[child].max);
+      return childArea + inheritanceCost;
+    };
+    float costLeft = getChildCost(_nodes[sibling].left);
+    float costRight = getChildCost(_nodes[sibling].right);
+    if (cost < costLeft && cost < costRight) break;
+
+    sibling = costLeft < costRight ? _nodes[sibling].left : _nodes[sibling].right;
+  }
+
+  // _nodes can be reallocated here, so don't keep references to nodes
+  int parentOld = _nodes[sibling].parent;
+  int parentNew = _allocateNode();
+  _nodes[parentNew].parent = parentOld;
+  _nodes[parentNew].left = sibling;
+  _nodes[parentNew].right = leaf;
+  _nodes[sibling].parent = parentNew;
+  _nodes[leaf].parent = parentNew;
+  if (parentOld == -1) {
+    _root = parentNew;
+  } else if (_nodes[parentOld].left == sibling) {
+    _nodes[parentOld].left = parentNew;
+  } else {
+    _nodes[parentOld].right = parentNew;
+  }
+
+  _refit(parentNew);
+}
+
+void BVH::_removeLeaf(int leaf) {
+  if (leaf == _root) {
+    _root = -1;
+    return;
+  }
+
+  int parent = _nodes[leaf].parent;
+  int grandParent = _nodes[parent].parent;
+  int sibling = _nodes[parent].left == leaf ? _nodes[parent].right : _nodes[parent].left;
+  _nodes[sibling].parent = grandParent;
+  if (grandParent == -1) {
+    _root = sibling;
+  } else {
+    if (_nodes[grandParent].left == parent) {
+      _nodes[grandParent].left = sibling;
+    } else {
+      _nodes[grandParent].right = sibling;
+    }
+    _refit(grandParent);
+  }
+  _nodes[leaf].parent = -1;
+  _freeNode(parent);
+}
+
+bool BVH::_setLeafBounds(int leaf) {
+  auto drawable = _nodes[leaf].drawable;
+  auto aabb = drawable->getAABB();
+  if (aabb == nullptr) return false;
+
+  aabb = aabb->transform(drawable->getModel());
+  _nodes[leaf].minLeaf = aabb->getMin();
+  _nodes[leaf].maxLeaf = aabb->getMax();
+  return true;
+}
+
+bool BVH::add(std::shared_ptr<Drawable> drawable) {
+  if (drawable == nullptr || drawable->getAABB() == nullptr) return false;
+  if (_leaves.find(drawable.get()) != _leaves.end()) return true;
+
+  int leaf = _allocateNode();
+  _nodes[leaf].drawable = drawable;
+  _setLeafBounds(leaf);
+  _nodes[leaf].min = _nodes[leaf].minLeaf - glm::vec3(_margin);
+  _nodes[leaf].max = _nodes[leaf].maxLeaf + glm::vec3(_margin);
+  _insertLeaf(leaf);
+  _leaves[drawable.get()] = leaf;
+  return true;
+}
+
+void BVH::remove(std::shared_ptr<Drawable> drawable) {
+  auto position = _leaves.find(drawable.get());
+  if (position == _leaves.end()) return;
+
+  _removeLeaf(position->second);
+  _freeNode(position->second);
+  _leaves.erase(position);
+}
+
+bool BVH::contains(std::shared_ptr<Drawable> drawable) { return _leaves.find(drawable.get()) != _leaves.end(); }
+
+int BVH::getSize() { return _leaves.size(); }
+
+void BVH::markChanged(Drawable* drawable) {
+  std::unique_lock<std::mutex> lock(_changedMutex);
+  _changed.insert(drawable);
+}
+
+void BVH::update() {
+  std::unique_lock<std::mutex> lock(_changedMutex);
+  for (auto drawable : _changed) {
+    auto position = _leaves.find(drawable);
+    // drawable can be already removed from tree
+    if (position == _leaves.end()) continue;
+
+    int leaf = position->second;
+    if (_setLeafBounds(leaf) == false) continue;
+    // enlarged bounds still contain the exact ones, tree stays the same
+    if (glm::all(glm::greaterThanEqual(_nodes[leaf].minLeaf, _nodes[leaf].min)) &&
+        glm::all(glm::lessThanEqual(_nodes[leaf].maxLeaf, _nodes[leaf].max)))
+      continue;
+
+    _removeLeaf(leaf);
+    _nodes[leaf].min = _nodes[leaf].minLeaf - glm::vec3(_margin);
+    _nodes[leaf].max = _nodes[leaf].maxLeaf + glm::vec3(_margin);
+    _insertLeaf(leaf);
+  }
+  _changed.clear();
+}
+
+void BVH::query(Frustum& frustum, std::vector<std::shared_ptr<Drawable>>& result) {
+  if (_root == -1) return;
+
+  std::vector<int> stack = {_root};
+  while (stack.size() > 0) {
+    int index = stack.back();
+    stack.pop_back();
+    auto& node = _nodes[index];
+    if (node.left == -1) {
+      if (frustum.intersect(node.minLeaf, node.maxLeaf)) result.push_back(node.drawable);
+      continue;
+    }
+
+    if (frustum.intersect(node.min, node.max) == false) continue;
+    stack.push_back(node.left);
+    stack.push_back(node.right);
+  }
+}
+
+std::optional<std::tuple<std::shared_ptr<Drawable>, float>> BVH::intersect(glm::vec3 origin, glm::vec3 direction) {
+  if (_root == -1) return std::nullopt;
+
+  // division by 0 gives inf which is handled correctly by slab test
+  glm::vec3 directionInverse = 1.f / direction;
+  std::optional<std::tuple<std::shared_ptr<Drawable>, float>> closest = std::nullopt;
+  std::vector<int> stack = {_root};
+  while (stack.size() > 0) {
+    int index = stack.back();
+    stack.pop_back();
+    auto& node = _nodes[index];
+    bool isLeaf = node.left == -1;
+    auto distance = isLeaf ? _intersectRay(origin, directionInverse, node.minLeaf, node.maxLeaf)
+                           : _intersectRay(origin, directionInverse, node.min, node.max);
+    if (distance.has_value() == false) continue;
+    // there is already closer hit
+    if (closest.has_value() && std::get<1>(closest.value()) <= distance.value()) continue;
+
+    if (isLeaf) {
+      closest = std::tuple{node.drawable, distance.value()};
+    } else {
+      stack.push_back(node.left);
+      stack.push_back(node.right);
+    }
+  }
+
+  return closest;
+}
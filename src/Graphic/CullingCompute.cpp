@@ -0,0 +1,247 @@
+#include "Graphic/CullingCompute.h"
+
+struct ObjectIndirect {
+  glm::vec4 minPoint;
+  glm::vec4 maxPoint;
+  alignas(16) int firstCommand;
+  int commandCount;
+};
+
+struct InstanceIndirect {
+  glm::mat4 model;
+  alignas(16) int object;
+};
+
+struct CullingPush {
+  std::array<glm::vec4, 6> planes;
+  int instanceCount;
+};
+
+CullingCompute::CullingCompute(std::shared_ptr<EngineState> engineState) {
+  _engineState = engineState;
+  int framesInFlight = _engineState->getSettings()->getMaxFramesInFlight();
+  _changed.resize(framesInFlight, true);
+  _changedObjects.resize(framesInFlight);
+  _commands.resize(framesInFlight);
+  _slots.resize(framesInFlight);
+  _instanceCount.resize(framesInFlight, 0);
+  _objectBuffer.resize(framesInFlight);
+  _instanceBuffer.resize(framesInFlight);
+  _commandBuffer.resize(framesInFlight);
+  _visibleBuffer.resize(framesInFlight);
+
+  _descriptorSetLayoutCompute = std::make_shared<DescriptorSetLayout>(_engineState->getDevice());
+  std::vector<VkDescriptorSetLayoutBinding> layoutCompute(4);
+  for (int i = 0; i < layoutCompute.size(); i++) {
+    layoutCompute[i] = {.binding = static_cast<uint32_t>(i),
+                        .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                        .descriptorCount = 1,
+                        .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+                        .pImmutableSamplers = nullptr};
+  }
+  _descriptorSetLayoutCompute->createCustom(layoutCompute);
+  _descriptorSetCompute = std::make_shared<DescriptorSet>(framesInFlight, _descriptorSetLayoutCompute, _engineState);
+
+  // the same as InstanceBuffer layout, so visible instances can be bound instead of drawable's ones
+  _descriptorSetLayoutVisible = std::make_shared<DescriptorSetLayout>(_engineState->getDevice());
+  std::vector<VkDescriptorSetLayoutBinding> layoutVisible{{.binding = 0,
+                                                           .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                                           .descriptorCount = 1,
+                                                           .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+                                                           .pImmutableSamplers = nullptr}};
+  _descriptorSetLayoutVisible->createCustom(layoutVisible);
+  _descriptorSetVisible = std::make_shared<DescriptorSet>(framesInFlight, _descriptorSetLayoutVisible, _engineState);
+
+  auto shader = std::make_shared<Shader>(_engineState);
+  shader->add("shaders/culling/culling_compute.spv", VK_SHADER_STAGE_COMPUTE_BIT);
+  std::map<std::string, VkPushConstantRange> pushConstants;
+  pushConstants["compute"] = VkPushConstantRange{
+      .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT, .offset = 0, .size = sizeof(CullingPush)};
+  _pipeline = std::make_shared<PipelineCompute>(_engineState->getDevice());
+  _pipeline->createCustom(shader->getShaderStageInfo(VK_SHADER_STAGE_COMPUTE_BIT),
+                          {{"culling", _descriptorSetLayoutCompute}}, pushConstants);
+}
+
+void CullingCompute::_update(int currentFrame) {
+  std::vector<ObjectIndirect> objects;
+  std::vector<InstanceIndirect> instances;
+  _commands[currentFrame].clear();
+  _slots[currentFrame].clear();
+  for (auto& object : _objects) {
+    auto aabb = object->getInstanceAABB();
+    auto commands = object->getDrawCommands();
+    if (aabb == nullptr || commands.size() == 0) continue;
+
+    auto matrices = object->getInstanceMatrices();
+    int objectIndex = objects.size();
+    objects.push_back(ObjectIndirect{.minPoint = glm::vec4(aabb->getMin(), 1.f),
+                                     .maxPoint = glm::vec4(aabb->getMax(), 1.f),
+                                     .firstCommand = static_cast<int>(_commands[currentFrame].size()),
+                                     .commandCount = static_cast<int>(commands.size())});
+    _slots[currentFrame][object.get()] = Slot{.object = objectIndex,
+                                              .firstCommand = static_cast<int>(_commands[currentFrame].size()),
+                                              .commandCount = static_cast<int>(commands.size()),
+                                              .firstInstance = static_cast<int>(instances.size()),
+                                              .instanceCount = static_cast<int>(matrices.size())};
+    // every object has own range in visible instances buffer, gl_InstanceIndex includes firstInstance
+    for (auto& command : commands) {
+      command.instanceCount = 0;
+      command.firstInstance = instances.size();
+      _commands[currentFrame].push_back(command);
+    }
+    for (auto& matrix : matrices) instances.push_back(InstanceIndirect{.model = matrix, .object = objectIndex});
+  }
+  _instanceCount[currentFrame] = instances.size();
+
+  // buffers of current frame aren't used by GPU anymore, so they can be safely recreated
+  auto allocate = [&](std::shared_ptr<Buffer>& buffer, VkDeviceSize size, VkBufferUsageFlags usage) {
+    if (buffer && buffer->getSize() >= size) return;
+    buffer = std::make_shared<Buffer>(size, usage,
+                                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                      _engineState);
+  };
+  allocate(_objectBuffer[currentFrame], sizeof(ObjectIndirect) * std::max(objects.size(), size_t(1)),
+           VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+  allocate(_instanceBuffer[currentFrame], sizeof(InstanceIndirect) * std::max(instances.size(), size_t(1)),
+           VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+  allocate(_commandBuffer[currentFrame],
+           sizeof(VkDrawIndexedIndirectCommand) * std::max(_commands[currentFrame].size(), size_t(1)),
+           VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+  allocate(_visibleBuffer[currentFrame], sizeof(glm::mat4) * std::max(instances.size(), size_t(1)),
+           VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+  if (objects.size() > 0)
+    _objectBuffer[currentFrame]->setData(objects.data(), sizeof(ObjectIndirect) * objects.size());
+  if (instances.size() > 0)
+    _instanceBuffer[currentFrame]->setData(instances.data(), sizeof(InstanceIndirect) * instances.size());
+
+  std::map<int, std::vector<VkDescriptorBufferInfo>> bufferInfo;
+  int binding = 0;
+  for (auto& buffer : {_objectBuffer[currentFrame], _instanceBuffer[currentFrame], _commandBuffer[currentFrame],
+                       _visibleBuffer[currentFrame]}) {
+    bufferInfo[binding++] = {{.buffer = buffer->getData(), .offset = 0, .range = buffer->getSize()}};
+  }
+  _descriptorSetCompute->createCustom(currentFrame, bufferInfo, {});
+  std::map<int, std::vector<VkDescriptorBufferInfo>> bufferInfoVisible = {
+      {0,
+       {{.buffer = _visibleBuffer[currentFrame]->getData(),
+         .offset = 0,
+         .range = _visibleBuffer[currentFrame]->getSize()}}}};
+  _descriptorSetVisible->createCustom(currentFrame, bufferInfoVisible, {});
+  _changed[currentFrame] = false;
+}
+
+bool CullingCompute::_updateObject(Cullable* object, int currentFrame) {
+  auto aabb = object->getInstanceAABB();
+  auto commands = object->getDrawCommands();
+  auto position = _slots[currentFrame].find(object);
+  // object without draws isn't stored
+  if (position == _slots[currentFrame].end()) return aabb == nullptr || commands.size() == 0;
+
+  auto& slot = position->second;
+  auto matrices = object->getInstanceMatrices();
+  if (aabb == nullptr || commands.size() != slot.commandCount || matrices.size() != slot.instanceCount) return false;
+
+  // buffers of current frame aren't used by GPU anymore, so ranges of object are overwritten in place
+  ObjectIndirect objectIndirect{.minPoint = glm::vec4(aabb->getMin(), 1.f),
+                                .maxPoint = glm::vec4(aabb->getMax(), 1.f),
+                                .firstCommand = slot.firstCommand,
+                                .commandCount = slot.commandCount};
+  _objectBuffer[currentFrame]->setData(&objectIndirect, sizeof(ObjectIndirect), sizeof(ObjectIndirect) * slot.object);
+  for (int i = 0; i < commands.size(); i++) {
+    commands[i].instanceCount = 0;
+    commands[i].firstInstance = slot.firstInstance;
+    _commands[currentFrame][slot.firstCommand + i] = commands[i];
+  }
+  std::vector<InstanceIndirect> instances;
+  for (auto& matrix : matrices) instances.push_back(InstanceIndirect{.model = matrix, .object = slot.object});
+  if (instances.size() > 0)
+    _instanceBuffer[currentFrame]->setData(instances.data(), sizeof(InstanceIndirect) * instances.size(),
+                                           sizeof(InstanceIndirect) * slot.firstInstance);
+  return true;
+}
+
+void CullingCompute::add(std::shared_ptr<Cullable> object) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  if (std::find(_objects.begin(), _objects.end(), object) != _objects.end()) return;
+  _objects.push_back(object);
+  for (int i = 0; i < _changed.size(); i++) _changed[i] = true;
+}
+
+void CullingCompute::remove(std::shared_ptr<Cullable> object) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  if (std::erase(_objects, object) == 0) return;
+  for (int i = 0; i < _changed.size(); i++) {
+    _changed[i] = true;
+    _changedObjects[i].erase(object.get());
+  }
+}
+
+void CullingCompute::markChanged(Cullable* object) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  auto position = std::find_if(_objects.begin(), _objects.end(),
+                               [object](std::shared_ptr<Cullable> current) { return current.get() == object; });
+  if (position == _objects.end()) return;
+  for (int i = 0; i < _changedObjects.size(); i++) _changedObjects[i].insert(object);
+}
+
+void CullingCompute::draw(glm::mat4 viewProjection, std::shared_ptr<CommandBuffer> commandBuffer) {
+  int currentFrame = _engineState->getFrameInFlight();
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_changed[currentFrame] == false) {
+      for (auto object : _changedObjects[currentFrame]) {
+        if (_updateObject(object, currentFrame) == false) {
+          _changed[currentFrame] = true;
+          break;
+        }
+      }
+    }
+    if (_changed[currentFrame]) _update(currentFrame);
+    _changedObjects[currentFrame].clear();
+  }
+  if (_instanceCount[currentFrame] == 0) return;
+
+  // reset instance counters, compute shader increments them for every visible instance
+  _commandBuffer[currentFrame]->setData(_commands[currentFrame].data(),
+                                        sizeof(VkDrawIndexedIndirectCommand) * _commands[currentFrame].size());
+
+  vkCmdBindPipeline(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_BIND_POINT_COMPUTE,
+                    _pipeline->getPipeline());
+  vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_BIND_POINT_COMPUTE,
+                          _pipeline->getPipelineLayout(), 0, 1,
+                          &_descriptorSetCompute->getDescriptorSets()[currentFrame], 0, nullptr);
+
+  CullingPush pushConstants{.planes = Frustum(viewProjection).getPlanes(),
+                            .instanceCount = _instanceCount[currentFrame]};
+  auto info = _pipeline->getPushConstants()["compute"];
+  vkCmdPushConstants(commandBuffer->getCommandBuffer()[currentFrame], _pipeline->getPipelineLayout(), info.stageFlags,
+                     info.offset, info.size, &pushConstants);
+  vkCmdDispatch(commandBuffer->getCommandBuffer()[currentFrame],
+                std::max(1, (int)std::ceil(_instanceCount[currentFrame] / 64.f)), 1, 1);
+
+  // draw commands are read by indirect draws and visible matrices by vertex shaders
+  VkMemoryBarrier barrier{.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                          .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+                          .dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT};
+  vkCmdPipelineBarrier(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, 0, 1, &barrier, 0,
+                       nullptr, 0, nullptr);
+}
+
+std::shared_ptr<DescriptorSet> CullingCompute::getDescriptorSetInstances() { return _descriptorSetVisible; }
+
+bool CullingCompute::contains(Cullable* object) {
+  int currentFrame = _engineState->getFrameInFlight();
+  return _slots[currentFrame].find(object) != _slots[currentFrame].end();
+}
+
+void CullingCompute::drawIndirect(Cullable* object,
+                                  int command,
+                                  int count,
+                                  std::shared_ptr<CommandBuffer> commandBuffer) {
+  int currentFrame = _engineState->getFrameInFlight();
+  int firstCommand = _slots[currentFrame].at(object).firstCommand;
+  vkCmdDrawIndexedIndirect(commandBuffer->getCommandBuffer()[currentFrame], _commandBuffer[currentFrame]->getData(),
+                           sizeof(VkDrawIndexedIndirectCommand) * (firstCommand + command), count,
+                           sizeof(VkDrawIndexedIndirectCommand));
+}
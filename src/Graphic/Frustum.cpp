@@ -0,0 +1,28 @@
+#include "Graphic/Frustum.h"
+
+Frustum::Frustum(glm::mat4 viewProjection) {
+  // glm is column major, so row i is (m[0][i], m[1][i], m[2][i], m[3][i])
+  auto row = [&](int i) {
+    return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+  };
+  // left, right, bottom, top, near, far; depth is in [0, 1] range (GLM_FORCE_DEPTH_ZERO_TO_ONE)
+  _planes = {row(3) + row(0), row(3) - row(0), row(3) + row(1), row(3) - row(1), row(2), row(3) - row(2)};
+  for (auto& plane : _planes) {
+    plane /= glm::length(glm::vec3(plane));
+  }
+}
+
+const std::array<glm::vec4, 6>& Frustum::getPlanes() { return _planes; }
+
+bool Frustum::intersect(std::shared_ptr<AABB> aabb) { return intersect(aabb->getMin(), aabb->getMax()); }
+
+bool Frustum::intersect(glm::vec3 min, glm::vec3 max) {
+  for (auto& plane : _planes) {
+    // take the box corner which is the furthest along plane normal, if it's outside the whole box is outside
+    glm::vec3 positive = {plane.x >= 0.f ? max.x : min.x, plane.y >= 0.f ? max.y : min.y,
+                          plane.z >= 0.f ? max.z : min.z};
+    if (glm::dot(glm::vec3(plane), positive) + plane.w < 0.f) return false;
+  }
+
+  return true;
+}
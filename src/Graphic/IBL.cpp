@@ -263,12 +263,12 @@ void IBL::_draw(int face,
 
   _cameraBufferCubemap[face][currentFrame]->setData(&cameraUBO);
 
-  VkBuffer vertexBuffers[] = {_mesh3D->getVertexBuffer()->getBuffer()->getData()};
+  VkBuffer vertexBuffers[] = {_mesh3D->getVertexBuffer()->getData()};
   VkDeviceSize offsets[] = {0};
   vkCmdBindVertexBuffers(commandBuffer->getCommandBuffer()[currentFrame], 0, 1, vertexBuffers, offsets);
 
   vkCmdBindIndexBuffer(commandBuffer->getCommandBuffer()[currentFrame],
-                       _mesh3D->getIndexBuffer()->getBuffer()->getData(), 0, VK_INDEX_TYPE_UINT32);
+                       _mesh3D->getIndexBuffer()->getData(), 0, VK_INDEX_TYPE_UINT32);
 
   auto pipelineLayout = pipeline->getDescriptorSetLayout();
   auto cameraLayout = std::find_if(pipelineLayout.begin(), pipelineLayout.end(),
@@ -282,7 +282,8 @@ void IBL::_draw(int face,
   }
 
   vkCmdDrawIndexed(commandBuffer->getCommandBuffer()[currentFrame],
-                   static_cast<uint32_t>(_mesh3D->getIndexData().size()), 1, 0, 0, 0);
+                   static_cast<uint32_t>(_mesh3D->getIndexData().size()), 1, _mesh3D->getIndexOffset(),
+                   _mesh3D->getVertexOffset(), 0);
 }
 
 void IBL::drawSpecular() {
@@ -0,0 +1,82 @@
+#include "Graphic/SkinningCompute.h"
+#include "Primitive/Mesh.h"
+
+struct SkinningPush {
+  int vertexOffset;
+  int vertexCount;
+};
+
+// compute shader reads vertices as floats with hardcoded offsets of attributes
+static_assert(sizeof(Vertex3D) == 23 * sizeof(float), "skinning.comp has to be updated");
+
+SkinningCompute::SkinningCompute(std::shared_ptr<EngineState> engineState) {
+  _engineState = engineState;
+
+  _descriptorSetLayout = std::make_shared<DescriptorSetLayout>(_engineState->getDevice());
+  std::vector<VkDescriptorSetLayoutBinding> layout(3);
+  for (int i = 0; i < layout.size(); i++) {
+    layout[i] = {.binding = static_cast<uint32_t>(i),
+                 .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                 .descriptorCount = 1,
+                 .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+                 .pImmutableSamplers = nullptr};
+  }
+  _descriptorSetLayout->createCustom(layout);
+
+  auto shader = std::make_shared<Shader>(_engineState);
+  shader->add("shaders/skinning/skinning_compute.spv", VK_SHADER_STAGE_COMPUTE_BIT);
+  std::map<std::string, VkPushConstantRange> pushConstants;
+  pushConstants["compute"] = VkPushConstantRange{
+      .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT, .offset = 0, .size = sizeof(SkinningPush)};
+  _pipeline = std::make_shared<PipelineCompute>(_engineState->getDevice());
+  _pipeline->createCustom(shader->getShaderStageInfo(VK_SHADER_STAGE_COMPUTE_BIT),
+                          {{"skinning", _descriptorSetLayout}}, pushConstants);
+}
+
+void SkinningCompute::add(std::shared_ptr<Skinnable> object) {
+  if (std::find(_objects.begin(), _objects.end(), object) != _objects.end()) return;
+  _objects.push_back(object);
+}
+
+void SkinningCompute::remove(std::shared_ptr<Skinnable> object) { std::erase(_objects, object); }
+
+std::shared_ptr<DescriptorSetLayout> SkinningCompute::getDescriptorSetLayout() { return _descriptorSetLayout; }
+
+void SkinningCompute::dispatch(std::shared_ptr<DescriptorSet> descriptorSet,
+                               int vertexOffset,
+                               int vertexCount,
+                               std::shared_ptr<CommandBuffer> commandBuffer) {
+  int currentFrame = _engineState->getFrameInFlight();
+  vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_BIND_POINT_COMPUTE,
+                          _pipeline->getPipelineLayout(), 0, 1, &descriptorSet->getDescriptorSets()[currentFrame], 0,
+                          nullptr);
+  SkinningPush pushConstants{.vertexOffset = vertexOffset, .vertexCount = vertexCount};
+  auto info = _pipeline->getPushConstants()["compute"];
+  vkCmdPushConstants(commandBuffer->getCommandBuffer()[currentFrame], _pipeline->getPipelineLayout(), info.stageFlags,
+                     info.offset, info.size, &pushConstants);
+  vkCmdDispatch(commandBuffer->getCommandBuffer()[currentFrame], std::max(1, (int)std::ceil(vertexCount / 64.f)), 1,
+                1);
+}
+
+std::vector<std::shared_ptr<Buffer>> SkinningCompute::getBuffers() {
+  std::vector<std::shared_ptr<Buffer>> buffers;
+  for (auto& object : _objects) {
+    auto skinned = object->getSkinnedBuffers();
+    buffers.insert(buffers.end(), skinned.begin(), skinned.end());
+  }
+  return buffers;
+}
+
+void SkinningCompute::draw(std::shared_ptr<CommandBuffer> commandBuffer) {
+  int currentFrame = _engineState->getFrameInFlight();
+  vkCmdBindPipeline(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_BIND_POINT_COMPUTE,
+                    _pipeline->getPipeline());
+  for (auto& object : _objects) object->skin(commandBuffer);
+
+  // skinned vertices are read by vertex input of shadow and main passes submitted after this one to the same queue
+  VkMemoryBarrier barrier{.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                          .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+                          .dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT};
+  vkCmdPipelineBarrier(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
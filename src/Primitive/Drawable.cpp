@@ -1,16 +1,33 @@
 #include "Primitive/Drawable.h"
 
-void Named::setName(std::string name) { _name = name; }
+void Named::setName(std::string name) {
+  _name = name;
+  _marker = Logger::intern(name);
+}
 
 std::string Named::getName() { return _name; }
 
-void Drawable::setOriginShift(glm::vec3 originShift) { _originShift = originShift; }
+const char* Named::getMarker() { return _marker; }
 
-void Drawable::setTranslate(glm::vec3 translate) { _translate = translate; }
+void Drawable::setOriginShift(glm::vec3 originShift) {
+  _originShift = originShift;
+  if (_callbackTransformChange) _callbackTransformChange();
+}
 
-void Drawable::setRotate(glm::quat rotate) { _rotate = rotate; }
+void Drawable::setTranslate(glm::vec3 translate) {
+  _translate = translate;
+  if (_callbackTransformChange) _callbackTransformChange();
+}
 
-void Drawable::setScale(glm::vec3 scale) { _scale = scale; }
+void Drawable::setRotate(glm::quat rotate) {
+  _rotate = rotate;
+  if (_callbackTransformChange) _callbackTransformChange();
+}
+
+void Drawable::setScale(glm::vec3 scale) {
+  _scale = scale;
+  if (_callbackTransformChange) _callbackTransformChange();
+}
 
 glm::vec3 Drawable::getOriginShift() { return _originShift; }
 
@@ -28,4 +45,8 @@ glm::mat4 Drawable::getModel() {
   matrix = glm::scale(matrix, _scale);
   matrix = glm::translate(matrix, _originShift);
   return matrix;
-}
\ No newline at end of file
+}
+
+std::shared_ptr<AABB> Drawable::getAABB() { return nullptr; }
+
+void Drawable::registerTransformChange(std::function<void()> callback) { _callbackTransformChange = callback; }
@@ -12,10 +12,7 @@ Equirectangular::Equirectangular(std::shared_ptr<ImageCPU<float>> imageCPU,
   int imageSize = texWidth * texHeight * STBI_rgb_alpha;
   int bufferSize = imageSize * sizeof(float);
   // fill buffer
-  _stagingBuffer = std::make_shared<Buffer>(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                                            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                                            engineState);
-  _stagingBuffer->setData(pixels);
+  auto staging = _engineState->getStagingRing()->upload(pixels, bufferSize);
 
   // image
   auto [width, height] = engineState->getSettings()->getResolution();
@@ -25,7 +22,7 @@ Equirectangular::Equirectangular(std::shared_ptr<ImageCPU<float>> imageCPU,
       VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, engineState);
   _image->changeLayout(VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT, 1, 1,
                        commandBufferTransfer);
-  _image->copyFrom(_stagingBuffer, {0}, commandBufferTransfer);
+  _image->copyFrom(staging.buffer, {static_cast<int>(staging.offset)}, commandBufferTransfer);
   _image->changeLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
                        VK_IMAGE_ASPECT_COLOR_BIT, 1, 1, commandBufferTransfer);
   _imageView = std::make_shared<ImageView>(_image, VK_IMAGE_VIEW_TYPE_2D, 0, 1, 0, 1, VK_IMAGE_ASPECT_COLOR_BIT,
@@ -223,12 +220,12 @@ void Equirectangular::_convertToCubemap() {
     BufferMVP cameraUBO{.model = glm::mat4(1.f), .view = _camera->getView(), .projection = _camera->getProjection()};
     _bufferCubemap[i][currentFrame]->setData(&cameraUBO);
 
-    VkBuffer vertexBuffers[] = {_mesh3D->getVertexBuffer()->getBuffer()->getData()};
+    VkBuffer vertexBuffers[] = {_mesh3D->getVertexBuffer()->getData()};
     VkDeviceSize offsets[] = {0};
     vkCmdBindVertexBuffers(_commandBufferTransfer->getCommandBuffer()[currentFrame], 0, 1, vertexBuffers, offsets);
 
     vkCmdBindIndexBuffer(_commandBufferTransfer->getCommandBuffer()[currentFrame],
-                         _mesh3D->getIndexBuffer()->getBuffer()->getData(), 0, VK_INDEX_TYPE_UINT32);
+                         _mesh3D->getIndexBuffer()->getData(), 0, VK_INDEX_TYPE_UINT32);
 
     auto pipelineLayout = _pipelineEquirectangular->getDescriptorSetLayout();
     auto colorLayout = std::find_if(pipelineLayout.begin(), pipelineLayout.end(),
@@ -242,7 +239,8 @@ void Equirectangular::_convertToCubemap() {
     }
 
     vkCmdDrawIndexed(_commandBufferTransfer->getCommandBuffer()[currentFrame],
-                     static_cast<uint32_t>(_mesh3D->getIndexData().size()), 1, 0, 0, 0);
+                     static_cast<uint32_t>(_mesh3D->getIndexData().size()), 1, _mesh3D->getIndexOffset(),
+                     _mesh3D->getVertexOffset(), 0);
     _logger->end(_commandBufferTransfer);
 
     vkCmdEndRenderPass(_commandBufferTransfer->getCommandBuffer()[currentFrame]);
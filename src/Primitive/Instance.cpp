@@ -0,0 +1,70 @@
+#include "Primitive/Instance.h"
+
+InstanceBuffer::InstanceBuffer(std::shared_ptr<EngineState> engineState) {
+  _engineState = engineState;
+  int framesInFlight = _engineState->getSettings()->getMaxFramesInFlight();
+  _buffer.resize(framesInFlight);
+  _model.resize(framesInFlight, glm::mat4(1.f));
+  _changed.resize(framesInFlight, true);
+
+  _descriptorSetLayout = std::make_shared<DescriptorSetLayout>(_engineState->getDevice());
+  std::vector<VkDescriptorSetLayoutBinding> layoutInstances{{.binding = 0,
+                                                             .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                                             .descriptorCount = 1,
+                                                             .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+                                                             .pImmutableSamplers = nullptr}};
+  _descriptorSetLayout->createCustom(layoutInstances);
+  _descriptorSet = std::make_shared<DescriptorSet>(framesInFlight, _descriptorSetLayout, _engineState);
+  for (int i = 0; i < framesInFlight; i++) _allocateBuffer(i);
+}
+
+void InstanceBuffer::_allocateBuffer(int frame) {
+  _buffer[frame] = std::make_shared<Buffer>(
+      sizeof(glm::mat4) * _instances.size(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, _engineState);
+  std::map<int, std::vector<VkDescriptorBufferInfo>> bufferInfo = {
+      {0, {{.buffer = _buffer[frame]->getData(), .offset = 0, .range = _buffer[frame]->getSize()}}}};
+  _descriptorSet->createCustom(frame, bufferInfo, {});
+}
+
+void InstanceBuffer::setInstances(std::vector<glm::mat4> instances) {
+  if (instances.size() == 0) throw std::runtime_error("at least one instance is required");
+  std::unique_lock<std::mutex> lock(_mutex);
+  _instances = instances;
+  for (int i = 0; i < _changed.size(); i++) _changed[i] = true;
+}
+
+const std::vector<glm::mat4>& InstanceBuffer::getInstances() { return _instances; }
+
+int InstanceBuffer::getInstanceCount() { return _instances.size(); }
+
+std::shared_ptr<AABB> InstanceBuffer::getAABB(std::shared_ptr<AABB> aabb) {
+  if (aabb == nullptr) return nullptr;
+  auto aabbTotal = std::make_shared<AABB>();
+  for (auto& instance : _instances) aabbTotal->extend(aabb->transform(instance));
+  return aabbTotal;
+}
+
+std::vector<glm::mat4> InstanceBuffer::getMatrices(glm::mat4 model) {
+  std::vector<glm::mat4> matrices(_instances.size());
+  for (int i = 0; i < _instances.size(); i++) matrices[i] = model * _instances[i];
+  return matrices;
+}
+
+void InstanceBuffer::update(glm::mat4 model) {
+  int currentFrame = _engineState->getFrameInFlight();
+  std::unique_lock<std::mutex> lock(_mutex);
+  if (_changed[currentFrame] == false && _model[currentFrame] == model) return;
+
+  // buffer of current frame isn't used by GPU anymore, so it can be safely recreated
+  if (_buffer[currentFrame]->getSize() < sizeof(glm::mat4) * _instances.size()) _allocateBuffer(currentFrame);
+
+  auto matrices = getMatrices(model);
+  _buffer[currentFrame]->setData(matrices.data(), sizeof(glm::mat4) * matrices.size());
+  _model[currentFrame] = model;
+  _changed[currentFrame] = false;
+}
+
+std::shared_ptr<DescriptorSetLayout> InstanceBuffer::getDescriptorSetLayout() { return _descriptorSetLayout; }
+
+std::shared_ptr<DescriptorSet> InstanceBuffer::getDescriptorSet() { return _descriptorSet; }
@@ -17,6 +17,22 @@ void AABB::extend(std::shared_ptr<AABB> aabb) {
   extend(aabb->getMax());
 }
 
+std::shared_ptr<AABB> AABB::transform(glm::mat4 matrix) {
+  // transform center and project extent onto new axes instead of transforming all 8 corners
+  glm::vec3 center = (_min + _max) * 0.5f;
+  glm::vec3 extent = (_max - _min) * 0.5f;
+  glm::vec3 centerTransformed = glm::vec3(matrix * glm::vec4(center, 1.f));
+  glm::vec3 extentTransformed = glm::vec3(0.f);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) extentTransformed[i] += std::abs(matrix[j][i]) * extent[j];
+  }
+
+  auto aabb = std::make_shared<AABB>();
+  aabb->extend(centerTransformed - extentTransformed);
+  aabb->extend(centerTransformed + extentTransformed);
+  return aabb;
+}
+
 glm::vec3 AABB::getMin() { return _min; }
 
 glm::vec3 AABB::getMax() { return _max; }
@@ -35,21 +51,36 @@ std::vector<VkVertexInputAttributeDescription> Mesh::getAttributeDescriptions(
   return attributeDescriptions;
 }
 
-MeshStatic3D::MeshStatic3D(std::shared_ptr<EngineState> engineState) : Mesh(engineState) {
-  _vertexBuffer = std::make_shared<VertexBufferStatic<Vertex3D>>(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, _engineState);
-  _indexBuffer = std::make_shared<VertexBufferStatic<uint32_t>>(VK_BUFFER_USAGE_INDEX_BUFFER_BIT, _engineState);
+MeshStatic3D::MeshStatic3D(std::shared_ptr<EngineState> engineState) : Mesh(engineState) {}
+
+void MeshStatic3D::_upload(std::shared_ptr<BufferArena> arena,
+                           std::optional<ArenaRange>& range,
+                           void* data,
+                           VkDeviceSize size,
+                           std::shared_ptr<CommandBuffer> commandBufferTransfer) {
+  // the same range is reused if number of elements hasn't changed (f.e. setColor)
+  if (range.has_value() && range->size != size) {
+    arena->free(range.value());
+    range.reset();
+  }
+  if (size == 0) return;
+  if (range.has_value() == false) range = arena->allocate(size);
+  arena->setData(range.value(), data, commandBufferTransfer);
 }
 
 void MeshStatic3D::setVertices(std::vector<Vertex3D> vertices, std::shared_ptr<CommandBuffer> commandBufferTransfer) {
   std::unique_lock<std::mutex> accessLock(_accessVertexMutex);
   _vertexData = vertices;
-  _vertexBuffer->setData(_vertexData, commandBufferTransfer);
+  _upload(_engineState->getVertexArena(), _vertexRange, _vertexData.data(), _vertexData.size(), commandBufferTransfer);
+  // can be overridden by setAABB (f.e. glTF loader provides bounds from accessors)
+  _aabb = std::make_shared<AABB>();
+  for (auto& vertex : _vertexData) _aabb->extend(vertex.pos);
 }
 
 void MeshStatic3D::setIndexes(std::vector<uint32_t> indexes, std::shared_ptr<CommandBuffer> commandBufferTransfer) {
   std::unique_lock<std::mutex> accessLock(_accessIndexMutex);
   _indexData = indexes;
-  _indexBuffer->setData(_indexData, commandBufferTransfer);
+  _upload(_engineState->getIndexArena(), _indexRange, _indexData.data(), _indexData.size(), commandBufferTransfer);
 }
 
 const std::vector<uint32_t>& MeshStatic3D::getIndexData() {
@@ -62,14 +93,28 @@ const std::vector<Vertex3D>& MeshStatic3D::getVertexData() {
   return _vertexData;
 }
 
-std::shared_ptr<VertexBuffer<Vertex3D>> MeshStatic3D::getVertexBuffer() {
+std::shared_ptr<Buffer> MeshStatic3D::getVertexBuffer() {
   std::unique_lock<std::mutex> accessLock(_accessVertexMutex);
-  return _vertexBuffer;
+  if (_vertexRange.has_value() == false) return nullptr;
+  return _engineState->getVertexArena()->getBuffer(_vertexRange->block);
 }
 
-std::shared_ptr<VertexBuffer<uint32_t>> MeshStatic3D::getIndexBuffer() {
+std::shared_ptr<Buffer> MeshStatic3D::getIndexBuffer() {
   std::unique_lock<std::mutex> accessLock(_accessIndexMutex);
-  return _indexBuffer;
+  if (_indexRange.has_value() == false) return nullptr;
+  return _engineState->getIndexArena()->getBuffer(_indexRange->block);
+}
+
+int MeshStatic3D::getVertexOffset() {
+  std::unique_lock<std::mutex> accessLock(_accessVertexMutex);
+  if (_vertexRange.has_value() == false) return 0;
+  return _vertexRange->offset;
+}
+
+int MeshStatic3D::getIndexOffset() {
+  std::unique_lock<std::mutex> accessLock(_accessIndexMutex);
+  if (_indexRange.has_value() == false) return 0;
+  return _indexRange->offset;
 }
 
 void MeshStatic3D::setColor(std::vector<glm::vec3> color, std::shared_ptr<CommandBuffer> commandBufferTransfer) {
@@ -83,7 +128,7 @@ void MeshStatic3D::setColor(std::vector<glm::vec3> color, std::shared_ptr<Comman
     if (i < color.size()) colorValue = color[i];
     _vertexData[i].color = colorValue;
   }
-  _vertexBuffer->setData(_vertexData, commandBufferTransfer);
+  _upload(_engineState->getVertexArena(), _vertexRange, _vertexData.data(), _vertexData.size(), commandBufferTransfer);
 }
 
 void MeshStatic3D::setNormal(std::vector<glm::vec3> normal, std::shared_ptr<CommandBuffer> commandBufferTransfer) {
@@ -97,7 +142,7 @@ void MeshStatic3D::setNormal(std::vector<glm::vec3> normal, std::shared_ptr<Comm
     if (i < normal.size()) normalValue = normal[i];
     _vertexData[i].normal = normalValue;
   }
-  _vertexBuffer->setData(_vertexData, commandBufferTransfer);
+  _upload(_engineState->getVertexArena(), _vertexRange, _vertexData.data(), _vertexData.size(), commandBufferTransfer);
 }
 
 void MeshStatic3D::setPosition(std::vector<glm::vec3> position, std::shared_ptr<CommandBuffer> commandBufferTransfer) {
@@ -110,7 +155,9 @@ void MeshStatic3D::setPosition(std::vector<glm::vec3> position, std::shared_ptr<
     if (i < position.size()) positionValue = position[i];
     _vertexData[i].pos = positionValue;
   }
-  _vertexBuffer->setData(_vertexData, commandBufferTransfer);
+  _upload(_engineState->getVertexArena(), _vertexRange, _vertexData.data(), _vertexData.size(), commandBufferTransfer);
+  _aabb = std::make_shared<AABB>();
+  for (auto& vertex : _vertexData) _aabb->extend(vertex.pos);
 }
 
 void MeshStatic3D::setAABB(std::shared_ptr<AABB> aabb) { _aabb = aabb; }
@@ -121,6 +168,12 @@ const std::vector<MeshPrimitive>& MeshStatic3D::getPrimitives() { return _primit
 
 std::shared_ptr<AABB> MeshStatic3D::getAABB() { return _aabb; }
 
+MeshStatic3D::~MeshStatic3D() {
+  // arena reuses ranges only after frames in flight that can still read them are finished
+  if (_vertexRange.has_value()) _engineState->getVertexArena()->free(_vertexRange.value());
+  if (_indexRange.has_value()) _engineState->getIndexArena()->free(_indexRange.value());
+}
+
 VkVertexInputBindingDescription MeshStatic3D::getBindingDescription() {
   VkVertexInputBindingDescription bindingDescription{.binding = 0,
                                                      .stride = sizeof(Vertex3D),
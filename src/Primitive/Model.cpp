@@ -16,6 +16,11 @@ struct FragmentPush {
   alignas(16) glm::vec3 cameraPosition;
 };
 
+struct VertexPush {
+  // index of the first draw in draw nodes buffer, vertex shaders add gl_DrawIDARB to it
+  alignas(16) int draw;
+};
+
 Model3DPhysics::Model3DPhysics(glm::vec3 translate, glm::vec3 size, std::shared_ptr<PhysicsManager> physicsManager) {
   _physicsManager = physicsManager;
   JPH::CharacterSettings settings;
@@ -105,6 +110,8 @@ Model3DPhysics::~Model3DPhysics() {
   // removeBody inside
 }
 
+Model3D::~Model3D() { _animation->unregisterPoseChange(this); }
+
 void Model3D::enableDepth(bool enable) { _enableDepth = enable; }
 
 bool Model3D::isDepthEnabled() { return _enableDepth; }
@@ -120,6 +127,9 @@ Model3D::Model3D(const std::vector<std::shared_ptr<NodeGLTF>>& nodes,
   _meshes = meshes;
   _gameState = gameState;
   auto settings = _engineState->getSettings();
+  // draws are merged to multi-draw indirect only with GPU culling, vertex shaders take node of such draw by
+  // gl_DrawIDARB, so shader draw parameters are used only by this variant
+  std::string vertexVariant = settings->getIndirectCulling() ? "DrawParameters" : "";
   _changedMaterial.resize(_engineState->getSettings()->getMaxFramesInFlight(), false);
   // default material if model doesn't have material at all, we still have to send data to shader
   _defaultMaterialPhong = std::make_shared<MaterialPhong>(MaterialTarget::SIMPLE, commandBufferTransfer, engineState);
@@ -138,17 +148,58 @@ Model3D::Model3D(const std::vector<std::shared_ptr<NodeGLTF>>& nodes,
   _renderPass = _engineState->getRenderPassManager()->getRenderPass(RenderPassScenario::GRAPHIC);
   _renderPassDepth = _engineState->getRenderPassManager()->getRenderPass(RenderPassScenario::SHADOW);
 
-  // initialize UBO
-  _cameraUBOFull.resize(_engineState->getSettings()->getMaxFramesInFlight());
+  _instanceBuffer = std::make_shared<InstanceBuffer>(engineState);
+  // flatten node hierarchy, so world matrices can be calculated linearly
+  for (auto& node : _nodes) _flattenNode(node, -1);
+  // nodes of glTF model aren't changed by animations, so rest pose is calculated once, parent is always before child
+  _nodesMatrix.resize(_nodesOrdered.size(), glm::mat4(1.f));
+  for (int i = 0; i < _nodesOrdered.size(); i++) {
+    _nodesMatrix[i] = _nodesOrdered[i]->getLocalMatrix();
+    if (_nodesParent[i] >= 0) _nodesMatrix[i] = _nodesMatrix[_nodesParent[i]] * _nodesMatrix[i];
+  }
+  // skinned vertices are moved by joints, so mesh is bounded by boxes of vertices influenced by every joint of skin
+  for (auto& node : _nodesOrdered) {
+    if (node->skin < 0 || node->mesh < 0 || _jointsAABB.contains(node->mesh)) continue;
+    auto& jointsAABB = _jointsAABB[node->mesh];
+    for (auto& vertex : _meshes[node->mesh]->getVertexData()) {
+      for (int i = 0; i < 4; i++) {
+        if (vertex.jointWeights[i] <= 0.f) continue;
+        int joint = static_cast<int>(vertex.jointIndices[i]);
+        if (joint >= jointsAABB.size()) jointsAABB.resize(joint + 1);
+        if (jointsAABB[joint] == nullptr) jointsAABB[joint] = std::make_shared<AABB>();
+        jointsAABB[joint]->extend(vertex.pos);
+      }
+    }
+  }
+  _nodesBuffer.resize(_engineState->getSettings()->getMaxFramesInFlight());
+  for (int i = 0; i < _engineState->getSettings()->getMaxFramesInFlight(); i++)
+    _nodesBuffer[i] = std::make_shared<Buffer>(
+        sizeof(glm::mat4) * std::max(static_cast<int>(_nodesOrdered.size()), 1), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, _engineState);
+  _updateDraws();
+  _drawsBuffer.resize(_engineState->getSettings()->getMaxFramesInFlight());
   for (int i = 0; i < _engineState->getSettings()->getMaxFramesInFlight(); i++)
-    _cameraUBOFull[i] = std::make_shared<Buffer>(
-        sizeof(BufferMVP), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+    _drawsBuffer[i] = std::make_shared<Buffer>(
+        sizeof(int) * std::max(static_cast<int>(_draws.size()), 1), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, _engineState);
+  std::map<std::string, VkPushConstantRange> vertexPushConstants;
+  vertexPushConstants["vertex"] = VkPushConstantRange{
+      .stageFlags = VK_SHADER_STAGE_VERTEX_BIT, .offset = 0, .size = sizeof(VertexPush)};
 
   // setup joints
   {
     _descriptorSetLayoutJoints = std::make_shared<DescriptorSetLayout>(_engineState->getDevice());
     std::vector<VkDescriptorSetLayoutBinding> layoutJoints{{.binding = 0,
+                                                            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                                            .descriptorCount = 1,
+                                                            .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+                                                            .pImmutableSamplers = nullptr},
+                                                           {.binding = 1,
+                                                            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                                            .descriptorCount = 1,
+                                                            .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+                                                            .pImmutableSamplers = nullptr},
+                                                           {.binding = 2,
                                                             .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
                                                             .descriptorCount = 1,
                                                             .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
@@ -156,43 +207,56 @@ Model3D::Model3D(const std::vector<std::shared_ptr<NodeGLTF>>& nodes,
     _descriptorSetLayoutJoints->createCustom(layoutJoints);
 
     _updateJointsDescriptor();
+
+    // stub is never changed, so it's shared between frames in flight
+    _jointsStub = std::make_shared<Buffer>(sizeof(glm::vec4) + sizeof(glm::mat4), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                           VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                           _engineState);
+    int jointNumber = 0;
+    auto identityMat = glm::mat4(1.f);
+    _jointsStub->setData(&jointNumber, sizeof(int));
+    _jointsStub->setData(&identityMat, sizeof(glm::mat4), sizeof(glm::vec4));
+    _descriptorSetJointsStatic = std::make_shared<DescriptorSet>(_engineState->getSettings()->getMaxFramesInFlight(),
+                                                                 _descriptorSetLayoutJoints, _engineState);
+    for (int i = 0; i < _engineState->getSettings()->getMaxFramesInFlight(); i++) {
+      std::map<int, std::vector<VkDescriptorBufferInfo>> bufferInfo = {
+          {0, {{.buffer = _jointsStub->getData(), .offset = 0, .range = _jointsStub->getSize()}}},
+          {1, {{.buffer = _nodesBuffer[i]->getData(), .offset = 0, .range = _nodesBuffer[i]->getSize()}}},
+          {2, {{.buffer = _drawsBuffer[i]->getData(), .offset = 0, .range = _drawsBuffer[i]->getSize()}}}};
+      _descriptorSetJointsStatic->createCustom(i, bufferInfo, {});
+    }
   }
 
   // setup Normal
   {
     _descriptorSetLayoutNormalsMesh = std::make_shared<DescriptorSetLayout>(_engineState->getDevice());
-    std::vector<VkDescriptorSetLayoutBinding> layoutNormalsMesh{{.binding = 0,
-                                                                 .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-                                                                 .descriptorCount = 1,
-                                                                 .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
-                                                                 .pImmutableSamplers = nullptr},
-                                                                {.binding = 1,
-                                                                 .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-                                                                 .descriptorCount = 1,
-                                                                 .stageFlags = VK_SHADER_STAGE_GEOMETRY_BIT,
-                                                                 .pImmutableSamplers = nullptr}};
+    std::vector<VkDescriptorSetLayoutBinding> layoutNormalsMesh{
+        {.binding = 0,
+         .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+         .descriptorCount = 1,
+         .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+         .pImmutableSamplers = nullptr},
+        {.binding = 1,
+         .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+         .descriptorCount = 1,
+         .stageFlags = VK_SHADER_STAGE_GEOMETRY_BIT,
+         .pImmutableSamplers = nullptr}};
     _descriptorSetLayoutNormalsMesh->createCustom(layoutNormalsMesh);
 
-    // TODO: we can just have one buffer and put it twice to descriptor
-
     _descriptorSetNormalsMesh = std::make_shared<DescriptorSet>(engineState->getSettings()->getMaxFramesInFlight(),
                                                                 _descriptorSetLayoutNormalsMesh, engineState);
     for (int i = 0; i < engineState->getSettings()->getMaxFramesInFlight(); i++) {
+      // camera matrices are pushed to uniform ring every draw, offset is passed during bind
+      auto uniformBuffer = _engineState->getUniformRing()->getBuffer(i);
       std::map<int, std::vector<VkDescriptorBufferInfo>> bufferInfoNormalsMesh = {
-          {0,
-           {VkDescriptorBufferInfo{.buffer = _cameraUBOFull[i]->getData(),
-                                   .offset = 0,
-                                   .range = _cameraUBOFull[i]->getSize()}}},
-          {1,
-           {VkDescriptorBufferInfo{.buffer = _cameraUBOFull[i]->getData(),
-                                   .offset = 0,
-                                   .range = _cameraUBOFull[i]->getSize()}}}};
+          {0, {{.buffer = uniformBuffer->getData(), .offset = 0, .range = sizeof(BufferMVP)}}},
+          {1, {{.buffer = uniformBuffer->getData(), .offset = 0, .range = sizeof(BufferMVP)}}}};
       _descriptorSetNormalsMesh->createCustom(i, bufferInfoNormalsMesh, {});
     }
 
     // initialize Normal (per vertex)
     auto shader = std::make_shared<Shader>(_engineState);
-    shader->add("shaders/shape/cubeNormal_vertex.spv", VK_SHADER_STAGE_VERTEX_BIT);
+    shader->add("shaders/model/modelNormal" + vertexVariant + "_vertex.spv", VK_SHADER_STAGE_VERTEX_BIT);
     shader->add("shaders/shape/cubeNormal_fragment.spv", VK_SHADER_STAGE_FRAGMENT_BIT);
     shader->add("shaders/shape/cubeNormal_geometry.spv", VK_SHADER_STAGE_GEOMETRY_BIT);
 
@@ -204,7 +268,10 @@ Model3D::Model3D(const std::vector<std::shared_ptr<NodeGLTF>>& nodes,
         {shader->getShaderStageInfo(VK_SHADER_STAGE_VERTEX_BIT),
          shader->getShaderStageInfo(VK_SHADER_STAGE_FRAGMENT_BIT),
          shader->getShaderStageInfo(VK_SHADER_STAGE_GEOMETRY_BIT)},
-        std::vector{std::pair{std::string("normal"), _descriptorSetLayoutNormalsMesh}}, {},
+        std::vector{std::pair{std::string("normal"), _descriptorSetLayoutNormalsMesh},
+                    std::pair{std::string("joints"), _descriptorSetLayoutJoints},
+                    std::pair{std::string("instances"), _instanceBuffer->getDescriptorSetLayout()}},
+        vertexPushConstants,
         _mesh->getBindingDescription(),
         _mesh->Mesh::getAttributeDescriptions({{VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex3D, pos)},
                                                {VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex3D, normal)},
@@ -219,7 +286,10 @@ Model3D::Model3D(const std::vector<std::shared_ptr<NodeGLTF>>& nodes,
         {shader->getShaderStageInfo(VK_SHADER_STAGE_VERTEX_BIT),
          shader->getShaderStageInfo(VK_SHADER_STAGE_FRAGMENT_BIT),
          shader->getShaderStageInfo(VK_SHADER_STAGE_GEOMETRY_BIT)},
-        std::vector{std::pair{std::string("normal"), _descriptorSetLayoutNormalsMesh}}, {},
+        std::vector{std::pair{std::string("normal"), _descriptorSetLayoutNormalsMesh},
+                    std::pair{std::string("joints"), _descriptorSetLayoutJoints},
+                    std::pair{std::string("instances"), _instanceBuffer->getDescriptorSetLayout()}},
+        vertexPushConstants,
         _mesh->getBindingDescription(),
         _mesh->Mesh::getAttributeDescriptions({{VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex3D, pos)},
                                                {VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex3D, normal)},
@@ -229,7 +299,7 @@ Model3D::Model3D(const std::vector<std::shared_ptr<NodeGLTF>>& nodes,
     // initialize Tangent (per vertex)
     {
       auto shader = std::make_shared<Shader>(_engineState);
-      shader->add("shaders/shape/cubeTangent_vertex.spv", VK_SHADER_STAGE_VERTEX_BIT);
+      shader->add("shaders/model/modelTangent" + vertexVariant + "_vertex.spv", VK_SHADER_STAGE_VERTEX_BIT);
       shader->add("shaders/shape/cubeNormal_fragment.spv", VK_SHADER_STAGE_FRAGMENT_BIT);
       shader->add("shaders/shape/cubeNormal_geometry.spv", VK_SHADER_STAGE_GEOMETRY_BIT);
 
@@ -241,7 +311,10 @@ Model3D::Model3D(const std::vector<std::shared_ptr<NodeGLTF>>& nodes,
           {shader->getShaderStageInfo(VK_SHADER_STAGE_VERTEX_BIT),
            shader->getShaderStageInfo(VK_SHADER_STAGE_FRAGMENT_BIT),
            shader->getShaderStageInfo(VK_SHADER_STAGE_GEOMETRY_BIT)},
-          std::vector{std::pair{std::string("normal"), _descriptorSetLayoutNormalsMesh}}, {},
+          std::vector{std::pair{std::string("normal"), _descriptorSetLayoutNormalsMesh},
+                      std::pair{std::string("joints"), _descriptorSetLayoutJoints},
+                      std::pair{std::string("instances"), _instanceBuffer->getDescriptorSetLayout()}},
+          vertexPushConstants,
           _mesh->getBindingDescription(),
           _mesh->Mesh::getAttributeDescriptions({{VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex3D, pos)},
                                                  {VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex3D, normal)},
@@ -256,7 +329,10 @@ Model3D::Model3D(const std::vector<std::shared_ptr<NodeGLTF>>& nodes,
           {shader->getShaderStageInfo(VK_SHADER_STAGE_VERTEX_BIT),
            shader->getShaderStageInfo(VK_SHADER_STAGE_FRAGMENT_BIT),
            shader->getShaderStageInfo(VK_SHADER_STAGE_GEOMETRY_BIT)},
-          std::vector{std::pair{std::string("normal"), _descriptorSetLayoutNormalsMesh}}, {},
+          std::vector{std::pair{std::string("normal"), _descriptorSetLayoutNormalsMesh},
+                      std::pair{std::string("joints"), _descriptorSetLayoutJoints},
+                      std::pair{std::string("instances"), _instanceBuffer->getDescriptorSetLayout()}},
+          vertexPushConstants,
           _mesh->getBindingDescription(),
           _mesh->Mesh::getAttributeDescriptions({{VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex3D, pos)},
                                                  {VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex3D, normal)},
@@ -269,7 +345,7 @@ Model3D::Model3D(const std::vector<std::shared_ptr<NodeGLTF>>& nodes,
   {
     _descriptorSetLayoutColor = std::make_shared<DescriptorSetLayout>(_engineState->getDevice());
     std::vector<VkDescriptorSetLayoutBinding> layoutColor{{.binding = 0,
-                                                           .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                                                           .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
                                                            .descriptorCount = 1,
                                                            .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
                                                            .pImmutableSamplers = nullptr},
@@ -286,7 +362,7 @@ Model3D::Model3D(const std::vector<std::shared_ptr<NodeGLTF>>& nodes,
     // initialize Color
     {
       auto shader = std::make_shared<Shader>(_engineState);
-      shader->add("shaders/model/modelColor_vertex.spv", VK_SHADER_STAGE_VERTEX_BIT);
+      shader->add("shaders/model/modelColor" + vertexVariant + "_vertex.spv", VK_SHADER_STAGE_VERTEX_BIT);
       shader->add("shaders/model/modelColor_fragment.spv", VK_SHADER_STAGE_FRAGMENT_BIT);
 
       _pipeline[MaterialType::COLOR] = std::make_shared<PipelineGraphic>(engineState->getDevice());
@@ -302,7 +378,10 @@ Model3D::Model3D(const std::vector<std::shared_ptr<NodeGLTF>>& nodes,
       _pipeline[MaterialType::COLOR]->createCustom(
           {shader->getShaderStageInfo(VK_SHADER_STAGE_VERTEX_BIT),
            shader->getShaderStageInfo(VK_SHADER_STAGE_FRAGMENT_BIT)},
-          {{"color", _descriptorSetLayoutColor}, {"joints", _descriptorSetLayoutJoints}}, {},
+          {{"color", _descriptorSetLayoutColor},
+           {"joints", _descriptorSetLayoutJoints},
+           {"instances", _instanceBuffer->getDescriptorSetLayout()}},
+          vertexPushConstants,
           _mesh->getBindingDescription(), _mesh->Mesh::getAttributeDescriptions(attributes), _renderPass);
 
       _pipelineCullOff[MaterialType::COLOR] = std::make_shared<PipelineGraphic>(engineState->getDevice());
@@ -311,7 +390,10 @@ Model3D::Model3D(const std::vector<std::shared_ptr<NodeGLTF>>& nodes,
       _pipelineCullOff[MaterialType::COLOR]->createCustom(
           {shader->getShaderStageInfo(VK_SHADER_STAGE_VERTEX_BIT),
            shader->getShaderStageInfo(VK_SHADER_STAGE_FRAGMENT_BIT)},
-          {{"color", _descriptorSetLayoutColor}, {"joints", _descriptorSetLayoutJoints}}, {},
+          {{"color", _descriptorSetLayoutColor},
+           {"joints", _descriptorSetLayoutJoints},
+           {"instances", _instanceBuffer->getDescriptorSetLayout()}},
+          vertexPushConstants,
           _mesh->getBindingDescription(), _mesh->Mesh::getAttributeDescriptions(attributes), _renderPass);
 
       _pipelineWireframe[MaterialType::COLOR] = std::make_shared<PipelineGraphic>(engineState->getDevice());
@@ -322,7 +404,10 @@ Model3D::Model3D(const std::vector<std::shared_ptr<NodeGLTF>>& nodes,
       _pipelineWireframe[MaterialType::COLOR]->createCustom(
           {shader->getShaderStageInfo(VK_SHADER_STAGE_VERTEX_BIT),
            shader->getShaderStageInfo(VK_SHADER_STAGE_FRAGMENT_BIT)},
-          {{"color", _descriptorSetLayoutColor}, {"joints", _descriptorSetLayoutJoints}}, {},
+          {{"color", _descriptorSetLayoutColor},
+           {"joints", _descriptorSetLayoutJoints},
+           {"instances", _instanceBuffer->getDescriptorSetLayout()}},
+          vertexPushConstants,
           _mesh->getBindingDescription(), _mesh->Mesh::getAttributeDescriptions(attributes), _renderPass);
     }
   }
@@ -331,7 +416,7 @@ Model3D::Model3D(const std::vector<std::shared_ptr<NodeGLTF>>& nodes,
   {
     _descriptorSetLayoutPhong = std::make_shared<DescriptorSetLayout>(_engineState->getDevice());
     std::vector<VkDescriptorSetLayoutBinding> layoutPhong{{.binding = 0,
-                                                           .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                                                           .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
                                                            .descriptorCount = 1,
                                                            .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
                                                            .pImmutableSamplers = nullptr},
@@ -365,13 +450,13 @@ Model3D::Model3D(const std::vector<std::shared_ptr<NodeGLTF>>& nodes,
     setMaterial({_defaultMaterialPhong});
 
     auto shader = std::make_shared<Shader>(_engineState);
-    shader->add("shaders/model/modelPhong_vertex.spv", VK_SHADER_STAGE_VERTEX_BIT);
+    shader->add("shaders/model/modelPhong" + vertexVariant + "_vertex.spv", VK_SHADER_STAGE_VERTEX_BIT);
     shader->add("shaders/model/modelPhong_fragment.spv", VK_SHADER_STAGE_FRAGMENT_BIT);
 
     _pipeline[MaterialType::PHONG] = std::make_shared<PipelineGraphic>(engineState->getDevice());
-    std::map<std::string, VkPushConstantRange> defaultPushConstants;
-    defaultPushConstants["constants"] =
-        VkPushConstantRange{.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT, .offset = 0, .size = sizeof(FragmentPush)};
+    std::map<std::string, VkPushConstantRange> defaultPushConstants = vertexPushConstants;
+    defaultPushConstants["constants"] = VkPushConstantRange{
+        .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT, .offset = sizeof(VertexPush), .size = sizeof(FragmentPush)};
     _pipeline[MaterialType::PHONG]->setDepthTest(true);
     _pipeline[MaterialType::PHONG]->setDepthWrite(true);
     _pipeline[MaterialType::PHONG]->setCullMode(VK_CULL_MODE_BACK_BIT);
@@ -379,7 +464,8 @@ Model3D::Model3D(const std::vector<std::shared_ptr<NodeGLTF>>& nodes,
                                                   shader->getShaderStageInfo(VK_SHADER_STAGE_FRAGMENT_BIT)},
                                                  {{"phong", _descriptorSetLayoutPhong},
                                                   {"joints", _descriptorSetLayoutJoints},
-                                                  {"globalPhong", _gameState->getLightManager()->getDSLGlobalPhong()}},
+                                                  {"globalPhong", _gameState->getLightManager()->getDSLGlobalPhong()},
+                                                  {"instances", _instanceBuffer->getDescriptorSetLayout()}},
                                                  defaultPushConstants, _mesh->getBindingDescription(),
                                                  _mesh->getAttributeDescriptions(), _renderPass);
 
@@ -391,7 +477,8 @@ Model3D::Model3D(const std::vector<std::shared_ptr<NodeGLTF>>& nodes,
          shader->getShaderStageInfo(VK_SHADER_STAGE_FRAGMENT_BIT)},
         {{"phong", _descriptorSetLayoutPhong},
          {"joints", _descriptorSetLayoutJoints},
-         {"globalPhong", _gameState->getLightManager()->getDSLGlobalPhong()}},
+         {"globalPhong", _gameState->getLightManager()->getDSLGlobalPhong()},
+         {"instances", _instanceBuffer->getDescriptorSetLayout()}},
         defaultPushConstants, _mesh->getBindingDescription(), _mesh->getAttributeDescriptions(), _renderPass);
 
     _pipelineWireframe[MaterialType::PHONG] = std::make_shared<PipelineGraphic>(engineState->getDevice());
@@ -404,7 +491,8 @@ Model3D::Model3D(const std::vector<std::shared_ptr<NodeGLTF>>& nodes,
          shader->getShaderStageInfo(VK_SHADER_STAGE_FRAGMENT_BIT)},
         {{"phong", _descriptorSetLayoutPhong},
          {"joints", _descriptorSetLayoutJoints},
-         {"globalPhong", _gameState->getLightManager()->getDSLGlobalPhong()}},
+         {"globalPhong", _gameState->getLightManager()->getDSLGlobalPhong()},
+         {"instances", _instanceBuffer->getDescriptorSetLayout()}},
         defaultPushConstants, _mesh->getBindingDescription(), _mesh->getAttributeDescriptions(), _renderPass);
   }
 
@@ -412,7 +500,7 @@ Model3D::Model3D(const std::vector<std::shared_ptr<NodeGLTF>>& nodes,
   {
     _descriptorSetLayoutPBR = std::make_shared<DescriptorSetLayout>(_engineState->getDevice());
     std::vector<VkDescriptorSetLayoutBinding> layoutPBR{{.binding = 0,
-                                                         .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                                                         .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
                                                          .descriptorCount = 1,
                                                          .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
                                                          .pImmutableSamplers = nullptr},
@@ -480,7 +568,7 @@ Model3D::Model3D(const std::vector<std::shared_ptr<NodeGLTF>>& nodes,
     // initialize PBR
     {
       auto shader = std::make_shared<Shader>(_engineState);
-      shader->add("shaders/model/modelPBR_vertex.spv", VK_SHADER_STAGE_VERTEX_BIT);
+      shader->add("shaders/model/modelPBR" + vertexVariant + "_vertex.spv", VK_SHADER_STAGE_VERTEX_BIT);
       shader->add("shaders/model/modelPBR_fragment.spv", VK_SHADER_STAGE_FRAGMENT_BIT);
 
       _pipeline[MaterialType::PBR] = std::make_shared<PipelineGraphic>(engineState->getDevice());
@@ -488,15 +576,16 @@ Model3D::Model3D(const std::vector<std::shared_ptr<NodeGLTF>>& nodes,
       _pipeline[MaterialType::PBR]->setDepthWrite(true);
       _pipeline[MaterialType::PBR]->setCullMode(VK_CULL_MODE_BACK_BIT);
 
-      std::map<std::string, VkPushConstantRange> defaultPushConstants;
-      defaultPushConstants["constants"] =
-          VkPushConstantRange{.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT, .offset = 0, .size = sizeof(FragmentPush)};
+      std::map<std::string, VkPushConstantRange> defaultPushConstants = vertexPushConstants;
+      defaultPushConstants["constants"] = VkPushConstantRange{
+          .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT, .offset = sizeof(VertexPush), .size = sizeof(FragmentPush)};
 
       _pipeline[MaterialType::PBR]->createCustom({shader->getShaderStageInfo(VK_SHADER_STAGE_VERTEX_BIT),
                                                   shader->getShaderStageInfo(VK_SHADER_STAGE_FRAGMENT_BIT)},
                                                  {{"pbr", _descriptorSetLayoutPBR},
                                                   {"joints", _descriptorSetLayoutJoints},
-                                                  {"globalPBR", _gameState->getLightManager()->getDSLGlobalPBR()}},
+                                                  {"globalPBR", _gameState->getLightManager()->getDSLGlobalPBR()},
+                                                  {"instances", _instanceBuffer->getDescriptorSetLayout()}},
                                                  defaultPushConstants, _mesh->getBindingDescription(),
                                                  _mesh->getAttributeDescriptions(), _renderPass);
 
@@ -508,7 +597,8 @@ Model3D::Model3D(const std::vector<std::shared_ptr<NodeGLTF>>& nodes,
            shader->getShaderStageInfo(VK_SHADER_STAGE_FRAGMENT_BIT)},
           {{"pbr", _descriptorSetLayoutPBR},
            {"joints", _descriptorSetLayoutJoints},
-           {"globalPBR", _gameState->getLightManager()->getDSLGlobalPBR()}},
+           {"globalPBR", _gameState->getLightManager()->getDSLGlobalPBR()},
+           {"instances", _instanceBuffer->getDescriptorSetLayout()}},
           defaultPushConstants, _mesh->getBindingDescription(), _mesh->getAttributeDescriptions(), _renderPass);
 
       _pipelineWireframe[MaterialType::PBR] = std::make_shared<PipelineGraphic>(engineState->getDevice());
@@ -520,80 +610,36 @@ Model3D::Model3D(const std::vector<std::shared_ptr<NodeGLTF>>& nodes,
            shader->getShaderStageInfo(VK_SHADER_STAGE_FRAGMENT_BIT)},
           {{"pbr", _descriptorSetLayoutPBR},
            {"joints", _descriptorSetLayoutJoints},
-           {"globalPBR", _gameState->getLightManager()->getDSLGlobalPBR()}},
+           {"globalPBR", _gameState->getLightManager()->getDSLGlobalPBR()},
+           {"instances", _instanceBuffer->getDescriptorSetLayout()}},
           defaultPushConstants, _mesh->getBindingDescription(), _mesh->getAttributeDescriptions(), _renderPass);
     }
   }
 
   auto cameraLayout = std::make_shared<DescriptorSetLayout>(engineState->getDevice());
   VkDescriptorSetLayoutBinding layoutBinding = {.binding = 0,
-                                                .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                                                .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
                                                 .descriptorCount = 1,
                                                 .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
                                                 .pImmutableSamplers = nullptr};
   cameraLayout->createCustom({layoutBinding});
 
-  int lightNumber = _engineState->getSettings()->getMaxDirectionalLights() +
-                    _engineState->getSettings()->getMaxPointLights();
-  for (int i = 0; i < _engineState->getSettings()->getMaxDirectionalLights(); i++) {
-    std::vector<std::shared_ptr<Buffer>> buffer(_engineState->getSettings()->getMaxFramesInFlight());
-    for (int j = 0; j < _engineState->getSettings()->getMaxFramesInFlight(); j++)
-      buffer[j] = std::make_shared<Buffer>(sizeof(BufferMVP), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                                           VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                                           _engineState);
-    _cameraUBODepth.push_back({buffer});
-  }
-
-  for (int i = 0; i < _engineState->getSettings()->getMaxPointLights(); i++) {
-    std::vector<std::vector<std::shared_ptr<Buffer>>> facesBuffer(6);
-    for (int j = 0; j < 6; j++) {
-      facesBuffer[j].resize(_engineState->getSettings()->getMaxFramesInFlight());
-      for (int k = 0; k < _engineState->getSettings()->getMaxFramesInFlight(); k++)
-        facesBuffer[j][k] = std::make_shared<Buffer>(
-            sizeof(BufferMVP), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, _engineState);
-    }
-    _cameraUBODepth.push_back(facesBuffer);
-  }
-  // initialize descriptor sets
-  {
-    for (int i = 0; i < _engineState->getSettings()->getMaxDirectionalLights(); i++) {
-      auto cameraSet = std::make_shared<DescriptorSet>(_engineState->getSettings()->getMaxFramesInFlight(),
-                                                       cameraLayout, _engineState);
-      for (int j = 0; j < _engineState->getSettings()->getMaxFramesInFlight(); j++) {
-        std::map<int, std::vector<VkDescriptorBufferInfo>> bufferInfo = {
-            {0,
-             {{.buffer = _cameraUBODepth[i][0][j]->getData(),
-               .offset = 0,
-               .range = _cameraUBODepth[i][0][j]->getSize()}}}};
-        cameraSet->createCustom(j, bufferInfo, {});
-      }
-      _descriptorSetCameraDepth.push_back({cameraSet});
-    }
-
-    for (int i = 0; i < _engineState->getSettings()->getMaxPointLights(); i++) {
-      std::vector<std::shared_ptr<DescriptorSet>> facesSet(6);
-      for (int j = 0; j < 6; j++) {
-        facesSet[j] = std::make_shared<DescriptorSet>(_engineState->getSettings()->getMaxFramesInFlight(), cameraLayout,
-                                                      _engineState);
-        for (int k = 0; k < _engineState->getSettings()->getMaxFramesInFlight(); k++) {
-          std::map<int, std::vector<VkDescriptorBufferInfo>> bufferInfo = {
-              {0,
-               {{.buffer = _cameraUBODepth[i + _engineState->getSettings()->getMaxDirectionalLights()][j][k]->getData(),
-                 .offset = 0,
-                 .range =
-                     _cameraUBODepth[i + _engineState->getSettings()->getMaxDirectionalLights()][j][k]->getSize()}}}};
-          facesSet[j]->createCustom(k, bufferInfo, {});
-        }
-      }
-      _descriptorSetCameraDepth.push_back(facesSet);
-    }
+  // the same set is used for all lights and faces, camera matrices are pushed to uniform ring every draw
+  _descriptorSetCameraDepth = std::make_shared<DescriptorSet>(_engineState->getSettings()->getMaxFramesInFlight(),
+                                                              cameraLayout, _engineState);
+  for (int i = 0; i < _engineState->getSettings()->getMaxFramesInFlight(); i++) {
+    std::map<int, std::vector<VkDescriptorBufferInfo>> bufferInfo = {
+        {0,
+         {{.buffer = _engineState->getUniformRing()->getBuffer(i)->getData(),
+           .offset = 0,
+           .range = sizeof(BufferMVP)}}}};
+    _descriptorSetCameraDepth->createCustom(i, bufferInfo, {});
   }
 
   // initialize depth directional
   {
     auto shader = std::make_shared<Shader>(_engineState);
-    shader->add("shaders/model/modelDepth_vertex.spv", VK_SHADER_STAGE_VERTEX_BIT);
+    shader->add("shaders/model/modelDepth" + vertexVariant + "_vertex.spv", VK_SHADER_STAGE_VERTEX_BIT);
     shader->add("shaders/model/modelDepthDirectional_fragment.spv", VK_SHADER_STAGE_FRAGMENT_BIT);
     _pipelineDirectional = std::make_shared<PipelineGraphic>(_engineState->getDevice());
     _pipelineDirectional->setDepthBias(true);
@@ -601,7 +647,10 @@ Model3D::Model3D(const std::vector<std::shared_ptr<NodeGLTF>>& nodes,
     _pipelineDirectional->createCustom(
         {shader->getShaderStageInfo(VK_SHADER_STAGE_VERTEX_BIT),
          shader->getShaderStageInfo(VK_SHADER_STAGE_FRAGMENT_BIT)},
-        {{"depth", cameraLayout}, {"joints", _descriptorSetLayoutJoints}}, {}, _mesh->getBindingDescription(),
+        {{"depth", cameraLayout},
+         {"joints", _descriptorSetLayoutJoints},
+         {"instances", _instanceBuffer->getDescriptorSetLayout()}},
+        vertexPushConstants, _mesh->getBindingDescription(),
         _mesh->Mesh::getAttributeDescriptions({{VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex3D, pos)},
                                                {VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Vertex3D, jointIndices)},
                                                {VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Vertex3D, jointWeights)}}),
@@ -611,13 +660,13 @@ Model3D::Model3D(const std::vector<std::shared_ptr<NodeGLTF>>& nodes,
   // initialize depth point
   {
     auto shader = std::make_shared<Shader>(_engineState);
-    shader->add("shaders/model/modelDepth_vertex.spv", VK_SHADER_STAGE_VERTEX_BIT);
+    shader->add("shaders/model/modelDepth" + vertexVariant + "_vertex.spv", VK_SHADER_STAGE_VERTEX_BIT);
     shader->add("shaders/model/modelDepthPoint_fragment.spv", VK_SHADER_STAGE_FRAGMENT_BIT);
     _pipelinePoint = std::make_shared<PipelineGraphic>(_engineState->getDevice());
-    std::map<std::string, VkPushConstantRange> defaultPushConstants;
+    std::map<std::string, VkPushConstantRange> defaultPushConstants = vertexPushConstants;
     defaultPushConstants["constants"] = VkPushConstantRange{
         .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT,
-        .offset = 0,
+        .offset = sizeof(VertexPush),
         .size = sizeof(FragmentPointLightPushDepth),
     };
 
@@ -626,7 +675,10 @@ Model3D::Model3D(const std::vector<std::shared_ptr<NodeGLTF>>& nodes,
     _pipelinePoint->createCustom(
         {shader->getShaderStageInfo(VK_SHADER_STAGE_VERTEX_BIT),
          shader->getShaderStageInfo(VK_SHADER_STAGE_FRAGMENT_BIT)},
-        {{"depth", cameraLayout}, {"joints", _descriptorSetLayoutJoints}}, defaultPushConstants,
+        {{"depth", cameraLayout},
+         {"joints", _descriptorSetLayoutJoints},
+         {"instances", _instanceBuffer->getDescriptorSetLayout()}},
+        defaultPushConstants,
         _mesh->getBindingDescription(),
         _mesh->Mesh::getAttributeDescriptions({{VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex3D, pos)},
                                                {VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Vertex3D, jointIndices)},
@@ -645,21 +697,66 @@ void Model3D::_updateJointsDescriptor() {
           {0,
            {{.buffer = _animation->getJointMatricesBuffer()[skin][i]->getData(),
              .offset = 0,
-             .range = _animation->getJointMatricesBuffer()[skin][i]->getSize()}}}};
+             .range = _animation->getJointMatricesBuffer()[skin][i]->getSize()}}},
+          {1, {{.buffer = _nodesBuffer[i]->getData(), .offset = 0, .range = _nodesBuffer[i]->getSize()}}},
+          {2, {{.buffer = _drawsBuffer[i]->getData(), .offset = 0, .range = _drawsBuffer[i]->getSize()}}}};
       _descriptorSetJoints[skin]->createCustom(i, bufferInfo, {});
     }
   }
 }
 
+void Model3D::_updateSkinning() {
+  _descriptorSetSkinning.clear();
+  if (_skinning) {
+    int framesInFlight = _engineState->getSettings()->getMaxFramesInFlight();
+    auto jointsBuffer = _animation->getJointMatricesBuffer();
+    for (int nodeIndex = 0; nodeIndex < _nodesOrdered.size(); nodeIndex++) {
+      auto node = _nodesOrdered[nodeIndex];
+      if (node->mesh < 0 || node->skin < 0 || node->skin >= _animation->getSkinNumber()) continue;
+      auto mesh = _meshes[node->mesh];
+      auto& vertices = mesh->getVertexData();
+      if (vertices.size() == 0 || mesh->getVertexBuffer() == nullptr) continue;
+      // static attributes are copied once in skin, compute shader overwrites only position, normal and tangent
+      if (_skinnedBuffers.find(nodeIndex) == _skinnedBuffers.end()) {
+        _skinnedUnfilled.resize(framesInFlight);
+        for (int i = 0; i < framesInFlight; i++) {
+          VkBufferUsageFlags usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
+                                     VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+          _skinnedBuffers[nodeIndex].push_back(std::make_shared<Buffer>(
+              sizeof(Vertex3D) * vertices.size(), usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, _engineState));
+          _skinnedUnfilled[i].insert(nodeIndex);
+        }
+      }
+
+      auto descriptorSet = std::make_shared<DescriptorSet>(framesInFlight, _skinning->getDescriptorSetLayout(),
+                                                           _engineState);
+      for (int i = 0; i < framesInFlight; i++) {
+        auto source = mesh->getVertexBuffer();
+        auto joints = jointsBuffer[node->skin][i];
+        auto skinned = _skinnedBuffers[nodeIndex][i];
+        std::map<int, std::vector<VkDescriptorBufferInfo>> bufferInfo = {
+            {0, {{.buffer = source->getData(), .offset = 0, .range = source->getSize()}}},
+            {1, {{.buffer = joints->getData(), .offset = 0, .range = joints->getSize()}}},
+            {2, {{.buffer = skinned->getData(), .offset = 0, .range = skinned->getSize()}}}};
+        descriptorSet->createCustom(i, bufferInfo, {});
+      }
+      _descriptorSetSkinning[nodeIndex] = descriptorSet;
+    }
+  }
+  // vertex buffers and vertex offsets of draws are changed
+  _updateDraws();
+  if (_culling) _culling->markChanged(this);
+}
+
 void Model3D::_updatePBRDescriptor() {
   int currentFrame = _engineState->getFrameInFlight();
   for (int i = 0; i < _materials.size(); i++) {
     std::shared_ptr<MaterialPBR> material = std::dynamic_pointer_cast<MaterialPBR>(_materials[i]);
     std::map<int, std::vector<VkDescriptorBufferInfo>> bufferInfoColor = {
         {0,
-         {{.buffer = _cameraUBOFull[currentFrame]->getData(),
+         {{.buffer = _engineState->getUniformRing()->getBuffer(currentFrame)->getData(),
            .offset = 0,
-           .range = _cameraUBOFull[currentFrame]->getSize()}}},
+           .range = sizeof(BufferMVP)}}},
         {10,
          {{.buffer = material->getBufferAlphaCutoff()[currentFrame]->getData(),
            .offset = 0,
@@ -717,9 +814,9 @@ void Model3D::_updatePhongDescriptor() {
     std::shared_ptr<MaterialPhong> material = std::dynamic_pointer_cast<MaterialPhong>(_materials[i]);
     std::map<int, std::vector<VkDescriptorBufferInfo>> bufferInfoColor = {
         {0,
-         {{.buffer = _cameraUBOFull[currentFrame]->getData(),
+         {{.buffer = _engineState->getUniformRing()->getBuffer(currentFrame)->getData(),
            .offset = 0,
-           .range = _cameraUBOFull[currentFrame]->getSize()}}},
+           .range = sizeof(BufferMVP)}}},
         {4,
          {{.buffer = material->getBufferAlphaCutoff()[currentFrame]->getData(),
            .offset = 0,
@@ -752,9 +849,9 @@ void Model3D::_updateColorDescriptor() {
     std::shared_ptr<MaterialColor> material = std::dynamic_pointer_cast<MaterialColor>(_materials[i]);
     std::map<int, std::vector<VkDescriptorBufferInfo>> bufferInfoColor = {
         {0,
-         {{.buffer = _cameraUBOFull[currentFrame]->getData(),
+         {{.buffer = _engineState->getUniformRing()->getBuffer(currentFrame)->getData(),
            .offset = 0,
-           .range = _cameraUBOFull[currentFrame]->getSize()}}}};
+           .range = sizeof(BufferMVP)}}}};
     auto texture = _defaultMaterialColor->getBaseColor();
     if (material->getBaseColor().size() > 0) texture = material->getBaseColor();
     std::map<int, std::vector<VkDescriptorImageInfo>> textureInfoColor = {
@@ -785,6 +882,9 @@ void Model3D::setMaterial(std::vector<std::shared_ptr<MaterialColor>> materials)
   for (int i = 0; i < _changedMaterial.size(); i++) {
     _changedMaterial[i] = true;
   }
+  // draws are grouped by material
+  _updateDraws();
+  if (_culling) _culling->markChanged(this);
 }
 
 void Model3D::setMaterial(std::vector<std::shared_ptr<MaterialPhong>> materials) {
@@ -808,6 +908,9 @@ void Model3D::setMaterial(std::vector<std::shared_ptr<MaterialPhong>> materials)
   for (int i = 0; i < _changedMaterial.size(); i++) {
     _changedMaterial[i] = true;
   }
+  // draws are grouped by material
+  _updateDraws();
+  if (_culling) _culling->markChanged(this);
 }
 
 void Model3D::setMaterial(std::vector<std::shared_ptr<MaterialPBR>> materials) {
@@ -836,6 +939,9 @@ void Model3D::setMaterial(std::vector<std::shared_ptr<MaterialPBR>> materials) {
   for (int i = 0; i < _changedMaterial.size(); i++) {
     _changedMaterial[i] = true;
   }
+  // draws are grouped by material
+  _updateDraws();
+  if (_culling) _culling->markChanged(this);
 }
 
 void Model3D::setDrawType(DrawType drawType) { _drawType = drawType; }
@@ -844,144 +950,318 @@ MaterialType Model3D::getMaterialType() { return _materialType; }
 
 DrawType Model3D::getDrawType() { return _drawType; }
 
-std::shared_ptr<AABB> Model3D::getAABB() {
+std::shared_ptr<AABB> Model3D::getAABB() { return _instanceBuffer->getAABB(getInstanceAABB()); }
+
+std::shared_ptr<AABB> Model3D::getInstanceAABB() {
+  auto& nodesMatrix = _getNodesMatrix();
+  auto& palettes = _animation->getPalettes();
   std::shared_ptr<AABB> aabbTotal = std::make_shared<AABB>();
-  for (auto& mesh : _meshes) {
-    auto aabb = mesh->getAABB();
-    aabbTotal->extend(aabb);
+  for (int i = 0; i < _nodesOrdered.size(); i++) {
+    auto node = _nodesOrdered[i];
+    if (node->mesh < 0) continue;
+    // skinned vertex is a blend of joint transforms, so it's inside union of boxes transformed by its joints
+    if (node->skin >= 0 && node->skin < palettes.size() && _jointsAABB.contains(node->mesh)) {
+      auto& jointsAABB = _jointsAABB[node->mesh];
+      auto& palette = palettes[node->skin];
+      for (int joint = 0; joint < std::min(jointsAABB.size(), palette.size()); joint++) {
+        if (jointsAABB[joint]) aabbTotal->extend(jointsAABB[joint]->transform(nodesMatrix[i] * palette[joint]));
+      }
+      continue;
+    }
+
+    auto aabb = _meshes[node->mesh]->getAABB();
+    // empty mesh has inverted box
+    if (aabb && aabb->getMin().x <= aabb->getMax().x) aabbTotal->extend(aabb->transform(nodesMatrix[i]));
   }
   return aabbTotal;
 }
 
+std::vector<glm::mat4> Model3D::getInstanceMatrices() { return _instanceBuffer->getMatrices(getModel()); }
+
+std::vector<VkDrawIndexedIndirectCommand> Model3D::getDrawCommands() {
+  std::vector<VkDrawIndexedIndirectCommand> commands;
+  for (auto& draw : _draws) {
+    auto mesh = _meshes[_nodesOrdered[draw.node]->mesh];
+    auto& primitive = mesh->getPrimitives()[draw.primitive];
+    // skinned buffer contains only vertices of the mesh
+    int vertexOffset = _descriptorSetSkinning.contains(draw.node) ? 0 : mesh->getVertexOffset();
+    commands.push_back({.indexCount = static_cast<uint32_t>(primitive.indexCount),
+                        .firstIndex = static_cast<uint32_t>(mesh->getIndexOffset() + primitive.firstIndex),
+                        .vertexOffset = vertexOffset});
+  }
+  return commands;
+}
+
+void Model3D::setCulling(std::shared_ptr<CullingCompute> culling) { _culling = culling; }
+
+void Model3D::setSkinning(std::shared_ptr<SkinningCompute> skinning) {
+  _skinning = skinning;
+  _updateSkinning();
+}
+
+void Model3D::skin(std::shared_ptr<CommandBuffer> commandBuffer) {
+  int currentFrame = _engineState->getFrameInFlight();
+  if (currentFrame < _skinnedUnfilled.size() && _skinnedUnfilled[currentFrame].size() > 0) {
+    // mesh can be uploaded to arena in the same frame
+    VkMemoryBarrier barrier{.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                            .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                            .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT};
+    vkCmdPipelineBarrier(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+    for (int nodeIndex : _skinnedUnfilled[currentFrame]) {
+      auto mesh = _meshes[_nodesOrdered[nodeIndex]->mesh];
+      auto skinned = _skinnedBuffers[nodeIndex][currentFrame];
+      skinned->copyFrom(mesh->getVertexBuffer(), sizeof(Vertex3D) * mesh->getVertexOffset(), 0, skinned->getSize(),
+                        commandBuffer);
+    }
+    _skinnedUnfilled[currentFrame].clear();
+    // compute shader keeps static attributes and overwrites the rest
+    barrier = {.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+               .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+               .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT};
+    vkCmdPipelineBarrier(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+  }
+  for (auto& [nodeIndex, descriptorSet] : _descriptorSetSkinning) {
+    auto mesh = _meshes[_nodesOrdered[nodeIndex]->mesh];
+    _skinning->dispatch(descriptorSet, mesh->getVertexOffset(), mesh->getVertexData().size(), commandBuffer);
+  }
+}
+
+std::vector<std::shared_ptr<Buffer>> Model3D::getSkinnedBuffers() {
+  std::vector<std::shared_ptr<Buffer>> buffers;
+  for (auto& [nodeIndex, descriptorSet] : _descriptorSetSkinning)
+    buffers.push_back(_skinnedBuffers[nodeIndex][_engineState->getFrameInFlight()]);
+  return buffers;
+}
+
+void Model3D::setInstances(std::vector<glm::mat4> instances) {
+  _instanceBuffer->setInstances(instances);
+  // bounds depend on instances
+  if (_callbackTransformChange) _callbackTransformChange();
+}
+
+const std::vector<glm::mat4>& Model3D::getInstances() { return _instanceBuffer->getInstances(); }
+
 void Model3D::setAnimation(std::shared_ptr<Animation> animation) {
+  _animation->unregisterPoseChange(this);
   _animation = animation;
+  // bounds follow pose of animation
+  _animation->registerPoseChange(this, [this]() {
+    if (_callbackTransformChange) _callbackTransformChange();
+  });
   _updateJointsDescriptor();
+  _updateSkinning();
+  if (_callbackTransformChange) _callbackTransformChange();
+}
+
+void Model3D::_updateDraws() {
+  _draws.clear();
+  for (int nodeIndex = 0; nodeIndex < _nodesOrdered.size(); nodeIndex++) {
+    auto node = _nodesOrdered[nodeIndex];
+    if (node->mesh < 0) continue;
+    auto& primitives = _meshes[node->mesh]->getPrimitives();
+    for (int i = 0; i < primitives.size(); i++) {
+      if (primitives[i].indexCount <= 0) continue;
+      // the first material is used if primitive doesn't have valid one
+      int material = 0;
+      if (primitives[i].materialIndex >= 0 && primitives[i].materialIndex < _materials.size())
+        material = primitives[i].materialIndex;
+      _draws.push_back({.node = nodeIndex, .primitive = i, .material = material});
+    }
+  }
+  // draws with the same material and joints become neighbours, pre-skinned nodes have own vertex buffers
+  auto key = [this](const Draw& draw) {
+    bool skinned = _descriptorSetSkinning.contains(draw.node);
+    return std::tuple{draw.material, skinned ? draw.node : -1, std::max(0, _nodesOrdered[draw.node]->skin)};
+  };
+  std::stable_sort(_draws.begin(), _draws.end(), [&](const Draw& left, const Draw& right) {
+    return key(left) < key(right);
+  });
+}
+
+void Model3D::_flattenNode(std::shared_ptr<NodeGLTF> node, int parent) {
+  _nodesOrdered.push_back(node);
+  _nodesParent.push_back(parent);
+  int index = _nodesOrdered.size() - 1;
+  for (auto& child : node->children) _flattenNode(child, index);
 }
 
-void Model3D::_drawNode(std::shared_ptr<CommandBuffer> commandBuffer,
-                        std::shared_ptr<Pipeline> pipeline,
-                        std::shared_ptr<Pipeline> pipelineCullOff,
-                        std::shared_ptr<DescriptorSet> cameraDS,
-                        std::vector<std::shared_ptr<Buffer>> cameraUBO,
-                        glm::mat4 view,
-                        glm::mat4 projection,
-                        std::shared_ptr<NodeGLTF> node) {
+const std::vector<glm::mat4>& Model3D::_getNodesMatrix() {
+  // pose of frame is taken by Core before recording, so it's the same pose as joint matrices of frame
+  auto& nodesMatrix = _animation->getNodeMatrices();
+  if (nodesMatrix.size() == _nodesMatrix.size()) return nodesMatrix;
+  return _nodesMatrix;
+}
+
+void Model3D::_updateNodes() {
+  std::unique_lock<std::mutex> lock(_nodesMutex);
+  // draw and drawShadow share world matrices during the frame, so upload them only once
+  if (_nodesFrame == _engineState->getFrame()) return;
+
+  auto& nodesMatrix = _getNodesMatrix();
+  if (nodesMatrix.size() > 0)
+    _nodesBuffer[_engineState->getFrameInFlight()]->setData(nodesMatrix.data(), sizeof(glm::mat4) * nodesMatrix.size());
+  std::vector<int> drawNodes(_draws.size());
+  for (int i = 0; i < _draws.size(); i++) drawNodes[i] = _draws[i].node;
+  if (drawNodes.size() > 0)
+    _drawsBuffer[_engineState->getFrameInFlight()]->setData(drawNodes.data(), sizeof(int) * drawNodes.size());
+  _nodesFrame = _engineState->getFrame();
+}
+
+void Model3D::_drawNodes(std::shared_ptr<CommandBuffer> commandBuffer,
+                         std::shared_ptr<Pipeline> pipeline,
+                         std::shared_ptr<Pipeline> pipelineCullOff,
+                         uint32_t cameraOffset,
+                         std::shared_ptr<CullingCompute> culling) {
   int currentFrame = _engineState->getFrameInFlight();
-  if (node->mesh >= 0 && _meshes[node->mesh]->getPrimitives().size() > 0) {
-    VkBuffer vertexBuffers[] = {_meshes[node->mesh]->getVertexBuffer()->getBuffer()->getData()};
-    VkDeviceSize offsets[] = {0};
-    vkCmdBindVertexBuffers(commandBuffer->getCommandBuffer()[currentFrame], 0, 1, vertexBuffers, offsets);
-    vkCmdBindIndexBuffer(commandBuffer->getCommandBuffer()[currentFrame],
-                         _meshes[node->mesh]->getIndexBuffer()->getBuffer()->getData(), 0, VK_INDEX_TYPE_UINT32);
-
-    glm::mat4 nodeMatrix = node->getLocalMatrix();
-    std::shared_ptr<NodeGLTF> currentParent = node->parent;
-    while (currentParent) {
-      nodeMatrix = currentParent->getLocalMatrix() * nodeMatrix;
-      currentParent = currentParent->parent;
+  auto pipelineLayout = pipeline->getDescriptorSetLayout();
+  // visible instances and their number are written by culling compute shader
+  bool indirect = culling && culling->contains(this);
+
+  // normals and tangents
+  auto normalTangentLayout = std::find_if(pipelineLayout.begin(), pipelineLayout.end(),
+                                          [](std::pair<std::string, std::shared_ptr<DescriptorSetLayout>> info) {
+                                            return info.first == std::string("normal");
+                                          });
+  if (normalTangentLayout != pipelineLayout.end()) {
+    // vertex and geometry stages read the same camera
+    std::array<uint32_t, 2> cameraOffsets = {cameraOffset, cameraOffset};
+    vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
+                            pipeline->getPipelineLayout(), 0, 1,
+                            &_descriptorSetNormalsMesh->getDescriptorSets()[currentFrame], cameraOffsets.size(),
+                            cameraOffsets.data());
+  }
+
+  // depth
+  auto depthLayout = std::find_if(pipelineLayout.begin(), pipelineLayout.end(),
+                                  [](std::pair<std::string, std::shared_ptr<DescriptorSetLayout>> info) {
+                                    return info.first == std::string("depth");
+                                  });
+  if (depthLayout != pipelineLayout.end()) {
+    vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
+                            pipeline->getPipelineLayout(), 0, 1,
+                            &_descriptorSetCameraDepth->getDescriptorSets()[currentFrame], 1, &cameraOffset);
+  }
+
+  // instances, set number depends on pipeline
+  auto instanceLayout = std::find_if(pipelineLayout.begin(), pipelineLayout.end(),
+                                     [](std::pair<std::string, std::shared_ptr<DescriptorSetLayout>> info) {
+                                       return info.first == std::string("instances");
+                                     });
+  if (instanceLayout != pipelineLayout.end()) {
+    auto descriptorSetInstances = indirect ? culling->getDescriptorSetInstances() : _instanceBuffer->getDescriptorSet();
+    vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
+                            pipeline->getPipelineLayout(), std::distance(pipelineLayout.begin(), instanceLayout), 1,
+                            &descriptorSetInstances->getDescriptorSets()[currentFrame], 0, nullptr);
+  }
+
+  auto jointLayout = std::find_if(pipelineLayout.begin(), pipelineLayout.end(),
+                                  [](std::pair<std::string, std::shared_ptr<DescriptorSetLayout>> info) {
+                                    return info.first == std::string("joints");
+                                  });
+
+  // draws with the same state are merged to one indirect draw, they differ only by index range and node
+  auto state = [&](const Draw& draw) {
+    auto node = _nodesOrdered[draw.node];
+    auto mesh = _meshes[node->mesh];
+    // pre-skinned vertices are drawn as static geometry from own buffer
+    bool skinned = _descriptorSetSkinning.contains(draw.node);
+    auto vertexBuffer = skinned ? _skinnedBuffers[draw.node][currentFrame] : mesh->getVertexBuffer();
+    // if node->skin == -1 then use 0 index that contains identity matrix because of animation default behavior
+    auto descriptorSetJoints = skinned ? _descriptorSetJointsStatic : _descriptorSetJoints[std::max(0, node->skin)];
+    return std::tuple{draw.material, vertexBuffer->getData(), mesh->getIndexBuffer()->getData(), descriptorSetJoints};
+  };
+
+  // meshes are suballocated from shared arena blocks, so rebind only if block is changed
+  VkBuffer boundVertex = VK_NULL_HANDLE, boundIndex = VK_NULL_HANDLE;
+  for (int draw = 0; draw < _draws.size();) {
+    auto current = state(_draws[draw]);
+    auto [materialIndex, vertexBuffer, indexBuffer, descriptorSetJoints] = current;
+    int count = 1;
+    if (indirect) {
+      while (draw + count < _draws.size() && state(_draws[draw + count]) == current) count++;
     }
-    // pass this matrix to uniforms
-    BufferMVP cameraMVP{.model = getModel() * nodeMatrix, .view = view, .projection = projection};
 
-    cameraUBO[currentFrame]->setData(&cameraMVP);
+    if (vertexBuffer != boundVertex) {
+      boundVertex = vertexBuffer;
+      VkDeviceSize offsets[] = {0};
+      vkCmdBindVertexBuffers(commandBuffer->getCommandBuffer()[currentFrame], 0, 1, &boundVertex, offsets);
+    }
+    if (indexBuffer != boundIndex) {
+      boundIndex = indexBuffer;
+      vkCmdBindIndexBuffer(commandBuffer->getCommandBuffer()[currentFrame], boundIndex, 0, VK_INDEX_TYPE_UINT32);
+    }
 
-    auto pipelineLayout = pipeline->getDescriptorSetLayout();
+    // world matrix of node is taken from node matrices buffer by node of draw
+    if (pipeline->getPushConstants().find("vertex") != pipeline->getPushConstants().end()) {
+      VertexPush pushConstants{.draw = draw};
+      auto info = pipeline->getPushConstants()["vertex"];
+      vkCmdPushConstants(commandBuffer->getCommandBuffer()[currentFrame], pipeline->getPipelineLayout(),
+                         info.stageFlags, info.offset, info.size, &pushConstants);
+    }
 
-    // normals and tangents
-    auto normalTangentLayout = std::find_if(pipelineLayout.begin(), pipelineLayout.end(),
-                                            [](std::pair<std::string, std::shared_ptr<DescriptorSetLayout>> info) {
-                                              return info.first == std::string("normal");
-                                            });
-    if (normalTangentLayout != pipelineLayout.end()) {
+    // joints
+    if (jointLayout != pipelineLayout.end()) {
       vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
-                              pipeline->getPipelineLayout(), 0, 1,
-                              &_descriptorSetNormalsMesh->getDescriptorSets()[currentFrame], 0, nullptr);
+                              pipeline->getPipelineLayout(), 1, 1,
+                              &descriptorSetJoints->getDescriptorSets()[currentFrame], 0, nullptr);
     }
 
-    // depth
-    auto depthLayout = std::find_if(pipelineLayout.begin(), pipelineLayout.end(),
+    std::shared_ptr<Material> material = _defaultMaterialPhong;
+    if (_materials.size() > 0) material = _materials[materialIndex];
+
+    // color
+    auto layoutColor = std::find_if(pipelineLayout.begin(), pipelineLayout.end(),
                                     [](std::pair<std::string, std::shared_ptr<DescriptorSetLayout>> info) {
-                                      return info.first == std::string("depth");
+                                      return info.first == std::string("color");
                                     });
-    if (depthLayout != pipelineLayout.end()) {
+    if (layoutColor != pipelineLayout.end()) {
       vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
-                              pipeline->getPipelineLayout(), 0, 1, &cameraDS->getDescriptorSets()[currentFrame], 0,
-                              nullptr);
+                              pipeline->getPipelineLayout(), 0, 1,
+                              &_descriptorSetColor[materialIndex]->getDescriptorSets()[currentFrame], 1,
+                              &cameraOffset);
     }
 
-    // joints
-    auto jointLayout = std::find_if(pipelineLayout.begin(), pipelineLayout.end(),
+    // phong
+    auto layoutPhong = std::find_if(pipelineLayout.begin(), pipelineLayout.end(),
                                     [](std::pair<std::string, std::shared_ptr<DescriptorSetLayout>> info) {
-                                      return info.first == std::string("joints");
+                                      return info.first == std::string("phong");
                                     });
-
-    if (jointLayout != pipelineLayout.end()) {
-      // if node->skin == -1 then use 0 index that contains identity matrix because of animation default behavior
+    if (layoutPhong != pipelineLayout.end()) {
       vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
-                              pipeline->getPipelineLayout(), 1, 1,
-                              &_descriptorSetJoints[std::max(0, node->skin)]->getDescriptorSets()[currentFrame], 0,
-                              nullptr);
+                              pipeline->getPipelineLayout(), 0, 1,
+                              &_descriptorSetPhong[materialIndex]->getDescriptorSets()[currentFrame], 1,
+                              &cameraOffset);
     }
 
-    for (MeshPrimitive primitive : _meshes[node->mesh]->getPrimitives()) {
-      if (primitive.indexCount > 0) {
-        std::shared_ptr<Material> material = _defaultMaterialPhong;
-        int materialIndex = 0;
-        // Get the texture index for this primitive
-        if (_materials.size() > 0) {
-          material = _materials.front();
-          if (primitive.materialIndex >= 0 && primitive.materialIndex < _materials.size()) {
-            material = _materials[primitive.materialIndex];
-            materialIndex = primitive.materialIndex;
-          }
-        }
-
-        // color
-        auto layoutColor = std::find_if(pipelineLayout.begin(), pipelineLayout.end(),
-                                        [](std::pair<std::string, std::shared_ptr<DescriptorSetLayout>> info) {
-                                          return info.first == std::string("color");
-                                        });
-        if (layoutColor != pipelineLayout.end()) {
-          vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                  pipeline->getPipelineLayout(), 0, 1,
-                                  &_descriptorSetColor[materialIndex]->getDescriptorSets()[currentFrame], 0, nullptr);
-        }
-
-        // phong
-        auto layoutPhong = std::find_if(pipelineLayout.begin(), pipelineLayout.end(),
-                                        [](std::pair<std::string, std::shared_ptr<DescriptorSetLayout>> info) {
-                                          return info.first == std::string("phong");
-                                        });
-        if (layoutPhong != pipelineLayout.end()) {
-          vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                  pipeline->getPipelineLayout(), 0, 1,
-                                  &_descriptorSetPhong[materialIndex]->getDescriptorSets()[currentFrame], 0, nullptr);
-        }
-
-        // pbr
-        auto layoutPBR = std::find_if(pipelineLayout.begin(), pipelineLayout.end(),
-                                      [](std::pair<std::string, std::shared_ptr<DescriptorSetLayout>> info) {
-                                        return info.first == std::string("pbr");
-                                      });
-        if (layoutPBR != pipelineLayout.end()) {
-          vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                  pipeline->getPipelineLayout(), 0, 1,
-                                  &_descriptorSetPBR[materialIndex]->getDescriptorSets()[currentFrame], 0, nullptr);
-        }
-
-        auto currentPipeline = pipeline;
-        // by default double side is false
-        if (material->getDoubleSided()) currentPipeline = pipelineCullOff;
-        vkCmdBindPipeline(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
-                          currentPipeline->getPipeline());
-        vkCmdDrawIndexed(commandBuffer->getCommandBuffer()[currentFrame], primitive.indexCount, 1, primitive.firstIndex,
-                         0, 0);
-      }
+    // pbr
+    auto layoutPBR = std::find_if(pipelineLayout.begin(), pipelineLayout.end(),
+                                  [](std::pair<std::string, std::shared_ptr<DescriptorSetLayout>> info) {
+                                    return info.first == std::string("pbr");
+                                  });
+    if (layoutPBR != pipelineLayout.end()) {
+      vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
+                              pipeline->getPipelineLayout(), 0, 1,
+                              &_descriptorSetPBR[materialIndex]->getDescriptorSets()[currentFrame], 1, &cameraOffset);
     }
-  }
 
-  for (auto& child : node->children) {
-    _drawNode(commandBuffer, pipeline, pipelineCullOff, cameraDS, cameraUBO, view, projection, child);
+    auto currentPipeline = pipeline;
+    // by default double side is false
+    if (material->getDoubleSided()) currentPipeline = pipelineCullOff;
+    vkCmdBindPipeline(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
+                      currentPipeline->getPipeline());
+    if (indirect) {
+      culling->drawIndirect(this, draw, count, commandBuffer);
+    } else {
+      auto mesh = _meshes[_nodesOrdered[_draws[draw].node]->mesh];
+      auto& primitive = mesh->getPrimitives()[_draws[draw].primitive];
+      int vertexOffset = _descriptorSetSkinning.contains(_draws[draw].node) ? 0 : mesh->getVertexOffset();
+      vkCmdDrawIndexed(commandBuffer->getCommandBuffer()[currentFrame], primitive.indexCount,
+                       _instanceBuffer->getInstanceCount(), mesh->getIndexOffset() + primitive.firstIndex,
+                       vertexOffset, 0);
+    }
+    draw += count;
   }
 }
 
@@ -1064,12 +1344,15 @@ void Model3D::draw(std::shared_ptr<CommandBuffer> commandBuffer) {
         2, 1, &_gameState->getLightManager()->getDSGlobalPBR()->getDescriptorSets()[currentFrame], 0, nullptr);
   }
 
-  // Render all nodes at top-level
-  for (auto& node : _nodes) {
-    _drawNode(commandBuffer, pipeline, pipelineCullOff, nullptr, _cameraUBOFull,
-              _gameState->getCameraManager()->getCurrentCamera()->getView(),
-              _gameState->getCameraManager()->getCurrentCamera()->getProjection(), node);
-  }
+  // node and model matrices are applied in shader from storage buffers
+  BufferMVP cameraMVP{.model = glm::mat4(1.f),
+                      .view = _gameState->getCameraManager()->getCurrentCamera()->getView(),
+                      .projection = _gameState->getCameraManager()->getCurrentCamera()->getProjection()};
+  uint32_t cameraOffset = _engineState->getUniformRing()->push(&cameraMVP, sizeof(BufferMVP));
+
+  _updateNodes();
+  _instanceBuffer->update(getModel());
+  _drawNodes(commandBuffer, pipeline, pipelineCullOff, cameraOffset, _culling);
 }
 
 void Model3D::drawShadow(LightType lightType, int lightIndex, int face, std::shared_ptr<CommandBuffer> commandBuffer) {
@@ -1137,19 +1420,19 @@ void Model3D::drawShadow(LightType lightType, int lightIndex, int face, std::sha
 
   glm::mat4 view(1.f);
   glm::mat4 projection(1.f);
-  int lightIndexTotal = lightIndex;
   if (lightType == LightType::DIRECTIONAL) {
     view = _gameState->getLightManager()->getDirectionalLights()[lightIndex]->getCamera()->getView();
     projection = _gameState->getLightManager()->getDirectionalLights()[lightIndex]->getCamera()->getProjection();
   }
   if (lightType == LightType::POINT) {
-    lightIndexTotal += _engineState->getSettings()->getMaxDirectionalLights();
     view = _gameState->getLightManager()->getPointLights()[lightIndex]->getCamera()->getView(face);
     projection = _gameState->getLightManager()->getPointLights()[lightIndex]->getCamera()->getProjection();
   }
-  // Render all nodes at top-level
-  for (auto& node : _nodes) {
-    _drawNode(commandBuffer, pipeline, pipeline, _descriptorSetCameraDepth[lightIndexTotal][face],
-              _cameraUBODepth[lightIndexTotal][face], view, projection, node);
-  }
+  // node and model matrices are applied in shader from storage buffers
+  BufferMVP cameraMVP{.model = glm::mat4(1.f), .view = view, .projection = projection};
+  uint32_t cameraOffset = _engineState->getUniformRing()->push(&cameraMVP, sizeof(BufferMVP));
+
+  _updateNodes();
+  _instanceBuffer->update(getModel());
+  _drawNodes(commandBuffer, pipeline, pipeline, cameraOffset, nullptr);
 }
\ No newline at end of file
@@ -104,34 +104,31 @@ Shape3D::Shape3D(ShapeType shapeType,
   _renderPass = _engineState->getRenderPassManager()->getRenderPass(RenderPassScenario::GRAPHIC);
   _renderPassDepth = _engineState->getRenderPassManager()->getRenderPass(RenderPassScenario::SHADOW);
 
-  _uniformBufferCamera.resize(_engineState->getSettings()->getMaxFramesInFlight());
-  for (int i = 0; i < _engineState->getSettings()->getMaxFramesInFlight(); i++)
-    _uniformBufferCamera[i] = std::make_shared<Buffer>(
-        sizeof(BufferMVP), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, engineState);
+  _instanceBuffer = std::make_shared<InstanceBuffer>(engineState);
   // setup normals
   {
     _descriptorSetLayoutNormalsMesh = std::make_shared<DescriptorSetLayout>(_engineState->getDevice());
-    std::vector<VkDescriptorSetLayoutBinding> layoutNormalsMesh{{.binding = 0,
-                                                                 .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-                                                                 .descriptorCount = 1,
-                                                                 .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
-                                                                 .pImmutableSamplers = nullptr},
-                                                                {.binding = 1,
-                                                                 .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-                                                                 .descriptorCount = 1,
-                                                                 .stageFlags = VK_SHADER_STAGE_GEOMETRY_BIT,
-                                                                 .pImmutableSamplers = nullptr}};
+    std::vector<VkDescriptorSetLayoutBinding> layoutNormalsMesh{
+        {.binding = 0,
+         .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+         .descriptorCount = 1,
+         .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+         .pImmutableSamplers = nullptr},
+        {.binding = 1,
+         .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+         .descriptorCount = 1,
+         .stageFlags = VK_SHADER_STAGE_GEOMETRY_BIT,
+         .pImmutableSamplers = nullptr}};
     _descriptorSetLayoutNormalsMesh->createCustom(layoutNormalsMesh);
 
     _descriptorSetNormalsMesh = std::make_shared<DescriptorSet>(engineState->getSettings()->getMaxFramesInFlight(),
                                                                 _descriptorSetLayoutNormalsMesh, engineState);
     for (int i = 0; i < engineState->getSettings()->getMaxFramesInFlight(); i++) {
+      // camera matrices are pushed to uniform ring every draw, offset is passed during bind
+      auto uniformBuffer = _engineState->getUniformRing()->getBuffer(i);
       std::map<int, std::vector<VkDescriptorBufferInfo>> bufferInfoNormalsMesh = {
-          {0,
-           {{.buffer = _uniformBufferCamera[i]->getData(), .offset = 0, .range = _uniformBufferCamera[i]->getSize()}}},
-          {1,
-           {{.buffer = _uniformBufferCamera[i]->getData(), .offset = 0, .range = _uniformBufferCamera[i]->getSize()}}}};
+          {0, {{.buffer = uniformBuffer->getData(), .offset = 0, .range = sizeof(BufferMVP)}}},
+          {1, {{.buffer = uniformBuffer->getData(), .offset = 0, .range = sizeof(BufferMVP)}}}};
       _descriptorSetNormalsMesh->createCustom(i, bufferInfoNormalsMesh, {});
     }
 
@@ -150,7 +147,9 @@ Shape3D::Shape3D(ShapeType shapeType,
           {shader->getShaderStageInfo(VK_SHADER_STAGE_VERTEX_BIT),
            shader->getShaderStageInfo(VK_SHADER_STAGE_FRAGMENT_BIT),
            shader->getShaderStageInfo(VK_SHADER_STAGE_GEOMETRY_BIT)},
-          std::vector{std::pair{std::string("normal"), _descriptorSetLayoutNormalsMesh}}, {},
+          std::vector{std::pair{std::string("normal"), _descriptorSetLayoutNormalsMesh},
+                      std::pair{std::string("instances"), _instanceBuffer->getDescriptorSetLayout()}},
+          {},
           _mesh->getBindingDescription(),
           _mesh->Mesh::getAttributeDescriptions({{VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex3D, pos)},
                                                  {VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex3D, normal)},
@@ -172,7 +171,9 @@ Shape3D::Shape3D(ShapeType shapeType,
           {shader->getShaderStageInfo(VK_SHADER_STAGE_VERTEX_BIT),
            shader->getShaderStageInfo(VK_SHADER_STAGE_FRAGMENT_BIT),
            shader->getShaderStageInfo(VK_SHADER_STAGE_GEOMETRY_BIT)},
-          std::vector{std::pair{std::string("normal"), _descriptorSetLayoutNormalsMesh}}, {},
+          std::vector{std::pair{std::string("normal"), _descriptorSetLayoutNormalsMesh},
+                      std::pair{std::string("instances"), _instanceBuffer->getDescriptorSetLayout()}},
+          {},
           _mesh->getBindingDescription(),
           _mesh->Mesh::getAttributeDescriptions({{VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex3D, pos)},
                                                  {VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex3D, color)},
@@ -184,7 +185,7 @@ Shape3D::Shape3D(ShapeType shapeType,
   {
     auto descriptorSetLayout = std::make_shared<DescriptorSetLayout>(_engineState->getDevice());
     std::vector<VkDescriptorSetLayoutBinding> layoutColor{{.binding = 0,
-                                                           .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                                                           .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
                                                            .descriptorCount = 1,
                                                            .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
                                                            .pImmutableSamplers = nullptr},
@@ -195,6 +196,7 @@ Shape3D::Shape3D(ShapeType shapeType,
                                                            .pImmutableSamplers = nullptr}};
     descriptorSetLayout->createCustom(layoutColor);
     _descriptorSetLayout[MaterialType::COLOR].push_back({"color", descriptorSetLayout});
+    _descriptorSetLayout[MaterialType::COLOR].push_back({"instances", _instanceBuffer->getDescriptorSetLayout()});
 
     _descriptorSetColor = std::make_shared<DescriptorSet>(engineState->getSettings()->getMaxFramesInFlight(),
                                                           descriptorSetLayout, engineState);
@@ -243,7 +245,7 @@ Shape3D::Shape3D(ShapeType shapeType,
   {
     auto descriptorSetLayout = std::make_shared<DescriptorSetLayout>(_engineState->getDevice());
     std::vector<VkDescriptorSetLayoutBinding> layoutPhong{{.binding = 0,
-                                                           .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                                                           .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
                                                            .descriptorCount = 1,
                                                            .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
                                                            .pImmutableSamplers = nullptr},
@@ -271,6 +273,7 @@ Shape3D::Shape3D(ShapeType shapeType,
     _descriptorSetLayout[MaterialType::PHONG].push_back({"phong", descriptorSetLayout});
     _descriptorSetLayout[MaterialType::PHONG].push_back(
         {"globalPhong", _gameState->getLightManager()->getDSLGlobalPhong()});
+    _descriptorSetLayout[MaterialType::PHONG].push_back({"instances", _instanceBuffer->getDescriptorSetLayout()});
 
     _descriptorSetPhong = std::make_shared<DescriptorSet>(engineState->getSettings()->getMaxFramesInFlight(),
                                                           descriptorSetLayout, engineState);
@@ -333,7 +336,7 @@ Shape3D::Shape3D(ShapeType shapeType,
   {
     auto descriptorSetLayout = std::make_shared<DescriptorSetLayout>(_engineState->getDevice());
     std::vector<VkDescriptorSetLayoutBinding> layoutPBR{{.binding = 0,
-                                                         .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                                                         .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
                                                          .descriptorCount = 1,
                                                          .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
                                                          .pImmutableSamplers = nullptr},
@@ -395,6 +398,7 @@ Shape3D::Shape3D(ShapeType shapeType,
     descriptorSetLayout->createCustom(layoutPBR);
     _descriptorSetLayout[MaterialType::PBR].push_back({"pbr", descriptorSetLayout});
     _descriptorSetLayout[MaterialType::PBR].push_back({"globalPBR", _gameState->getLightManager()->getDSLGlobalPBR()});
+    _descriptorSetLayout[MaterialType::PBR].push_back({"instances", _instanceBuffer->getDescriptorSetLayout()});
 
     _descriptorSetPBR = std::make_shared<DescriptorSet>(engineState->getSettings()->getMaxFramesInFlight(),
                                                         descriptorSetLayout, engineState);
@@ -449,66 +453,22 @@ Shape3D::Shape3D(ShapeType shapeType,
   // shadows
   auto cameraLayout = std::make_shared<DescriptorSetLayout>(engineState->getDevice());
   VkDescriptorSetLayoutBinding layoutBinding = {.binding = 0,
-                                                .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                                                .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
                                                 .descriptorCount = 1,
                                                 .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
                                                 .pImmutableSamplers = nullptr};
   cameraLayout->createCustom({layoutBinding});
 
-  // initialize camera UBO and descriptor sets for shadow
-  // initialize UBO
-  for (int i = 0; i < _engineState->getSettings()->getMaxDirectionalLights(); i++) {
-    std::vector<std::shared_ptr<Buffer>> buffer(_engineState->getSettings()->getMaxFramesInFlight());
-    for (int j = 0; j < _engineState->getSettings()->getMaxFramesInFlight(); j++)
-      buffer[j] = std::make_shared<Buffer>(sizeof(BufferMVP), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                                           VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                                           _engineState);
-    _cameraUBODepth.push_back({buffer});
-  }
-
-  for (int i = 0; i < _engineState->getSettings()->getMaxPointLights(); i++) {
-    std::vector<std::vector<std::shared_ptr<Buffer>>> facesBuffer(6);
-    for (int j = 0; j < 6; j++) {
-      facesBuffer[j].resize(_engineState->getSettings()->getMaxFramesInFlight());
-      for (int k = 0; k < _engineState->getSettings()->getMaxFramesInFlight(); k++)
-        facesBuffer[j][k] = std::make_shared<Buffer>(
-            sizeof(BufferMVP), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, _engineState);
-    }
-    _cameraUBODepth.push_back(facesBuffer);
-  }
-  {
-    for (int i = 0; i < _engineState->getSettings()->getMaxDirectionalLights(); i++) {
-      auto cameraSet = std::make_shared<DescriptorSet>(_engineState->getSettings()->getMaxFramesInFlight(),
-                                                       cameraLayout, _engineState);
-      for (int j = 0; j < _engineState->getSettings()->getMaxFramesInFlight(); j++) {
-        std::map<int, std::vector<VkDescriptorBufferInfo>> bufferInfo = {
-            {0,
-             {{.buffer = _cameraUBODepth[i][0][j]->getData(),
-               .offset = 0,
-               .range = _cameraUBODepth[i][0][j]->getSize()}}}};
-        cameraSet->createCustom(j, bufferInfo, {});
-      }
-      _descriptorSetCameraDepth.push_back({cameraSet});
-    }
-
-    for (int i = 0; i < _engineState->getSettings()->getMaxPointLights(); i++) {
-      std::vector<std::shared_ptr<DescriptorSet>> facesSet(6);
-      for (int j = 0; j < 6; j++) {
-        facesSet[j] = std::make_shared<DescriptorSet>(_engineState->getSettings()->getMaxFramesInFlight(), cameraLayout,
-                                                      _engineState);
-        for (int k = 0; k < _engineState->getSettings()->getMaxFramesInFlight(); k++) {
-          std::map<int, std::vector<VkDescriptorBufferInfo>> bufferInfo = {
-              {0,
-               {{.buffer = _cameraUBODepth[i + _engineState->getSettings()->getMaxDirectionalLights()][j][k]->getData(),
-                 .offset = 0,
-                 .range =
-                     _cameraUBODepth[i + _engineState->getSettings()->getMaxDirectionalLights()][j][k]->getSize()}}}};
-          facesSet[j]->createCustom(k, bufferInfo, {});
-        }
-      }
-      _descriptorSetCameraDepth.push_back(facesSet);
-    }
+  // the same set is used for all lights and faces, camera matrices are pushed to uniform ring every draw
+  _descriptorSetCameraDepth = std::make_shared<DescriptorSet>(_engineState->getSettings()->getMaxFramesInFlight(),
+                                                              cameraLayout, _engineState);
+  for (int i = 0; i < _engineState->getSettings()->getMaxFramesInFlight(); i++) {
+    std::map<int, std::vector<VkDescriptorBufferInfo>> bufferInfo = {
+        {0,
+         {{.buffer = _engineState->getUniformRing()->getBuffer(i)->getData(),
+           .offset = 0,
+           .range = sizeof(BufferMVP)}}}};
+    _descriptorSetCameraDepth->createCustom(i, bufferInfo, {});
   }
 
   // initialize shadows directional
@@ -522,7 +482,8 @@ Shape3D::Shape3D(ShapeType shapeType,
     _pipelineDirectional->createCustom(
         {shader->getShaderStageInfo(VK_SHADER_STAGE_VERTEX_BIT),
          shader->getShaderStageInfo(VK_SHADER_STAGE_FRAGMENT_BIT)},
-        {{"depth", cameraLayout}}, {}, _mesh->getBindingDescription(),
+        {{"depth", cameraLayout}, {"instances", _instanceBuffer->getDescriptorSetLayout()}}, {},
+        _mesh->getBindingDescription(),
         _mesh->Mesh::getAttributeDescriptions({{VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex3D, pos)}}),
         _renderPassDepth);
   }
@@ -545,7 +506,8 @@ Shape3D::Shape3D(ShapeType shapeType,
     _pipelinePoint->createCustom(
         {shader->getShaderStageInfo(VK_SHADER_STAGE_VERTEX_BIT),
          shader->getShaderStageInfo(VK_SHADER_STAGE_FRAGMENT_BIT)},
-        {{"depth", cameraLayout}}, defaultPushConstants, _mesh->getBindingDescription(),
+        {{"depth", cameraLayout}, {"instances", _instanceBuffer->getDescriptorSetLayout()}}, defaultPushConstants,
+        _mesh->getBindingDescription(),
         _mesh->Mesh::getAttributeDescriptions({{VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex3D, pos)}}),
         _renderPassDepth);
   }
@@ -556,7 +518,9 @@ void Shape3D::_updateColorDescriptor(std::shared_ptr<MaterialColor> material) {
   for (int i = 0; i < _engineState->getSettings()->getMaxFramesInFlight(); i++) {
     std::map<int, std::vector<VkDescriptorBufferInfo>> bufferInfoColor = {
         {0,
-         {{.buffer = _uniformBufferCamera[i]->getData(), .offset = 0, .range = _uniformBufferCamera[i]->getSize()}}}};
+         {{.buffer = _engineState->getUniformRing()->getBuffer(i)->getData(),
+           .offset = 0,
+           .range = sizeof(BufferMVP)}}}};
     std::map<int, std::vector<VkDescriptorImageInfo>> textureInfoColor = {
         {1,
          {{.sampler = material->getBaseColor()[0]->getSampler()->getSampler(),
@@ -572,7 +536,10 @@ void Shape3D::_updatePhongDescriptor(std::shared_ptr<MaterialPhong> material) {
   std::vector<VkDescriptorImageInfo> colorImageInfo(_engineState->getSettings()->getMaxFramesInFlight());
   for (int i = 0; i < _engineState->getSettings()->getMaxFramesInFlight(); i++) {
     std::map<int, std::vector<VkDescriptorBufferInfo>> bufferInfoColor = {
-        {0, {{.buffer = _uniformBufferCamera[i]->getData(), .offset = 0, .range = _uniformBufferCamera[i]->getSize()}}},
+        {0,
+         {{.buffer = _engineState->getUniformRing()->getBuffer(i)->getData(),
+           .offset = 0,
+           .range = sizeof(BufferMVP)}}},
         {4,
          {{.buffer = material->getBufferCoefficients()[i]->getData(),
            .offset = 0,
@@ -601,7 +568,10 @@ void Shape3D::_updatePBRDescriptor(std::shared_ptr<MaterialPBR> material) {
   std::vector<VkDescriptorImageInfo> colorImageInfo(_engineState->getSettings()->getMaxFramesInFlight());
   for (int i = 0; i < _engineState->getSettings()->getMaxFramesInFlight(); i++) {
     std::map<int, std::vector<VkDescriptorBufferInfo>> bufferInfoColor = {
-        {0, {{.buffer = _uniformBufferCamera[i]->getData(), .offset = 0, .range = _uniformBufferCamera[i]->getSize()}}},
+        {0,
+         {{.buffer = _engineState->getUniformRing()->getBuffer(i)->getData(),
+           .offset = 0,
+           .range = sizeof(BufferMVP)}}},
         {10,
          {{.buffer = material->getBufferCoefficients()[i]->getData(),
            .offset = 0,
@@ -687,8 +657,32 @@ void Shape3D::setDrawType(DrawType drawType) { _drawType = drawType; }
 
 std::shared_ptr<MeshStatic3D> Shape3D::getMesh() { return _mesh; }
 
+void Shape3D::setInstances(std::vector<glm::mat4> instances) {
+  _instanceBuffer->setInstances(instances);
+  // bounds depend on instances
+  if (_callbackTransformChange) _callbackTransformChange();
+}
+
+const std::vector<glm::mat4>& Shape3D::getInstances() { return _instanceBuffer->getInstances(); }
+
+std::shared_ptr<AABB> Shape3D::getAABB() { return _instanceBuffer->getAABB(_mesh->getAABB()); }
+
+std::shared_ptr<AABB> Shape3D::getInstanceAABB() { return _mesh->getAABB(); }
+
+std::vector<glm::mat4> Shape3D::getInstanceMatrices() { return _instanceBuffer->getMatrices(getModel()); }
+
+std::vector<VkDrawIndexedIndirectCommand> Shape3D::getDrawCommands() {
+  return {{.indexCount = static_cast<uint32_t>(_mesh->getIndexData().size()),
+           .firstIndex = static_cast<uint32_t>(_mesh->getIndexOffset()),
+           .vertexOffset = _mesh->getVertexOffset()}};
+}
+
+void Shape3D::setCulling(std::shared_ptr<CullingCompute> culling) { _culling = culling; }
+
 void Shape3D::draw(std::shared_ptr<CommandBuffer> commandBuffer) {
   int currentFrame = _engineState->getFrameInFlight();
+  // visible instances and their number are written by culling compute shader
+  bool indirect = _culling && _culling->contains(this);
   auto drawShape3D = [&](std::shared_ptr<Pipeline> pipeline) {
     vkCmdBindPipeline(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
                       pipeline->getPipeline());
@@ -715,17 +709,19 @@ void Shape3D::draw(std::shared_ptr<CommandBuffer> commandBuffer) {
                          info.stageFlags, info.offset, info.size, &pushConstants);
     }
 
-    BufferMVP cameraUBO{.model = getModel(),
+    // model matrix is applied per instance
+    BufferMVP cameraUBO{.model = glm::mat4(1.f),
                         .view = _gameState->getCameraManager()->getCurrentCamera()->getView(),
                         .projection = _gameState->getCameraManager()->getCurrentCamera()->getProjection()};
-    _uniformBufferCamera[currentFrame]->setData(&cameraUBO);
+    uint32_t cameraOffset = _engineState->getUniformRing()->push(&cameraUBO, sizeof(BufferMVP));
+    _instanceBuffer->update(getModel());
 
-    VkBuffer vertexBuffers[] = {_mesh->getVertexBuffer()->getBuffer()->getData()};
+    VkBuffer vertexBuffers[] = {_mesh->getVertexBuffer()->getData()};
     VkDeviceSize offsets[] = {0};
     vkCmdBindVertexBuffers(commandBuffer->getCommandBuffer()[currentFrame], 0, 1, vertexBuffers, offsets);
 
     vkCmdBindIndexBuffer(commandBuffer->getCommandBuffer()[currentFrame],
-                         _mesh->getIndexBuffer()->getBuffer()->getData(), 0, VK_INDEX_TYPE_UINT32);
+                         _mesh->getIndexBuffer()->getData(), 0, VK_INDEX_TYPE_UINT32);
 
     // color
     auto pipelineLayout = pipeline->getDescriptorSetLayout();
@@ -736,7 +732,7 @@ void Shape3D::draw(std::shared_ptr<CommandBuffer> commandBuffer) {
     if (colorLayout != pipelineLayout.end()) {
       vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
                               pipeline->getPipelineLayout(), 0, 1,
-                              &_descriptorSetColor->getDescriptorSets()[currentFrame], 0, nullptr);
+                              &_descriptorSetColor->getDescriptorSets()[currentFrame], 1, &cameraOffset);
     }
 
     // Phong
@@ -747,7 +743,7 @@ void Shape3D::draw(std::shared_ptr<CommandBuffer> commandBuffer) {
     if (phongLayout != pipelineLayout.end()) {
       vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
                               pipeline->getPipelineLayout(), 0, 1,
-                              &_descriptorSetPhong->getDescriptorSets()[currentFrame], 0, nullptr);
+                              &_descriptorSetPhong->getDescriptorSets()[currentFrame], 1, &cameraOffset);
     }
 
     // global Phong
@@ -770,7 +766,7 @@ void Shape3D::draw(std::shared_ptr<CommandBuffer> commandBuffer) {
     if (pbrLayout != pipelineLayout.end()) {
       vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
                               pipeline->getPipelineLayout(), 0, 1,
-                              &_descriptorSetPBR->getDescriptorSets()[currentFrame], 0, nullptr);
+                              &_descriptorSetPBR->getDescriptorSets()[currentFrame], 1, &cameraOffset);
     }
 
     // global PBR
@@ -791,13 +787,34 @@ void Shape3D::draw(std::shared_ptr<CommandBuffer> commandBuffer) {
                                               return info.first == std::string("normal");
                                             });
     if (normalTangentLayout != pipelineLayout.end()) {
+      // vertex and geometry stages read the same camera
+      std::array<uint32_t, 2> cameraOffsets = {cameraOffset, cameraOffset};
       vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
                               pipeline->getPipelineLayout(), 0, 1,
-                              &_descriptorSetNormalsMesh->getDescriptorSets()[currentFrame], 0, nullptr);
+                              &_descriptorSetNormalsMesh->getDescriptorSets()[currentFrame], cameraOffsets.size(),
+                              cameraOffsets.data());
     }
 
-    vkCmdDrawIndexed(commandBuffer->getCommandBuffer()[currentFrame],
-                     static_cast<uint32_t>(_mesh->getIndexData().size()), 1, 0, 0, 0);
+    // instances, set number depends on pipeline
+    auto instanceLayout = std::find_if(pipelineLayout.begin(), pipelineLayout.end(),
+                                       [](std::pair<std::string, std::shared_ptr<DescriptorSetLayout>> info) {
+                                         return info.first == std::string("instances");
+                                       });
+    if (instanceLayout != pipelineLayout.end()) {
+      auto descriptorSetInstances = indirect ? _culling->getDescriptorSetInstances()
+                                             : _instanceBuffer->getDescriptorSet();
+      vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
+                              pipeline->getPipelineLayout(), std::distance(pipelineLayout.begin(), instanceLayout), 1,
+                              &descriptorSetInstances->getDescriptorSets()[currentFrame], 0, nullptr);
+    }
+
+    if (indirect) {
+      _culling->drawIndirect(this, 0, 1, commandBuffer);
+    } else {
+      vkCmdDrawIndexed(commandBuffer->getCommandBuffer()[currentFrame],
+                       static_cast<uint32_t>(_mesh->getIndexData().size()), _instanceBuffer->getInstanceCount(),
+                       _mesh->getIndexOffset(), _mesh->getVertexOffset(), 0);
+    }
   };
 
   auto pipeline = _pipeline[_shapeType][_materialType];
@@ -853,26 +870,26 @@ void Shape3D::drawShadow(LightType lightType, int lightIndex, int face, std::sha
 
   glm::mat4 view(1.f);
   glm::mat4 projection(1.f);
-  int lightIndexTotal = lightIndex;
   if (lightType == LightType::DIRECTIONAL) {
     view = _gameState->getLightManager()->getDirectionalLights()[lightIndex]->getCamera()->getView();
     projection = _gameState->getLightManager()->getDirectionalLights()[lightIndex]->getCamera()->getProjection();
   }
   if (lightType == LightType::POINT) {
-    lightIndexTotal += _engineState->getSettings()->getMaxDirectionalLights();
     view = _gameState->getLightManager()->getPointLights()[lightIndex]->getCamera()->getView(face);
     projection = _gameState->getLightManager()->getPointLights()[lightIndex]->getCamera()->getProjection();
   }
 
-  BufferMVP cameraMVP{.model = getModel(), .view = view, .projection = projection};
-  _cameraUBODepth[lightIndexTotal][face][currentFrame]->setData(&cameraMVP);
+  // model matrix is applied per instance
+  BufferMVP cameraMVP{.model = glm::mat4(1.f), .view = view, .projection = projection};
+  uint32_t cameraOffset = _engineState->getUniformRing()->push(&cameraMVP, sizeof(BufferMVP));
+  _instanceBuffer->update(getModel());
 
-  VkBuffer vertexBuffers[] = {_mesh->getVertexBuffer()->getBuffer()->getData()};
+  VkBuffer vertexBuffers[] = {_mesh->getVertexBuffer()->getData()};
   VkDeviceSize offsets[] = {0};
   vkCmdBindVertexBuffers(commandBuffer->getCommandBuffer()[currentFrame], 0, 1, vertexBuffers, offsets);
 
-  vkCmdBindIndexBuffer(commandBuffer->getCommandBuffer()[currentFrame], _mesh->getIndexBuffer()->getBuffer()->getData(),
-                       0, VK_INDEX_TYPE_UINT32);
+  vkCmdBindIndexBuffer(commandBuffer->getCommandBuffer()[currentFrame], _mesh->getIndexBuffer()->getData(), 0,
+                       VK_INDEX_TYPE_UINT32);
 
   auto pipelineLayout = pipeline->getDescriptorSetLayout();
   auto depthLayout = std::find_if(pipelineLayout.begin(), pipelineLayout.end(),
@@ -882,9 +899,19 @@ void Shape3D::drawShadow(LightType lightType, int lightIndex, int face, std::sha
   if (depthLayout != pipelineLayout.end()) {
     vkCmdBindDescriptorSets(
         commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->getPipelineLayout(),
-        0, 1, &_descriptorSetCameraDepth[lightIndexTotal][face]->getDescriptorSets()[currentFrame], 0, nullptr);
+        0, 1, &_descriptorSetCameraDepth->getDescriptorSets()[currentFrame], 1, &cameraOffset);
+  }
+
+  auto instanceLayout = std::find_if(pipelineLayout.begin(), pipelineLayout.end(),
+                                     [](std::pair<std::string, std::shared_ptr<DescriptorSetLayout>> info) {
+                                       return info.first == std::string("instances");
+                                     });
+  if (instanceLayout != pipelineLayout.end()) {
+    vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
+                            pipeline->getPipelineLayout(), std::distance(pipelineLayout.begin(), instanceLayout), 1,
+                            &_instanceBuffer->getDescriptorSet()->getDescriptorSets()[currentFrame], 0, nullptr);
   }
 
   vkCmdDrawIndexed(commandBuffer->getCommandBuffer()[currentFrame], static_cast<uint32_t>(_mesh->getIndexData().size()),
-                   1, 0, 0, 0);
+                   _instanceBuffer->getInstanceCount(), _mesh->getIndexOffset(), _mesh->getVertexOffset(), 0);
 }
\ No newline at end of file
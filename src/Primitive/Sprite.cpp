@@ -43,37 +43,32 @@ Sprite::Sprite(std::shared_ptr<CommandBuffer> commandBufferTransfer,
   _renderPass = _engineState->getRenderPassManager()->getRenderPass(RenderPassScenario::GRAPHIC);
   _renderPassDepth = _engineState->getRenderPassManager()->getRenderPass(RenderPassScenario::SHADOW);
 
-  // initialize UBO
-  _cameraUBOFull.resize(_engineState->getSettings()->getMaxFramesInFlight());
-  for (int i = 0; i < _engineState->getSettings()->getMaxFramesInFlight(); i++)
-    _cameraUBOFull[i] = std::make_shared<Buffer>(
-        sizeof(BufferMVP), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, _engineState);
-
   // setup Normal
   {
     _descriptorSetLayoutNormalsMesh = std::make_shared<DescriptorSetLayout>(_engineState->getDevice());
-    std::vector<VkDescriptorSetLayoutBinding> layoutNormalsMesh{{.binding = 0,
-                                                                 .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-                                                                 .descriptorCount = 1,
-                                                                 .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
-                                                                 .pImmutableSamplers = nullptr},
-                                                                {.binding = 1,
-                                                                 .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-                                                                 .descriptorCount = 1,
-                                                                 .stageFlags = VK_SHADER_STAGE_GEOMETRY_BIT,
-                                                                 .pImmutableSamplers = nullptr}};
+    std::vector<VkDescriptorSetLayoutBinding> layoutNormalsMesh{
+        {.binding = 0,
+         .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+         .descriptorCount = 1,
+         .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+         .pImmutableSamplers = nullptr},
+        {.binding = 1,
+         .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+         .descriptorCount = 1,
+         .stageFlags = VK_SHADER_STAGE_GEOMETRY_BIT,
+         .pImmutableSamplers = nullptr}};
     _descriptorSetLayoutNormalsMesh->createCustom(layoutNormalsMesh);
 
-    // TODO: we can just have one buffer and put it twice to descriptor
     _descriptorSetNormalsMesh = std::make_shared<DescriptorSet>(engineState->getSettings()->getMaxFramesInFlight(),
                                                                 _descriptorSetLayoutNormalsMesh, engineState);
     loggerUtils->setName("Descriptor set sprite normals mesh", VkObjectType::VK_OBJECT_TYPE_DESCRIPTOR_SET,
                          _descriptorSetNormalsMesh->getDescriptorSets());
     for (int i = 0; i < engineState->getSettings()->getMaxFramesInFlight(); i++) {
+      // camera matrices are pushed to uniform ring every draw, offset is passed during bind
+      auto uniformBuffer = _engineState->getUniformRing()->getBuffer(i);
       std::map<int, std::vector<VkDescriptorBufferInfo>> bufferInfoNormalsMesh = {
-          {0, {{.buffer = _cameraUBOFull[i]->getData(), .offset = 0, .range = _cameraUBOFull[i]->getSize()}}},
-          {1, {{.buffer = _cameraUBOFull[i]->getData(), .offset = 0, .range = _cameraUBOFull[i]->getSize()}}}};
+          {0, {{.buffer = uniformBuffer->getData(), .offset = 0, .range = sizeof(BufferMVP)}}},
+          {1, {{.buffer = uniformBuffer->getData(), .offset = 0, .range = sizeof(BufferMVP)}}}};
       _descriptorSetNormalsMesh->createCustom(i, bufferInfoNormalsMesh, {});
     }
 
@@ -126,7 +121,7 @@ Sprite::Sprite(std::shared_ptr<CommandBuffer> commandBufferTransfer,
   {
     auto descriptorSetLayout = std::make_shared<DescriptorSetLayout>(_engineState->getDevice());
     std::vector<VkDescriptorSetLayoutBinding> layoutColor{{.binding = 0,
-                                                           .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                                                           .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
                                                            .descriptorCount = 1,
                                                            .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
                                                            .pImmutableSamplers = nullptr},
@@ -186,45 +181,17 @@ Sprite::Sprite(std::shared_ptr<CommandBuffer> commandBufferTransfer,
     }
   }
 
-  // initialize camera UBO and descriptor sets for shadow
-  // initialize UBO
-  for (int i = 0; i < _engineState->getSettings()->getMaxDirectionalLights(); i++) {
-    std::vector<std::shared_ptr<Buffer>> buffer(_engineState->getSettings()->getMaxFramesInFlight());
-    for (int j = 0; j < _engineState->getSettings()->getMaxFramesInFlight(); j++)
-      buffer[j] = std::make_shared<Buffer>(sizeof(BufferMVP), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                                           VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                                           _engineState);
-    _cameraUBODepth.push_back({buffer});
-    auto cameraSet = std::make_shared<DescriptorSet>(_engineState->getSettings()->getMaxFramesInFlight(),
-                                                     _descriptorSetLayoutDepth, _engineState);
-    loggerUtils->setName("Descriptor set sprite directional camera " + std::to_string(i),
-                         VkObjectType::VK_OBJECT_TYPE_DESCRIPTOR_SET, cameraSet->getDescriptorSets());
-    _descriptorSetCameraDepth.push_back({cameraSet});
-  }
-
-  for (int i = 0; i < _engineState->getSettings()->getMaxPointLights(); i++) {
-    std::vector<std::vector<std::shared_ptr<Buffer>>> facesBuffer(6);
-    std::vector<std::shared_ptr<DescriptorSet>> facesSet(6);
-    for (int j = 0; j < 6; j++) {
-      facesBuffer[j].resize(_engineState->getSettings()->getMaxFramesInFlight());
-      for (int k = 0; k < _engineState->getSettings()->getMaxFramesInFlight(); k++)
-        facesBuffer[j][k] = std::make_shared<Buffer>(
-            sizeof(BufferMVP), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, _engineState);
-      facesSet[j] = std::make_shared<DescriptorSet>(_engineState->getSettings()->getMaxFramesInFlight(),
-                                                    _descriptorSetLayoutDepth, _engineState);
-      loggerUtils->setName("Descriptor set sprite point camera " + std::to_string(i) + "x" + std::to_string(j),
-                           VkObjectType::VK_OBJECT_TYPE_DESCRIPTOR_SET, facesSet[j]->getDescriptorSets());
-    }
-    _cameraUBODepth.push_back(facesBuffer);
-    _descriptorSetCameraDepth.push_back(facesSet);
-  }
+  // the same set is used for all lights and faces, camera matrices are pushed to uniform ring every draw
+  _descriptorSetCameraDepth = std::make_shared<DescriptorSet>(_engineState->getSettings()->getMaxFramesInFlight(),
+                                                              _descriptorSetLayoutDepth, _engineState);
+  loggerUtils->setName("Descriptor set sprite depth camera", VkObjectType::VK_OBJECT_TYPE_DESCRIPTOR_SET,
+                       _descriptorSetCameraDepth->getDescriptorSets());
 
   // setup Phong
   {
     auto descriptorSetLayout = std::make_shared<DescriptorSetLayout>(_engineState->getDevice());
     std::vector<VkDescriptorSetLayoutBinding> layoutPhong{{.binding = 0,
-                                                           .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                                                           .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
                                                            .descriptorCount = 1,
                                                            .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
                                                            .pImmutableSamplers = nullptr},
@@ -298,7 +265,7 @@ Sprite::Sprite(std::shared_ptr<CommandBuffer> commandBufferTransfer,
   {
     auto descriptorSetLayout = std::make_shared<DescriptorSetLayout>(_engineState->getDevice());
     std::vector<VkDescriptorSetLayoutBinding> layoutPBR{{.binding = 0,
-                                                         .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                                                         .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
                                                          .descriptorCount = 1,
                                                          .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
                                                          .pImmutableSamplers = nullptr},
@@ -448,9 +415,9 @@ void Sprite::_updateColorDescriptor() {
   auto material = std::dynamic_pointer_cast<MaterialColor>(_material);
   std::map<int, std::vector<VkDescriptorBufferInfo>> bufferInfoColor{
       {0,
-       {{.buffer = _cameraUBOFull[currentFrame]->getData(),
+       {{.buffer = _engineState->getUniformRing()->getBuffer(currentFrame)->getData(),
          .offset = 0,
-         .range = _cameraUBOFull[currentFrame]->getSize()}}}};
+         .range = sizeof(BufferMVP)}}}};
   std::map<int, std::vector<VkDescriptorImageInfo>> textureInfoColor{
       {1,
        {{.sampler = material->getBaseColor()[0]->getSampler()->getSampler(),
@@ -464,9 +431,9 @@ void Sprite::_updatePhongDescriptor() {
   auto material = std::dynamic_pointer_cast<MaterialPhong>(_material);
   std::map<int, std::vector<VkDescriptorBufferInfo>> bufferInfoColor{
       {0,
-       {{.buffer = _cameraUBOFull[currentFrame]->getData(),
+       {{.buffer = _engineState->getUniformRing()->getBuffer(currentFrame)->getData(),
          .offset = 0,
-         .range = _cameraUBOFull[currentFrame]->getSize()}}},
+         .range = sizeof(BufferMVP)}}},
       {4,
        {{.buffer = material->getBufferCoefficients()[currentFrame]->getData(),
          .offset = 0,
@@ -494,9 +461,9 @@ void Sprite::_updatePBRDescriptor() {
   auto material = std::dynamic_pointer_cast<MaterialPBR>(_material);
   std::map<int, std::vector<VkDescriptorBufferInfo>> bufferInfoColor{
       {0,
-       {{.buffer = _cameraUBOFull[currentFrame]->getData(),
+       {{.buffer = _engineState->getUniformRing()->getBuffer(currentFrame)->getData(),
          .offset = 0,
-         .range = _cameraUBOFull[currentFrame]->getSize()}}},
+         .range = sizeof(BufferMVP)}}},
       {10,
        {{.buffer = material->getBufferCoefficients()[currentFrame]->getData(),
          .offset = 0,
@@ -553,19 +520,8 @@ void Sprite::setMaterial(std::shared_ptr<MaterialPBR> material) {
                                                {MaterialTexture::IBL_DIFFUSE, 7},
                                                {MaterialTexture::IBL_SPECULAR, 8},
                                                {MaterialTexture::BRDF_SPECULAR, 9}});
-  for (int d = 0; d < _engineState->getSettings()->getMaxDirectionalLights(); d++) {
-    if (_material) _material->unregisterUpdate(_descriptorSetCameraDepth[d][0]);
-    material->registerUpdate(_descriptorSetCameraDepth[d][0], {{MaterialTexture::COLOR, 1}});
-  }
-  for (int p = 0; p < _engineState->getSettings()->getMaxPointLights(); p++) {
-    for (int f = 0; f < 6; f++) {
-      if (_material)
-        _material->unregisterUpdate(
-            _descriptorSetCameraDepth[_engineState->getSettings()->getMaxDirectionalLights() + p][f]);
-      material->registerUpdate(_descriptorSetCameraDepth[_engineState->getSettings()->getMaxDirectionalLights() + p][f],
-                               {{MaterialTexture::COLOR, 1}});
-    }
-  }
+  if (_material) _material->unregisterUpdate(_descriptorSetCameraDepth);
+  material->registerUpdate(_descriptorSetCameraDepth, {{MaterialTexture::COLOR, 1}});
   _materialType = MaterialType::PBR;
   _material = material;
   for (int i = 0; i < _changedMaterialRender.size(); i++) {
@@ -578,19 +534,8 @@ void Sprite::setMaterial(std::shared_ptr<MaterialPhong> material) {
   if (_material) _material->unregisterUpdate(_descriptorSetPhong);
   material->registerUpdate(_descriptorSetPhong,
                            {{MaterialTexture::COLOR, 1}, {MaterialTexture::NORMAL, 2}, {MaterialTexture::SPECULAR, 3}});
-  for (int d = 0; d < _engineState->getSettings()->getMaxDirectionalLights(); d++) {
-    if (_material) _material->unregisterUpdate(_descriptorSetCameraDepth[d][0]);
-    material->registerUpdate(_descriptorSetCameraDepth[d][0], {{MaterialTexture::COLOR, 1}});
-  }
-  for (int p = 0; p < _engineState->getSettings()->getMaxPointLights(); p++) {
-    for (int f = 0; f < 6; f++) {
-      if (_material)
-        _material->unregisterUpdate(
-            _descriptorSetCameraDepth[_engineState->getSettings()->getMaxDirectionalLights() + p][f]);
-      material->registerUpdate(_descriptorSetCameraDepth[_engineState->getSettings()->getMaxDirectionalLights() + p][f],
-                               {{MaterialTexture::COLOR, 1}});
-    }
-  }
+  if (_material) _material->unregisterUpdate(_descriptorSetCameraDepth);
+  material->registerUpdate(_descriptorSetCameraDepth, {{MaterialTexture::COLOR, 1}});
   _materialType = MaterialType::PHONG;
   _material = material;
   for (int i = 0; i < _changedMaterialRender.size(); i++) {
@@ -602,19 +547,8 @@ void Sprite::setMaterial(std::shared_ptr<MaterialPhong> material) {
 void Sprite::setMaterial(std::shared_ptr<MaterialColor> material) {
   if (_material) _material->unregisterUpdate(_descriptorSetColor);
   material->registerUpdate(_descriptorSetColor, {{MaterialTexture::COLOR, 1}});
-  for (int d = 0; d < _engineState->getSettings()->getMaxDirectionalLights(); d++) {
-    if (_material) _material->unregisterUpdate(_descriptorSetCameraDepth[d][0]);
-    material->registerUpdate(_descriptorSetCameraDepth[d][0], {{MaterialTexture::COLOR, 1}});
-  }
-  for (int p = 0; p < _engineState->getSettings()->getMaxPointLights(); p++) {
-    for (int f = 0; f < 6; f++) {
-      if (_material)
-        _material->unregisterUpdate(
-            _descriptorSetCameraDepth[_engineState->getSettings()->getMaxDirectionalLights() + p][f]);
-      material->registerUpdate(_descriptorSetCameraDepth[_engineState->getSettings()->getMaxDirectionalLights() + p][f],
-                               {{MaterialTexture::COLOR, 1}});
-    }
-  }
+  if (_material) _material->unregisterUpdate(_descriptorSetCameraDepth);
+  material->registerUpdate(_descriptorSetCameraDepth, {{MaterialTexture::COLOR, 1}});
 
   _materialType = MaterialType::COLOR;
   _material = material;
@@ -688,7 +622,7 @@ void Sprite::draw(std::shared_ptr<CommandBuffer> commandBuffer) {
     cameraMVP.projection = _gameState->getCameraManager()->getCurrentCamera()->getProjection();
   }
 
-  _cameraUBOFull[currentFrame]->setData(&cameraMVP);
+  uint32_t cameraOffset = _engineState->getUniformRing()->push(&cameraMVP, sizeof(BufferMVP));
 
   VkBuffer vertexBuffers[] = {_mesh->getVertexBuffer()->getBuffer()->getData()};
   VkDeviceSize offsets[] = {0};
@@ -709,7 +643,7 @@ void Sprite::draw(std::shared_ptr<CommandBuffer> commandBuffer) {
   if (colorLayout != pipelineLayout.end()) {
     vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
                             pipeline->getPipelineLayout(), 0, 1,
-                            &_descriptorSetColor->getDescriptorSets()[currentFrame], 0, nullptr);
+                            &_descriptorSetColor->getDescriptorSets()[currentFrame], 1, &cameraOffset);
   }
 
   // Phong
@@ -720,7 +654,7 @@ void Sprite::draw(std::shared_ptr<CommandBuffer> commandBuffer) {
   if (phongLayout != pipelineLayout.end()) {
     vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
                             pipeline->getPipelineLayout(), 0, 1,
-                            &_descriptorSetPhong->getDescriptorSets()[currentFrame], 0, nullptr);
+                            &_descriptorSetPhong->getDescriptorSets()[currentFrame], 1, &cameraOffset);
   }
 
   // global Phong
@@ -742,7 +676,7 @@ void Sprite::draw(std::shared_ptr<CommandBuffer> commandBuffer) {
   if (pbrLayout != pipelineLayout.end()) {
     vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
                             pipeline->getPipelineLayout(), 0, 1, &_descriptorSetPBR->getDescriptorSets()[currentFrame],
-                            0, nullptr);
+                            1, &cameraOffset);
   }
 
   // global PBR
@@ -762,9 +696,12 @@ void Sprite::draw(std::shared_ptr<CommandBuffer> commandBuffer) {
                                             return info.first == std::string("normal");
                                           });
   if (normalTangentLayout != pipelineLayout.end()) {
+    // vertex and geometry stages read the same camera
+    std::array<uint32_t, 2> cameraOffsets = {cameraOffset, cameraOffset};
     vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
                             pipeline->getPipelineLayout(), 0, 1,
-                            &_descriptorSetNormalsMesh->getDescriptorSets()[currentFrame], 0, nullptr);
+                            &_descriptorSetNormalsMesh->getDescriptorSets()[currentFrame], cameraOffsets.size(),
+                            cameraOffsets.data());
   }
 
   vkCmdDrawIndexed(commandBuffer->getCommandBuffer()[currentFrame], static_cast<uint32_t>(_mesh->getIndexData().size()),
@@ -839,19 +776,17 @@ void Sprite::drawShadow(LightType lightType, int lightIndex, int face, std::shar
 
   glm::mat4 view(1.f);
   glm::mat4 projection(1.f);
-  int lightIndexTotal = lightIndex;
   if (lightType == LightType::DIRECTIONAL) {
     view = _gameState->getLightManager()->getDirectionalLights()[lightIndex]->getCamera()->getView();
     projection = _gameState->getLightManager()->getDirectionalLights()[lightIndex]->getCamera()->getProjection();
   }
   if (lightType == LightType::POINT) {
-    lightIndexTotal += _engineState->getSettings()->getMaxDirectionalLights();
     view = _gameState->getLightManager()->getPointLights()[lightIndex]->getCamera()->getView(face);
     projection = _gameState->getLightManager()->getPointLights()[lightIndex]->getCamera()->getProjection();
   }
 
   BufferMVP cameraMVP{.model = getModel(), .view = view, .projection = projection};
-  _cameraUBODepth[lightIndexTotal][face][currentFrame]->setData(&cameraMVP);
+  uint32_t cameraOffset = _engineState->getUniformRing()->push(&cameraMVP, sizeof(BufferMVP));
 
   VkBuffer vertexBuffers[] = {_mesh->getVertexBuffer()->getBuffer()->getData()};
   VkDeviceSize offsets[] = {0};
@@ -866,9 +801,9 @@ void Sprite::drawShadow(LightType lightType, int lightIndex, int face, std::shar
                                     return info.first == std::string("depth");
                                   });
   if (depthLayout != pipelineLayout.end()) {
-    vkCmdBindDescriptorSets(
-        commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->getPipelineLayout(),
-        0, 1, &_descriptorSetCameraDepth[lightIndexTotal][face]->getDescriptorSets()[currentFrame], 0, nullptr);
+    vkCmdBindDescriptorSets(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
+                            pipeline->getPipelineLayout(), 0, 1,
+                            &_descriptorSetCameraDepth->getDescriptorSets()[currentFrame], 1, &cameraOffset);
   }
 
   vkCmdDrawIndexed(commandBuffer->getCommandBuffer()[currentFrame], static_cast<uint32_t>(_mesh->getIndexData().size()),
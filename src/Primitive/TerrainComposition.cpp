@@ -1543,7 +1543,7 @@ void TerrainComposition::draw(std::shared_ptr<CommandBuffer> commandBuffer) {
 
     _cameraBuffer[currentFrame]->setData(&cameraUBO);
 
-    VkBuffer vertexBuffers[] = {_mesh->getVertexBuffer()->getBuffer()->getData()};
+    VkBuffer vertexBuffers[] = {_mesh->getVertexBuffer()->getData()};
     VkDeviceSize offsets[] = {0};
     vkCmdBindVertexBuffers(commandBuffer->getCommandBuffer()[currentFrame], 0, 1, vertexBuffers, offsets);
 
@@ -1605,7 +1605,8 @@ void TerrainComposition::draw(std::shared_ptr<CommandBuffer> commandBuffer) {
           &_gameState->getLightManager()->getDSGlobalTerrainPBR()->getDescriptorSets()[currentFrame], 0, nullptr);
     }
 
-    vkCmdDraw(commandBuffer->getCommandBuffer()[currentFrame], _mesh->getVertexData().size(), 1, 0, 0);
+    vkCmdDraw(commandBuffer->getCommandBuffer()[currentFrame], _mesh->getVertexData().size(), 1,
+              _mesh->getVertexOffset(), 0);
   };
 
   if (_changedMaterial[currentFrame]) {
@@ -1711,7 +1712,7 @@ void TerrainComposition::drawShadow(LightType lightType,
 
   _cameraBufferDepth[lightIndexTotal][face][currentFrame]->setData(&cameraUBO);
 
-  VkBuffer vertexBuffers[] = {_mesh->getVertexBuffer()->getBuffer()->getData()};
+  VkBuffer vertexBuffers[] = {_mesh->getVertexBuffer()->getData()};
   VkDeviceSize offsets[] = {0};
   vkCmdBindVertexBuffers(commandBuffer->getCommandBuffer()[currentFrame], 0, 1, vertexBuffers, offsets);
 
@@ -1726,5 +1727,6 @@ void TerrainComposition::drawShadow(LightType lightType,
         0, 1, &_descriptorSetCameraDepth[lightIndexTotal][face]->getDescriptorSets()[currentFrame], 0, nullptr);
   }
 
-  vkCmdDraw(commandBuffer->getCommandBuffer()[currentFrame], _mesh->getVertexData().size(), 1, 0, 0);
+  vkCmdDraw(commandBuffer->getCommandBuffer()[currentFrame], _mesh->getVertexData().size(), 1,
+            _mesh->getVertexOffset(), 0);
 }
\ No newline at end of file
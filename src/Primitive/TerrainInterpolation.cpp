@@ -1545,7 +1545,7 @@ void TerrainInterpolation::draw(std::shared_ptr<CommandBuffer> commandBuffer) {
                         .projection = _gameState->getCameraManager()->getCurrentCamera()->getProjection()};
     _cameraBuffer[currentFrame]->setData(&cameraUBO);
 
-    VkBuffer vertexBuffers[] = {_mesh->getVertexBuffer()->getBuffer()->getData()};
+    VkBuffer vertexBuffers[] = {_mesh->getVertexBuffer()->getData()};
     VkDeviceSize offsets[] = {0};
     vkCmdBindVertexBuffers(commandBuffer->getCommandBuffer()[currentFrame], 0, 1, vertexBuffers, offsets);
 
@@ -1607,7 +1607,8 @@ void TerrainInterpolation::draw(std::shared_ptr<CommandBuffer> commandBuffer) {
           &_gameState->getLightManager()->getDSGlobalTerrainPBR()->getDescriptorSets()[currentFrame], 0, nullptr);
     }
 
-    vkCmdDraw(commandBuffer->getCommandBuffer()[currentFrame], _mesh->getVertexData().size(), 1, 0, 0);
+    vkCmdDraw(commandBuffer->getCommandBuffer()[currentFrame], _mesh->getVertexData().size(), 1,
+              _mesh->getVertexOffset(), 0);
   };
 
   if (_changedMaterial[currentFrame]) {
@@ -1713,7 +1714,7 @@ void TerrainInterpolation::drawShadow(LightType lightType,
 
   _cameraBufferDepth[lightIndexTotal][face][currentFrame]->setData(&cameraUBO);
 
-  VkBuffer vertexBuffers[] = {_mesh->getVertexBuffer()->getBuffer()->getData()};
+  VkBuffer vertexBuffers[] = {_mesh->getVertexBuffer()->getData()};
   VkDeviceSize offsets[] = {0};
   vkCmdBindVertexBuffers(commandBuffer->getCommandBuffer()[currentFrame], 0, 1, vertexBuffers, offsets);
 
@@ -1728,5 +1729,6 @@ void TerrainInterpolation::drawShadow(LightType lightType,
         0, 1, &_descriptorSetCameraDepth[lightIndexTotal][face]->getDescriptorSets()[currentFrame], 0, nullptr);
   }
 
-  vkCmdDraw(commandBuffer->getCommandBuffer()[currentFrame], _mesh->getVertexData().size(), 1, 0, 0);
+  vkCmdDraw(commandBuffer->getCommandBuffer()[currentFrame], _mesh->getVertexData().size(), 1,
+            _mesh->getVertexOffset(), 0);
 }
\ No newline at end of file
@@ -10,6 +10,40 @@ Animation::Animation(const std::vector<std::shared_ptr<NodeGLTF>>& nodes,
   _engineState = engineState;
 
   _logger = std::make_shared<Logger>();
+  std::map<uint32_t, int> ordered;
+  for (auto& node : _nodes) _flattenNode(node, -1, ordered);
+  _world.resize(_parents.size());
+  _times.resize(_animations.size(), 0.f);
+  for (auto& animation : _animations) {
+    _cursors.push_back(std::vector<int>(animation->channels.size(), 0));
+    std::vector<int> targets;
+    for (auto& channel : animation->channels) {
+      targets.push_back((channel.node && ordered.contains(channel.node->index)) ? ordered[channel.node->index] : -1);
+    }
+    _targets.push_back(targets);
+  }
+  for (auto& skin : _skins) {
+    std::vector<int> joints;
+    for (auto& joint : skin->joints) joints.push_back(ordered[joint->index]);
+    _joints.push_back(joints);
+    _palettes.push_back(std::vector<glm::mat4>(joints.size(), glm::mat4(1.f)));
+  }
+  // if skin is used by several nodes the last one defines palette
+  std::map<int, int> skinNode;
+  for (auto [node, skin] : _skinned) skinNode[skin] = node;
+  _skinned.clear();
+  for (auto [skin, node] : skinNode) {
+    _skinned.push_back({node, skin});
+    _skinnedOffsets.push_back(_jointNumber);
+    _jointNumber += _joints[skin].size();
+  }
+  // bind pose until the first calculateJoints
+  _calculateWorld();
+  calculatePalettes(0, _jointNumber);
+  _palettesPublished = _palettes;
+  _palettesFrame = _palettes;
+  _worldPublished = _world;
+  _worldFrame = _world;
 
   _ssboJoints.resize(_skins.size());
   for (int i = 0; i < _skins.size(); i++) {
@@ -40,39 +74,65 @@ Animation::Animation(const std::vector<std::shared_ptr<NodeGLTF>>& nodes,
   }
 }
 
+int Animation::getSkinNumber() { return _skins.size(); }
+
 std::vector<std::vector<std::shared_ptr<Buffer>>> Animation::getJointMatricesBuffer() { return _ssboJoints; }
 
-void Animation::_updateJoints(int currentImage, std::shared_ptr<NodeGLTF> node) {
-  if (node->skin > -1) {
-    // Update the joint matrices
-    // glm::mat4 inverseTransform = glm::inverse(_getNodeMatrix(node));
-    glm::mat4 inverseTransform = glm::inverse(_matricesJoint[node->index]);
-    std::shared_ptr<SkinGLTF> skin = _skins[node->skin];
-    std::vector<glm::mat4> jointMatrices(skin->joints.size());
-    for (size_t i = 0; i < jointMatrices.size(); i++) {
-      // jointMatrices[i] = _getNodeMatrix(skin->joints[i]) * skin->inverseBindMatrices[i];
-      jointMatrices[i] = _matricesJoint[skin->joints[i]->index] * skin->inverseBindMatrices[i];
-      jointMatrices[i] = inverseTransform * jointMatrices[i];
-    }
-    auto frameInFlight = currentImage % _engineState->getSettings()->getMaxFramesInFlight();
-    int jointNumber = jointMatrices.size();
-    _ssboJoints[node->skin][frameInFlight]->setData(&jointNumber, sizeof(glm::vec4));
-    _ssboJoints[node->skin][frameInFlight]->setData(jointMatrices.data(), jointMatrices.size() * sizeof(glm::mat4),
-                                                    sizeof(glm::vec4));
-  }
+void Animation::_flattenNode(std::shared_ptr<NodeGLTF> node, int parent, std::map<uint32_t, int>& ordered) {
+  int index = _parents.size();
+  ordered[node->index] = index;
+  _parents.push_back(parent);
+  _translations.push_back(node->translation);
+  _rotations.push_back(node->rotation);
+  _scales.push_back(node->scale);
+  _matrices.push_back(node->matrix);
+  if (node->matrix != glm::mat4(1.f)) _matrixNodes.push_back(index);
+  if (node->skin > -1) _skinned.push_back({index, node->skin});
+  for (auto& child : node->children) _flattenNode(child, index, ordered);
+}
 
-  for (auto& child : node->children) {
-    _updateJoints(currentImage, child);
+void Animation::_calculateWorld() {
+  // translate * rotate * scale * matrix, see NodeGLTF::getLocalMatrix, local matrices are composed in place of world
+  PoseKernel::composeTRS(_translations.data(), _rotations.data(), _scales.data(), _world.data(), _world.size(), _simd);
+  for (int node : _matrixNodes) PoseKernel::multiply(_world[node], _matrices[node], _world[node], _simd);
+  // parent is always before child, so parent's world matrix is already known
+  for (int i = 0; i < _parents.size(); i++) {
+    if (_parents[i] >= 0) PoseKernel::multiply(_world[_parents[i]], _world[i], _world[i], _simd);
   }
 }
 
-void Animation::_fillMatricesJoint(std::shared_ptr<NodeGLTF> node, glm::mat4 matrixParent) {
-  _matricesJoint[node->index] = matrixParent * node->getLocalMatrix();
-  for (auto& child : node->children) {
-    _fillMatricesJoint(child, _matricesJoint[node->index]);
+int Animation::getNodeNumber() { return _parents.size(); }
+
+int Animation::getJointNumber() { return _jointNumber; }
+
+void Animation::calculatePalettes(int begin, int end) {
+  for (int i = 0; i < _skinned.size(); i++) {
+    auto [node, skin] = _skinned[i];
+    // intersection of range with joints of skin
+    int first = std::max(begin - _skinnedOffsets[i], 0);
+    int last = std::min(end - _skinnedOffsets[i], static_cast<int>(_joints[skin].size()));
+    if (first >= last) continue;
+    PoseKernel::multiplyIndexed(glm::inverse(_world[node]), _world.data(), _joints[skin].data() + first,
+                                _skins[skin]->inverseBindMatrices.data() + first, _palettes[skin].data() + first,
+                                last - first, _simd);
   }
 }
 
+void Animation::publish() {
+  std::unique_lock<std::mutex> lock(_mutexPalettes);
+  std::swap(_palettes, _palettesPublished);
+  std::swap(_world, _worldPublished);
+  _published = true;
+}
+
+int Animation::_findKeyframe(const std::vector<float>& inputs, float time, int& cursor) {
+  int size = inputs.size();
+  if (cursor < size && time < inputs[cursor] && (cursor == 0 || inputs[cursor - 1] <= time)) return cursor;
+  if (cursor + 1 < size && inputs[cursor] <= time && time < inputs[cursor + 1]) return ++cursor;
+  cursor = std::distance(inputs.begin(), std::upper_bound(inputs.begin(), inputs.end(), time));
+  return cursor;
+}
+
 std::vector<std::string> Animation::getAnimations() {
   std::vector<std::string> names(_animations.size());
   for (int i = 0; i < _animations.size(); i++) {
@@ -93,86 +153,132 @@ void Animation::setPlay(bool play) {
   _play = play;
 }
 
+void Animation::setSIMD(bool simd) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  _simd = simd;
+}
+
 std::tuple<float, float> Animation::getTimeline() {
   return {_animations[_animationIndex]->start, _animations[_animationIndex]->end};
 }
 
 void Animation::setTime(float time) {
   std::unique_lock<std::mutex> lock(_mutex);
-  _animations[_animationIndex]->currentTime = time;
+  _times[_animationIndex] = time;
 }
 
 std::tuple<float, float> Animation::getTimeRange() {
   return {0, _animations[_animationIndex]->end - _animations[_animationIndex]->start};
 }
 
-// TODO: mutex?
-float Animation::getCurrentTime() { return _animations[_animationIndex]->currentTime; }
+float Animation::getCurrentTime() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  return _times[_animationIndex];
+}
 
 void Animation::calculateJoints(float deltaTime) {
+  if (sample(deltaTime) == false) return;
+  _logger->begin("Update palettes");
+  calculatePalettes(0, _jointNumber);
+  publish();
+  _logger->end();
+}
+
+bool Animation::sample(float deltaTime) {
   std::unique_lock<std::mutex> lock(_mutex);
   if (_play == false || _animations.size() == 0 || _animationIndex > static_cast<uint32_t>(_animations.size()) - 1) {
-    return;
+    return false;
   }
 
   _logger->begin("Update translate/scale/rotation");
   std::shared_ptr<AnimationGLTF> animation = _animations[_animationIndex];
-  animation->currentTime += deltaTime;
-  animation->currentTime = fmod(animation->currentTime, animation->end - animation->start);
-  for (auto& channel : animation->channels) {
+  _times[_animationIndex] = fmod(_times[_animationIndex] + deltaTime, animation->end - animation->start);
+  // capacity is kept, so there are no allocations after the first frame
+  _slerpChannels.clear();
+  _slerpFrom.clear();
+  _slerpTo.clear();
+  _slerpFactors.clear();
+  // order of glm::quat constructor arguments depends on GLM configuration, so components are set by name
+  auto toQuat = [](const glm::vec4& value) {
+    glm::quat quat;
+    quat.x = value.x;
+    quat.y = value.y;
+    quat.z = value.z;
+    quat.w = value.w;
+    return quat;
+  };
+  for (int i = 0; i < animation->channels.size(); i++) {
+    AnimationChannelGLTF& channel = animation->channels[i];
     AnimationSamplerGLTF& sampler = animation->samplers[channel.samplerIndex];
-    if (sampler.interpolation != "LINEAR") {
-      std::cout << "This sample only supports linear interpolations\n";
-      continue;
-    }
+    // not supported
+    if (sampler.interpolation != InterpolationGLTF::LINEAR) continue;
     if (sampler.inputs.size() <= 1) continue;
-    auto higher = std::find_if(sampler.inputs.begin(), sampler.inputs.end(),
-                               [current = animation->currentTime, start = animation->start](float value) {
-                                 return value > (current + start);
-                               });
+    float time = _times[_animationIndex] + animation->start;
+    int target = _targets[_animationIndex][i];
+    if (target < 0) continue;
+    int right = _findKeyframe(sampler.inputs, time, _cursors[_animationIndex][i]);
     // Get the input keyframe values for the current time stamp
-    if (higher != sampler.inputs.begin()) {
-      if (higher == sampler.inputs.end() && (animation->currentTime + animation->start) > sampler.inputs.back())
-        continue;
-      int right = std::distance(sampler.inputs.begin(), higher);
+    if (right > 0 && right < sampler.inputs.size()) {
       int left = right - 1;
-      float a = (animation->currentTime + animation->start - sampler.inputs[left]) /
-                (sampler.inputs[right] - sampler.inputs[left]);
-      if (channel.path == "translation") {
-        channel.node->translation = glm::mix(sampler.outputsVec4[left], sampler.outputsVec4[right], a);
+      float a = (time - sampler.inputs[left]) / (sampler.inputs[right] - sampler.inputs[left]);
+      if (channel.path == AnimationPathGLTF::TRANSLATION) {
+        _translations[target] = glm::mix(sampler.outputsVec4[left], sampler.outputsVec4[right], a);
       }
-      if (channel.path == "rotation") {
-        glm::quat q1;
-        q1.x = sampler.outputsVec4[left].x;
-        q1.y = sampler.outputsVec4[left].y;
-        q1.z = sampler.outputsVec4[left].z;
-        q1.w = sampler.outputsVec4[left].w;
-
-        glm::quat q2;
-        q2.x = sampler.outputsVec4[right].x;
-        q2.y = sampler.outputsVec4[right].y;
-        q2.z = sampler.outputsVec4[right].z;
-        q2.w = sampler.outputsVec4[right].w;
-
-        channel.node->rotation = glm::normalize(glm::slerp(q1, q2, a));
+      if (channel.path == AnimationPathGLTF::ROTATION) {
+        _slerpChannels.push_back(i);
+        _slerpFrom.push_back(toQuat(sampler.outputsVec4[left]));
+        _slerpTo.push_back(toQuat(sampler.outputsVec4[right]));
+        _slerpFactors.push_back(a);
       }
-      if (channel.path == "scale") {
-        channel.node->scale = glm::mix(sampler.outputsVec4[left], sampler.outputsVec4[right], a);
+      if (channel.path == AnimationPathGLTF::SCALE) {
+        _scales[target] = glm::mix(sampler.outputsVec4[left], sampler.outputsVec4[right], a);
       }
     }
   }
+  _slerpResult.resize(_slerpChannels.size());
+  PoseKernel::slerp(_slerpFrom.data(), _slerpTo.data(), _slerpFactors.data(), _slerpResult.data(),
+                    _slerpChannels.size(), _simd);
+  // nodes of glTF model aren't changed, they are shared between instances and read by recording threads
+  for (int i = 0; i < _slerpChannels.size(); i++)
+    _rotations[_targets[_animationIndex][_slerpChannels[i]]] = _slerpResult[i];
   _logger->end();
 
   _logger->begin("Update matrixes");
-  _matricesJoint.clear();
-  for (auto& node : _nodes) {
-    _fillMatricesJoint(node, glm::mat4(1.f));
-  }
+  _calculateWorld();
   _logger->end();
+  return true;
 }
 
 void Animation::updateBuffers(int currentImage) {
-  for (auto& node : _nodes) {
-    _updateJoints(currentImage, node);
+  auto frameInFlight = currentImage % _engineState->getSettings()->getMaxFramesInFlight();
+  bool changed = false;
+  {
+    std::unique_lock<std::mutex> lock(_mutexPalettes);
+    // sizes are the same, so there are no allocations
+    if (_published) {
+      _palettesFrame = _palettesPublished;
+      _worldFrame = _worldPublished;
+      _published = false;
+      changed = true;
+    }
   }
-}
\ No newline at end of file
+  for (int i = 0; i < _palettesFrame.size(); i++) {
+    int jointNumber = _palettesFrame[i].size();
+    _ssboJoints[i][frameInFlight]->setData(&jointNumber, sizeof(glm::vec4));
+    _ssboJoints[i][frameInFlight]->setData(_palettesFrame[i].data(), _palettesFrame[i].size() * sizeof(glm::mat4),
+                                           sizeof(glm::vec4));
+  }
+  if (changed) {
+    for (auto& [owner, callback] : _callbacksPose) callback();
+  }
+}
+
+const std::vector<glm::mat4>& Animation::getNodeMatrices() { return _worldFrame; }
+
+const std::vector<std::vector<glm::mat4>>& Animation::getPalettes() { return _palettesFrame; }
+
+void Animation::registerPoseChange(const void* owner, std::function<void()> callback) {
+  _callbacksPose[owner] = callback;
+}
+
+void Animation::unregisterPoseChange(const void* owner) { _callbacksPose.erase(owner); }
\ No newline at end of file
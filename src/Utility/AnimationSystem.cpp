@@ -0,0 +1,117 @@
+#include "Utility/AnimationSystem.h"
+
+AnimationSystem::AnimationSystem(std::shared_ptr<BS::thread_pool> pool, std::shared_ptr<EngineState> engineState) {
+  _pool = pool;
+  _engineState = engineState;
+}
+
+void AnimationSystem::add(std::shared_ptr<Animation> animation) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  if (std::find(_animations.begin(), _animations.end(), animation) != _animations.end()) return;
+  _animations.push_back(animation);
+}
+
+void AnimationSystem::remove(std::shared_ptr<Animation> animation) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  std::erase(_animations, animation);
+}
+
+void AnimationSystem::setJobSize(int jobSize) {
+  // job size is read by evaluation in progress
+  wait();
+  _jobSize = std::max(jobSize, 1);
+}
+
+void AnimationSystem::_fanOut(int jobs, std::function<void(int)> job) {
+  if (jobs == 0) return;
+  struct State {
+    std::atomic<int> next = 0;
+    std::atomic<int> done = 0;
+    std::function<void(int)> job;
+  };
+  auto state = std::make_shared<State>();
+  state->job = job;
+  auto work = [state, jobs]() {
+    for (int i = state->next.fetch_add(1); i < jobs; i = state->next.fetch_add(1)) {
+      state->job(i);
+      if (state->done.fetch_add(1, std::memory_order_acq_rel) + 1 == jobs) state->done.notify_all();
+    }
+  };
+  // workers are pushed without futures, worker started after all jobs are taken just returns, so calling thread waits
+  // only for jobs in progress and not for workers queued behind other tasks
+  int workers = std::min(static_cast<int>(_pool->get_thread_count()), jobs) - 1;
+  for (int i = 0; i < workers; i++) _pool->push_task(work);
+  work();
+  for (int done = state->done.load(std::memory_order_acquire); done < jobs;
+       done = state->done.load(std::memory_order_acquire))
+    state->done.wait(done);
+}
+
+void AnimationSystem::_update(std::vector<std::shared_ptr<Animation>> animations, float deltaTime) {
+  // sampling can't be split, so consecutive animations are packed to jobs of about _jobSize nodes
+  std::vector<std::pair<int, int>> sampleJobs;
+  int begin = 0, cost = 0;
+  for (int i = 0; i < animations.size(); i++) {
+    cost += animations[i]->getNodeNumber();
+    if (cost >= _jobSize || i == animations.size() - 1) {
+      sampleJobs.push_back({begin, i + 1});
+      begin = i + 1;
+      cost = 0;
+    }
+  }
+  // std::vector<bool> can't be written from different threads
+  std::vector<char> sampled(animations.size(), false);
+  _fanOut(sampleJobs.size(), [&](int job) {
+    for (int i = sampleJobs[job].first; i < sampleJobs[job].second; i++) sampled[i] = animations[i]->sample(deltaTime);
+  });
+
+  // joints of all sampled animations are cut to jobs of exactly _jobSize joints (except the last one), job can contain
+  // ranges of a few small skeletons or a part of huge one
+  struct Range {
+    int animation, begin, end;
+  };
+  std::vector<std::vector<Range>> paletteJobs(1);
+  int jobJoints = 0;
+  for (int i = 0; i < animations.size(); i++) {
+    if (sampled[i] == false) continue;
+    int joints = animations[i]->getJointNumber();
+    for (int first = 0; first < joints;) {
+      int last = std::min(joints, first + _jobSize - jobJoints);
+      paletteJobs.back().push_back({i, first, last});
+      jobJoints += last - first;
+      first = last;
+      if (jobJoints == _jobSize) {
+        paletteJobs.push_back({});
+        jobJoints = 0;
+      }
+    }
+  }
+  if (paletteJobs.back().size() == 0) paletteJobs.pop_back();
+  _fanOut(paletteJobs.size(), [&](int job) {
+    for (auto& range : paletteJobs[job]) animations[range.animation]->calculatePalettes(range.begin, range.end);
+  });
+
+  for (int i = 0; i < animations.size(); i++) {
+    if (sampled[i]) animations[i]->publish();
+  }
+}
+
+void AnimationSystem::update(float deltaTime) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  // the previous pose is normally finished long before, so this wait is rare
+  if (_future.valid()) _future.get();
+  if (_animations.size() == 0) return;
+  _future = _pool->submit([this, animations = _animations, deltaTime]() { _update(animations, deltaTime); });
+}
+
+void AnimationSystem::updateBuffers(int currentFrame) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  for (auto& animation : _animations) animation->updateBuffers(currentFrame);
+}
+
+void AnimationSystem::wait() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  if (_future.valid()) _future.get();
+}
+
+AnimationSystem::~AnimationSystem() { wait(); }
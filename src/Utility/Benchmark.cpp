@@ -0,0 +1,89 @@
+#include "Utility/Benchmark.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+
+BenchmarkArguments Benchmark::parseArguments(int argc, char* argv[]) {
+  for (int i = 1; i + 2 < argc; i++) {
+    if (std::string(argv[i]) == "--benchmark") return {.frames = std::stoi(argv[i + 1]), .path = argv[i + 2]};
+  }
+  return {};
+}
+
+void Benchmark::configure(std::shared_ptr<Settings> settings) {
+  settings->setHeadless(true);
+  settings->setFixedTimestep(1.f / 60.f);
+}
+
+void Benchmark::addCPU(std::string stage, std::chrono::high_resolution_clock::time_point start) {
+  std::chrono::duration<float, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+  std::unique_lock<std::mutex> lock(_mutex);
+  _frameCPU[stage] += elapsed.count();
+}
+
+void Benchmark::addGPU(std::string pass, float milliseconds) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  _frameGPU[pass] += milliseconds;
+}
+
+void Benchmark::nextFrame() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  for (auto& [stage, time] : _frameCPU) _samplesCPU[stage].push_back(time);
+  for (auto& [pass, time] : _frameGPU) _samplesGPU[pass].push_back(time);
+  _frameCPU.clear();
+  _frameGPU.clear();
+  _frames++;
+}
+
+int Benchmark::getFrames() { return _frames; }
+
+float Benchmark::_percentile(std::vector<float> samples, float percentile) {
+  if (samples.size() == 0) return 0.f;
+  // nearest rank
+  int rank = std::max(static_cast<int>(std::ceil(percentile / 100.f * samples.size())) - 1, 0);
+  std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+  return samples[rank];
+}
+
+std::map<std::string, std::array<float, 4>> Benchmark::_statistic(
+    std::map<std::string, std::vector<float>>& samples) {
+  std::map<std::string, std::array<float, 4>> statistic;
+  for (auto& [name, values] : samples) {
+    float mean = std::accumulate(values.begin(), values.end(), 0.f) / std::max(values.size(), size_t(1));
+    statistic[name] = {mean, _percentile(values, 50.f), _percentile(values, 95.f), _percentile(values, 99.f)};
+  }
+  return statistic;
+}
+
+std::map<std::string, std::array<float, 4>> Benchmark::getCPU() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  return _statistic(_samplesCPU);
+}
+
+std::map<std::string, std::array<float, 4>> Benchmark::getGPU() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  return _statistic(_samplesGPU);
+}
+
+void Benchmark::save(std::string path) {
+  std::map<std::string, std::map<std::string, std::array<float, 4>>> statistic = {{"cpu", getCPU()},
+                                                                                   {"gpu", getGPU()}};
+  nlohmann::json outputJSON;
+  outputJSON["frames"] = _frames;
+  std::ofstream fileCSV(path + ".csv");
+  fileCSV << "type,name,mean,p50,p95,p99" << std::endl;
+  for (auto& [type, values] : statistic) {
+    outputJSON[type] = nlohmann::json::object();
+    for (auto& [name, value] : values) {
+      outputJSON[type][name] = {{"mean", value[0]}, {"p50", value[1]}, {"p95", value[2]}, {"p99", value[3]}};
+      fileCSV << type << ",\"" << name << "\"," << value[0] << "," << value[1] << "," << value[2] << "," << value[3]
+              << std::endl;
+    }
+  }
+
+  std::ofstream fileJSON(path + ".json");
+  fileJSON << std::setw(4) << outputJSON << std::endl;
+}
@@ -9,15 +9,23 @@ AAssetManager* EngineState::getAssetManager() { return _assetManager; }
 #endif
 
 void EngineState::initialize() {
+  bool headless = _settings->getHeadless();
   _window = std::make_shared<Window>(_settings->getResolution());
 #ifdef __ANDROID__
   _window->setNativeWindow(_nativeWindow);
 #endif
-  _window->initialize();
+  if (headless == false) _window->initialize();
   _input = std::make_shared<Input>(_window);
-  _instance = std::make_shared<Instance>(_settings->getName(), true);
-  _surface = std::make_shared<Surface>(_window, _instance);
+  _instance = std::make_shared<Instance>(_settings->getName(), true, headless);
+  // in headless mode surface is nullptr
+  if (headless == false) _surface = std::make_shared<Surface>(_window, _instance);
   _device = std::make_shared<Device>(_surface, _instance);
+  _device->createPipelineCache(_settings->getPipelineCachePath());
+  // models are drawn on CPU path if device can't merge draws to multi-draw indirect
+  if (_settings->getIndirectCulling() && _device->isMultiDrawIndirectSupported() == false) {
+    std::cerr << "Indirect culling isn't supported by device and is disabled" << std::endl;
+    _settings->setIndirectCulling(false);
+  }
   _memoryAllocator = std::make_shared<MemoryAllocator>(_device, _instance);
   _descriptorPool = std::make_shared<DescriptorPool>(_settings, _device);
   _filesystem = std::make_shared<Filesystem>();
@@ -47,6 +55,31 @@ std::shared_ptr<Filesystem> EngineState::getFilesystem() { return _filesystem; }
 
 std::shared_ptr<RenderPassManager> EngineState::getRenderPassManager() { return _renderPassManager; }
 
+void EngineState::setGeometryArena(std::shared_ptr<BufferArena> vertexArena, std::shared_ptr<BufferArena> indexArena) {
+  _vertexArena = vertexArena;
+  _indexArena = indexArena;
+}
+
+std::shared_ptr<BufferArena> EngineState::getVertexArena() { return _vertexArena; }
+
+std::shared_ptr<BufferArena> EngineState::getIndexArena() { return _indexArena; }
+
+void EngineState::setStagingRing(std::shared_ptr<StagingRing> stagingRing) { _stagingRing = stagingRing; }
+
+std::shared_ptr<StagingRing> EngineState::getStagingRing() { return _stagingRing; }
+
+void EngineState::setUniformRing(std::shared_ptr<UniformRing> uniformRing) { _uniformRing = uniformRing; }
+
+std::shared_ptr<UniformRing> EngineState::getUniformRing() { return _uniformRing; }
+
+void EngineState::setProfilerGPU(std::shared_ptr<ProfilerGPU> profilerGPU) { _profilerGPU = profilerGPU; }
+
+std::shared_ptr<ProfilerGPU> EngineState::getProfilerGPU() { return _profilerGPU; }
+
 void EngineState::setFrameInFlight(int frameInFlight) { _frameInFlight = frameInFlight; }
 
-int EngineState::getFrameInFlight() { return _frameInFlight; }
\ No newline at end of file
+int EngineState::getFrameInFlight() { return _frameInFlight; }
+
+void EngineState::setFrame(uint64_t frame) { _frame = frame; }
+
+uint64_t EngineState::getFrame() { return _frame; }
\ No newline at end of file
@@ -56,11 +56,7 @@ void GUI::initialize(std::shared_ptr<CommandBuffer> commandBufferTransfer) {
     }
   }
 
-  auto stagingBuffer = std::make_shared<Buffer>(
-      uploadSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, _engineState);
-
-  stagingBuffer->setData(fontData);
+  auto staging = _engineState->getStagingRing()->upload(fontData, uploadSize);
 
   _fontImage = std::make_shared<Image>(
       std::tuple{texWidth, texHeight}, 1, 1, _engineState->getSettings()->getLoadTextureColorFormat(),
@@ -68,7 +64,7 @@ void GUI::initialize(std::shared_ptr<CommandBuffer> commandBufferTransfer) {
       VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, _engineState);
   _fontImage->changeLayout(VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT,
                            1, 1, commandBufferTransfer);
-  _fontImage->copyFrom(stagingBuffer, {0}, commandBufferTransfer);
+  _fontImage->copyFrom(staging.buffer, {static_cast<int>(staging.offset)}, commandBufferTransfer);
   _fontImage->changeLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_ASPECT_COLOR_BIT, 1,
                            1, commandBufferTransfer);
   _imageView = std::make_shared<ImageView>(_fontImage, VK_IMAGE_VIEW_TYPE_2D, 0, 1, 0, 1, VK_IMAGE_ASPECT_COLOR_BIT,
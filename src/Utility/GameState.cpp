@@ -1,7 +1,9 @@
 #include "Utility/GameState.h"
 
-GameState::GameState(std::shared_ptr<CommandBuffer> commandBuffer, std::shared_ptr<EngineState> engineState) {
-  _resourceManager = std::make_shared<ResourceManager>(engineState);
+GameState::GameState(std::shared_ptr<CommandBuffer> commandBuffer,
+                     std::shared_ptr<BS::thread_pool> pool,
+                     std::shared_ptr<EngineState> engineState) {
+  _resourceManager = std::make_shared<ResourceManager>(pool, engineState);
 #ifdef __ANDROID__
   _resourceManager->setAssetManager(engineState->getAssetManager());
 #endif
@@ -4,6 +4,8 @@
 Input::Input(std::shared_ptr<Window> window) {
 #ifndef __ANDROID__
   _window = window;
+  // headless mode, there is no window to receive events from
+  if (window->getWindow() == nullptr) return;
   glfwSetWindowUserPointer((GLFWwindow*)(window->getWindow()), this);
   glfwSetInputMode((GLFWwindow*)(window->getWindow()), GLFW_CURSOR, GLFW_CURSOR_NORMAL);
   glfwSetCursorPosCallback((GLFWwindow*)(window->getWindow()), [](GLFWwindow* window, double xpos, double ypos) {
@@ -80,6 +82,7 @@ void Input::subscribe(std::shared_ptr<InputSubscriberExclusive> sub) { _subscrib
 void Input::showCursor(bool show) {
   _showCursor = show;
 #ifndef __ANDROID__
+  if (_window->getWindow() == nullptr) return;
   if (show)
     glfwSetInputMode((GLFWwindow*)(_window->getWindow()), GLFW_CURSOR, GLFW_CURSOR_NORMAL);
   else
@@ -4,23 +4,95 @@
 #include "glm/gtc/type_ptr.hpp"
 #include <filesystem>
 #include "mikktspace.h"
+#include <cstring>
+#if defined(__SSSE3__) || defined(__AVX__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
-LoaderImage::LoaderImage(std::shared_ptr<EngineState> engineState) { _engineState = engineState; }
+LoaderImage::LoaderImage(std::shared_ptr<BS::thread_pool> pool, std::shared_ptr<EngineState> engineState) {
+  _pool = pool;
+  _engineState = engineState;
+}
+
+void LoaderImage::_expandRGBA(const uint8_t* rgb, uint8_t* rgba, size_t pixels) {
+  size_t i = 0;
+#if defined(__SSSE3__) || defined(__AVX__)
+  // 4 pixels per iteration, 16 bytes are loaded but only 12 are used, so the tail is left for scalar loop
+  const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+  const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000));
+  for (; i + 6 <= pixels; i += 4) {
+    __m128i source = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb + i * 3));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + i * 4), _mm_or_si128(_mm_shuffle_epi8(source, shuffle), alpha));
+  }
+#elif defined(__SSE2__) || defined(_M_X64)
+  // baseline of x86-64 (default GCC/Clang and MSVC builds) has no byte shuffle, so pixel k is moved to its 32 bit lane
+  // by shift of whole register by k bytes and masked
+  const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000));
+  const __m128i mask = _mm_setr_epi32(0x00FFFFFF, 0, 0, 0);
+  for (; i + 6 <= pixels; i += 4) {
+    __m128i source = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb + i * 3));
+    __m128i pixel0 = _mm_and_si128(source, mask);
+    __m128i pixel1 = _mm_and_si128(_mm_slli_si128(source, 1), _mm_slli_si128(mask, 4));
+    __m128i pixel2 = _mm_and_si128(_mm_slli_si128(source, 2), _mm_slli_si128(mask, 8));
+    __m128i pixel3 = _mm_and_si128(_mm_slli_si128(source, 3), _mm_slli_si128(mask, 12));
+    __m128i result = _mm_or_si128(_mm_or_si128(pixel0, pixel1), _mm_or_si128(pixel2, pixel3));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + i * 4), _mm_or_si128(result, alpha));
+  }
+#elif defined(__ARM_NEON)
+  // 16 pixels per iteration, channels are deinterleaved by load and interleaved back by store
+  for (; i + 16 <= pixels; i += 16) {
+    uint8x16x3_t source = vld3q_u8(rgb + i * 3);
+    uint8x16x4_t destination;
+    destination.val[0] = source.val[0];
+    destination.val[1] = source.val[1];
+    destination.val[2] = source.val[2];
+    destination.val[3] = vdupq_n_u8(255);
+    vst4q_u8(rgba + i * 4, destination);
+  }
+#endif
+  for (; i < pixels; i++) {
+    rgba[i * 4] = rgb[i * 3];
+    rgba[i * 4 + 1] = rgb[i * 3 + 1];
+    rgba[i * 4 + 2] = rgb[i * 3 + 2];
+    rgba[i * 4 + 3] = 255;
+  }
+}
+
+std::tuple<size_t, size_t> LoaderImage::_getKey(const uint8_t* content, size_t size) {
+  return {std::hash<std::string_view>{}(std::string_view(reinterpret_cast<const char*>(content), size)), size};
+}
+
+template <>
+std::map<std::tuple<size_t, size_t>, std::weak_ptr<ImageCPU<uint8_t>>>& LoaderImage::_getCache<uint8_t>() {
+  return _cacheUint8;
+}
 
 template <>
-std::shared_ptr<ImageCPU<uint8_t>> LoaderImage::loadCPU<uint8_t>(std::string path) {
+std::map<std::tuple<size_t, size_t>, std::weak_ptr<ImageCPU<float>>>& LoaderImage::_getCache<float>() {
+  return _cacheFloat;
+}
+
+template <>
+std::shared_ptr<ImageCPU<uint8_t>> LoaderImage::_decode<uint8_t>(const uint8_t* content,
+                                                                 size_t size,
+                                                                 std::string name) {
   int texWidth, texHeight, texChannels;
-#ifdef __ANDROID__
-  std::vector<stbi_uc> fileContent = _engineState->getFilesystem()->readFile<stbi_uc>(path);
-  std::shared_ptr<uint8_t[]> pixels(stbi_load_from_memory(fileContent.data(), fileContent.size(), &texWidth, &texHeight,
-                                                          &texChannels, STBI_rgb_alpha));
-#else
-  // load texture
-  std::shared_ptr<uint8_t[]> pixels(stbi_load(path.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha),
+  if (stbi_info_from_memory(content, size, &texWidth, &texHeight, &texChannels) == 0) {
+    throw std::runtime_error("failed to load texture image " + name);
+  }
+  // RGB is decoded as is and expanded to RGBA, as most devices don't support RGB-formats in Vulkan
+  int channels = texChannels == STBI_rgb ? STBI_rgb : STBI_rgb_alpha;
+  std::shared_ptr<uint8_t[]> pixels(stbi_load_from_memory(content, size, &texWidth, &texHeight, &texChannels, channels),
                                     stbi_image_free);
-#endif
   if (!pixels) {
-    throw std::runtime_error("failed to load texture image " + path);
+    throw std::runtime_error("failed to load texture image " + name);
+  }
+  if (channels == STBI_rgb) {
+    std::shared_ptr<uint8_t[]> rgba(new uint8_t[texWidth * texHeight * STBI_rgb_alpha]);
+    _expandRGBA(pixels.get(), rgba.get(), texWidth * texHeight);
+    pixels = rgba;
   }
   std::shared_ptr<ImageCPU<uint8_t>> imageCPU = std::make_shared<ImageCPU<uint8_t>>();
   imageCPU->setData(pixels);
@@ -30,19 +102,12 @@ std::shared_ptr<ImageCPU<uint8_t>> LoaderImage::loadCPU<uint8_t>(std::string pat
 }
 
 template <>
-std::shared_ptr<ImageCPU<float>> LoaderImage::loadCPU<float>(std::string path) {
+std::shared_ptr<ImageCPU<float>> LoaderImage::_decode<float>(const uint8_t* content, size_t size, std::string name) {
   int texWidth, texHeight, texChannels;
-#ifdef __ANDROID__
-  std::vector<stbi_uc> fileContent = _engineState->getFilesystem()->readFile<stbi_uc>(path);
-  std::shared_ptr<float[]> pixels(stbi_loadf_from_memory(fileContent.data(), fileContent.size(), &texWidth, &texHeight,
-                                                         &texChannels, STBI_rgb_alpha));
-#else
-  // load texture
-  std::shared_ptr<float[]> pixels(stbi_loadf(path.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha),
-                                  stbi_image_free);
-#endif
+  std::shared_ptr<float[]> pixels(
+      stbi_loadf_from_memory(content, size, &texWidth, &texHeight, &texChannels, STBI_rgb_alpha), stbi_image_free);
   if (!pixels) {
-    throw std::runtime_error("failed to load texture image " + path);
+    throw std::runtime_error("failed to load texture image " + name);
   }
 
   std::shared_ptr<ImageCPU<float>> imageCPU = std::make_shared<ImageCPU<float>>();
@@ -52,6 +117,83 @@ std::shared_ptr<ImageCPU<float>> LoaderImage::loadCPU<float>(std::string path) {
   return imageCPU;
 }
 
+template <class T>
+std::shared_ptr<ImageCPU<T>> LoaderImage::_load(std::tuple<size_t, size_t> key,
+                                                const uint8_t* content,
+                                                size_t size,
+                                                std::string name) {
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    auto cached = _getCache<T>().find(key);
+    if (cached != _getCache<T>().end()) {
+      if (auto image = cached->second.lock()) return image;
+    }
+  }
+  // decoded without lock, the same content loaded by several threads at once is decoded by each of them
+  auto imageCPU = _decode<T>(content, size, name);
+  std::unique_lock<std::mutex> lock(_mutex);
+  // images which aren't used anymore are dropped, so cache doesn't grow with every loaded file
+  std::erase_if(_getCache<T>(), [](auto& entry) { return entry.second.expired(); });
+  _getCache<T>()[key] = imageCPU;
+  return imageCPU;
+}
+
+template <class T>
+std::shared_ptr<ImageCPU<T>> LoaderImage::loadCPU(const uint8_t* content, size_t size, std::string name) {
+  return _load<T>(_getKey(content, size), content, size, name);
+}
+
+template <class T>
+std::shared_ptr<ImageCPU<T>> LoaderImage::loadCPU(std::string path) {
+  std::vector<char> content = _engineState->getFilesystem()->readFile<char>(path);
+  return loadCPU<T>(reinterpret_cast<const uint8_t*>(content.data()), content.size(), path);
+}
+
+template <class T>
+std::vector<std::shared_ptr<ImageCPU<T>>> LoaderImage::loadCPU(std::vector<std::string> paths) {
+  std::vector<std::vector<char>> contents(paths.size());
+  std::vector<std::shared_ptr<ImageCPU<T>>> images(paths.size());
+  // index of the first path with the same content, only it is decoded
+  std::vector<int> sources(paths.size());
+  std::map<std::tuple<size_t, size_t>, int> unique;
+  std::vector<std::future<void>> futures;
+  for (int i = 0; i < paths.size(); i++) {
+    contents[i] = _engineState->getFilesystem()->readFile<char>(paths[i]);
+    auto content = reinterpret_cast<const uint8_t*>(contents[i].data());
+    auto key = _getKey(content, contents[i].size());
+    auto [source, inserted] = unique.insert({key, i});
+    sources[i] = source->second;
+    if (inserted == false) continue;
+    futures.push_back(_pool->submit([this, &images, &contents, &paths, key, content, i]() {
+      images[i] = _load<T>(key, content, contents[i].size(), paths[i]);
+    }));
+  }
+  // tasks write to locals of this function, so all of them have to finish before the first decoding error is rethrown
+  std::exception_ptr exception;
+  for (auto& future : futures) {
+    try {
+      future.get();
+    } catch (...) {
+      if (exception == nullptr) exception = std::current_exception();
+    }
+  }
+  if (exception) std::rethrow_exception(exception);
+  for (int i = 0; i < paths.size(); i++) images[i] = images[sources[i]];
+
+  return images;
+}
+
+template std::shared_ptr<ImageCPU<uint8_t>> LoaderImage::loadCPU<uint8_t>(std::string path);
+template std::shared_ptr<ImageCPU<float>> LoaderImage::loadCPU<float>(std::string path);
+template std::vector<std::shared_ptr<ImageCPU<uint8_t>>> LoaderImage::loadCPU<uint8_t>(std::vector<std::string> paths);
+template std::vector<std::shared_ptr<ImageCPU<float>>> LoaderImage::loadCPU<float>(std::vector<std::string> paths);
+template std::shared_ptr<ImageCPU<uint8_t>> LoaderImage::loadCPU<uint8_t>(const uint8_t* content,
+                                                                          size_t size,
+                                                                          std::string name);
+template std::shared_ptr<ImageCPU<float>> LoaderImage::loadCPU<float>(const uint8_t* content,
+                                                                      size_t size,
+                                                                      std::string name);
+
 void ModelGLTF::setMaterialsColor(std::vector<std::shared_ptr<MaterialColor>>& materialsColor) {
   _materialsColor = materialsColor;
 }
@@ -97,48 +239,172 @@ void LoaderGLTF::setAssetManager(AAssetManager* assetManager) { tinygltf::asset_
 
 std::shared_ptr<ModelGLTF> LoaderGLTF::load(std::string path, std::shared_ptr<CommandBuffer> commandBufferTransfer) {
   if (_models.contains(path) == false) {
+    std::shared_ptr<SceneGLTF> scene = std::make_shared<SceneGLTF>();
+    scene->path = path;
+    _parse(*scene);
+    for (int i = 0; i < scene->model.images.size(); i++) {
+      _decodeImage(*scene, i);
+    }
+    for (int i = 0; i < scene->model.meshes.size(); i++) {
+      for (int j = 0; j < scene->model.meshes[i].primitives.size(); j++) {
+        _loadPrimitive(scene->model, scene->model.meshes[i].primitives[j], scene->materials, scene->primitives[i][j]);
+      }
+    }
+    _mergePrimitives(*scene);
+    return loadGPU(scene, commandBufferTransfer);
+  }
+  return _models[path];
+}
+
+void LoaderGLTF::loadCPU(std::string path,
+                         std::shared_ptr<BS::thread_pool> pool,
+                         std::function<void(std::shared_ptr<SceneGLTF>)> callback) {
+  std::shared_ptr<SceneGLTF> scene = std::make_shared<SceneGLTF>();
+  scene->path = path;
+  // pool is owned by caller, its destructor waits for pending tasks
+  pool->push_task([this, scene, pool = pool.get(), callback]() {
+    try {
+      _parse(*scene);
+    } catch (...) {
+      scene->error = std::current_exception();
+      callback(scene);
+      return;
+    }
+
+    std::vector<std::function<void()>> tasks;
+    for (int i = 0; i < scene->model.images.size(); i++) {
+      tasks.push_back([this, scene, i]() { _decodeImage(*scene, i); });
+    }
+    for (int i = 0; i < scene->model.meshes.size(); i++) {
+      for (int j = 0; j < scene->model.meshes[i].primitives.size(); j++) {
+        tasks.push_back([this, scene, i, j]() {
+          _loadPrimitive(scene->model, scene->model.meshes[i].primitives[j], scene->materials, scene->primitives[i][j]);
+        });
+      }
+    }
+
+    // tasks never wait for each other, so pool with any number of threads can't deadlock, the last finished task
+    // merges primitives and reports the scene. Extra count keeps callback from being called while tasks are pushed.
+    auto remaining = std::make_shared<std::atomic<int>>(tasks.size() + 1);
+    auto finish = [this, scene, remaining, callback]() {
+      if (remaining->fetch_sub(1, std::memory_order_acq_rel) > 1) return;
+      if (scene->error == nullptr) _mergePrimitives(*scene);
+      callback(scene);
+    };
+    for (auto& task : tasks) {
+      pool->push_task([scene, task, finish]() {
+        try {
+          task();
+        } catch (...) {
+          std::unique_lock<std::mutex> lock(scene->mutex);
+          if (scene->error == nullptr) scene->error = std::current_exception();
+        }
+        finish();
+      });
+    }
+    finish();
+  });
+}
+
+std::shared_ptr<ModelGLTF> LoaderGLTF::loadGPU(std::shared_ptr<SceneGLTF> scene,
+                                               std::shared_ptr<CommandBuffer> commandBufferTransfer) {
+  if (scene->error) std::rethrow_exception(scene->error);
+  // the same model could be loaded while scene was parsed
+  if (_models.contains(scene->path) == false) {
     std::shared_ptr<ModelGLTF> modelExternal = std::make_shared<ModelGLTF>();
-    std::vector<std::shared_ptr<NodeGLTF>> nodes;
-    std::vector<std::shared_ptr<MaterialGLTF>> materials;
-    std::vector<std::shared_ptr<SkinGLTF>> skins;
-    std::vector<std::shared_ptr<AnimationGLTF>> animations;
     std::vector<std::shared_ptr<MeshStatic3D>> meshes;
-    tinygltf::Model modelInternal;
-    std::string err, warn;
-    bool loaded = false;
-    std::string extension = path.substr(path.find_last_of(".") + 1);
-    if (extension == "gltf")
-      loaded = _loader.LoadASCIIFromFile(&modelInternal, &err, &warn, path);
-    else if (extension == "glb")
-      loaded = _loader.LoadBinaryFromFile(&modelInternal, &err, &warn, path);
-    if (loaded == false) throw std::runtime_error("Can't load model: " + path);
-
-    // allocate meshes
-    for (int i = 0; i < modelInternal.meshes.size(); i++) {
+    // load material
+    _loadMaterials(scene->model, scene->images, modelExternal, commandBufferTransfer);
+    for (int i = 0; i < scene->meshes.size(); i++) {
       auto mesh = std::make_shared<MeshStatic3D>(_engineState);
+      // meshes which aren't referenced by nodes stay empty
+      if (scene->aabbs[i] != nullptr) {
+        for (auto& primitive : scene->meshes[i].primitives) mesh->addPrimitive(primitive);
+        mesh->setIndexes(std::move(scene->meshes[i].indexes), commandBufferTransfer);
+        mesh->setVertices(std::move(scene->meshes[i].vertices), commandBufferTransfer);
+        mesh->setAABB(scene->aabbs[i]);
+      }
       meshes.push_back(mesh);
     }
-    // load material
-    _loadMaterials(modelInternal, materials, modelExternal, commandBufferTransfer);
-    // load nodes
-    const tinygltf::Scene& scene = modelInternal.scenes[0];
-    for (size_t i = 0; i < scene.nodes.size(); i++) {
-      tinygltf::Node& node = modelInternal.nodes[scene.nodes[i]];
-      _loadNode(modelInternal, node, nullptr, scene.nodes[i], materials, meshes, nodes, commandBufferTransfer);
-    }
-    // load bones/joints
-    _loadSkins(modelInternal, nodes, skins);
-    // load animations
-    _loadAnimations(modelInternal, nodes, animations);
-
-    modelExternal->setAnimations(animations);
+
+    modelExternal->setAnimations(scene->animations);
     modelExternal->setMeshes(meshes);
-    modelExternal->setNodes(nodes);
-    modelExternal->setSkins(skins);
-    _models[path] = modelExternal;
+    modelExternal->setNodes(scene->nodes);
+    modelExternal->setSkins(scene->skins);
+    _models[scene->path] = modelExternal;
   }
+  return _models[scene->path];
+}
 
-  return _models[path];
+void LoaderGLTF::_parse(SceneGLTF& scene) {
+  // loader isn't shared, so scenes can be parsed in parallel
+  tinygltf::TinyGLTF loader;
+  // images are decoded later by _decodeImage, only encoded data is kept
+  loader.SetImageLoader(
+      [](tinygltf::Image* image, const int imageIndex, std::string* err, std::string* warn, int requestedWidth,
+         int requestedHeight, const unsigned char* bytes, int size, void* userData) {
+        image->image.assign(bytes, bytes + size);
+        return true;
+      },
+      nullptr);
+  std::string err, warn;
+  bool loaded = false;
+  std::string extension = scene.path.substr(scene.path.find_last_of(".") + 1);
+  if (extension == "gltf")
+    loaded = loader.LoadASCIIFromFile(&scene.model, &err, &warn, scene.path);
+  else if (extension == "glb")
+    loaded = loader.LoadBinaryFromFile(&scene.model, &err, &warn, scene.path);
+  if (loaded == false) throw std::runtime_error("Can't load model: " + scene.path);
+
+  const tinygltf::Model& modelInternal = scene.model;
+  for (auto& glTFMaterial : modelInternal.materials) {
+    std::shared_ptr<MaterialGLTF> material = std::make_shared<MaterialGLTF>();
+    // Get the base color factor
+    material->baseColorFactor = glm::make_vec4(glTFMaterial.pbrMetallicRoughness.baseColorFactor.data());
+    scene.materials.push_back(material);
+  }
+  scene.images.resize(modelInternal.images.size());
+  scene.aabbs.resize(modelInternal.meshes.size());
+  scene.primitives.resize(modelInternal.meshes.size());
+  for (int i = 0; i < modelInternal.meshes.size(); i++) {
+    scene.primitives[i].resize(modelInternal.meshes[i].primitives.size());
+  }
+  // load nodes
+  const tinygltf::Scene& sceneInternal = modelInternal.scenes[0];
+  for (size_t i = 0; i < sceneInternal.nodes.size(); i++) {
+    const tinygltf::Node& node = modelInternal.nodes[sceneInternal.nodes[i]];
+    _loadNode(modelInternal, node, nullptr, sceneInternal.nodes[i], scene.aabbs, scene.nodes);
+  }
+  // load bones/joints
+  _loadSkins(modelInternal, scene.nodes, scene.skins);
+  // load animations
+  _loadAnimations(modelInternal, scene.nodes, scene.animations);
+}
+
+void LoaderGLTF::_decodeImage(SceneGLTF& scene, int imageIndex) {
+  tinygltf::Image& glTFImage = scene.model.images[imageIndex];
+  // identical images of different models are decoded once
+  auto imageCPU = _loaderImage->loadCPU<uint8_t>(glTFImage.image.data(), glTFImage.image.size(), glTFImage.uri);
+  scene.images[imageIndex] = _loaderImage->loadGPU<uint8_t>({imageCPU});
+  // encoded data isn't needed anymore
+  std::vector<unsigned char>().swap(glTFImage.image);
+}
+
+void LoaderGLTF::_mergePrimitives(SceneGLTF& scene) {
+  scene.meshes.resize(scene.primitives.size());
+  for (int i = 0; i < scene.primitives.size(); i++) {
+    auto& mesh = scene.meshes[i];
+    for (auto& primitive : scene.primitives[i]) {
+      uint32_t firstIndex = mesh.indexes.size();
+      uint32_t vertexStart = mesh.vertices.size();
+      for (auto index : primitive.indexes) mesh.indexes.push_back(index + vertexStart);
+      mesh.vertices.insert(mesh.vertices.end(), primitive.vertices.begin(), primitive.vertices.end());
+      mesh.primitives.push_back({.firstIndex = static_cast<int>(firstIndex),
+                                 .indexCount = static_cast<int>(primitive.indexes.size()),
+                                 .materialIndex = primitive.material});
+    }
+  }
+  scene.primitives.clear();
 }
 
 void LoaderGLTF::_generateTangent(std::vector<uint32_t>& indexes, std::vector<Vertex3D>& vertices) {
@@ -234,74 +500,21 @@ void LoaderGLTF::_generateTangent(std::vector<uint32_t>& indexes, std::vector<Ve
 // load all textures here
 std::shared_ptr<Texture> LoaderGLTF::_loadTexture(int imageIndex,
                                                   VkFormat format,
-                                                  const tinygltf::Model& modelInternal,
+                                                  const std::vector<std::shared_ptr<BufferImage>>& images,
                                                   std::vector<std::shared_ptr<Texture>>& textures,
                                                   std::shared_ptr<CommandBuffer> commandBufferTransfer) {
   std::shared_ptr<Texture> texture = textures[imageIndex];
   if (texture == nullptr) {
-    const tinygltf::Image glTFImage = modelInternal.images[imageIndex];
-    auto filePath = _path.remove_filename().string() + glTFImage.uri;
-    if (std::filesystem::exists(filePath)) {
-      auto imageCPU = _loaderImage->loadCPU<uint8_t>(filePath);
-      texture = std::make_shared<Texture>(_loaderImage->loadGPU<uint8_t>({imageCPU}), format,
-                                          VK_SAMPLER_ADDRESS_MODE_REPEAT, 1, VK_FILTER_LINEAR, commandBufferTransfer,
-                                          _engineState);
-    } else {
-      // Get the image data from the glTF loader
-      unsigned char* buffer = nullptr;
-      int bufferSize = 0;
-      bool deleteBuffer = false;
-      // We convert RGB-only images to RGBA, as most devices don't support RGB-formats in Vulkan
-      if (glTFImage.component == 3) {
-        bufferSize = glTFImage.width * glTFImage.height * 4;
-        buffer = new unsigned char[bufferSize];
-        unsigned char* rgba = buffer;
-        const unsigned char* rgb = glTFImage.image.data();
-        for (size_t i = 0; i < glTFImage.width * glTFImage.height; ++i) {
-          memcpy(rgba, rgb, sizeof(unsigned char) * 3);
-          rgba += 4;
-          rgb += 3;
-        }
-        deleteBuffer = true;
-      } else {
-        buffer = (unsigned char*)glTFImage.image.data();
-        bufferSize = glTFImage.image.size();
-      }
-
-      // copy buffer to Texture
-      auto stagingBuffer = std::make_shared<Buffer>(
-          bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, _engineState);
-
-      stagingBuffer->setData(buffer);
-
-      // for some textures SRGB is used but for others linear format
-      auto image = std::make_shared<Image>(std::tuple{glTFImage.width, glTFImage.height}, 1, 1, format,
-                                           VK_IMAGE_TILING_OPTIMAL,
-                                           VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
-                                           VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, _engineState);
-
-      image->changeLayout(VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT, 1,
-                          1, commandBufferTransfer);
-      image->copyFrom(stagingBuffer, {0}, commandBufferTransfer);
-      image->changeLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_ASPECT_COLOR_BIT, 1,
-                          1, commandBufferTransfer);
-
-      auto imageView = std::make_shared<ImageView>(image, VK_IMAGE_VIEW_TYPE_2D, 0, 1, 0, 1, VK_IMAGE_ASPECT_COLOR_BIT,
-                                                   _engineState);
-      texture = std::make_shared<Texture>(VK_SAMPLER_ADDRESS_MODE_REPEAT, 1, VK_FILTER_LINEAR, imageView, _engineState);
-      if (deleteBuffer) {
-        delete[] buffer;
-      }
-    }
+    // for some textures SRGB is used but for others linear format
+    texture = std::make_shared<Texture>(images[imageIndex], format, VK_SAMPLER_ADDRESS_MODE_REPEAT, 1, VK_FILTER_LINEAR,
+                                        commandBufferTransfer, _engineState);
     textures[imageIndex] = texture;
   }
   return texture;
 }
 
-// TODO: we can store baseColorFactor only in GLTF material, rest will go to PBR/Phong
 void LoaderGLTF::_loadMaterials(const tinygltf::Model& modelInternal,
-                                std::vector<std::shared_ptr<MaterialGLTF>>& materialGLTF,
+                                const std::vector<std::shared_ptr<BufferImage>>& images,
                                 std::shared_ptr<ModelGLTF> modelExternal,
                                 std::shared_ptr<CommandBuffer> commandBufferTransfer) {
   std::vector<std::shared_ptr<MaterialPBR>> materialsPBR;
@@ -316,13 +529,10 @@ void LoaderGLTF::_loadMaterials(const tinygltf::Model& modelInternal,
                                                                              commandBufferTransfer, _engineState);
     std::shared_ptr<MaterialColor> materialColor = std::make_shared<MaterialColor>(MaterialTarget::SIMPLE,
                                                                                    commandBufferTransfer, _engineState);
-    std::shared_ptr<MaterialGLTF> material = std::make_shared<MaterialGLTF>();
     float metallicFactor = 0;
     float roughnessFactor = 0;
     float occlusionStrength = 0;
     glm::vec3 emissiveFactor = glm::vec3(0.f);
-    // Get the base color factor
-    material->baseColorFactor = glm::make_vec4(glTFMaterial.pbrMetallicRoughness.baseColorFactor.data());
     // Get metallic factor
     metallicFactor = glTFMaterial.pbrMetallicRoughness.metallicFactor;
     // Get roughness factor
@@ -348,14 +558,14 @@ void LoaderGLTF::_loadMaterials(const tinygltf::Model& modelInternal,
         auto baseColorImageIndex = modelInternal.textures[baseColorTextureIndex].source;
         // set texture to phong material
         materialPhong->setBaseColor(
-            {_loadTexture(baseColorImageIndex, _engineState->getSettings()->getLoadTextureColorFormat(), modelInternal,
+            {_loadTexture(baseColorImageIndex, _engineState->getSettings()->getLoadTextureColorFormat(), images,
                           textures, commandBufferTransfer)});
         // set texture to PBR material
         materialPBR->setBaseColor(
-            {_loadTexture(baseColorImageIndex, _engineState->getSettings()->getLoadTextureColorFormat(), modelInternal,
+            {_loadTexture(baseColorImageIndex, _engineState->getSettings()->getLoadTextureColorFormat(), images,
                           textures, commandBufferTransfer)});
         materialColor->setBaseColor(
-            {_loadTexture(baseColorImageIndex, _engineState->getSettings()->getLoadTextureColorFormat(), modelInternal,
+            {_loadTexture(baseColorImageIndex, _engineState->getSettings()->getLoadTextureColorFormat(), images,
                           textures, commandBufferTransfer)});
       }
     }
@@ -367,11 +577,11 @@ void LoaderGLTF::_loadMaterials(const tinygltf::Model& modelInternal,
         auto normalImageIndex = modelInternal.textures[normalTextureIndex].source;
         // set normal texture to phong material
         materialPhong->setNormal(
-            {_loadTexture(normalImageIndex, _engineState->getSettings()->getLoadTextureAuxilaryFormat(), modelInternal,
+            {_loadTexture(normalImageIndex, _engineState->getSettings()->getLoadTextureAuxilaryFormat(), images,
                           textures, commandBufferTransfer)});
         // set normal texture to PBR material
         materialPBR->setNormal(
-            {_loadTexture(normalImageIndex, _engineState->getSettings()->getLoadTextureAuxilaryFormat(), modelInternal,
+            {_loadTexture(normalImageIndex, _engineState->getSettings()->getLoadTextureAuxilaryFormat(), images,
                           textures, commandBufferTransfer)});
       }
     }
@@ -384,15 +594,15 @@ void LoaderGLTF::_loadMaterials(const tinygltf::Model& modelInternal,
         // set specular texture to Phong material
         materialPhong->setSpecular(
             {_loadTexture(metallicRoughnessImageIndex, _engineState->getSettings()->getLoadTextureAuxilaryFormat(),
-                          modelInternal, textures, commandBufferTransfer)});
+                          images, textures, commandBufferTransfer)});
         // set metallic texture to PBR material
         materialPBR->setMetallic(
             {_loadTexture(metallicRoughnessImageIndex, _engineState->getSettings()->getLoadTextureAuxilaryFormat(),
-                          modelInternal, textures, commandBufferTransfer)});
+                          images, textures, commandBufferTransfer)});
         // set roughness texture to PBR material
         materialPBR->setRoughness(
             {_loadTexture(metallicRoughnessImageIndex, _engineState->getSettings()->getLoadTextureAuxilaryFormat(),
-                          modelInternal, textures, commandBufferTransfer)});
+                          images, textures, commandBufferTransfer)});
       }
     }
     // Get occlusion texture
@@ -402,7 +612,7 @@ void LoaderGLTF::_loadMaterials(const tinygltf::Model& modelInternal,
         auto occlusionImageIndex = modelInternal.textures[occlusionTextureIndex].source;
         materialPBR->setOccluded(
             {_loadTexture(occlusionImageIndex, _engineState->getSettings()->getLoadTextureAuxilaryFormat(),
-                          modelInternal, textures, commandBufferTransfer)});
+                          images, textures, commandBufferTransfer)});
       }
     }
     // Get emissive texture
@@ -411,12 +621,11 @@ void LoaderGLTF::_loadMaterials(const tinygltf::Model& modelInternal,
       if (emissiveTextureIndex >= 0) {
         auto emissiveImageIndex = modelInternal.textures[emissiveTextureIndex].source;
         materialPBR->setEmissive(
-            {_loadTexture(emissiveImageIndex, _engineState->getSettings()->getLoadTextureColorFormat(), modelInternal,
+            {_loadTexture(emissiveImageIndex, _engineState->getSettings()->getLoadTextureColorFormat(), images,
                           textures, commandBufferTransfer)});
       }
     }
 
-    materialGLTF.push_back(material);
     materialsPhong.push_back(materialPhong);
     materialsPBR.push_back(materialPBR);
     materialsColor.push_back(materialColor);
@@ -430,10 +639,8 @@ void LoaderGLTF::_loadNode(const tinygltf::Model& modelInternal,
                            const tinygltf::Node& input,
                            std::shared_ptr<NodeGLTF> parent,
                            uint32_t nodeIndex,
-                           const std::vector<std::shared_ptr<MaterialGLTF>>& materials,
-                           const std::vector<std::shared_ptr<MeshStatic3D>>& meshes,
-                           std::vector<std::shared_ptr<NodeGLTF>>& nodes,
-                           std::shared_ptr<CommandBuffer> commandBufferTransfer) {
+                           std::vector<std::shared_ptr<AABB>>& aabbs,
+                           std::vector<std::shared_ptr<NodeGLTF>>& nodes) {
   std::shared_ptr<NodeGLTF> node = std::make_shared<NodeGLTF>();
   node->parent = parent;
   node->matrix = glm::mat4(1.f);
@@ -461,232 +668,200 @@ void LoaderGLTF::_loadNode(const tinygltf::Model& modelInternal,
   // Load node's children
   if (input.children.size() > 0) {
     for (size_t i = 0; i < input.children.size(); i++) {
-      _loadNode(modelInternal, modelInternal.nodes[input.children[i]], node, input.children[i], materials, meshes,
-                nodes, commandBufferTransfer);
+      _loadNode(modelInternal, modelInternal.nodes[input.children[i]], node, input.children[i], aabbs, nodes);
     }
   }
 
-  // we have to calculate translate-scale-rotate matrices here
-  glm::mat4 nodeMatrix = node->getLocalMatrix();
-  std::shared_ptr<NodeGLTF> currentParent = node->parent;
-  while (currentParent) {
-    nodeMatrix = currentParent->getLocalMatrix() * nodeMatrix;
-    currentParent = currentParent->parent;
-  }
-
-  // If the node contains mesh data, we load vertices and indices from the buffers
-  // In glTF this is done via accessors and buffer views
+  // bounding box of mesh in mesh space, mesh can be shared by a few nodes, so node transforms are applied by Model3D
   if (input.mesh > -1) {
-    // GLTF mesh
-    const tinygltf::Mesh meshGLTF = modelInternal.meshes[input.mesh];
-    // internal engine mesh
-    auto mesh = meshes[input.mesh];
-    std::vector<uint32_t> indexes;
-    std::vector<Vertex3D> vertices;
     std::shared_ptr<AABB> aabb = std::make_shared<AABB>();
-    bool generateTangent = true;
-    // Iterate through all primitives of this node's mesh
-    for (size_t i = 0; i < meshGLTF.primitives.size(); i++) {
-      const tinygltf::Primitive& glTFPrimitive = meshGLTF.primitives[i];
-      uint32_t firstIndex = indexes.size();
-      uint32_t vertexStart = vertices.size();
-      uint32_t indexCount = 0;
-      bool hasSkin = false;
-      // Vertices
-      {
-        const float* positionBuffer = nullptr;
-        const float* normalsBuffer = nullptr;
-        const float* texCoordsBuffer = nullptr;
-        const void* jointIndicesBuffer = nullptr;
-        const float* jointWeightsBuffer = nullptr;
-        const float* tangentsBuffer = nullptr;
-        size_t vertexCount = 0;
-
-        int jointByteStride;
-        int jointComponentType;
-        int positionByteStride;
-        int normalByteStride;
-        int uv0ByteStride;
-        int weightByteStride;
-        int tangentByteStride;
-        // Get buffer data for vertex positions
-        if (glTFPrimitive.attributes.find("POSITION") != glTFPrimitive.attributes.end()) {
-          const tinygltf::Accessor& accessor =
-              modelInternal.accessors[glTFPrimitive.attributes.find("POSITION")->second];
-          glm::vec4 tempMin = {accessor.minValues[0], accessor.minValues[1], accessor.minValues[2], 1.f};
-          glm::vec4 tempMax = {accessor.maxValues[0], accessor.maxValues[1], accessor.maxValues[2], 1.f};
-          tempMin = nodeMatrix * tempMin;
-          tempMax = nodeMatrix * tempMax;
-          aabb->extend(glm::vec3(tempMin.x, tempMin.y, tempMin.z));
-          aabb->extend(glm::vec3(tempMax.x, tempMax.y, tempMax.z));
-
-          const tinygltf::BufferView& view = modelInternal.bufferViews[accessor.bufferView];
-          positionBuffer = reinterpret_cast<const float*>(
-              &(modelInternal.buffers[view.buffer].data[accessor.byteOffset + view.byteOffset]));
-          vertexCount = accessor.count;
-          positionByteStride = accessor.ByteStride(view) ? (accessor.ByteStride(view) / sizeof(float))
-                                                         : tinygltf::GetNumComponentsInType(TINYGLTF_TYPE_VEC3);
-        }
-        // Get buffer data for vertex normals
-        if (glTFPrimitive.attributes.find("NORMAL") != glTFPrimitive.attributes.end()) {
-          const tinygltf::Accessor& accessor = modelInternal.accessors[glTFPrimitive.attributes.find("NORMAL")->second];
-          const tinygltf::BufferView& view = modelInternal.bufferViews[accessor.bufferView];
-          normalsBuffer = reinterpret_cast<const float*>(
-              &(modelInternal.buffers[view.buffer].data[accessor.byteOffset + view.byteOffset]));
-          normalByteStride = accessor.ByteStride(view) ? (accessor.ByteStride(view) / sizeof(float))
-                                                       : tinygltf::GetNumComponentsInType(TINYGLTF_TYPE_VEC3);
-        }
-        // Get buffer data for vertex texture coordinates
-        // glTF supports multiple sets, we only load the first one
-        if (glTFPrimitive.attributes.find("TEXCOORD_0") != glTFPrimitive.attributes.end()) {
-          const tinygltf::Accessor& accessor =
-              modelInternal.accessors[glTFPrimitive.attributes.find("TEXCOORD_0")->second];
-          const tinygltf::BufferView& view = modelInternal.bufferViews[accessor.bufferView];
-          texCoordsBuffer = reinterpret_cast<const float*>(
-              &(modelInternal.buffers[view.buffer].data[accessor.byteOffset + view.byteOffset]));
-          uv0ByteStride = accessor.ByteStride(view) ? (accessor.ByteStride(view) / sizeof(float))
-                                                    : tinygltf::GetNumComponentsInType(TINYGLTF_TYPE_VEC2);
-        }
-
-        if (glTFPrimitive.attributes.find("TANGENT") != glTFPrimitive.attributes.end()) {
-          const tinygltf::Accessor& accessor =
-              modelInternal.accessors[glTFPrimitive.attributes.find("TANGENT")->second];
-          const tinygltf::BufferView& view = modelInternal.bufferViews[accessor.bufferView];
-          tangentsBuffer = reinterpret_cast<const float*>(
-              &(modelInternal.buffers[view.buffer].data[accessor.byteOffset + view.byteOffset]));
-          tangentByteStride = accessor.ByteStride(view) ? (accessor.ByteStride(view) / sizeof(float))
-                                                        : tinygltf::GetNumComponentsInType(TINYGLTF_TYPE_VEC4);
-        }
+    for (auto& glTFPrimitive : modelInternal.meshes[input.mesh].primitives) {
+      if (glTFPrimitive.attributes.find("POSITION") == glTFPrimitive.attributes.end()) continue;
+      const tinygltf::Accessor& accessor = modelInternal.accessors[glTFPrimitive.attributes.find("POSITION")->second];
+      aabb->extend(glm::vec3(accessor.minValues[0], accessor.minValues[1], accessor.minValues[2]));
+      aabb->extend(glm::vec3(accessor.maxValues[0], accessor.maxValues[1], accessor.maxValues[2]));
+    }
+    aabbs[input.mesh] = aabb;
+  }
 
-        // Get vertex joint indices
-        if (glTFPrimitive.attributes.find("JOINTS_0") != glTFPrimitive.attributes.end()) {
-          const tinygltf::Accessor& accessor =
-              modelInternal.accessors[glTFPrimitive.attributes.find("JOINTS_0")->second];
-          const tinygltf::BufferView& view = modelInternal.bufferViews[accessor.bufferView];
-          jointIndicesBuffer = &(modelInternal.buffers[view.buffer].data[accessor.byteOffset + view.byteOffset]);
-          jointComponentType = accessor.componentType;
-          jointByteStride = accessor.ByteStride(view)
-                                ? (accessor.ByteStride(view) / tinygltf::GetComponentSizeInBytes(jointComponentType))
-                                : tinygltf::GetNumComponentsInType(TINYGLTF_TYPE_VEC4);
-        }
-        // Get vertex joint weights
-        if (glTFPrimitive.attributes.find("WEIGHTS_0") != glTFPrimitive.attributes.end()) {
-          const tinygltf::Accessor& accessor =
-              modelInternal.accessors[glTFPrimitive.attributes.find("WEIGHTS_0")->second];
-          const tinygltf::BufferView& view = modelInternal.bufferViews[accessor.bufferView];
-          jointWeightsBuffer = reinterpret_cast<const float*>(
-              &(modelInternal.buffers[view.buffer].data[accessor.byteOffset + view.byteOffset]));
-          weightByteStride = accessor.ByteStride(view) ? (accessor.ByteStride(view) / sizeof(float))
-                                                       : tinygltf::GetNumComponentsInType(TINYGLTF_TYPE_VEC4);
-        }
+  // we store all node's heads in _nodes array
+  // if parent exists just attach node to existing node tree
+  if (parent) {
+    parent->children.push_back(node);
+  } else {
+    nodes.push_back(node);
+  }
+}
 
-        hasSkin = (jointIndicesBuffer && jointWeightsBuffer);
+void LoaderGLTF::_loadPrimitive(const tinygltf::Model& modelInternal,
+                                const tinygltf::Primitive& glTFPrimitive,
+                                const std::vector<std::shared_ptr<MaterialGLTF>>& materials,
+                                PrimitiveGLTF& primitive) {
+  primitive.material = glTFPrimitive.material;
+  bool generateTangent = true;
+  bool hasSkin = false;
+  // Vertices
+  {
+    const float* positionBuffer = nullptr;
+    const float* normalsBuffer = nullptr;
+    const float* texCoordsBuffer = nullptr;
+    const void* jointIndicesBuffer = nullptr;
+    const float* jointWeightsBuffer = nullptr;
+    const float* tangentsBuffer = nullptr;
+    size_t vertexCount = 0;
+
+    int jointByteStride;
+    int jointComponentType;
+    int positionByteStride;
+    int normalByteStride;
+    int uv0ByteStride;
+    int weightByteStride;
+    int tangentByteStride;
+    // Get buffer data for vertex positions
+    if (glTFPrimitive.attributes.find("POSITION") != glTFPrimitive.attributes.end()) {
+      const tinygltf::Accessor& accessor = modelInternal.accessors[glTFPrimitive.attributes.find("POSITION")->second];
+      const tinygltf::BufferView& view = modelInternal.bufferViews[accessor.bufferView];
+      positionBuffer = reinterpret_cast<const float*>(
+          &(modelInternal.buffers[view.buffer].data[accessor.byteOffset + view.byteOffset]));
+      vertexCount = accessor.count;
+      positionByteStride = accessor.ByteStride(view) ? (accessor.ByteStride(view) / sizeof(float))
+                                                     : tinygltf::GetNumComponentsInType(TINYGLTF_TYPE_VEC3);
+    }
+    // Get buffer data for vertex normals
+    if (glTFPrimitive.attributes.find("NORMAL") != glTFPrimitive.attributes.end()) {
+      const tinygltf::Accessor& accessor = modelInternal.accessors[glTFPrimitive.attributes.find("NORMAL")->second];
+      const tinygltf::BufferView& view = modelInternal.bufferViews[accessor.bufferView];
+      normalsBuffer = reinterpret_cast<const float*>(
+          &(modelInternal.buffers[view.buffer].data[accessor.byteOffset + view.byteOffset]));
+      normalByteStride = accessor.ByteStride(view) ? (accessor.ByteStride(view) / sizeof(float))
+                                                   : tinygltf::GetNumComponentsInType(TINYGLTF_TYPE_VEC3);
+    }
+    // Get buffer data for vertex texture coordinates
+    // glTF supports multiple sets, we only load the first one
+    if (glTFPrimitive.attributes.find("TEXCOORD_0") != glTFPrimitive.attributes.end()) {
+      const tinygltf::Accessor& accessor = modelInternal.accessors[glTFPrimitive.attributes.find("TEXCOORD_0")->second];
+      const tinygltf::BufferView& view = modelInternal.bufferViews[accessor.bufferView];
+      texCoordsBuffer = reinterpret_cast<const float*>(
+          &(modelInternal.buffers[view.buffer].data[accessor.byteOffset + view.byteOffset]));
+      uv0ByteStride = accessor.ByteStride(view) ? (accessor.ByteStride(view) / sizeof(float))
+                                                : tinygltf::GetNumComponentsInType(TINYGLTF_TYPE_VEC2);
+    }
 
-        // Append data to model's vertex buffer
-        for (size_t v = 0; v < vertexCount; v++) {
-          Vertex3D vertex{};
-          vertex.pos = glm::vec4(glm::make_vec3(&positionBuffer[v * positionByteStride]), 1.0f);
-          // default value
-          vertex.normal = glm::vec3(0.f, 0.f, 1.f);
-          if (normalsBuffer) {
-            vertex.normal = glm::normalize(glm::vec3(glm::make_vec3(&normalsBuffer[v * normalByteStride])));
-          }
-          vertex.texCoord = texCoordsBuffer ? glm::make_vec2(&texCoordsBuffer[v * uv0ByteStride]) : glm::vec3(0.0f);
-          vertex.jointIndices = glm::vec4(0.0f);
-          vertex.jointWeights = glm::vec4(0.0f);
-          if (hasSkin) {
-            vertex.jointWeights = glm::make_vec4(&jointWeightsBuffer[v * weightByteStride]);
-            switch (jointComponentType) {
-              case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: {
-                const uint16_t* buf = static_cast<const uint16_t*>(jointIndicesBuffer);
-                vertex.jointIndices = glm::vec4(glm::make_vec4(&buf[v * jointByteStride]));
-                break;
-              }
-              case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: {
-                const uint8_t* buf = static_cast<const uint8_t*>(jointIndicesBuffer);
-                vertex.jointIndices = glm::vec4(glm::make_vec4(&buf[v * jointByteStride]));
-                break;
-              }
-              default:
-                // Not supported by spec
-                std::cerr << "Joint component type " << jointComponentType << " not supported!" << std::endl;
-                break;
-            }
-          }
-          vertex.color = glm::vec3(1.f);
-          if (materials.size() > glTFPrimitive.material)
-            vertex.color = materials[glTFPrimitive.material]->baseColorFactor;
-
-          vertex.tangent = glm::vec4(0.0f);
-          if (tangentsBuffer) {
-            vertex.tangent = glm::make_vec4(&tangentsBuffer[v * tangentByteStride]);
-            generateTangent = false;
-          }
+    if (glTFPrimitive.attributes.find("TANGENT") != glTFPrimitive.attributes.end()) {
+      const tinygltf::Accessor& accessor = modelInternal.accessors[glTFPrimitive.attributes.find("TANGENT")->second];
+      const tinygltf::BufferView& view = modelInternal.bufferViews[accessor.bufferView];
+      tangentsBuffer = reinterpret_cast<const float*>(
+          &(modelInternal.buffers[view.buffer].data[accessor.byteOffset + view.byteOffset]));
+      tangentByteStride = accessor.ByteStride(view) ? (accessor.ByteStride(view) / sizeof(float))
+                                                    : tinygltf::GetNumComponentsInType(TINYGLTF_TYPE_VEC4);
+    }
 
-          vertices.push_back(vertex);
-        }
-      }
-      // Indices
-      {
-        const tinygltf::Accessor& accessor = modelInternal.accessors[glTFPrimitive.indices];
-        const tinygltf::BufferView& bufferView = modelInternal.bufferViews[accessor.bufferView];
-        const tinygltf::Buffer& buffer = modelInternal.buffers[bufferView.buffer];
+    // Get vertex joint indices
+    if (glTFPrimitive.attributes.find("JOINTS_0") != glTFPrimitive.attributes.end()) {
+      const tinygltf::Accessor& accessor = modelInternal.accessors[glTFPrimitive.attributes.find("JOINTS_0")->second];
+      const tinygltf::BufferView& view = modelInternal.bufferViews[accessor.bufferView];
+      jointIndicesBuffer = &(modelInternal.buffers[view.buffer].data[accessor.byteOffset + view.byteOffset]);
+      jointComponentType = accessor.componentType;
+      jointByteStride = accessor.ByteStride(view)
+                            ? (accessor.ByteStride(view) / tinygltf::GetComponentSizeInBytes(jointComponentType))
+                            : tinygltf::GetNumComponentsInType(TINYGLTF_TYPE_VEC4);
+    }
+    // Get vertex joint weights
+    if (glTFPrimitive.attributes.find("WEIGHTS_0") != glTFPrimitive.attributes.end()) {
+      const tinygltf::Accessor& accessor = modelInternal.accessors[glTFPrimitive.attributes.find("WEIGHTS_0")->second];
+      const tinygltf::BufferView& view = modelInternal.bufferViews[accessor.bufferView];
+      jointWeightsBuffer = reinterpret_cast<const float*>(
+          &(modelInternal.buffers[view.buffer].data[accessor.byteOffset + view.byteOffset]));
+      weightByteStride = accessor.ByteStride(view) ? (accessor.ByteStride(view) / sizeof(float))
+                                                   : tinygltf::GetNumComponentsInType(TINYGLTF_TYPE_VEC4);
+    }
 
-        indexCount += static_cast<uint32_t>(accessor.count);
+    hasSkin = (jointIndicesBuffer && jointWeightsBuffer);
 
-        // glTF supports different component types of indices
-        // TODO: check + vertexStart, what is it
-        switch (accessor.componentType) {
-          case TINYGLTF_PARAMETER_TYPE_UNSIGNED_INT: {
-            const uint32_t* buf = reinterpret_cast<const uint32_t*>(
-                &buffer.data[accessor.byteOffset + bufferView.byteOffset]);
-            for (size_t index = 0; index < accessor.count; index++) {
-              indexes.push_back(buf[index] + vertexStart);
-            }
-            break;
-          }
-          case TINYGLTF_PARAMETER_TYPE_UNSIGNED_SHORT: {
-            const uint16_t* buf = reinterpret_cast<const uint16_t*>(
-                &buffer.data[accessor.byteOffset + bufferView.byteOffset]);
-            for (size_t index = 0; index < accessor.count; index++) {
-              indexes.push_back(buf[index] + vertexStart);
-            }
+    // Append data to model's vertex buffer
+    for (size_t v = 0; v < vertexCount; v++) {
+      Vertex3D vertex{};
+      vertex.pos = glm::vec4(glm::make_vec3(&positionBuffer[v * positionByteStride]), 1.0f);
+      // default value
+      vertex.normal = glm::vec3(0.f, 0.f, 1.f);
+      if (normalsBuffer) {
+        vertex.normal = glm::normalize(glm::vec3(glm::make_vec3(&normalsBuffer[v * normalByteStride])));
+      }
+      vertex.texCoord = texCoordsBuffer ? glm::make_vec2(&texCoordsBuffer[v * uv0ByteStride]) : glm::vec3(0.0f);
+      vertex.jointIndices = glm::vec4(0.0f);
+      vertex.jointWeights = glm::vec4(0.0f);
+      if (hasSkin) {
+        vertex.jointWeights = glm::make_vec4(&jointWeightsBuffer[v * weightByteStride]);
+        switch (jointComponentType) {
+          case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: {
+            const uint16_t* buf = static_cast<const uint16_t*>(jointIndicesBuffer);
+            vertex.jointIndices = glm::vec4(glm::make_vec4(&buf[v * jointByteStride]));
             break;
           }
-          case TINYGLTF_PARAMETER_TYPE_UNSIGNED_BYTE: {
-            const uint8_t* buf = reinterpret_cast<const uint8_t*>(
-                &buffer.data[accessor.byteOffset + bufferView.byteOffset]);
-            for (size_t index = 0; index < accessor.count; index++) {
-              indexes.push_back(buf[index] + vertexStart);
-            }
+          case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: {
+            const uint8_t* buf = static_cast<const uint8_t*>(jointIndicesBuffer);
+            vertex.jointIndices = glm::vec4(glm::make_vec4(&buf[v * jointByteStride]));
             break;
           }
           default:
-            std::cerr << "Index component type " << accessor.componentType << " not supported!" << std::endl;
-            return;
+            // Not supported by spec
+            std::cerr << "Joint component type " << jointComponentType << " not supported!" << std::endl;
+            break;
         }
       }
-      MeshPrimitive primitive{.firstIndex = static_cast<int>(firstIndex),
-                              .indexCount = static_cast<int>(indexCount),
-                              .materialIndex = glTFPrimitive.material};
-      mesh->addPrimitive(primitive);
-    }
+      vertex.color = glm::vec3(1.f);
+      if (materials.size() > glTFPrimitive.material)
+        vertex.color = materials[glTFPrimitive.material]->baseColorFactor;
+
+      vertex.tangent = glm::vec4(0.0f);
+      if (tangentsBuffer) {
+        vertex.tangent = glm::make_vec4(&tangentsBuffer[v * tangentByteStride]);
+        generateTangent = false;
+      }
 
-    if (generateTangent) {
-      _generateTangent(indexes, vertices);
+      primitive.vertices.push_back(vertex);
+    }
+  }
+  // Indices
+  {
+    const tinygltf::Accessor& accessor = modelInternal.accessors[glTFPrimitive.indices];
+    const tinygltf::BufferView& bufferView = modelInternal.bufferViews[accessor.bufferView];
+    const tinygltf::Buffer& buffer = modelInternal.buffers[bufferView.buffer];
+
+    // glTF supports different component types of indices
+    switch (accessor.componentType) {
+      case TINYGLTF_PARAMETER_TYPE_UNSIGNED_INT: {
+        const uint32_t* buf = reinterpret_cast<const uint32_t*>(
+            &buffer.data[accessor.byteOffset + bufferView.byteOffset]);
+        for (size_t index = 0; index < accessor.count; index++) {
+          primitive.indexes.push_back(buf[index]);
+        }
+        break;
+      }
+      case TINYGLTF_PARAMETER_TYPE_UNSIGNED_SHORT: {
+        const uint16_t* buf = reinterpret_cast<const uint16_t*>(
+            &buffer.data[accessor.byteOffset + bufferView.byteOffset]);
+        for (size_t index = 0; index < accessor.count; index++) {
+          primitive.indexes.push_back(buf[index]);
+        }
+        break;
+      }
+      case TINYGLTF_PARAMETER_TYPE_UNSIGNED_BYTE: {
+        const uint8_t* buf = reinterpret_cast<const uint8_t*>(
+            &buffer.data[accessor.byteOffset + bufferView.byteOffset]);
+        for (size_t index = 0; index < accessor.count; index++) {
+          primitive.indexes.push_back(buf[index]);
+        }
+        break;
+      }
+      default:
+        std::cerr << "Index component type " << accessor.componentType << " not supported!" << std::endl;
+        return;
     }
-
-    mesh->setIndexes(indexes, commandBufferTransfer);
-    mesh->setVertices(vertices, commandBufferTransfer);
-    mesh->setAABB(aabb);
   }
 
-  // we store all node's heads in _nodes array
-  // if parent exists just attach node to existing node tree
-  if (parent) {
-    parent->children.push_back(node);
-  } else {
-    nodes.push_back(node);
+  if (generateTangent) {
+    _generateTangent(primitive.indexes, primitive.vertices);
   }
 }
 
@@ -760,7 +935,12 @@ void LoaderGLTF::_loadAnimations(const tinygltf::Model& modelInternal,
     for (size_t j = 0; j < glTFAnimation.samplers.size(); j++) {
       tinygltf::AnimationSampler glTFSampler = glTFAnimation.samplers[j];
       AnimationSamplerGLTF& dstSampler = animation->samplers[j];
-      dstSampler.interpolation = glTFSampler.interpolation;
+      dstSampler.interpolation = InterpolationGLTF::LINEAR;
+      if (glTFSampler.interpolation == "STEP") dstSampler.interpolation = InterpolationGLTF::STEP;
+      if (glTFSampler.interpolation == "CUBICSPLINE") dstSampler.interpolation = InterpolationGLTF::CUBICSPLINE;
+      if (dstSampler.interpolation != InterpolationGLTF::LINEAR) {
+        std::cout << "Only linear interpolation is supported, sampler is ignored" << std::endl;
+      }
 
       // Read sampler keyframe input time values
       {
@@ -817,7 +997,10 @@ void LoaderGLTF::_loadAnimations(const tinygltf::Model& modelInternal,
     for (size_t j = 0; j < glTFAnimation.channels.size(); j++) {
       tinygltf::AnimationChannel glTFChannel = glTFAnimation.channels[j];
       AnimationChannelGLTF& dstChannel = animation->channels[j];
-      dstChannel.path = glTFChannel.target_path;
+      dstChannel.path = AnimationPathGLTF::WEIGHTS;
+      if (glTFChannel.target_path == "translation") dstChannel.path = AnimationPathGLTF::TRANSLATION;
+      if (glTFChannel.target_path == "rotation") dstChannel.path = AnimationPathGLTF::ROTATION;
+      if (glTFChannel.target_path == "scale") dstChannel.path = AnimationPathGLTF::SCALE;
       dstChannel.samplerIndex = glTFChannel.sampler;
       dstChannel.node = _nodeFromIndex(glTFChannel.target_node, nodes);
     }
@@ -1,26 +1,45 @@
 #include "Utility/Logger.h"
+#include "Utility/Profiler.h"
 #include "nvtx3/nvtx3.hpp"
+#include <cinttypes>
+#include <mutex>
+#include <unordered_set>
 #ifdef __ANDROID__
 #include <android/trace.h>
 #endif
 
-void LoggerAndroid::begin(std::string name) {
+// name with payload is formatted to stack buffer for consumers that accept only string
+static const char* formatMarker(const char* name, int64_t payload, char* buffer, size_t size) {
+  if (payload < 0) return name;
+  std::snprintf(buffer, size, "%s %" PRId64, name, payload);
+  return buffer;
+}
+
+void LoggerAndroid::begin(const char* name, int64_t payload) {
 #ifdef __ANDROID__
-  ATrace_beginSection(name.c_str());
+  if (ATrace_isEnabled() == false) return;
+  char buffer[256];
+  ATrace_beginSection(formatMarker(name, payload, buffer, sizeof(buffer)));
 #endif
 }
 
 void LoggerAndroid::end() {
 #ifdef __ANDROID__
+  if (ATrace_isEnabled() == false) return;
   ATrace_endSection();
 #endif
 }
 
 LoggerUtils::LoggerUtils(std::shared_ptr<EngineState> engineState) { _engineState = engineState; }
 
-void LoggerUtils::begin(std::string marker, std::shared_ptr<CommandBuffer> buffer, std::array<float, 4> color) {
+void LoggerUtils::begin(const char* marker,
+                        int64_t payload,
+                        std::shared_ptr<CommandBuffer> buffer,
+                        std::array<float, 4> color) {
   auto frameInFlight = _engineState->getFrameInFlight();
-  VkDebugUtilsLabelEXT markerInfo = {.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, .pLabelName = marker.c_str()};
+  char label[256];
+  VkDebugUtilsLabelEXT markerInfo = {.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT,
+                                     .pLabelName = formatMarker(marker, payload, label, sizeof(label))};
   std::copy(color.begin(), color.end(), markerInfo.color);
   vkCmdBeginDebugUtilsLabelEXT(buffer->getCommandBuffer()[frameInFlight], &markerInfo);
 }
@@ -30,40 +49,71 @@ void LoggerUtils::end(std::shared_ptr<CommandBuffer> buffer) {
   vkCmdEndDebugUtilsLabelEXT(buffer->getCommandBuffer()[frameInFlight]);
 }
 
-void LoggerNVTX::begin(std::string name) { nvtxRangePush(name.c_str()); }
+void LoggerNVTX::begin(const char* name, int64_t payload) {
+  // NVTX accepts payload as is, it's no-op if no tool is attached
+  nvtxEventAttributes_t attributes = {0};
+  attributes.version = NVTX_VERSION;
+  attributes.size = NVTX_EVENT_ATTRIB_STRUCT_SIZE;
+  attributes.messageType = NVTX_MESSAGE_TYPE_ASCII;
+  attributes.message.ascii = name;
+  if (payload >= 0) {
+    attributes.payloadType = NVTX_PAYLOAD_TYPE_INT64;
+    attributes.payload.llValue = payload;
+  }
+  nvtxRangePushEx(&attributes);
+}
 
 void LoggerNVTX::end() { nvtxRangePop(); }
 
 Logger::Logger(std::shared_ptr<EngineState> engineState) {
+  _engineState = engineState;
 #ifdef __ANDROID__
   _loggerAndroid = std::make_shared<LoggerAndroid>();
 #else
-  _engineState = engineState;
-  if (engineState)
-    _loggerUtils = std::make_shared<LoggerUtils>(engineState);
-  else
-    _loggerNVTX = std::make_shared<LoggerNVTX>();
+  // command buffer labels are available only if debug utils are enabled
+  if (engineState && engineState->getInstance()->isDebug()) _loggerUtils = std::make_shared<LoggerUtils>(engineState);
+  _loggerNVTX = std::make_shared<LoggerNVTX>();
 #endif
 }
 
-void Logger::begin(std::string marker, std::shared_ptr<CommandBuffer> buffer, std::array<float, 4> color) {
+const char* Logger::intern(const std::string& name) {
+  static std::mutex mutex;
+  // node based container, so pointers to elements stay valid after insertion
+  static std::unordered_set<std::string> names;
+  std::unique_lock<std::mutex> lock(mutex);
+  return names.insert(name).first->c_str();
+}
+
+void Logger::begin(const char* marker,
+                   std::shared_ptr<CommandBuffer> buffer,
+                   int64_t payload,
+                   std::array<float, 4> color) {
+  // profilers are independent from markers, so they measure scopes even if markers are compiled out
+  ProfilerCPU::begin(marker, payload);
+  if (buffer && _engineState && _engineState->getProfilerGPU()) _engineState->getProfilerGPU()->begin(marker, buffer);
+#ifdef ENGINE_MARKERS
 #ifdef __ANDROID__
-  _loggerAndroid->begin(marker);
+  _loggerAndroid->begin(marker, payload);
 #else
-  if (buffer)
-    _loggerUtils->begin(marker, buffer, color);
-  else
-    _loggerNVTX->begin(marker);
+  if (buffer) {
+    if (_loggerUtils) _loggerUtils->begin(marker, payload, buffer, color);
+  } else
+    _loggerNVTX->begin(marker, payload);
+#endif
 #endif
 }
 
 void Logger::end(std::shared_ptr<CommandBuffer> buffer) {
+  ProfilerCPU::end();
+  if (buffer && _engineState && _engineState->getProfilerGPU()) _engineState->getProfilerGPU()->end(buffer);
+#ifdef ENGINE_MARKERS
 #ifdef __ANDROID__
   _loggerAndroid->end();
 #else
-  if (buffer)
-    _loggerUtils->end(buffer);
-  else
+  if (buffer) {
+    if (_loggerUtils) _loggerUtils->end(buffer);
+  } else
     _loggerNVTX->end();
 #endif
+#endif
 }
\ No newline at end of file
@@ -1,4 +1,25 @@
 #include "Utility/PhysicsManager.h"
+#include "Utility/Profiler.h"
+
+JPH::JobSystem::JobHandle JobSystemProfiled::CreateJob(const char* inName,
+                                                       JPH::ColorArg inColor,
+                                                       const JobFunction& inJobFunction,
+                                                       JPH::uint32 inNumDependencies) {
+  // job is wrapped only during capture, job names are string literals
+  if (ProfilerCPU::isRecording() == false)
+    return JobSystemThreadPool::CreateJob(inName, inColor, inJobFunction, inNumDependencies);
+
+  return JobSystemThreadPool::CreateJob(
+      inName, inColor,
+      [inName, inJobFunction]() {
+        // jobs can be also executed by thread waiting for them, it keeps own name
+        ProfilerCPU::setThreadName("Physics");
+        ProfilerCPU::begin(inName);
+        inJobFunction();
+        ProfilerCPU::end();
+      },
+      inNumDependencies);
+}
 
 PhysicsManager::PhysicsManager() {
   // Register allocation hook. In this example we'll just let Jolt use malloc / free but you can override these if you
@@ -24,8 +45,8 @@ PhysicsManager::PhysicsManager() {
   // We need a job system that will execute physics jobs on multiple threads. Typically
   // you would implement the JobSystem interface yourself and let Jolt Physics run on top
   // of your own job scheduler. JobSystemThreadPool is an example implementation.
-  _jobSystem = std::make_shared<JPH::JobSystemThreadPool>(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers,
-                                                          JPH::thread::hardware_concurrency() - 1);
+  _jobSystem = std::make_shared<JobSystemProfiled>(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers,
+                                                   JPH::thread::hardware_concurrency() - 1);
 
   // This is the max amount of rigid bodies that you can add to the physics system. If you try to add more you'll get an
   // error. Note: This value is low because this is a simple test. For a real project use something in the order of
@@ -62,7 +83,9 @@ glm::vec3 PhysicsManager::getGravity() {
 float PhysicsManager::getDeltaTime() { return _deltaTime; }
 
 void PhysicsManager::update() {
+  ProfilerCPU::begin("Physics update");
   _physicsSystem.Update(_deltaTime, _collisionSteps, _tempAllocator.get(), _jobSystem.get());
+  ProfilerCPU::end();
 }
 
 PhysicsManager::~PhysicsManager() {}
\ No newline at end of file
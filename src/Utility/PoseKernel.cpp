@@ -0,0 +1,364 @@
+#include "Utility/PoseKernel.h"
+#include "glm/gtc/type_ptr.hpp"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+#if defined(__SSE2__) || defined(_M_X64) || defined(__AVX__)
+#include <immintrin.h>
+#define POSE_KERNEL_SIMD
+typedef __m128 Lanes;
+
+static inline Lanes load(const float* data) { return _mm_loadu_ps(data); }
+static inline void store(float* data, Lanes value) { _mm_storeu_ps(data, value); }
+static inline Lanes splat(float value) { return _mm_set1_ps(value); }
+static inline Lanes set(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+static inline Lanes add(Lanes a, Lanes b) { return _mm_add_ps(a, b); }
+static inline Lanes sub(Lanes a, Lanes b) { return _mm_sub_ps(a, b); }
+static inline Lanes mul(Lanes a, Lanes b) { return _mm_mul_ps(a, b); }
+
+// a * b + c
+static inline Lanes madd(Lanes a, Lanes b, Lanes c) {
+#if defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__))
+  return _mm_fmadd_ps(a, b, c);
+#else
+  return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+}
+
+template <int I>
+static inline Lanes broadcast(Lanes value) {
+  return _mm_shuffle_ps(value, value, _MM_SHUFFLE(I, I, I, I));
+}
+
+// a with sign flipped in lanes where b is negative
+static inline Lanes flipSign(Lanes a, Lanes b) { return _mm_xor_ps(a, _mm_and_ps(b, _mm_set1_ps(-0.f))); }
+static inline Lanes absolute(Lanes value) { return _mm_andnot_ps(_mm_set1_ps(-0.f), value); }
+static inline Lanes inverseSqrt(Lanes value) { return _mm_div_ps(_mm_set1_ps(1.f), _mm_sqrt_ps(value)); }
+static inline void transpose(Lanes& a, Lanes& b, Lanes& c, Lanes& d) { _MM_TRANSPOSE4_PS(a, b, c, d); }
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define POSE_KERNEL_SIMD
+typedef float32x4_t Lanes;
+
+// only ARMv7 intrinsics are used, so 32-bit Android ABI is supported too
+static inline Lanes load(const float* data) { return vld1q_f32(data); }
+static inline void store(float* data, Lanes value) { vst1q_f32(data, value); }
+static inline Lanes splat(float value) { return vdupq_n_f32(value); }
+
+static inline Lanes set(float x, float y, float z, float w) {
+  float data[4] = {x, y, z, w};
+  return vld1q_f32(data);
+}
+
+static inline Lanes add(Lanes a, Lanes b) { return vaddq_f32(a, b); }
+static inline Lanes sub(Lanes a, Lanes b) { return vsubq_f32(a, b); }
+static inline Lanes mul(Lanes a, Lanes b) { return vmulq_f32(a, b); }
+
+// a * b + c
+static inline Lanes madd(Lanes a, Lanes b, Lanes c) {
+#if defined(__ARM_FEATURE_FMA)
+  return vfmaq_f32(c, a, b);
+#else
+  return vmlaq_f32(c, a, b);
+#endif
+}
+
+template <int I>
+static inline Lanes broadcast(Lanes value) {
+  return vdupq_n_f32(vgetq_lane_f32(value, I));
+}
+
+// a with sign flipped in lanes where b is negative
+static inline Lanes flipSign(Lanes a, Lanes b) {
+  uint32x4_t sign = vandq_u32(vreinterpretq_u32_f32(b), vdupq_n_u32(0x80000000));
+  return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(a), sign));
+}
+
+static inline Lanes absolute(Lanes value) { return vabsq_f32(value); }
+
+static inline Lanes inverseSqrt(Lanes value) {
+  // estimate has 8 bits of precision, every Newton-Raphson step doubles it
+  Lanes estimate = vrsqrteq_f32(value);
+  estimate = vmulq_f32(estimate, vrsqrtsq_f32(vmulq_f32(value, estimate), estimate));
+  return vmulq_f32(estimate, vrsqrtsq_f32(vmulq_f32(value, estimate), estimate));
+}
+
+static inline void transpose(Lanes& a, Lanes& b, Lanes& c, Lanes& d) {
+  float32x4x2_t ab = vtrnq_f32(a, b);
+  float32x4x2_t cd = vtrnq_f32(c, d);
+  a = vcombine_f32(vget_low_f32(ab.val[0]), vget_low_f32(cd.val[0]));
+  b = vcombine_f32(vget_low_f32(ab.val[1]), vget_low_f32(cd.val[1]));
+  c = vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0]));
+  d = vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1]));
+}
+#endif
+
+#ifdef POSE_KERNEL_SIMD
+// column of a * b
+static inline Lanes multiplyColumn(Lanes a0, Lanes a1, Lanes a2, Lanes a3, Lanes b) {
+  Lanes result = mul(a0, broadcast<0>(b));
+  result = madd(a1, broadcast<1>(b), result);
+  result = madd(a2, broadcast<2>(b), result);
+  return madd(a3, broadcast<3>(b), result);
+}
+
+// result = a * b for column major matrices, both matrices are loaded before store, so result can be a or b
+static inline void multiplyMatrix(const float* a, const float* b, float* result) {
+#if defined(__AVX__)
+  // two columns of result per instruction, columns of a are duplicated to both halves
+  __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a));
+  __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 4));
+  __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 8));
+  __m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 12));
+  __m256 b01 = _mm256_loadu_ps(b);
+  __m256 b23 = _mm256_loadu_ps(b + 8);
+  auto column = [&](__m256 pair) {
+#if defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__))
+    __m256 result = _mm256_mul_ps(a0, _mm256_permute_ps(pair, 0x00));
+    result = _mm256_fmadd_ps(a1, _mm256_permute_ps(pair, 0x55), result);
+    result = _mm256_fmadd_ps(a2, _mm256_permute_ps(pair, 0xAA), result);
+    return _mm256_fmadd_ps(a3, _mm256_permute_ps(pair, 0xFF), result);
+#else
+    __m256 result = _mm256_mul_ps(a0, _mm256_permute_ps(pair, 0x00));
+    result = _mm256_add_ps(_mm256_mul_ps(a1, _mm256_permute_ps(pair, 0x55)), result);
+    result = _mm256_add_ps(_mm256_mul_ps(a2, _mm256_permute_ps(pair, 0xAA)), result);
+    return _mm256_add_ps(_mm256_mul_ps(a3, _mm256_permute_ps(pair, 0xFF)), result);
+#endif
+  };
+  _mm256_storeu_ps(result, column(b01));
+  _mm256_storeu_ps(result + 8, column(b23));
+#else
+  Lanes a0 = load(a), a1 = load(a + 4), a2 = load(a + 8), a3 = load(a + 12);
+  Lanes b0 = load(b), b1 = load(b + 4), b2 = load(b + 8), b3 = load(b + 12);
+  store(result, multiplyColumn(a0, a1, a2, a3, b0));
+  store(result + 4, multiplyColumn(a0, a1, a2, a3, b1));
+  store(result + 8, multiplyColumn(a0, a1, a2, a3, b2));
+  store(result + 12, multiplyColumn(a0, a1, a2, a3, b3));
+#endif
+}
+#endif
+
+bool PoseKernel::isSupported() {
+#ifdef POSE_KERNEL_SIMD
+  return true;
+#else
+  return false;
+#endif
+}
+
+void PoseKernel::composeTRS(const glm::vec3* translations,
+                            const glm::quat* rotations,
+                            const glm::vec3* scales,
+                            glm::mat4* result,
+                            int count,
+                            bool simd) {
+  int i = 0;
+#ifdef POSE_KERNEL_SIMD
+  if (simd) {
+    const Lanes one = splat(1.f), two = splat(2.f), zero = splat(0.f);
+    for (; i + 4 <= count; i += 4) {
+      // lane per joint, components are gathered by name, so storage order of glm::quat doesn't matter
+      const glm::quat* r = rotations + i;
+      const glm::vec3* s = scales + i;
+      Lanes x = set(r[0].x, r[1].x, r[2].x, r[3].x);
+      Lanes y = set(r[0].y, r[1].y, r[2].y, r[3].y);
+      Lanes z = set(r[0].z, r[1].z, r[2].z, r[3].z);
+      Lanes w = set(r[0].w, r[1].w, r[2].w, r[3].w);
+      Lanes sx = set(s[0].x, s[1].x, s[2].x, s[3].x);
+      Lanes sy = set(s[0].y, s[1].y, s[2].y, s[3].y);
+      Lanes sz = set(s[0].z, s[1].z, s[2].z, s[3].z);
+      Lanes xx = mul(x, x), yy = mul(y, y), zz = mul(z, z);
+      Lanes xy = mul(x, y), xz = mul(x, z), yz = mul(y, z);
+      Lanes wx = mul(w, x), wy = mul(w, y), wz = mul(w, z);
+      // the same as glm::mat3_cast, every column is multiplied by scale
+      Lanes c0x = mul(sub(one, mul(two, add(yy, zz))), sx);
+      Lanes c0y = mul(mul(two, add(xy, wz)), sx);
+      Lanes c0z = mul(mul(two, sub(xz, wy)), sx);
+      Lanes c0w = zero;
+      Lanes c1x = mul(mul(two, sub(xy, wz)), sy);
+      Lanes c1y = mul(sub(one, mul(two, add(xx, zz))), sy);
+      Lanes c1z = mul(mul(two, add(yz, wx)), sy);
+      Lanes c1w = zero;
+      Lanes c2x = mul(mul(two, add(xz, wy)), sz);
+      Lanes c2y = mul(mul(two, sub(yz, wx)), sz);
+      Lanes c2z = mul(sub(one, mul(two, add(xx, yy))), sz);
+      Lanes c2w = zero;
+      // lane j of transposed vectors is column of joint j
+      transpose(c0x, c0y, c0z, c0w);
+      transpose(c1x, c1y, c1z, c1w);
+      transpose(c2x, c2y, c2z, c2w);
+      Lanes column0[4] = {c0x, c0y, c0z, c0w};
+      Lanes column1[4] = {c1x, c1y, c1z, c1w};
+      Lanes column2[4] = {c2x, c2y, c2z, c2w};
+      for (int j = 0; j < 4; j++) {
+        float* matrix = glm::value_ptr(result[i + j]);
+        store(matrix, column0[j]);
+        store(matrix + 4, column1[j]);
+        store(matrix + 8, column2[j]);
+        result[i + j][3] = glm::vec4(translations[i + j], 1.f);
+      }
+    }
+  }
+#endif
+  for (; i < count; i++) {
+    glm::mat4 matrix = glm::mat4_cast(rotations[i]);
+    matrix[0] *= scales[i].x;
+    matrix[1] *= scales[i].y;
+    matrix[2] *= scales[i].z;
+    matrix[3] = glm::vec4(translations[i], 1.f);
+    result[i] = matrix;
+  }
+}
+
+void PoseKernel::multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& result, bool simd) {
+#ifdef POSE_KERNEL_SIMD
+  if (simd) {
+    multiplyMatrix(glm::value_ptr(a), glm::value_ptr(b), glm::value_ptr(result));
+    return;
+  }
+#endif
+  result = a * b;
+}
+
+void PoseKernel::multiplyIndexed(const glm::mat4& left,
+                                 const glm::mat4* matrices,
+                                 const int* indexes,
+                                 const glm::mat4* right,
+                                 glm::mat4* result,
+                                 int count,
+                                 bool simd) {
+#ifdef POSE_KERNEL_SIMD
+  if (simd) {
+    for (int i = 0; i < count; i++) {
+      glm::mat4 matrix;
+      multiplyMatrix(glm::value_ptr(left), glm::value_ptr(matrices[indexes[i]]), glm::value_ptr(matrix));
+      multiplyMatrix(glm::value_ptr(matrix), glm::value_ptr(right[i]), glm::value_ptr(result[i]));
+    }
+    return;
+  }
+#endif
+  for (int i = 0; i < count; i++) result[i] = left * matrices[indexes[i]] * right[i];
+}
+
+void PoseKernel::slerp(const glm::quat* from,
+                       const glm::quat* to,
+                       const float* factors,
+                       glm::quat* result,
+                       int count,
+                       bool simd) {
+  int i = 0;
+#ifdef POSE_KERNEL_SIMD
+  // nlerp deviates from slerp by less than 0.02 degree if rotations differ by less than 20 degrees
+  const float threshold = 0.985f;
+  if (simd) {
+    const Lanes one = splat(1.f);
+    for (; i + 4 <= count; i += 4) {
+      const glm::quat* f = from + i;
+      const glm::quat* t = to + i;
+      Lanes fx = set(f[0].x, f[1].x, f[2].x, f[3].x);
+      Lanes fy = set(f[0].y, f[1].y, f[2].y, f[3].y);
+      Lanes fz = set(f[0].z, f[1].z, f[2].z, f[3].z);
+      Lanes fw = set(f[0].w, f[1].w, f[2].w, f[3].w);
+      Lanes tx = set(t[0].x, t[1].x, t[2].x, t[3].x);
+      Lanes ty = set(t[0].y, t[1].y, t[2].y, t[3].y);
+      Lanes tz = set(t[0].z, t[1].z, t[2].z, t[3].z);
+      Lanes tw = set(t[0].w, t[1].w, t[2].w, t[3].w);
+      Lanes a = load(factors + i);
+      Lanes b = sub(one, a);
+      Lanes cosine = madd(fw, tw, madd(fz, tz, madd(fy, ty, mul(fx, tx))));
+      // q and -q are the same rotation, the closest one is used
+      tx = flipSign(tx, cosine);
+      ty = flipSign(ty, cosine);
+      tz = flipSign(tz, cosine);
+      tw = flipSign(tw, cosine);
+      Lanes rx = madd(tx, a, mul(fx, b));
+      Lanes ry = madd(ty, a, mul(fy, b));
+      Lanes rz = madd(tz, a, mul(fz, b));
+      Lanes rw = madd(tw, a, mul(fw, b));
+      Lanes length = inverseSqrt(madd(rw, rw, madd(rz, rz, madd(ry, ry, mul(rx, rx)))));
+      float x[4], y[4], z[4], w[4], angle[4];
+      store(x, mul(rx, length));
+      store(y, mul(ry, length));
+      store(z, mul(rz, length));
+      store(w, mul(rw, length));
+      store(angle, absolute(cosine));
+      for (int j = 0; j < 4; j++) {
+        if (angle[j] < threshold) {
+          result[i + j] = glm::normalize(glm::slerp(f[j], t[j], factors[i + j]));
+          continue;
+        }
+        result[i + j].x = x[j];
+        result[i + j].y = y[j];
+        result[i + j].z = z[j];
+        result[i + j].w = w[j];
+      }
+    }
+  }
+#endif
+  for (; i < count; i++) result[i] = glm::normalize(glm::slerp(from[i], to[i], factors[i]));
+}
+
+void PoseKernel::benchmark(int count, int iterations) {
+  // random skeleton, parent is always before child as in Animation
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+  auto random = [&]() { return distribution(generator); };
+  std::vector<glm::vec3> translations(count), scales(count);
+  std::vector<glm::quat> from(count), to(count);
+  std::vector<float> factors(count);
+  std::vector<glm::mat4> inverseBind(count, glm::mat4(1.f));
+  std::vector<int> parents(count, -1), joints(count);
+  for (int i = 0; i < count; i++) {
+    translations[i] = glm::vec3(random(), random(), random());
+    scales[i] = glm::vec3(1.f) + 0.1f * glm::vec3(random(), random(), random());
+    from[i] = glm::normalize(glm::quat(random(), random(), random(), random()));
+    // neighbour keyframes are close, but some of them are far enough for slerp fallback
+    glm::vec3 axis = glm::normalize(glm::vec3(random(), random(), random()) + glm::vec3(0.f, 0.f, 2.f));
+    to[i] = glm::normalize(from[i] * glm::angleAxis(random() * 0.5f, axis));
+    factors[i] = (random() + 1.f) / 2.f;
+    inverseBind[i][3] = glm::vec4(-translations[i], 1.f);
+    if (i > 0) parents[i] = generator() % i;
+    joints[i] = generator() % count;
+  }
+
+  std::vector<glm::quat> rotations[2] = {std::vector<glm::quat>(count), std::vector<glm::quat>(count)};
+  std::vector<glm::mat4> local(count), world(count);
+  std::vector<glm::mat4> palette[2] = {std::vector<glm::mat4>(count), std::vector<glm::mat4>(count)};
+  float milliseconds[2];
+  for (int path = 0; path < 2; path++) {
+    bool simd = path == 1;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int iteration = 0; iteration < iterations; iteration++) {
+      slerp(from.data(), to.data(), factors.data(), rotations[path].data(), count, simd);
+      composeTRS(translations.data(), rotations[path].data(), scales.data(), local.data(), count, simd);
+      for (int i = 0; i < count; i++) {
+        if (parents[i] >= 0)
+          multiply(world[parents[i]], local[i], world[i], simd);
+        else
+          world[i] = local[i];
+      }
+      multiplyIndexed(glm::inverse(world[0]), world.data(), joints.data(), inverseBind.data(), palette[path].data(),
+                      count, simd);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    milliseconds[path] = std::chrono::duration<float, std::milli>(end - start).count() / iterations;
+  }
+
+  float rotationError = 0.f, paletteError = 0.f;
+  for (int i = 0; i < count; i++) {
+    rotationError = std::max(rotationError, glm::length(glm::vec4(rotations[0][i].x - rotations[1][i].x,
+                                                                  rotations[0][i].y - rotations[1][i].y,
+                                                                  rotations[0][i].z - rotations[1][i].z,
+                                                                  rotations[0][i].w - rotations[1][i].w)));
+    for (int j = 0; j < 4; j++)
+      paletteError = std::max(paletteError, glm::length(palette[0][i][j] - palette[1][i][j]));
+  }
+
+  std::cout << "Pose kernel, " << count << " joints, " << iterations << " iterations" << std::endl;
+  std::cout << "GLM: " << milliseconds[0] << " ms" << std::endl;
+  std::cout << "SIMD: " << milliseconds[1] << " ms" << (isSupported() ? "" : " (not supported, GLM path is used)")
+            << std::endl;
+  std::cout << "Speedup: " << milliseconds[0] / milliseconds[1] << "x" << std::endl;
+  std::cout << "Max difference: rotation " << rotationError << ", palette " << paletteError << std::endl;
+}
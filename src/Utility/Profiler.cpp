@@ -0,0 +1,252 @@
+#include "Utility/Profiler.h"
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+ProfilerGPU::ProfilerGPU(std::shared_ptr<EngineState> engineState) {
+  _engineState = engineState;
+  auto limits = engineState->getDevice()->getDeviceLimits();
+  // nanoseconds per timestamp tick
+  _timestampPeriod = limits.timestampPeriod;
+  // all graphic and compute queues support timestamps
+  _supported = limits.timestampComputeAndGraphics && engineState->getDevice()->isHostQueryResetSupported();
+
+  int framesInFlight = engineState->getSettings()->getMaxFramesInFlight();
+  _scopes.resize(framesInFlight, std::vector<std::tuple<const char*, int>>(_scopesMax));
+  _scopesNext = std::vector<std::atomic<int>>(framesInFlight);
+  if (_supported) {
+    for (int i = 0; i < framesInFlight; i++) {
+      _queryPool.push_back(
+          std::make_shared<QueryPool>(VK_QUERY_TYPE_TIMESTAMP, _scopesMax * 2, engineState->getDevice()));
+      // queries have to be reset before the first usage
+      vkResetQueryPoolEXT(engineState->getDevice()->getLogicalDevice(), _queryPool[i]->getQueryPool(), 0,
+                          _scopesMax * 2);
+    }
+  }
+}
+
+bool ProfilerGPU::isSupported() { return _supported; }
+
+void ProfilerGPU::setEnabled(bool enabled) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  _enabledNext = enabled && _supported;
+}
+
+bool ProfilerGPU::isEnabled() { return _enabledNext; }
+
+void ProfilerGPU::setOverlay(bool overlay) { _overlay = overlay; }
+
+thread_local std::map<std::pair<ProfilerGPU*, VkCommandBuffer>, StackGPU> ProfilerGPU::_stacks;
+
+std::vector<int>& ProfilerGPU::_getStack(VkCommandBuffer commandBuffer) {
+  auto& stack = _stacks[{this, commandBuffer}];
+  int64_t frame = _frame.load(std::memory_order_relaxed);
+  if (stack.frame != frame) {
+    stack.frame = frame;
+    stack.scopes.clear();
+  }
+  return stack.scopes;
+}
+
+void ProfilerGPU::begin(const char* name, std::shared_ptr<CommandBuffer> commandBuffer) {
+  if (_enabled == false || _active == false) return;
+  int frameInFlight = _engineState->getFrameInFlight();
+  auto buffer = commandBuffer->getCommandBuffer()[frameInFlight];
+  auto& stack = _getStack(buffer);
+  // secondary command buffers are executed inside pass of primary one
+  int depth = stack.size() + (commandBuffer->getLevel() == VK_COMMAND_BUFFER_LEVEL_SECONDARY ? 1 : 0);
+  int scope = _scopesNext[frameInFlight].fetch_add(1, std::memory_order_relaxed);
+  if (scope < _scopesMax)
+    _scopes[frameInFlight][scope] = {name, depth};
+  else
+    scope = -1;
+  stack.push_back(scope);
+
+  if (scope >= 0)
+    vkCmdWriteTimestamp(buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, _queryPool[frameInFlight]->getQueryPool(),
+                        scope * 2);
+}
+
+void ProfilerGPU::end(std::shared_ptr<CommandBuffer> commandBuffer) {
+  if (_enabled == false || _active == false) return;
+  int frameInFlight = _engineState->getFrameInFlight();
+  auto buffer = commandBuffer->getCommandBuffer()[frameInFlight];
+  auto& stack = _getStack(buffer);
+  if (stack.size() == 0) return;
+  int scope = stack.back();
+  stack.pop_back();
+
+  if (scope >= 0)
+    vkCmdWriteTimestamp(buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, _queryPool[frameInFlight]->getQueryPool(),
+                        scope * 2 + 1);
+}
+
+void ProfilerGPU::beginFrame() {
+  int frameInFlight = _engineState->getFrameInFlight();
+  std::unique_lock<std::mutex> lock(_mutex);
+  // recording threads of the previous frame are already joined
+  int scopesNumber = std::min(_scopesNext[frameInFlight].load(), _scopesMax);
+  auto& scopes = _scopes[frameInFlight];
+  if (scopesNumber > 0) {
+    // every query is followed by availability value
+    std::vector<uint64_t> timestamps(scopesNumber * 2 * 2);
+    auto result = vkGetQueryPoolResults(_engineState->getDevice()->getLogicalDevice(),
+                                        _queryPool[frameInFlight]->getQueryPool(), 0, scopesNumber * 2,
+                                        sizeof(uint64_t) * timestamps.size(), timestamps.data(), sizeof(uint64_t) * 2,
+                                        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+    if (result == VK_SUCCESS || result == VK_NOT_READY) {
+      _results.clear();
+      for (int i = 0; i < scopesNumber; i++) {
+        // scope can be not ended or its command buffer can be not submitted
+        if (timestamps[i * 4 + 1] == 0 || timestamps[i * 4 + 3] == 0) continue;
+        auto [name, depth] = scopes[i];
+        float milliseconds = (timestamps[i * 4 + 2] - timestamps[i * 4]) * _timestampPeriod / 1000000.f;
+        _results.push_back({.name = name, .depth = depth, .milliseconds = milliseconds});
+      }
+    }
+    vkResetQueryPoolEXT(_engineState->getDevice()->getLogicalDevice(), _queryPool[frameInFlight]->getQueryPool(), 0,
+                        scopesNumber * 2);
+  }
+  _scopesNext[frameInFlight] = 0;
+  // opened scopes of all threads are dropped
+  _frame++;
+  if (_enabledNext == false) _results.clear();
+  _enabled = _enabledNext;
+  _active = true;
+}
+
+void ProfilerGPU::endFrame() { _active = false; }
+
+std::vector<ScopeGPU> ProfilerGPU::getResults() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  return _results;
+}
+
+void ProfilerGPU::drawOverlay(std::shared_ptr<GUI> gui) {
+  if (_overlay == false || _enabledNext == false) return;
+  auto [width, height] = _engineState->getSettings()->getResolution();
+  gui->startWindow("GPU profiler");
+  gui->setWindowPosition({width - 420, 20});
+  std::vector<std::string> text;
+  for (auto& scope : getResults()) {
+    std::stringstream line;
+    line << std::string(scope.depth * 2, ' ') << scope.name << ": " << std::fixed << std::setprecision(3)
+         << scope.milliseconds << " ms";
+    text.push_back(line.str());
+  }
+  gui->drawText(text);
+  gui->endWindow();
+}
+
+std::mutex ProfilerCPU::_mutex;
+std::vector<std::shared_ptr<ThreadCPU>> ProfilerCPU::_threads;
+thread_local std::shared_ptr<ThreadCPU> ProfilerCPU::_thread;
+std::atomic<bool> ProfilerCPU::_recording = false;
+std::atomic<int> ProfilerCPU::_generation = 0;
+int ProfilerCPU::_frames = 0;
+std::string ProfilerCPU::_path;
+std::chrono::high_resolution_clock::time_point ProfilerCPU::_origin;
+
+std::shared_ptr<ThreadCPU> ProfilerCPU::_getThread() {
+  if (_thread == nullptr) {
+    _thread = std::make_shared<ThreadCPU>();
+    std::unique_lock<std::mutex> lock(_mutex);
+    _thread->id = _threads.size();
+    _threads.push_back(_thread);
+  }
+  return _thread;
+}
+
+void ProfilerCPU::_record(EventCPU event) {
+  auto thread = _getThread();
+  // buffer is reset by its own thread when new capture is started, so writer never races with reset
+  int generation = _generation.load(std::memory_order_acquire);
+  if (thread->generation.load(std::memory_order_relaxed) != generation) {
+    if (thread->events.size() == 0) thread->events.resize(_eventsMax);
+    thread->size.store(0, std::memory_order_relaxed);
+    thread->generation.store(generation, std::memory_order_release);
+  }
+  int size = thread->size.load(std::memory_order_relaxed);
+  if (size >= _eventsMax) return;
+  thread->events[size] = event;
+  thread->size.store(size + 1, std::memory_order_release);
+}
+
+void ProfilerCPU::_save() {
+  std::ofstream file(_path);
+  file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [" << std::endl;
+  auto escape = [](const char* name) {
+    std::string escaped;
+    for (; name && *name; name++) {
+      if (*name == '"' || *name == '\\') escaped += '\\';
+      escaped += *name;
+    }
+    return escaped;
+  };
+  auto microseconds = [](std::chrono::high_resolution_clock::duration duration) {
+    return std::chrono::duration<double, std::micro>(duration).count();
+  };
+  bool first = true;
+  int generation = _generation.load();
+  for (auto& thread : _threads) {
+    if (thread->generation.load(std::memory_order_acquire) != generation) continue;
+    auto name = thread->name.load();
+    std::string threadName = name ? escape(name) : "Thread " + std::to_string(thread->id);
+    file << (first ? "" : ",\n") << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": " << thread->id
+         << ", \"args\": {\"name\": \"" << threadName << "\"}}";
+    first = false;
+    int size = thread->size.load(std::memory_order_acquire);
+    for (int i = 0; i < size; i++) {
+      auto& event = thread->events[i];
+      file << ",\n{\"ph\": \"" << event.phase << "\", \"pid\": 0, \"tid\": " << thread->id << ", \"ts\": " << std::fixed
+           << std::setprecision(3) << microseconds(event.timestamp - _origin);
+      if (event.phase != 'E') file << ", \"name\": \"" << escape(event.name) << "\"";
+      if (event.phase == 'X') file << ", \"dur\": " << microseconds(event.duration);
+      if (event.payload >= 0) file << ", \"args\": {\"payload\": " << event.payload << "}";
+      file << "}";
+    }
+  }
+  file << std::endl << "]}" << std::endl;
+}
+
+void ProfilerCPU::capture(int frames, std::string path) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  _frames = frames;
+  _path = path;
+  _origin = std::chrono::high_resolution_clock::now();
+  // buffers of previous capture are dropped
+  _generation++;
+  _recording = true;
+}
+
+bool ProfilerCPU::isRecording() { return _recording.load(std::memory_order_relaxed); }
+
+void ProfilerCPU::nextFrame() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  if (_recording == false) return;
+  if (--_frames > 0) return;
+  _recording = false;
+  // threads which are still inside scopes add events after size was read, such events are ignored
+  _save();
+}
+
+void ProfilerCPU::setThreadName(const char* name) {
+  const char* unnamed = nullptr;
+  _getThread()->name.compare_exchange_strong(unnamed, name);
+}
+
+void ProfilerCPU::begin(const char* name, int64_t payload) {
+  if (isRecording() == false) return;
+  _record({.name = name, .payload = payload, .timestamp = std::chrono::high_resolution_clock::now(), .phase = 'B'});
+}
+
+void ProfilerCPU::end() {
+  if (isRecording() == false) return;
+  _record({.name = nullptr, .payload = -1, .timestamp = std::chrono::high_resolution_clock::now(), .phase = 'E'});
+}
+
+void ProfilerCPU::complete(const char* name, std::chrono::high_resolution_clock::time_point start) {
+  if (isRecording() == false) return;
+  auto now = std::chrono::high_resolution_clock::now();
+  _record({.name = name, .payload = -1, .timestamp = start, .duration = now - start, .phase = 'X'});
+}
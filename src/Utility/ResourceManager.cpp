@@ -1,40 +1,38 @@
 #include "Utility/ResourceManager.h"
 
-ResourceManager::ResourceManager(std::shared_ptr<EngineState> engineState) { _engineState = engineState; }
+ResourceManager::ResourceManager(std::shared_ptr<BS::thread_pool> pool, std::shared_ptr<EngineState> engineState) {
+  _pool = pool;
+  _engineState = engineState;
+}
 
 void ResourceManager::initialize(std::shared_ptr<CommandBuffer> commandBufferTransfer) {
-  _loaderImage = std::make_shared<LoaderImage>(_engineState);
+  _loaderImage = std::make_shared<LoaderImage>(_pool, _engineState);
   _loaderGLTF = std::make_shared<LoaderGLTF>(_loaderImage, _engineState);
 #ifdef __ANDROID__
   _loaderGLTF->setAssetManager(_assetManager);
 #endif
-  _stubTextureOne = std::make_shared<Texture>(
-      loadImageGPU<uint8_t>({loadImageCPU<uint8_t>(_assetEnginePath + "stubs/Texture1x1.png")}),
-      _engineState->getSettings()->getLoadTextureColorFormat(), VK_SAMPLER_ADDRESS_MODE_REPEAT, 1, VK_FILTER_LINEAR,
-      commandBufferTransfer, _engineState);
-  _stubTextureZero = std::make_shared<Texture>(
-      loadImageGPU<uint8_t>({loadImageCPU<uint8_t>(_assetEnginePath + "stubs/Texture1x1Black.png")}),
-      _engineState->getSettings()->getLoadTextureColorFormat(), VK_SAMPLER_ADDRESS_MODE_REPEAT, 1, VK_FILTER_LINEAR,
-      commandBufferTransfer, _engineState);
+  // stubs are decoded once, cubemaps reuse them for every face
+  auto stubs = loadImageCPU<uint8_t>(std::vector<std::string>{_assetEnginePath + "stubs/Texture1x1.png",
+                                                              _assetEnginePath + "stubs/Texture1x1Black.png"});
+  auto stubOne = stubs[0];
+  auto stubZero = stubs[1];
+  _stubTextureOne = std::make_shared<Texture>(loadImageGPU<uint8_t>({stubOne}),
+                                              _engineState->getSettings()->getLoadTextureColorFormat(),
+                                              VK_SAMPLER_ADDRESS_MODE_REPEAT, 1, VK_FILTER_LINEAR,
+                                              commandBufferTransfer, _engineState);
+  _stubTextureZero = std::make_shared<Texture>(loadImageGPU<uint8_t>({stubZero}),
+                                               _engineState->getSettings()->getLoadTextureColorFormat(),
+                                               VK_SAMPLER_ADDRESS_MODE_REPEAT, 1, VK_FILTER_LINEAR,
+                                               commandBufferTransfer, _engineState);
 
   _stubCubemapZero = std::make_shared<Cubemap>(
-      loadImageGPU<uint8_t>({loadImageCPU<uint8_t>(_assetEnginePath + "stubs/Texture1x1Black.png"),
-                             loadImageCPU<uint8_t>(_assetEnginePath + "stubs/Texture1x1Black.png"),
-                             loadImageCPU<uint8_t>(_assetEnginePath + "stubs/Texture1x1Black.png"),
-                             loadImageCPU<uint8_t>(_assetEnginePath + "stubs/Texture1x1Black.png"),
-                             loadImageCPU<uint8_t>(_assetEnginePath + "stubs/Texture1x1Black.png"),
-                             loadImageCPU<uint8_t>(_assetEnginePath + "stubs/Texture1x1Black.png")}),
+      loadImageGPU<uint8_t>({stubZero, stubZero, stubZero, stubZero, stubZero, stubZero}),
       _engineState->getSettings()->getLoadTextureColorFormat(), 1, VK_IMAGE_ASPECT_COLOR_BIT,
       VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_FILTER_LINEAR, commandBufferTransfer,
       _engineState);
 
   _stubCubemapOne = std::make_shared<Cubemap>(
-      loadImageGPU<uint8_t>({loadImageCPU<uint8_t>(_assetEnginePath + "stubs/Texture1x1.png"),
-                             loadImageCPU<uint8_t>(_assetEnginePath + "stubs/Texture1x1.png"),
-                             loadImageCPU<uint8_t>(_assetEnginePath + "stubs/Texture1x1.png"),
-                             loadImageCPU<uint8_t>(_assetEnginePath + "stubs/Texture1x1.png"),
-                             loadImageCPU<uint8_t>(_assetEnginePath + "stubs/Texture1x1.png"),
-                             loadImageCPU<uint8_t>(_assetEnginePath + "stubs/Texture1x1.png")}),
+      loadImageGPU<uint8_t>({stubOne, stubOne, stubOne, stubOne, stubOne, stubOne}),
       _engineState->getSettings()->getLoadTextureColorFormat(), 1, VK_IMAGE_ASPECT_COLOR_BIT,
       VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_FILTER_LINEAR, commandBufferTransfer,
       _engineState);
@@ -51,6 +49,17 @@ std::shared_ptr<ModelGLTF> ResourceManager::loadModel(std::string path,
   return _loaderGLTF->load(path, commandBufferTransfer);
 }
 
+void ResourceManager::loadModelCPU(std::string path,
+                                   std::shared_ptr<BS::thread_pool> pool,
+                                   std::function<void(std::shared_ptr<SceneGLTF>)> callback) {
+  _loaderGLTF->loadCPU(path, pool, callback);
+}
+
+std::shared_ptr<ModelGLTF> ResourceManager::loadModelGPU(std::shared_ptr<SceneGLTF> scene,
+                                                         std::shared_ptr<CommandBuffer> commandBufferTransfer) {
+  return _loaderGLTF->loadGPU(scene, commandBufferTransfer);
+}
+
 std::shared_ptr<Texture> ResourceManager::getTextureZero() { return _stubTextureZero; }
 
 std::shared_ptr<Texture> ResourceManager::getTextureOne() { return _stubTextureOne; }
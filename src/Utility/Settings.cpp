@@ -24,12 +24,30 @@ void Settings::setAnisotropicSamples(int number) { _anisotropicSamples = number;
 
 void Settings::setDesiredFPS(int fps) { _desiredFPS = fps; }
 
+void Settings::setFixedTimestep(float timestep) { _fixedTimestep = timestep; }
+
+void Settings::setFrustumCulling(bool enable) { _frustumCulling = enable; }
+
+void Settings::setIndirectCulling(bool enable) { _indirectCulling = enable; }
+
+void Settings::setComputeSkinning(bool enable) { _computeSkinning = enable; }
+
+void Settings::setGeometryArenaSize(std::tuple<int, int> size) { _geometryArenaSize = size; }
+
+void Settings::setStagingSize(int size) { _stagingSize = size; }
+
+void Settings::setUniformSize(int size) { _uniformSize = size; }
+
+void Settings::setPipelineCachePath(std::string path) { _pipelineCachePath = path; }
+
 void Settings::setPoolSize(int poolSizeDescriptorSets,
                            int poolSizeUBO,
+                           int poolSizeUBODynamic,
                            int poolSizeSampler,
                            int poolSizeSSBO,
                            int poolSizeComputeImage) {
   _poolSizeUBO = poolSizeUBO;
+  _poolSizeUBODynamic = poolSizeUBODynamic;
   _poolSizeSampler = poolSizeSampler;
   _poolSizeSSBO = poolSizeSSBO;
   _poolSizeComputeImage = poolSizeComputeImage;
@@ -78,6 +96,30 @@ int Settings::getAnisotropicSamples() { return _anisotropicSamples; }
 
 int Settings::getDesiredFPS() { return _desiredFPS; }
 
+float Settings::getFixedTimestep() { return _fixedTimestep; }
+
+bool Settings::getFrustumCulling() { return _frustumCulling; }
+
+bool Settings::getIndirectCulling() { return _indirectCulling; }
+
+bool Settings::getComputeSkinning() { return _computeSkinning; }
+
+std::tuple<int, int> Settings::getGeometryArenaSize() { return _geometryArenaSize; }
+
+int Settings::getStagingSize() { return _stagingSize; }
+
+int Settings::getUniformSize() { return _uniformSize; }
+
+void Settings::setHeadless(bool headless) { _headless = headless; }
+
+bool Settings::getHeadless() { return _headless; }
+
+void Settings::setAsyncCompute(bool enable) { _asyncCompute = enable; }
+
+bool Settings::getAsyncCompute() { return _asyncCompute; }
+
+std::string Settings::getPipelineCachePath() { return _pipelineCachePath; }
+
 std::tuple<int, int> Settings::getDiffuseIBLResolution() { return _diffuseIBLResolution; }
 
 std::tuple<int, int> Settings::getSpecularIBLResolution() { return _specularIBLResolution; }
@@ -90,6 +132,8 @@ float Settings::getDepthBiasSlope() { return _depthBiasSlope; }
 
 int Settings::getPoolSizeUBO() { return _poolSizeUBO; }
 
+int Settings::getPoolSizeUBODynamic() { return _poolSizeUBODynamic; }
+
 int Settings::getPoolSizeSampler() { return _poolSizeSampler; }
 
 int Settings::getPoolSizeSSBO() { return _poolSizeSSBO; }
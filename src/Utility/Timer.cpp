@@ -32,6 +32,7 @@ Timer::Timer() {
   _frameCounterSleep = 0;
   _elapsedCurrent = 0;
   _FPSMaxPrevious = 0;
+  _fixedTimestep = 0;
   _startTime = std::chrono::high_resolution_clock::now();
   _logger = std::make_shared<Logger>();
 }
@@ -51,8 +52,11 @@ void Timer::tock() {
   // calculate current timing for models and particle systems
   std::chrono::duration<double> elapsedCurrent = (end - _startTimeCurrent);
   _elapsedCurrent = elapsedCurrent.count();
+  if (_fixedTimestep > 0) _elapsedCurrent = _fixedTimestep;
 }
 
+void Timer::setFixedTimestep(float timestep) { _fixedTimestep = timestep; }
+
 float Timer::getElapsedCurrent() { return _elapsedCurrent; }
 
 void Timer::sleep(int FPSMax) {
@@ -63,7 +67,7 @@ void Timer::sleep(int FPSMax) {
   auto elapsedSleep = std::chrono::duration_cast<std::chrono::milliseconds>(end - _startTime).count();
   uint64_t expected = (1000.f / FPSMax) * _frameCounterSleep;
   if (elapsedSleep < expected) {
-    _logger->begin("Sleep for: " + std::to_string(expected - elapsedSleep));
+    _logger->begin("Sleep for", nullptr, expected - elapsedSleep);
     std::this_thread::sleep_for(std::chrono::milliseconds(expected - elapsedSleep));
     _logger->end();
   }
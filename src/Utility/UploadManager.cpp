@@ -0,0 +1,232 @@
+#include "Utility/UploadManager.h"
+#include "Utility/Profiler.h"
+
+UploadManager::UploadManager(std::shared_ptr<EngineState> engineState) {
+  _engineState = engineState;
+  _logger = std::make_shared<Logger>(engineState);
+  auto device = engineState->getDevice();
+  _commandPoolTransfer = std::make_shared<CommandPool>(vkb::QueueType::transfer, device);
+  _commandPoolGraphic = std::make_shared<CommandPool>(vkb::QueueType::graphics, device);
+  _familyTransfer = device->getQueueIndex(vkb::QueueType::transfer);
+  _familyGraphic = device->getQueueIndex(vkb::QueueType::graphics);
+  _timeline = std::make_shared<SemaphoreTimeline>(device);
+  _worker = std::thread(&UploadManager::_work, this);
+}
+
+void UploadManager::_request(std::function<void(Batch&)> request) {
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _requests.push_back(request);
+  }
+  _condition.notify_one();
+}
+
+void UploadManager::_work() {
+  ProfilerCPU::setThreadName("Upload");
+  auto device = _engineState->getDevice()->getLogicalDevice();
+  while (true) {
+    std::vector<std::function<void(Batch&)>> requests;
+    std::deque<std::shared_ptr<Batch>> finished;
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _condition.wait(lock, [this]() { return _stop || _requests.size() > 0 || _finished.size() > 0; });
+      if (_stop) return;
+      std::swap(requests, _requests);
+      std::swap(finished, _finished);
+    }
+    for (auto& batch : finished) {
+      vkFreeCommandBuffers(device, _commandPoolTransfer->getCommandPool(), 1, &batch->transfer);
+      vkFreeCommandBuffers(device, _commandPoolGraphic->getCommandPool(), 1, &batch->graphic);
+    }
+    // all requests received so far are recorded to one batch
+    if (requests.size() > 0) _record(requests);
+  }
+}
+
+void UploadManager::_record(std::vector<std::function<void(Batch&)>> requests) {
+  _logger->begin("Record uploads", nullptr, requests.size());
+  auto device = _engineState->getDevice()->getLogicalDevice();
+  auto batch = std::make_shared<Batch>();
+  VkCommandBufferAllocateInfo allocInfo{.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+                                        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+                                        .commandBufferCount = 1};
+  allocInfo.commandPool = _commandPoolTransfer->getCommandPool();
+  if (vkAllocateCommandBuffers(device, &allocInfo, &batch->transfer) != VK_SUCCESS)
+    throw std::runtime_error("failed to allocate command buffers!");
+  allocInfo.commandPool = _commandPoolGraphic->getCommandPool();
+  if (vkAllocateCommandBuffers(device, &allocInfo, &batch->graphic) != VK_SUCCESS)
+    throw std::runtime_error("failed to allocate command buffers!");
+
+  VkCommandBufferBeginInfo beginInfo{.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+                                     .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT};
+  vkBeginCommandBuffer(batch->transfer, &beginInfo);
+  vkBeginCommandBuffer(batch->graphic, &beginInfo);
+  for (auto& request : requests) request(*batch);
+  vkEndCommandBuffer(batch->transfer);
+  vkEndCommandBuffer(batch->graphic);
+  _logger->end();
+
+  std::unique_lock<std::mutex> lock(_mutex);
+  _recorded.push_back(batch);
+}
+
+void UploadManager::uploadBuffer(void* data,
+                                 VkDeviceSize size,
+                                 VkBufferUsageFlags usage,
+                                 std::function<void(std::shared_ptr<Buffer>)> callback) {
+  // batch is finished on transfer timeline, not with frame, so staging is held until then
+  auto staging = _engineState->getStagingRing()->upload(data, size, true);
+  _request([this, staging, size, usage, callback](Batch& batch) {
+    auto buffer = std::make_shared<Buffer>(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | usage,
+                                           VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, _engineState);
+    // buffers are shared by all queue families, memory dependency is provided by semaphores
+    VkBufferCopy region{.srcOffset = staging.offset, .dstOffset = 0, .size = size};
+    vkCmdCopyBuffer(batch.transfer, staging.buffer->getData(), buffer->getData(), 1, &region);
+    batch.staging.push_back(staging);
+    batch.ready.push_back([callback, buffer]() { callback(buffer); });
+  });
+}
+
+std::future<std::shared_ptr<Buffer>> UploadManager::uploadBuffer(void* data,
+                                                                 VkDeviceSize size,
+                                                                 VkBufferUsageFlags usage) {
+  auto promise = std::make_shared<std::promise<std::shared_ptr<Buffer>>>();
+  uploadBuffer(data, size, usage, [promise](std::shared_ptr<Buffer> buffer) { promise->set_value(buffer); });
+  return promise->get_future();
+}
+
+void UploadManager::uploadTexture(std::shared_ptr<BufferImage> data,
+                                  VkFormat format,
+                                  VkSamplerAddressMode mode,
+                                  int mipMapLevels,
+                                  VkFilter filter,
+                                  std::function<void(std::shared_ptr<Texture>)> callback) {
+  _request([this, data, format, mode, mipMapLevels, filter, callback](Batch& batch) {
+    auto staging = _engineState->getStagingRing()->upload(data->getData(), data->getSize(), true);
+    auto image = std::make_shared<Image>(
+        data->getResolution(), 1, mipMapLevels, format, VK_IMAGE_TILING_OPTIMAL,
+        VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, _engineState);
+
+    VkImageMemoryBarrier barrier{.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                                 .srcAccessMask = 0,
+                                 .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                                 .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                                 .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                 .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                                 .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                                 .image = image->getImage(),
+                                 .subresourceRange = {.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                                                      .baseMipLevel = 0,
+                                                      .levelCount = static_cast<uint32_t>(mipMapLevels),
+                                                      .baseArrayLayer = 0,
+                                                      .layerCount = 1}};
+    vkCmdPipelineBarrier(batch.transfer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0,
+                         nullptr, 0, nullptr, 1, &barrier);
+    auto [width, height] = data->getResolution();
+    VkBufferImageCopy region{.bufferOffset = staging.offset,
+                             .imageSubresource = {.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                                                  .mipLevel = 0,
+                                                  .baseArrayLayer = 0,
+                                                  .layerCount = 1},
+                             .imageOffset = {0, 0, 0},
+                             .imageExtent = {static_cast<uint32_t>(width), static_cast<uint32_t>(height), 1}};
+    vkCmdCopyBufferToImage(batch.transfer, staging.buffer->getData(), image->getImage(),
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+    // image is exclusive, the same barrier releases it on transfer queue and acquires on graphic one
+    if (_familyTransfer != _familyGraphic) {
+      barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+      barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+      barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+      barrier.srcQueueFamilyIndex = _familyTransfer;
+      barrier.dstQueueFamilyIndex = _familyGraphic;
+      vkCmdPipelineBarrier(batch.transfer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0,
+                           nullptr, 0, nullptr, 1, &barrier);
+      vkCmdPipelineBarrier(batch.graphic, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0,
+                           nullptr, 0, nullptr, 1, &barrier);
+    }
+    // blit isn't supported by transfer queue, also transitions image to shader read only layout
+    image->generateMipmaps(mipMapLevels, 1, batch.graphic);
+
+    auto imageView = std::make_shared<ImageView>(image, VK_IMAGE_VIEW_TYPE_2D, 0, 1, 0, mipMapLevels,
+                                                 VK_IMAGE_ASPECT_COLOR_BIT, _engineState);
+    auto texture = std::make_shared<Texture>(mode, mipMapLevels, filter, imageView, _engineState);
+    batch.staging.push_back(staging);
+    batch.ready.push_back([callback, texture]() { callback(texture); });
+  });
+}
+
+std::future<std::shared_ptr<Texture>> UploadManager::uploadTexture(std::shared_ptr<BufferImage> data,
+                                                                   VkFormat format,
+                                                                   VkSamplerAddressMode mode,
+                                                                   int mipMapLevels,
+                                                                   VkFilter filter) {
+  auto promise = std::make_shared<std::promise<std::shared_ptr<Texture>>>();
+  uploadTexture(data, format, mode, mipMapLevels, filter,
+                [promise](std::shared_ptr<Texture> texture) { promise->set_value(texture); });
+  return promise->get_future();
+}
+
+void UploadManager::update(std::shared_ptr<FrameGraph> frameGraph) {
+  auto device = _engineState->getDevice();
+  uint64_t frame = _engineState->getFrame();
+  bool free = false;
+  std::vector<std::function<void()>> ready;
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    for (auto& batch : _recorded) {
+      batch->value = ++_value;
+      VkTimelineSemaphoreSubmitInfoKHR timelineInfo{.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR,
+                                                    .signalSemaphoreValueCount = 1,
+                                                    .pSignalSemaphoreValues = &batch->value};
+      VkSubmitInfo submitInfo{.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+                              .pNext = &timelineInfo,
+                              .commandBufferCount = 1,
+                              .pCommandBuffers = &batch->transfer,
+                              .signalSemaphoreCount = 1,
+                              .pSignalSemaphores = &_timeline->getSemaphore()};
+      if (vkQueueSubmit(device->getQueue(vkb::QueueType::transfer), 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+        throw std::runtime_error("failed to submit upload!");
+      _transferred.push_back(batch);
+    }
+    _recorded.clear();
+
+    // graphic part is submitted only after transfer is finished, so graphic queue never waits for transfer one
+    uint64_t value = 0;
+    vkGetSemaphoreCounterValueKHR(device->getLogicalDevice(), _timeline->getSemaphore(), &value);
+    while (_transferred.size() > 0 && _transferred.front()->value <= value) {
+      auto batch = _transferred.front();
+      _transferred.pop_front();
+      // wait provides memory dependency between queues, it's already satisfied
+      frameGraph->submitExternal(vkb::QueueType::graphics, batch->graphic, _timeline->getSemaphore(), batch->value);
+      ready.insert(ready.end(), batch->ready.begin(), batch->ready.end());
+      batch->ready.clear();
+      for (auto& staging : batch->staging) _engineState->getStagingRing()->release(staging);
+      batch->staging.clear();
+      batch->frame = frame;
+      _submitted.push_back(batch);
+    }
+
+    // fence of frame in flight is waited, so command buffers submitted maxFramesInFlight frames ago are executed
+    int framesInFlight = _engineState->getSettings()->getMaxFramesInFlight();
+    while (_submitted.size() > 0 && _submitted.front()->frame + framesInFlight <= frame) {
+      _finished.push_back(_submitted.front());
+      _submitted.pop_front();
+      free = true;
+    }
+  }
+  if (free) _condition.notify_one();
+  // callbacks are called without lock, so they can request new uploads
+  for (auto& callback : ready) callback();
+}
+
+UploadManager::~UploadManager() {
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _stop = true;
+  }
+  _condition.notify_one();
+  _worker.join();
+  // command buffers are freed together with their pools
+}
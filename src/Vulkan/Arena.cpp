@@ -0,0 +1,122 @@
+#include "Vulkan/Arena.h"
+
+BufferArena::BufferArena(VkDeviceSize elementSize,
+                         VkDeviceSize blockSize,
+                         VkBufferUsageFlags usage,
+                         std::shared_ptr<EngineState> engineState) {
+  _elementSize = elementSize;
+  _blockSize = blockSize;
+  _usage = usage;
+  _engineState = engineState;
+}
+
+void BufferArena::_addBlock(VkDeviceSize size) {
+  _blocks.push_back(std::make_shared<Buffer>(_elementSize * size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | _usage,
+                                             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, _engineState));
+  _free.push_back({{0, size}});
+}
+
+ArenaRange BufferArena::allocate(VkDeviceSize size) {
+  if (size == 0) throw std::runtime_error("can't allocate empty range");
+  std::unique_lock<std::mutex> lock(_mutex);
+  auto find = [&]() -> std::optional<ArenaRange> {
+    for (int block = 0; block < _free.size(); block++) {
+      for (auto [offset, freeSize] : _free[block]) {
+        if (freeSize < size) continue;
+        ArenaRange range{.block = block, .offset = offset, .size = size};
+        _free[block].erase(offset);
+        if (freeSize > size) _free[block][range.offset + size] = freeSize - size;
+        return range;
+      }
+    }
+    return std::nullopt;
+  };
+
+  auto range = find();
+  if (range.has_value() == false) {
+    _addBlock(std::max(size, _blockSize));
+    range = find();
+  }
+  _used += size;
+  return range.value();
+}
+
+void BufferArena::free(ArenaRange range) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  _released.push_back({_engineState->getFrame(), range});
+}
+
+void BufferArena::release(uint64_t frame) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (_released.empty() == false && std::get<0>(_released.front()) <= frame) {
+    _release(std::get<1>(_released.front()));
+    _released.pop_front();
+  }
+}
+
+void BufferArena::_release(ArenaRange range) {
+  auto& free = _free[range.block];
+  auto [current, inserted] = free.insert({range.offset, range.size});
+  if (inserted == false) throw std::runtime_error("range is already freed");
+  _used -= range.size;
+  // merge with next free range
+  auto next = std::next(current);
+  if (next != free.end() && current->first + current->second == next->first) {
+    current->second += next->second;
+    free.erase(next);
+  }
+  // merge with previous free range
+  if (current != free.begin()) {
+    auto previous = std::prev(current);
+    if (previous->first + previous->second == current->first) {
+      previous->second += current->second;
+      free.erase(current);
+    }
+  }
+}
+
+void BufferArena::setData(ArenaRange range, void* data, std::shared_ptr<CommandBuffer> commandBufferTransfer) {
+  auto staging = _engineState->getStagingRing()->upload(data, _elementSize * range.size);
+  auto buffer = getBuffer(range.block);
+  // range can be overwritten in place (f.e. setColor), so copy has to wait for draws and skinning that read it
+  VkMemoryBarrier readBarrier{
+      .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+      .srcAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_SHADER_READ_BIT,
+      .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT};
+  vkCmdPipelineBarrier(commandBufferTransfer->getCommandBuffer()[_engineState->getFrameInFlight()],
+                       VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &readBarrier, 0, nullptr, 0, nullptr);
+  buffer->copyFrom(staging.buffer, staging.offset, _elementSize * range.offset, _elementSize * range.size,
+                   commandBufferTransfer);
+  // need to insert memory barrier so read in vertex shader and skinning compute shader waits for copy
+  VkMemoryBarrier memoryBarrier{
+      .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+      .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+      .dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_SHADER_READ_BIT};
+  vkCmdPipelineBarrier(commandBufferTransfer->getCommandBuffer()[_engineState->getFrameInFlight()],
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier,
+                       0, nullptr, 0, nullptr);
+}
+
+std::shared_ptr<Buffer> BufferArena::getBuffer(int block) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  return _blocks[block];
+}
+
+int BufferArena::getBlockNumber() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  return _blocks.size();
+}
+
+VkDeviceSize BufferArena::getUsed() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  return _used;
+}
+
+VkDeviceSize BufferArena::getCapacity() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  VkDeviceSize capacity = 0;
+  for (auto& block : _blocks) capacity += block->getSize() / _elementSize;
+  return capacity;
+}
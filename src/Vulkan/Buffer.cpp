@@ -1,4 +1,5 @@
 #include "Vulkan/Buffer.h"
+#include <limits>
 
 Buffer::Buffer(VkDeviceSize size,
                VkBufferUsageFlags usage,
@@ -11,9 +12,28 @@ Buffer::Buffer(VkDeviceSize size,
                                 .size = size,
                                 .usage = usage,
                                 .sharingMode = VK_SHARING_MODE_EXCLUSIVE};
-  VmaAllocationCreateInfo allocCreateInfo = {
-      .flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
-      .usage = VMA_MEMORY_USAGE_AUTO};
+  // buffers are accessed by graphic, async compute and upload queues (f.e. particles are simulated on compute and
+  // drawn on graphic), concurrent sharing avoids ownership transfers and costs nothing for buffers on most hardware
+  auto device = engineState->getDevice();
+  std::set<uint32_t> families = {static_cast<uint32_t>(device->getQueueIndex(vkb::QueueType::graphics)),
+                                 static_cast<uint32_t>(device->getQueueIndex(vkb::QueueType::transfer))};
+  if (engineState->getSettings()->getAsyncCompute())
+    families.insert(static_cast<uint32_t>(device->getQueueIndex(vkb::QueueType::compute)));
+  std::vector<uint32_t> queueFamilies(families.begin(), families.end());
+  if (queueFamilies.size() > 1) {
+    bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+    bufferInfo.queueFamilyIndexCount = queueFamilies.size();
+    bufferInfo.pQueueFamilyIndices = queueFamilies.data();
+  }
+  // buffers read back by CPU should be in cached memory
+  VmaAllocationCreateFlags hostAccess = (properties & VK_MEMORY_PROPERTY_HOST_CACHED_BIT)
+                                            ? VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT
+                                            : VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+  VmaAllocationCreateInfo allocCreateInfo = {.flags = hostAccess | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+                                             .usage = VMA_MEMORY_USAGE_AUTO};
+  // buffers without host access are filled by transfer commands only, so they aren't mapped and are kept in VRAM
+  if ((properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) == 0)
+    allocCreateInfo = {.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, .requiredFlags = properties};
 
   vmaCreateBuffer(engineState->getMemoryAllocator()->getAllocator(), &bufferInfo, &allocCreateInfo, &_data, &_memory,
                   &_memoryInfo);
@@ -22,10 +42,9 @@ Buffer::Buffer(VkDeviceSize size,
 void Buffer::copyFrom(std::shared_ptr<Buffer> buffer,
                       VkDeviceSize srcOffset,
                       VkDeviceSize dstOffset,
+                      VkDeviceSize size,
                       std::shared_ptr<CommandBuffer> commandBufferTransfer) {
-  _stagingBuffer = buffer;
-
-  VkBufferCopy copyRegion{.srcOffset = srcOffset, .dstOffset = dstOffset, .size = buffer->getSize() - srcOffset};
+  VkBufferCopy copyRegion{.srcOffset = srcOffset, .dstOffset = dstOffset, .size = size};
   vkCmdCopyBuffer(commandBufferTransfer->getCommandBuffer()[_engineState->getFrameInFlight()], buffer->getData(), _data,
                   1, &copyRegion);
 }
@@ -38,22 +57,166 @@ VkResult Buffer::flush() {
   return vmaFlushAllocation(_engineState->getMemoryAllocator()->getAllocator(), _memory, 0, VK_WHOLE_SIZE);
 }
 
+VkResult Buffer::invalidate() {
+  return vmaInvalidateAllocation(_engineState->getMemoryAllocator()->getAllocator(), _memory, 0, VK_WHOLE_SIZE);
+}
+
+void* Buffer::getMappedMemory() { return _memoryInfo.pMappedData; }
+
 Buffer::~Buffer() { vmaDestroyBuffer(_engineState->getMemoryAllocator()->getAllocator(), _data, _memory); }
 
-BufferImage::BufferImage(std::tuple<int, int> resolution,
-                         int channels,
-                         int number,
-                         VkBufferUsageFlags usage,
-                         VkMemoryPropertyFlags properties,
-                         std::shared_ptr<EngineState> engineState)
-    : Buffer(std::get<0>(resolution) * std::get<1>(resolution) * channels * number, usage, properties, engineState) {
+StagingRing::StagingRing(VkDeviceSize size, std::shared_ptr<EngineState> engineState) {
+  _engineState = engineState;
+  _buffer = std::make_shared<Buffer>(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                     engineState);
+}
+
+std::optional<VkDeviceSize> StagingRing::_find(VkDeviceSize size) {
+  if (_regions.empty()) {
+    _head = 0;
+    _tail = 0;
+  }
+  // offsets of buffer to image copies have to be multiple of texel size and 4
+  VkDeviceSize offset = (_head + 15) & ~VkDeviceSize(15);
+  // used part is [tail, head), free space is after head and before tail
+  if (_regions.empty() || _head > _tail) {
+    if (offset + size <= _buffer->getSize()) return offset;
+    // wrap around, the end of buffer stays unused until tail passes it
+    if (size <= _tail) return 0;
+    return std::nullopt;
+  }
+  // wrapped, used part is [tail, end) and [0, head)
+  if (offset + size <= _tail) return offset;
+  return std::nullopt;
+}
+
+StagingAllocation StagingRing::allocate(VkDeviceSize size, bool held) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  // held allocations can be made from any thread, so frame isn't read for them
+  uint64_t frame = held ? std::numeric_limits<uint64_t>::max() : _engineState->getFrame();
+  _used += size;
+  _peak = std::max(_peak, _used);
+  auto offset = _find(size);
+  if (offset.has_value()) {
+    _regions.push_back({.frame = frame, .offset = offset.value(), .size = size});
+    _head = offset.value() + size;
+    return {.buffer = _buffer, .offset = offset.value()};
+  }
+
+  auto buffer = std::make_shared<Buffer>(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                         _engineState);
+  _dedicated.push_back({frame, buffer});
+  return {.buffer = buffer, .offset = 0};
+}
+
+StagingAllocation StagingRing::upload(void* data, VkDeviceSize size, bool held) {
+  auto allocation = allocate(size, held);
+  allocation.buffer->setData(data, size, allocation.offset);
+  return allocation;
+}
+
+void StagingRing::release(uint64_t frame) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  // allocations are made in frame order, so the oldest ones are at front
+  while (_regions.empty() == false && _regions.front().frame <= frame) {
+    _used -= _regions.front().size;
+    _regions.pop_front();
+    if (_regions.empty() == false) _tail = _regions.front().offset;
+  }
+  // dedicated buffers don't have to be freed in order, so held ones don't delay the rest
+  std::erase_if(_dedicated, [&](auto& dedicated) {
+    if (std::get<0>(dedicated) > frame) return false;
+    _used -= std::get<1>(dedicated)->getSize();
+    return true;
+  });
+}
+
+void StagingRing::release(StagingAllocation allocation) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  if (allocation.buffer == _buffer) {
+    // region stays in ring order, so regions after it are still freed only after this one
+    for (auto& region : _regions) {
+      if (region.offset == allocation.offset && region.frame == std::numeric_limits<uint64_t>::max()) {
+        region.frame = 0;
+        return;
+      }
+    }
+  }
+  for (auto& [frame, buffer] : _dedicated) {
+    if (buffer == allocation.buffer) {
+      frame = 0;
+      return;
+    }
+  }
+}
+
+VkDeviceSize StagingRing::getUsed() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  return _used;
+}
+
+VkDeviceSize StagingRing::getPeak() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  return _peak;
+}
+
+VkDeviceSize StagingRing::getCapacity() { return _buffer->getSize(); }
+
+UniformRing::UniformRing(VkDeviceSize size, std::shared_ptr<EngineState> engineState) {
+  _engineState = engineState;
+  _alignment = engineState->getDevice()->getDeviceLimits().minUniformBufferOffsetAlignment;
+  int framesInFlight = engineState->getSettings()->getMaxFramesInFlight();
+  _head.resize(framesInFlight, 0);
+  for (int i = 0; i < framesInFlight; i++) {
+    _buffer.push_back(std::make_shared<Buffer>(
+        size, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, engineState));
+  }
+}
+
+uint32_t UniformRing::push(void* data, VkDeviceSize size) {
+  int currentFrame = _engineState->getFrameInFlight();
+  VkDeviceSize offset;
+  {
+    // draw and drawShadow are called from different threads
+    std::unique_lock<std::mutex> lock(_mutex);
+    offset = _head[currentFrame];
+    if (offset + size > _buffer[currentFrame]->getSize())
+      throw std::runtime_error("uniform ring is full, increase Settings::setUniformSize");
+    _head[currentFrame] = (offset + size + _alignment - 1) / _alignment * _alignment;
+    _peak = std::max(_peak, _head[currentFrame]);
+  }
+  _buffer[currentFrame]->setData(data, size, offset);
+  return offset;
+}
+
+void UniformRing::reset(int frame) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  _head[frame] = 0;
+}
+
+std::shared_ptr<Buffer> UniformRing::getBuffer(int frame) { return _buffer[frame]; }
+
+VkDeviceSize UniformRing::getPeak() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  return _peak;
+}
+
+BufferImage::BufferImage(std::tuple<int, int> resolution, int channels, int number) {
+  _data.resize(std::get<0>(resolution) * std::get<1>(resolution) * channels * number);
   _resolution = resolution;
   _channels = channels;
   _number = number;
 }
 
+uint8_t* BufferImage::getData() { return _data.data(); }
+
+VkDeviceSize BufferImage::getSize() { return _data.size(); }
+
 std::tuple<int, int> BufferImage::getResolution() { return _resolution; }
 
 int BufferImage::getChannels() { return _channels; }
 
-int BufferImage::getNumber() { return _number; }
\ No newline at end of file
+int BufferImage::getNumber() { return _number; }
@@ -1,14 +1,21 @@
 #include "Vulkan/Command.h"
 
-CommandBuffer::CommandBuffer(int number, std::shared_ptr<CommandPool> pool, std::shared_ptr<EngineState> engineState) {
+CommandBuffer::CommandBuffer(int number, std::shared_ptr<CommandPool> pool, std::shared_ptr<EngineState> engineState)
+    : CommandBuffer(number, VK_COMMAND_BUFFER_LEVEL_PRIMARY, pool, engineState) {}
+
+CommandBuffer::CommandBuffer(int number,
+                             VkCommandBufferLevel level,
+                             std::shared_ptr<CommandPool> pool,
+                             std::shared_ptr<EngineState> engineState) {
   _pool = pool;
+  _level = level;
   _engineState = engineState;
 
   _buffer.resize(number);
 
   VkCommandBufferAllocateInfo allocInfo{.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
                                         .commandPool = pool->getCommandPool(),
-                                        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+                                        .level = level,
                                         .commandBufferCount = static_cast<uint32_t>(number)};
 
   if (vkAllocateCommandBuffers(_engineState->getDevice()->getLogicalDevice(), &allocInfo, _buffer.data()) !=
@@ -27,12 +34,30 @@ void CommandBuffer::beginCommands() {
   _active = true;
 }
 
+void CommandBuffer::beginCommands(VkRenderPass renderPass, VkFramebuffer framebuffer) {
+  int frameInFlight = _engineState->getFrameInFlight();
+
+  VkCommandBufferInheritanceInfo inheritanceInfo{.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+                                                 .renderPass = renderPass,
+                                                 .subpass = 0,
+                                                 .framebuffer = framebuffer};
+  VkCommandBufferBeginInfo beginInfo{
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+      .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+      .pInheritanceInfo = &inheritanceInfo};
+
+  vkBeginCommandBuffer(_buffer[frameInFlight], &beginInfo);
+  _active = true;
+}
+
 void CommandBuffer::endCommands() {
   int frameInFlight = _engineState->getFrameInFlight();
   vkEndCommandBuffer(_buffer[frameInFlight]);
   _active = false;
 }
 
+VkCommandBufferLevel CommandBuffer::getLevel() { return _level; }
+
 bool CommandBuffer::getActive() { return _active; }
 
 std::vector<VkCommandBuffer>& CommandBuffer::getCommandBuffer() { return _buffer; }
@@ -1,4 +1,5 @@
 #include "Vulkan/Device.h"
+#include <fstream>
 
 Device::Device(std::shared_ptr<Surface> surface, std::shared_ptr<Instance> instance) {
   VkPhysicalDeviceFeatures deviceFeatures{
@@ -10,15 +11,68 @@ Device::Device(std::shared_ptr<Surface> surface, std::shared_ptr<Instance> insta
 
   vkb::PhysicalDeviceSelector deviceSelector(instance->getInstance());
   deviceSelector.set_required_features(deviceFeatures);
-
-  // VK_KHR_SWAPCHAIN_EXTENSION_NAME is added by default
-  auto deviceSelectorResult = deviceSelector.set_surface(surface->getSurface()).select();
+  // passes of frame graph are synchronized between queues with timeline semaphores
+  deviceSelector.add_required_extension(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+  deviceSelector.add_required_extension_features(VkPhysicalDeviceTimelineSemaphoreFeaturesKHR{
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR, .timelineSemaphore = VK_TRUE});
+
+  // VK_KHR_SWAPCHAIN_EXTENSION_NAME is added by default if instance isn't headless
+  if (surface) deviceSelector.set_surface(surface->getSurface());
+  auto deviceSelectorResult = deviceSelector.select();
   if (!deviceSelectorResult) {
     throw std::runtime_error(deviceSelectorResult.error().message());
   }
   auto devicePhysical = deviceSelectorResult.value();
+  // used to find out if pipeline was taken from pipeline cache
+  _pipelineFeedback = devicePhysical.enable_extension_if_present(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
+  // timestamp queries of GPU profiler are reset from CPU, so they can be written inside render passes
+  VkPhysicalDeviceHostQueryResetFeaturesEXT hostQueryResetFeatures{
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_QUERY_RESET_FEATURES_EXT};
+  if (devicePhysical.enable_extension_if_present(VK_EXT_HOST_QUERY_RESET_EXTENSION_NAME)) {
+    VkPhysicalDeviceFeatures2 features{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+                                       .pNext = &hostQueryResetFeatures};
+    vkGetPhysicalDeviceFeatures2(devicePhysical.physical_device, &features);
+    _hostQueryReset = hostQueryResetFeatures.hostQueryReset;
+  }
+  // whole frame is submitted with one vkQueueSubmit2 per queue if it's supported
+  VkPhysicalDeviceSynchronization2FeaturesKHR synchronization2Features{
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR};
+  if (devicePhysical.enable_extension_if_present(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME)) {
+    VkPhysicalDeviceFeatures2 features{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+                                       .pNext = &synchronization2Features};
+    vkGetPhysicalDeviceFeatures2(devicePhysical.physical_device, &features);
+    _synchronization2 = synchronization2Features.synchronization2;
+  }
+  // features of GPU culling are optional, indirect culling is switched off if any of them is missing: draws of model
+  // with the same state are merged to one indirect draw, culling writes offset of object's visible instances to
+  // firstInstance and vertex shaders of models take node of merged indirect draw by gl_DrawIDARB
+  VkPhysicalDeviceShaderDrawParametersFeatures shaderDrawParametersFeatures{
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_DRAW_PARAMETERS_FEATURES};
+  {
+    VkPhysicalDeviceFeatures2 features{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+                                       .pNext = &shaderDrawParametersFeatures};
+    vkGetPhysicalDeviceFeatures2(devicePhysical.physical_device, &features);
+    _multiDrawIndirect = features.features.multiDrawIndirect && features.features.drawIndirectFirstInstance &&
+                         shaderDrawParametersFeatures.shaderDrawParameters;
+  }
+  if (_multiDrawIndirect) {
+    devicePhysical.features.multiDrawIndirect = VK_TRUE;
+    devicePhysical.features.drawIndirectFirstInstance = VK_TRUE;
+  }
 
   vkb::DeviceBuilder builder{devicePhysical};
+  if (_multiDrawIndirect) {
+    shaderDrawParametersFeatures.pNext = nullptr;
+    builder.add_pNext(&shaderDrawParametersFeatures);
+  }
+  if (_hostQueryReset) {
+    hostQueryResetFeatures.pNext = nullptr;
+    builder.add_pNext(&hostQueryResetFeatures);
+  }
+  if (_synchronization2) {
+    synchronization2Features.pNext = nullptr;
+    builder.add_pNext(&synchronization2Features);
+  }
   auto builderResult = builder.build();
   if (!builderResult) {
     throw std::runtime_error(builderResult.error().message());
@@ -33,6 +87,72 @@ Device::Device(std::shared_ptr<Surface> surface, std::shared_ptr<Instance> insta
 
 VkPhysicalDeviceLimits& Device::getDeviceLimits() { return _deviceLimits; }
 
+void Device::createPipelineCache(std::string path) {
+  _pipelineCachePath = path;
+  std::vector<char> data;
+  if (path.empty() == false) {
+    std::ifstream file(path, std::ios::ate | std::ios::binary);
+    if (file.is_open()) {
+      data.resize(file.tellg());
+      file.seekg(0);
+      file.read(data.data(), data.size());
+    }
+  }
+
+  // cache from another driver or GPU is ignored, start with empty one instead
+  VkPhysicalDeviceProperties props;
+  vkGetPhysicalDeviceProperties(getPhysicalDevice(), &props);
+  VkPipelineCacheHeaderVersionOne header;
+  if (data.size() < sizeof(header)) {
+    data.clear();
+  } else {
+    memcpy(&header, data.data(), sizeof(header));
+    if (header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE || header.vendorID != props.vendorID ||
+        header.deviceID != props.deviceID ||
+        memcmp(header.pipelineCacheUUID, props.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+      data.clear();
+  }
+
+  VkPipelineCacheCreateInfo cacheInfo{.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+                                      .initialDataSize = data.size(),
+                                      .pInitialData = data.size() > 0 ? data.data() : nullptr};
+  if (vkCreatePipelineCache(getLogicalDevice(), &cacheInfo, nullptr, &_pipelineCache) != VK_SUCCESS)
+    throw std::runtime_error("failed to create pipeline cache!");
+}
+
+void Device::savePipelineCache() {
+  if (_pipelineCache == VK_NULL_HANDLE || _pipelineCachePath.empty()) return;
+  size_t size;
+  vkGetPipelineCacheData(getLogicalDevice(), _pipelineCache, &size, nullptr);
+  std::vector<char> data(size);
+  if (vkGetPipelineCacheData(getLogicalDevice(), _pipelineCache, &size, data.data()) != VK_SUCCESS) return;
+  // cache is optimization only, so failure to write it isn't an error (f.e. read only location)
+  std::ofstream file(_pipelineCachePath, std::ios::binary | std::ios::trunc);
+  if (file.is_open()) file.write(data.data(), size);
+}
+
+VkPipelineCache Device::getPipelineCache() { return _pipelineCache; }
+
+bool Device::isPipelineFeedbackSupported() { return _pipelineFeedback; }
+
+bool Device::isHostQueryResetSupported() { return _hostQueryReset; }
+
+bool Device::isSynchronization2Supported() { return _synchronization2; }
+
+bool Device::isMultiDrawIndirectSupported() { return _multiDrawIndirect; }
+
+void Device::addPipelineFeedback(VkPipelineCreationFeedbackEXT feedback) {
+  if ((feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT) == 0) return;
+  if (feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT)
+    _pipelineCacheHit++;
+  else
+    _pipelineCacheMiss++;
+}
+
+int Device::getPipelineCacheHit() { return _pipelineCacheHit; }
+
+int Device::getPipelineCacheMiss() { return _pipelineCacheMiss; }
+
 bool Device::isFormatFeatureSupported(VkFormat format, VkImageTiling tiling, VkFormatFeatureFlagBits featureFlagBit) {
   VkFormatProperties props;
   vkGetPhysicalDeviceFormatProperties(getPhysicalDevice(), format, &props);
@@ -60,6 +180,10 @@ VkQueue Device::getQueue(vkb::QueueType type) {
     if (!queueResult) {
       queueResult = _device.get_queue(vkb::QueueType::present);
     }
+    // there is no present queue in headless mode
+    if (!queueResult) {
+      queueResult = _device.get_queue(vkb::QueueType::graphics);
+    }
   }
 
   return queueResult.value();
@@ -73,9 +197,19 @@ int Device::getQueueIndex(vkb::QueueType type) {
     if (!queueResult) {
       queueResult = _device.get_queue_index(vkb::QueueType::present);
     }
+    // there is no present queue in headless mode
+    if (!queueResult) {
+      queueResult = _device.get_queue_index(vkb::QueueType::graphics);
+    }
   }
 
   return queueResult.value();
 }
 
-Device::~Device() { vkb::destroy_device(_device); }
\ No newline at end of file
+Device::~Device() {
+  if (_pipelineCache != VK_NULL_HANDLE) {
+    savePipelineCache();
+    vkDestroyPipelineCache(getLogicalDevice(), _pipelineCache, nullptr);
+  }
+  vkb::destroy_device(_device);
+}
\ No newline at end of file
@@ -0,0 +1,335 @@
+#include "Vulkan/FrameGraph.h"
+
+FrameGraph::FrameGraph(std::shared_ptr<EngineState> engineState) { _engineState = engineState; }
+
+bool FrameGraph::_isWrite(VkAccessFlags access) {
+  return access & (VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                   VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT |
+                   VK_ACCESS_HOST_WRITE_BIT | VK_ACCESS_MEMORY_WRITE_BIT);
+}
+
+std::shared_ptr<SemaphoreTimeline> FrameGraph::_getTimeline(VkQueue queue) {
+  if (_timeline.find(queue) == _timeline.end())
+    _timeline[queue] = std::make_shared<SemaphoreTimeline>(_engineState->getDevice());
+  return _timeline[queue];
+}
+
+void FrameGraph::reset() { _passes.clear(); }
+
+int FrameGraph::addPass(std::string name,
+                        vkb::QueueType queue,
+                        std::vector<std::shared_ptr<CommandBuffer>> commandBuffers) {
+  auto device = _engineState->getDevice();
+  _passes.push_back({.name = name,
+                     .queue = device->getQueue(queue),
+                     .family = static_cast<uint32_t>(device->getQueueIndex(queue)),
+                     .commandBuffers = commandBuffers});
+  return _passes.size() - 1;
+}
+
+void FrameGraph::addImage(int pass,
+                          VkImage image,
+                          VkImageSubresourceRange range,
+                          VkImageLayout layout,
+                          VkPipelineStageFlags stage,
+                          VkAccessFlags access) {
+  _passes[pass].accesses.push_back(
+      {.handle = (uint64_t)image, .image = true, .range = range, .layout = layout, .stage = stage, .access = access});
+}
+
+void FrameGraph::addBuffer(int pass, VkBuffer buffer, VkPipelineStageFlags stage, VkAccessFlags access) {
+  _passes[pass].accesses.push_back({.handle = (uint64_t)buffer, .image = false, .stage = stage, .access = access});
+}
+
+void FrameGraph::addMemory(int pass, VkPipelineStageFlags stage, VkAccessFlags access) {
+  _passes[pass].accesses.push_back({.handle = 0, .image = false, .stage = stage, .access = access});
+}
+
+void FrameGraph::addWait(int pass, VkSemaphore semaphore, VkPipelineStageFlags stage) {
+  _passes[pass].waitBinary.push_back({semaphore, stage});
+}
+
+void FrameGraph::addSignal(int pass, VkSemaphore semaphore) { _passes[pass].signalBinary.push_back(semaphore); }
+
+void FrameGraph::_addDependency(Pass& pass, int passSource, const Access& source, const Access& destination) {
+  auto& from = _passes[passSource];
+  // memory is made available and visible by semaphore
+  if (from.queue != pass.queue) {
+    auto& [value, stage] = pass.waitTimeline[from.queue];
+    value = std::max(value, from.value);
+    stage |= destination.stage;
+    return;
+  }
+
+  pass.barrierSrcStage |= source.stage;
+  pass.barrierDstStage |= destination.stage;
+  // write after read needs only execution dependency
+  if (_isWrite(source.access) == false) return;
+  if (destination.handle == 0) {
+    pass.memoryBarriers.push_back({.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                                   .srcAccessMask = source.access,
+                                   .dstAccessMask = destination.access});
+  } else if (destination.image) {
+    pass.imageBarriers.push_back({.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                                  .srcAccessMask = source.access,
+                                  .dstAccessMask = destination.access,
+                                  .oldLayout = destination.layout,
+                                  .newLayout = destination.layout,
+                                  .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                                  .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                                  .image = (VkImage)destination.handle,
+                                  .subresourceRange = destination.range});
+  } else {
+    pass.bufferBarriers.push_back({.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+                                   .srcAccessMask = source.access,
+                                   .dstAccessMask = destination.access,
+                                   .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                                   .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                                   .buffer = (VkBuffer)destination.handle,
+                                   .offset = 0,
+                                   .size = VK_WHOLE_SIZE});
+  }
+}
+
+void FrameGraph::_addOwnershipTransfer(Pass& pass, int passSource, const Access& source, const Access& destination) {
+  auto& from = _passes[passSource];
+  // the same barrier is recorded by both queues, release ignores dst access and acquire ignores src access
+  VkImageMemoryBarrier barrier{.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                               .srcAccessMask = _isWrite(source.access) ? source.access : 0,
+                               .dstAccessMask = destination.access,
+                               .oldLayout = source.layout,
+                               .newLayout = destination.layout,
+                               .srcQueueFamilyIndex = from.family,
+                               .dstQueueFamilyIndex = pass.family,
+                               .image = (VkImage)destination.handle,
+                               .subresourceRange = destination.range};
+  from.releaseSrcStage |= source.stage;
+  from.releaseBarriers.push_back(barrier);
+  // execution dependency is provided by semaphore
+  pass.barrierSrcStage |= VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+  pass.barrierDstStage |= destination.stage;
+  pass.imageBarriers.push_back(barrier);
+  // acquire has to wait for release even if both passes only read
+  auto& [value, stage] = pass.waitTimeline[from.queue];
+  value = std::max(value, from.value);
+  stage |= destination.stage;
+}
+
+void FrameGraph::compile() {
+  if (_passes.size() == 0) return;
+  // the latest write and reads after it for every resource
+  struct State {
+    int writer = -1;
+    Access write;
+    std::vector<std::tuple<int, Access>> readers;
+  };
+  std::map<uint64_t, State> states;
+  // the latest pass accessed image, its queue family owns the image
+  std::map<uint64_t, std::tuple<int, Access>> owners;
+  std::map<VkQueue, uint64_t> valueLatest;
+  for (auto& pass : _passes) {
+    pass.value = ++_value[pass.queue];
+    valueLatest[pass.queue] = pass.value;
+  }
+
+  for (int i = 0; i < _passes.size(); i++) {
+    auto& pass = _passes[i];
+    pass.waitTimeline.clear();
+    pass.barrierSrcStage = 0;
+    pass.barrierDstStage = 0;
+    pass.memoryBarriers.clear();
+    pass.bufferBarriers.clear();
+    pass.imageBarriers.clear();
+    pass.releaseSrcStage = 0;
+    pass.releaseBarriers.clear();
+    for (auto& [queue, value] : _external) pass.waitTimeline[queue] = {value, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT};
+
+    for (auto& access : pass.accesses) {
+      auto& state = states[access.handle];
+      if (state.writer >= 0 && state.writer != i) _addDependency(pass, state.writer, state.write, access);
+      if (_isWrite(access.access)) {
+        for (auto& [reader, read] : state.readers)
+          if (reader != i) _addDependency(pass, reader, read, access);
+      }
+      auto owner = owners.find(access.handle);
+      if (access.image && owner != owners.end()) {
+        auto& [passOwner, accessOwner] = owner->second;
+        if (passOwner != i && _passes[passOwner].family != pass.family)
+          _addOwnershipTransfer(pass, passOwner, accessOwner, access);
+      }
+    }
+    for (auto& access : pass.accesses) {
+      if (access.image) owners[access.handle] = {i, access};
+      auto& state = states[access.handle];
+      if (_isWrite(access.access)) {
+        state.writer = i;
+        state.write = access;
+        state.readers.clear();
+      } else {
+        state.readers.push_back({i, access});
+      }
+    }
+  }
+  _external.clear();
+
+  // fence is signaled by the last pass, so it waits for all work of other queues
+  auto& last = _passes.back();
+  for (auto& [queue, value] : valueLatest) {
+    if (queue == last.queue) continue;
+    auto& [waitValue, waitStage] = last.waitTimeline[queue];
+    if (waitValue < value) {
+      waitValue = value;
+      waitStage |= VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    }
+  }
+}
+
+void FrameGraph::recordBarriers(int pass) {
+  auto& current = _passes[pass];
+  if (current.barrierSrcStage == 0 || current.commandBuffers.size() == 0) return;
+  auto frameInFlight = _engineState->getFrameInFlight();
+  vkCmdPipelineBarrier(current.commandBuffers.front()->getCommandBuffer()[frameInFlight], current.barrierSrcStage,
+                       current.barrierDstStage, 0, current.memoryBarriers.size(), current.memoryBarriers.data(),
+                       current.bufferBarriers.size(), current.bufferBarriers.data(), current.imageBarriers.size(),
+                       current.imageBarriers.data());
+}
+
+void FrameGraph::recordReleases(int pass) {
+  auto& current = _passes[pass];
+  if (current.releaseBarriers.size() == 0 || current.commandBuffers.size() == 0) return;
+  auto frameInFlight = _engineState->getFrameInFlight();
+  vkCmdPipelineBarrier(current.commandBuffers.back()->getCommandBuffer()[frameInFlight], current.releaseSrcStage,
+                       VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, current.releaseBarriers.size(),
+                       current.releaseBarriers.data());
+}
+
+void FrameGraph::_submit(VkQueue queue, std::vector<int> passes, VkFence fence) {
+  auto frameInFlight = _engineState->getFrameInFlight();
+  // semaphore, value (ignored for binary semaphore), stage
+  std::vector<std::vector<std::tuple<VkSemaphore, uint64_t, VkPipelineStageFlags>>> waits(passes.size()),
+      signals(passes.size());
+  std::vector<std::vector<VkCommandBuffer>> commandBuffers(passes.size());
+  for (int i = 0; i < passes.size(); i++) {
+    auto& pass = _passes[passes[i]];
+    for (auto& [semaphore, stage] : pass.waitBinary) waits[i].push_back({semaphore, 0, stage});
+    for (auto& [waitQueue, wait] : pass.waitTimeline) {
+      auto [value, stage] = wait;
+      waits[i].push_back({_getTimeline(waitQueue)->getSemaphore(), value, stage});
+    }
+    for (auto& semaphore : pass.signalBinary) signals[i].push_back({semaphore, 0, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT});
+    signals[i].push_back({_getTimeline(queue)->getSemaphore(), pass.value, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT});
+    for (auto& commandBuffer : pass.commandBuffers)
+      commandBuffers[i].push_back(commandBuffer->getCommandBuffer()[frameInFlight]);
+  }
+
+  if (_engineState->getDevice()->isSynchronization2Supported()) {
+    std::vector<std::vector<VkSemaphoreSubmitInfoKHR>> waitInfos(passes.size()), signalInfos(passes.size());
+    std::vector<std::vector<VkCommandBufferSubmitInfoKHR>> commandBufferInfos(passes.size());
+    std::vector<VkSubmitInfo2KHR> submitInfos;
+    for (int i = 0; i < passes.size(); i++) {
+      for (auto& [semaphore, value, stage] : waits[i])
+        waitInfos[i].push_back({.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO_KHR,
+                                .semaphore = semaphore,
+                                .value = value,
+                                .stageMask = stage});
+      for (auto& [semaphore, value, stage] : signals[i])
+        signalInfos[i].push_back({.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO_KHR,
+                                  .semaphore = semaphore,
+                                  .value = value,
+                                  .stageMask = stage});
+      for (auto& commandBuffer : commandBuffers[i])
+        commandBufferInfos[i].push_back(
+            {.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO_KHR, .commandBuffer = commandBuffer});
+      submitInfos.push_back({.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2_KHR,
+                             .waitSemaphoreInfoCount = static_cast<uint32_t>(waitInfos[i].size()),
+                             .pWaitSemaphoreInfos = waitInfos[i].data(),
+                             .commandBufferInfoCount = static_cast<uint32_t>(commandBufferInfos[i].size()),
+                             .pCommandBufferInfos = commandBufferInfos[i].data(),
+                             .signalSemaphoreInfoCount = static_cast<uint32_t>(signalInfos[i].size()),
+                             .pSignalSemaphoreInfos = signalInfos[i].data()});
+    }
+    if (vkQueueSubmit2KHR(queue, submitInfos.size(), submitInfos.data(), fence) != VK_SUCCESS)
+      throw std::runtime_error("failed to submit frame!");
+    return;
+  }
+
+  // values of timeline semaphores are passed separately from submit info
+  std::vector<std::vector<VkSemaphore>> waitSemaphores(passes.size()), signalSemaphores(passes.size());
+  std::vector<std::vector<uint64_t>> waitValues(passes.size()), signalValues(passes.size());
+  std::vector<std::vector<VkPipelineStageFlags>> waitStages(passes.size());
+  std::vector<VkTimelineSemaphoreSubmitInfoKHR> timelineInfos(passes.size());
+  std::vector<VkSubmitInfo> submitInfos(passes.size());
+  for (int i = 0; i < passes.size(); i++) {
+    for (auto& [semaphore, value, stage] : waits[i]) {
+      waitSemaphores[i].push_back(semaphore);
+      waitValues[i].push_back(value);
+      waitStages[i].push_back(stage);
+    }
+    for (auto& [semaphore, value, stage] : signals[i]) {
+      signalSemaphores[i].push_back(semaphore);
+      signalValues[i].push_back(value);
+    }
+    timelineInfos[i] = {.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR,
+                        .waitSemaphoreValueCount = static_cast<uint32_t>(waitValues[i].size()),
+                        .pWaitSemaphoreValues = waitValues[i].data(),
+                        .signalSemaphoreValueCount = static_cast<uint32_t>(signalValues[i].size()),
+                        .pSignalSemaphoreValues = signalValues[i].data()};
+    submitInfos[i] = {.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+                      .pNext = &timelineInfos[i],
+                      .waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores[i].size()),
+                      .pWaitSemaphores = waitSemaphores[i].data(),
+                      .pWaitDstStageMask = waitStages[i].data(),
+                      .commandBufferCount = static_cast<uint32_t>(commandBuffers[i].size()),
+                      .pCommandBuffers = commandBuffers[i].data(),
+                      .signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores[i].size()),
+                      .pSignalSemaphores = signalSemaphores[i].data()};
+  }
+  if (vkQueueSubmit(queue, submitInfos.size(), submitInfos.data(), fence) != VK_SUCCESS)
+    throw std::runtime_error("failed to submit frame!");
+}
+
+void FrameGraph::submit(VkFence fence) {
+  // passes are grouped by queue keeping their order, waits for later submitted signals are allowed for timelines
+  std::vector<VkQueue> queues;
+  std::map<VkQueue, std::vector<int>> passes;
+  for (int i = 0; i < _passes.size(); i++) {
+    if (passes[_passes[i].queue].size() == 0) queues.push_back(_passes[i].queue);
+    passes[_passes[i].queue].push_back(i);
+  }
+  if (queues.size() == 0) return;
+  auto last = _passes.back().queue;
+  for (auto queue : queues)
+    if (queue != last) _submit(queue, passes[queue], VK_NULL_HANDLE);
+  _submit(last, passes[last], fence);
+}
+
+void FrameGraph::submitExternal(vkb::QueueType queueType, std::shared_ptr<CommandBuffer> commandBuffer) {
+  submitExternal(queueType, commandBuffer->getCommandBuffer()[_engineState->getFrameInFlight()]);
+}
+
+void FrameGraph::submitExternal(vkb::QueueType queueType,
+                                VkCommandBuffer commandBuffer,
+                                VkSemaphore waitTimeline,
+                                uint64_t waitValue) {
+  auto queue = _engineState->getDevice()->getQueue(queueType);
+  uint64_t value = ++_value[queue];
+  VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+  uint32_t waitCount = waitTimeline == VK_NULL_HANDLE ? 0 : 1;
+  VkTimelineSemaphoreSubmitInfoKHR timelineInfo{.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR,
+                                                .waitSemaphoreValueCount = waitCount,
+                                                .pWaitSemaphoreValues = &waitValue,
+                                                .signalSemaphoreValueCount = 1,
+                                                .pSignalSemaphoreValues = &value};
+  VkSubmitInfo submitInfo{.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+                          .pNext = &timelineInfo,
+                          .waitSemaphoreCount = waitCount,
+                          .pWaitSemaphores = &waitTimeline,
+                          .pWaitDstStageMask = &waitStage,
+                          .commandBufferCount = 1,
+                          .pCommandBuffers = &commandBuffer,
+                          .signalSemaphoreCount = 1,
+                          .pSignalSemaphores = &_getTimeline(queue)->getSemaphore()};
+  if (vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+    throw std::runtime_error("failed to submit command buffer!");
+  _external[queue] = value;
+}
@@ -60,7 +60,10 @@ void Image::overrideLayout(VkImageLayout layout) { _imageLayout = layout; }
 std::tuple<int, int> Image::getResolution() { return _resolution; }
 
 void Image::generateMipmaps(int mipMapLevels, int layers, std::shared_ptr<CommandBuffer> commandBuffer) {
-  int currentFrame = _engineState->getFrameInFlight();
+  generateMipmaps(mipMapLevels, layers, commandBuffer->getCommandBuffer()[_engineState->getFrameInFlight()]);
+}
+
+void Image::generateMipmaps(int mipMapLevels, int layers, VkCommandBuffer commandBuffer) {
   VkImageMemoryBarrier barrier{.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
                                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
                                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
@@ -78,8 +81,8 @@ void Image::generateMipmaps(int mipMapLevels, int layers, std::shared_ptr<Comman
     barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
     barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
 
-    vkCmdPipelineBarrier(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_STAGE_TRANSFER_BIT,
-                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr,
+                         0, nullptr, 1, &barrier);
 
     VkImageBlit blit{};
     blit.srcOffsets[0] = {0, 0, 0};
@@ -97,8 +100,8 @@ void Image::generateMipmaps(int mipMapLevels, int layers, std::shared_ptr<Comman
 
     // i = 0 has SRC layout (we changed it above), i = 1 has DST layout (we changed from undefined to dst in
     // constructor)
-    vkCmdBlitImage(commandBuffer->getCommandBuffer()[currentFrame], getImage(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                   getImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+    vkCmdBlitImage(commandBuffer, getImage(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, getImage(),
+                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
 
     // change i = 0 to READ OPTIMAL, we won't use this level anymore, next resizes will use next i
     barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
@@ -106,8 +109,8 @@ void Image::generateMipmaps(int mipMapLevels, int layers, std::shared_ptr<Comman
     barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
     barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 
-    vkCmdPipelineBarrier(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_STAGE_TRANSFER_BIT,
-                         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0,
+                         nullptr, 0, nullptr, 1, &barrier);
 
     if (mipWidth > 1) mipWidth /= 2;
     if (mipHeight > 1) mipHeight /= 2;
@@ -120,8 +123,8 @@ void Image::generateMipmaps(int mipMapLevels, int layers, std::shared_ptr<Comman
   barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
   barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 
-  vkCmdPipelineBarrier(commandBuffer->getCommandBuffer()[currentFrame], VK_PIPELINE_STAGE_TRANSFER_BIT,
-                       VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0,
+                       nullptr, 0, nullptr, 1, &barrier);
 
   // we changed real image layout above, need to override imageLayout internal field
   overrideLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
@@ -246,8 +249,6 @@ void Image::setData(std::shared_ptr<Buffer> buffer) {}
 void Image::copyFrom(std::shared_ptr<Buffer> buffer,
                      std::vector<int> bufferOffsets,
                      std::shared_ptr<CommandBuffer> commandBufferTransfer) {
-  _stagingBuffer = buffer;
-
   std::vector<VkBufferImageCopy> bufferCopyRegions;
   for (int i = 0; i < bufferOffsets.size(); i++) {
     VkBufferImageCopy region{
@@ -276,6 +277,14 @@ void Image::copyFrom(std::shared_ptr<Buffer> buffer,
                        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
 }
 
+void Image::copyFrom(std::shared_ptr<BufferImage> data,
+                     std::vector<int> bufferOffsets,
+                     std::shared_ptr<CommandBuffer> commandBufferTransfer) {
+  auto staging = _engineState->getStagingRing()->upload(data->getData(), data->getSize());
+  for (auto& offset : bufferOffsets) offset += staging.offset;
+  copyFrom(staging.buffer, bufferOffsets, commandBufferTransfer);
+}
+
 VkImageLayout& Image::getImageLayout() { return _imageLayout; }
 
 VkImage& Image::getImage() { return _image; }
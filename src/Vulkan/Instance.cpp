@@ -16,7 +16,7 @@ VKAPI_ATTR VkBool32 VKAPI_CALL debugCallbackUtils(VkDebugUtilsMessageSeverityFla
   return VK_FALSE;
 }
 
-Instance::Instance(std::string name, bool validation) {
+Instance::Instance(std::string name, bool validation, bool headless) {
   auto sts = volkInitialize();
   if (sts != VK_SUCCESS) throw std::runtime_error("Can't initialize Vulkan Loader");
   // VK_KHR_win32_surface || VK_KHR_android_surface as well as VK_KHR_surface
@@ -34,6 +34,8 @@ Instance::Instance(std::string name, bool validation) {
       _debugUtils = true;
     }
   }
+  // surface extensions aren't required, so software implementations without WSI can be used
+  builder.set_headless(headless);
   auto instanceResult = builder.set_app_name(name.c_str()).require_api_version(1, 1, 0).build();
   if (!instanceResult)
     throw std::runtime_error("Failed to create Vulkan instance. Error: " + instanceResult.error().message());
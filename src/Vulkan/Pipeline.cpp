@@ -163,11 +163,16 @@ void PipelineGraphic::createCustom(
                                             .subpass = 0,
                                             .basePipelineHandle = VK_NULL_HANDLE};
   if (_tessellationState) pipelineInfo.pTessellationState = &_tessellationState.value();
-  auto status = vkCreateGraphicsPipelines(_device->getLogicalDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr,
-                                          &_pipeline);
+  VkPipelineCreationFeedbackEXT feedback{};
+  VkPipelineCreationFeedbackCreateInfoEXT feedbackInfo{
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT, .pPipelineCreationFeedback = &feedback};
+  if (_device->isPipelineFeedbackSupported()) pipelineInfo.pNext = &feedbackInfo;
+  auto status = vkCreateGraphicsPipelines(_device->getLogicalDevice(), _device->getPipelineCache(), 1, &pipelineInfo,
+                                          nullptr, &_pipeline);
   if (status != VK_SUCCESS) {
     throw std::runtime_error("failed to create graphics pipeline!");
   }
+  _device->addPipelineFeedback(feedback);
 }
 
 PipelineCompute::PipelineCompute(std::shared_ptr<Device> device) : Pipeline(device) {}
@@ -207,6 +212,11 @@ void PipelineCompute::createCustom(
   computePipelineCreateInfo.flags = 0;
   //
   computePipelineCreateInfo.stage = shaderStage;
-  vkCreateComputePipelines(_device->getLogicalDevice(), VK_NULL_HANDLE, 1, &computePipelineCreateInfo, nullptr,
-                           &_pipeline);
+  VkPipelineCreationFeedbackEXT feedback{};
+  VkPipelineCreationFeedbackCreateInfoEXT feedbackInfo{
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT, .pPipelineCreationFeedback = &feedback};
+  if (_device->isPipelineFeedbackSupported()) computePipelineCreateInfo.pNext = &feedbackInfo;
+  vkCreateComputePipelines(_device->getLogicalDevice(), _device->getPipelineCache(), 1, &computePipelineCreateInfo,
+                           nullptr, &_pipeline);
+  _device->addPipelineFeedback(feedback);
 }
\ No newline at end of file
@@ -18,11 +18,31 @@ VkCommandPool& CommandPool::getCommandPool() { return _commandPool; }
 
 CommandPool::~CommandPool() { vkDestroyCommandPool(_device->getLogicalDevice(), _commandPool, nullptr); }
 
+QueryPool::QueryPool(VkQueryType type, int size, std::shared_ptr<Device> device) {
+  _device = device;
+  _size = size;
+  VkQueryPoolCreateInfo poolInfo{.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+                                 .queryType = type,
+                                 .queryCount = static_cast<uint32_t>(size)};
+
+  if (vkCreateQueryPool(device->getLogicalDevice(), &poolInfo, nullptr, &_queryPool) != VK_SUCCESS) {
+    throw std::runtime_error("failed to create query pool!");
+  }
+}
+
+VkQueryPool& QueryPool::getQueryPool() { return _queryPool; }
+
+int QueryPool::getSize() { return _size; }
+
+QueryPool::~QueryPool() { vkDestroyQueryPool(_device->getLogicalDevice(), _queryPool, nullptr); }
+
 DescriptorPool::DescriptorPool(std::shared_ptr<Settings> settings, std::shared_ptr<Device> device) {
   _device = device;
 
   std::vector<VkDescriptorPoolSize> poolSizes{
       {.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, .descriptorCount = static_cast<uint32_t>(settings->getPoolSizeUBO())},
+      {.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+       .descriptorCount = static_cast<uint32_t>(settings->getPoolSizeUBODynamic())},
       {.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
        .descriptorCount = static_cast<uint32_t>(settings->getPoolSizeSampler())},
       {.type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
@@ -76,7 +76,9 @@ RenderPassManager::RenderPassManager(std::shared_ptr<Settings> settings, std::sh
                                                            // comes from postprocessing
                                                            .initialLayout = VK_IMAGE_LAYOUT_GENERAL,
                                                            // goes to presentation
-                                                           .finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR}};
+                                                           .finalLayout = settings->getHeadless()
+                                                                              ? VK_IMAGE_LAYOUT_GENERAL
+                                                                              : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR}};
     VkAttachmentReference colorReference{.attachment = 0, .layout = VK_IMAGE_LAYOUT_GENERAL};
     _renderPasses[RenderPassScenario::GUI] = std::make_shared<RenderPass>(device);
     _renderPasses[RenderPassScenario::GUI]->initializeCustom(colorDescription, {colorReference}, std::nullopt);
@@ -2,6 +2,10 @@
 
 Swapchain::Swapchain(std::shared_ptr<EngineState> engineState) {
   _engineState = engineState;
+  if (engineState->getSettings()->getHeadless()) {
+    _createImageViewsHeadless();
+    return;
+  }
 
   vkb::SwapchainBuilder builder{_engineState->getDevice()->getDevice()};
 #if __ANDROID__
@@ -11,8 +15,8 @@ Swapchain::Swapchain(std::shared_ptr<EngineState> engineState) {
 #endif
   builder.set_desired_format(VkSurfaceFormatKHR{.format = engineState->getSettings()->getSwapchainColorFormat(),
                                                 .colorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR});
-  // because we use swapchain in compute shader
-  builder.add_image_usage_flags(VK_IMAGE_USAGE_STORAGE_BIT);
+  // because we use swapchain in compute shader, transfer is needed for frame capture
+  builder.add_image_usage_flags(VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
   auto swapchainResult = builder.build();
   if (!swapchainResult) {
     throw std::runtime_error(swapchainResult.error().message());
@@ -37,11 +41,32 @@ void Swapchain::_createImageViews() {
   }
 }
 
+void Swapchain::_createImageViewsHeadless() {
+  auto settings = _engineState->getSettings();
+  _swapchainImageViews.clear();
+  for (int i = 0; i < settings->getMaxFramesInFlight(); i++) {
+    auto image = std::make_shared<Image>(
+        settings->getResolution(), 1, 1, settings->getSwapchainColorFormat(), VK_IMAGE_TILING_OPTIMAL,
+        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, _engineState);
+    _swapchainImageViews.push_back(std::make_shared<ImageView>(image, VK_IMAGE_VIEW_TYPE_2D, 0, 1, 0, 1,
+                                                               VK_IMAGE_ASPECT_COLOR_BIT, _engineState));
+  }
+}
+
 std::vector<std::shared_ptr<ImageView>> Swapchain::getImageViews() { return _swapchainImageViews; }
 
+VkImageLayout Swapchain::getPresentLayout() {
+  if (_engineState->getSettings()->getHeadless()) return VK_IMAGE_LAYOUT_GENERAL;
+  return VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+}
+
 Swapchain::~Swapchain() { _destroy(); }
 
-void Swapchain::_destroy() { vkb::destroy_swapchain(_swapchain); }
+void Swapchain::_destroy() {
+  if (_engineState->getSettings()->getHeadless()) return;
+  vkb::destroy_swapchain(_swapchain);
+}
 
 const vkb::Swapchain& Swapchain::getSwapchain() { return _swapchain; }
 
@@ -58,8 +83,8 @@ void Swapchain::reset() {
 #endif
   builder.set_desired_format(VkSurfaceFormatKHR{.format = _engineState->getSettings()->getSwapchainColorFormat(),
                                                 .colorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR});
-  // because we use swapchain in compute shader
-  builder.add_image_usage_flags(VK_IMAGE_USAGE_STORAGE_BIT);
+  // because we use swapchain in compute shader, transfer is needed for frame capture
+  builder.add_image_usage_flags(VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
   auto swapchainResult = builder.build();
   if (!swapchainResult) {
     // If it failed to create a swapchain, the old swapchain handle is invalid.
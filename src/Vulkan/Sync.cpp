@@ -13,6 +13,22 @@ VkSemaphore& Semaphore::getSemaphore() { return _semaphore; }
 
 Semaphore::~Semaphore() { vkDestroySemaphore(_device->getLogicalDevice(), _semaphore, nullptr); }
 
+SemaphoreTimeline::SemaphoreTimeline(std::shared_ptr<Device> device) {
+  _device = device;
+
+  VkSemaphoreTypeCreateInfoKHR typeInfo{.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR,
+                                        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR,
+                                        .initialValue = 0};
+  VkSemaphoreCreateInfo semaphoreInfo{.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO, .pNext = &typeInfo};
+
+  if (vkCreateSemaphore(device->getLogicalDevice(), &semaphoreInfo, nullptr, &_semaphore) != VK_SUCCESS)
+    throw std::runtime_error("failed to create timeline semaphore!");
+}
+
+VkSemaphore& SemaphoreTimeline::getSemaphore() { return _semaphore; }
+
+SemaphoreTimeline::~SemaphoreTimeline() { vkDestroySemaphore(_device->getLogicalDevice(), _semaphore, nullptr); }
+
 Fence::Fence(std::shared_ptr<Device> device) {
   _device = device;
 
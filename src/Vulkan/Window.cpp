@@ -26,6 +26,8 @@ void Window::setNativeWindow(ANativeWindow* window) { _window = window; }
 
 Window::~Window() {
 #ifndef __ANDROID__
+  // window isn't created in headless mode
+  if (_window == nullptr) return;
   glfwDestroyWindow((GLFWwindow*)(_window));
   glfwTerminate();
 #endif